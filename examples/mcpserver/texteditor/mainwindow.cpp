@@ -72,6 +72,8 @@ void MainWindow::setupMcpServer()
         { u"saveFileAs"_s, u"Save the current document to a new file"_s },
         { u"saveFileAs/filePath"_s, u"Full path where to save the file"_s },
     });
+    // Editing raises a change per keystroke; let clients hear of a burst once.
+    m_server->setNotificationCoalescing(200, 1000);
     m_server->start();
 }
 
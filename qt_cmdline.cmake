@@ -1,2 +1,3 @@
 qt_commandline_subconfig(src/mcpserver)
 qt_commandline_subconfig(src/mcpclient)
+qt_commandline_subconfig(src/mcpproxy)
@@ -4,59 +4,61 @@
 #include "qmcpclient.h"
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qjsonobject.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qtimer.h>
 #include <QtCore/private/qfactoryloader_p.h>
 
 #include <QtMcpClient/qmcpclientbackendplugin.h>
 #include <QtMcpClient/qmcpclientbackendinterface.h>
 #include <QtMcpCommon>
+#include <QtMcpCommon/private/qmcppendingrequests_p.h>
 
 QT_BEGIN_NAMESPACE
 
 Q_GLOBAL_STATIC_WITH_ARGS(QFactoryLoader, backendLoader,
                           (QMcpClientBackendPluginFactoryInterface_iid, "/mcpclientbackend"_L1, Qt::CaseInsensitive))
 
+// Used when neither the caller nor the server suggested a poll interval.
+static constexpr int DefaultTaskPollIntervalMs = 1000;
+
 class QMcpClient::Private
 {
 public:
     QtMcp::ProtocolVersion protocolVersion = QtMcp::ProtocolVersion::Latest; // Default to latest version
     bool tasksExtensionEnabled = false;
+    bool partialToolResultsEnabled = false;
     const QList<QtMcp::ProtocolVersion> supportedVersions = {QtMcp::ProtocolVersion::v2024_11_05, QtMcp::ProtocolVersion::v2025_03_26, QtMcp::ProtocolVersion::v2025_06_18, QtMcp::ProtocolVersion::v2025_11_25, QtMcp::ProtocolVersion::v2026_07_28};
 
-    Private(const QString &type, QMcpClient *parent)
+    Private(QMcpClientBackendInterface *backend, QMcpClient *parent)
         : q(parent)
+        , backend(backend)
     {
-        backend = qLoadPlugin<QMcpClientBackendInterface, QMcpClientBackendPlugin>(backendLoader(), type);
-        if (!backend) {
-            qWarning() << type << "not found";
-            qWarning() << "call QMcpClient::backends() to get a list of available backends";
-            qWarning() << QMcpClient::backends();
+        if (!backend)
             return;
-        }
 
         backend->setParent(q);
         connect(backend, &QMcpClientBackendInterface::started, q, &QMcpClient::started);
         connect(backend, &QMcpClientBackendInterface::errorOccurred, q, &QMcpClient::errorOccurred);
         connect(backend, &QMcpClientBackendInterface::received, q, [this](const QJsonObject &object) {
-            if (object.contains("id"_L1)) {
+            if (object.contains("id"_L1) && !object.contains("method"_L1)) {
                 const auto id = object.value("id"_L1);
                 if (object.contains("result"_L1)) {
-                    if (callbacks.contains(id)) {
+                    if (const auto callback = pending.take(QUuid(), id)) {
                         const auto result = object.value("result"_L1).toObject();
                         // A multi round-trip interim result (2026-07-28) does
                         // not complete the request; the caller retries with
                         // inputResponses and gets the final result there.
                         if (result.value("resultType"_L1).toString() == "input_required"_L1) {
-                            callbacks.remove(id);
                             emit q->inputRequired(id, result);
                             return;
                         }
-                        callbacks.take(id)(result, {});
+                        callback(result, {});
                         return;
                     }
                 } else if (object.contains("error"_L1)) {
-                    if (callbacks.contains(id)) {
+                    if (const auto callback = pending.take(QUuid(), id)) {
                         const auto error = object.value("error"_L1).toObject();
-                        callbacks.take(id)({}, error);
+                        callback({}, error);
                         return;
                     }
                 }
@@ -102,6 +104,22 @@ public:
                     return;
                 }
 
+                // tasks extension: a pushed status replaces polling the task.
+                if (method == "notifications/tasks"_L1 || method == "notifications/tasks/status"_L1)
+                    updateTask(object.value("params"_L1).toObject(), true);
+
+                if (method == "notifications/tools/partialResult"_L1) {
+                    const auto params = object.value("params"_L1).toObject();
+                    QList<QMcpCallToolResultContent> content;
+                    const auto items = params.value("content"_L1).toArray();
+                    for (const auto &item : items) {
+                        QMcpCallToolResultContent block;
+                        if (block.fromJsonObject(item.toObject(), protocolVersion))
+                            content.append(block);
+                    }
+                    emit q->partialToolResult(params.value("progressToken"_L1), content);
+                }
+
                 if (notificationHandlers.contains(method)) {
                     const auto handlers = notificationHandlers.values(method);
                     for (auto &handler : handlers) {
@@ -109,27 +127,113 @@ public:
                     }
                     return;
                 }
+                if (method == "notifications/tasks"_L1 || method == "notifications/tasks/status"_L1
+                    || method == "notifications/tools/partialResult"_L1)
+                    return;
             }
 
             qWarning() << "not handled" << object;
         });
     }
 
+    void updateTask(const QJsonObject &task, bool pushed);
+    void scheduleTaskPoll(const QString &taskId, int intervalMs);
+
 private:
     QMcpClient *q;
 public:
     QMcpClientBackendInterface *backend = nullptr;
-    QHash<QJsonValue, std::function<void(const QJsonObject &, const QJsonObject &)>> callbacks;
+    // Requests sent to the server that still await an answer.
+    QMcpPendingRequests pending;
     QHash<QString, std::function<QJsonObject(const QJsonObject &, QMcpJSONRPCErrorError *)>> requestHandlers;
     QMultiHash<QString, std::function<void(const QJsonObject &)>> notificationHandlers;
+
+    // Tasks passed to followTask(). Polling stops for good once the server
+    // pushed a status for the task.
+    struct FollowedTask {
+        QMcpTaskStatus::QMcpTaskStatus status = QMcpTaskStatus::working;
+        bool pushed = false;
+    };
+    QHash<QString, FollowedTask> followedTasks;
 };
 
+// Records the task state from a push or a tasks/get result. Pushes are
+// transitions and always reported; a poll only when the status moved.
+void QMcpClient::Private::updateTask(const QJsonObject &task, bool pushed)
+{
+    const auto taskId = task.value("taskId"_L1).toString();
+    if (taskId.isEmpty())
+        return;
+    bool ok = false;
+    const auto status = static_cast<QMcpTaskStatus::QMcpTaskStatus>(
+        QMetaEnum::fromType<QMcpTaskStatus::QMcpTaskStatus>().keyToValue(
+            task.value("status"_L1).toString().toLatin1().constData(), &ok));
+    if (!ok)
+        return;
+
+    const bool followed = followedTasks.contains(taskId);
+    if (followed) {
+        auto &entry = followedTasks[taskId];
+        if (!pushed && entry.status == status)
+            return;
+        entry.status = status;
+        entry.pushed = entry.pushed || pushed;
+        if (status != QMcpTaskStatus::working && status != QMcpTaskStatus::input_required)
+            followedTasks.remove(taskId);
+    }
+    emit q->taskStatusChanged(taskId, status, task);
+}
+
+void QMcpClient::Private::scheduleTaskPoll(const QString &taskId, int intervalMs)
+{
+    QTimer::singleShot(intervalMs, q, [this, taskId]() {
+        if (!followedTasks.contains(taskId) || followedTasks.value(taskId).pushed)
+            return;
+        QJsonObject params;
+        params.insert("taskId"_L1, taskId);
+        QJsonObject request;
+        request.insert("jsonrpc"_L1, "2.0"_L1);
+        request.insert("id"_L1, QJsonValue::Null);
+        request.insert("method"_L1, "tasks/get"_L1);
+        request.insert("params"_L1, params);
+        q->send(request, [this, taskId](const QJsonObject &result, const QJsonObject &error) {
+            if (!error.isEmpty()) {
+                followedTasks.remove(taskId);
+                return;
+            }
+            updateTask(result, false);
+            if (followedTasks.contains(taskId) && !followedTasks.value(taskId).pushed)
+                scheduleTaskPoll(taskId, result.value("pollIntervalMs"_L1).toInt(DefaultTaskPollIntervalMs));
+        });
+    });
+}
+
 QStringList QMcpClient::backends()
 {
     return backendLoader()->keyMap().values();
 }
 
+/*!
+    \internal
+    Returns a new instance of the backend plugin \a type, or nullptr.
+*/
+static QMcpClientBackendInterface *loadBackend(const QString &type)
+{
+    auto *backend = qLoadPlugin<QMcpClientBackendInterface, QMcpClientBackendPlugin>(backendLoader(), type);
+    if (!backend) {
+        qWarning() << type << "not found";
+        qWarning() << "call QMcpClient::backends() to get a list of available backends";
+        qWarning() << QMcpClient::backends();
+    }
+    return backend;
+}
+
 QMcpClient::QMcpClient(const QString &backend, QObject *parent)
+    : QObject(parent)
+    , d(new Private(loadBackend(backend), this))
+{}
+
+QMcpClient::QMcpClient(QMcpClientBackendInterface *backend, QObject *parent)
     : QObject(parent)
     , d(new Private(backend, this))
 {}
@@ -170,6 +274,39 @@ bool QMcpClient::isTasksExtensionEnabled() const
     return d->tasksExtensionEnabled;
 }
 
+void QMcpClient::setPartialToolResultsEnabled(bool enabled)
+{
+    d->partialToolResultsEnabled = enabled;
+}
+
+bool QMcpClient::isPartialToolResultsEnabled() const
+{
+    return d->partialToolResultsEnabled;
+}
+
+void QMcpClient::setRequestTimeout(int msecs)
+{
+    d->pending.setTimeout(msecs);
+}
+
+int QMcpClient::requestTimeout() const
+{
+    return d->pending.timeout();
+}
+
+void QMcpClient::followTask(const QString &taskId, int pollIntervalMs)
+{
+    if (taskId.isEmpty() || d->followedTasks.contains(taskId))
+        return;
+    d->followedTasks.insert(taskId, Private::FollowedTask());
+    d->scheduleTaskPoll(taskId, pollIntervalMs > 0 ? pollIntervalMs : DefaultTaskPollIntervalMs);
+}
+
+void QMcpClient::unfollowTask(const QString &taskId)
+{
+    d->followedTasks.remove(taskId);
+}
+
 void QMcpClient::send(const QJsonObject &request, std::function<void(const QJsonObject &, const QJsonObject &)> callback)
 {
     if (!d->backend) return;
@@ -219,13 +356,12 @@ void QMcpClient::send(const QJsonObject &request, std::function<void(const QJson
         };
 
         // Send with our wrapped callback
-        static int id = 0;
         if (requestCopy.contains("id"_L1) && requestCopy.value("id"_L1).isNull()) {
             auto request2 = requestCopy;
+            const auto id = d->pending.nextId();
             request2.insert("id"_L1, id);
 
-            d->callbacks.insert(id, initCallback);
-            id++;
+            d->pending.insert(id, QUuid(), initCallback);
             d->backend->send(request2);
         } else {
             d->backend->send(requestCopy);
@@ -237,6 +373,18 @@ void QMcpClient::send(const QJsonObject &request, std::function<void(const QJson
     // For non-initialization requests, use the standard flow
     auto message = request;
 
+    // Partial tool results are tagged with the call's progress token, so
+    // only a call that has one can ask for them.
+    if (d->partialToolResultsEnabled && message.value("method"_L1).toString() == "tools/call"_L1) {
+        auto params = message.value("params"_L1).toObject();
+        auto meta = params.value("_meta"_L1).toObject();
+        if (meta.contains("progressToken"_L1)) {
+            meta.insert("io.qtmcp/partialResults"_L1, true);
+            params.insert("_meta"_L1, meta);
+            message.insert("params"_L1, params);
+        }
+    }
+
     // Stateless lifecycle (2026-07-28): there is no initialize handshake, so
     // every request identifies the protocol version and the client in its
     // params _meta instead.
@@ -261,14 +409,13 @@ void QMcpClient::send(const QJsonObject &request, std::function<void(const QJson
         message.insert("params"_L1, params);
     }
 
-    static int id = 0;
     if (message.contains("id"_L1) && message.value("id"_L1).isNull()) {
         auto request2 = message;
+        const auto id = d->pending.nextId();
         request2.insert("id"_L1, id);
 
         if (callback)
-            d->callbacks.insert(id, callback);
-        id++;
+            d->pending.insert(id, QUuid(), callback);
         d->backend->send(request2);
     } else {
         d->backend->send(message);
@@ -5,17 +5,26 @@
 #define QMCPCLIENT_H
 
 #include <QtMcpClient/qmcpclientglobal.h>
+#include <QtCore/QFuture>
 #include <QtCore/QObject>
+#include <QtCore/QPromise>
+#include <QtCore/QThreadPool>
+#include <QtMcpClient/qmcprequesterror.h>
+#include <QtMcpCommon/QMcpCallToolResultContent>
 #include <QtMcpCommon/QMcpRequest>
 #include <QtMcpCommon/QMcpResult>
 #include <QtMcpCommon/QMcpNotification>
 #include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/qmcptaskstatus.h>
 #include <QtMcpCommon/qtmcpnamespace.h>
 #include <concepts>
 #include <functional>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
+class QMcpClientBackendInterface;
+
 /*!
     \class QMcpClient
     \inmodule QtMcpClient
@@ -87,6 +96,16 @@ public:
     */
     explicit QMcpClient(const QString &backend, QObject *parent = nullptr);
 
+    /*!
+        Constructs an MCP client talking through \a backend, which it takes
+        ownership of. Used where a backend comes from elsewhere than a
+        plugin, as with QMcpStdioServerPool::lease().
+
+        \param backend Backend instance to use
+        \param parent Parent QObject (optional)
+    */
+    explicit QMcpClient(QMcpClientBackendInterface *backend, QObject *parent = nullptr);
+
     /*!
         Destroys the MCP client.
     */
@@ -123,7 +142,9 @@ public:
         Sends a request to the server and handles the response with a callback.
 
         The callback will be invoked with the response result and any error that occurred.
-        If no error occurred, the error parameter will be nullptr.
+        If no error occurred, the error parameter will be nullptr. A request
+        the server leaves unanswered for requestTimeout() fails with error
+        code -32001.
 
         Example:
         \code
@@ -153,18 +174,8 @@ public:
         // For all other requests, we use the current protocol version
         auto json = request.toJsonObject(protocolVersion());
         send(json, [callback, this](const QJsonObject &json, const QJsonObject &error) {
-            // Use the negotiated protocol version from the response when available
-            QtMcp::ProtocolVersion versionToUse = protocolVersion();
-
-            // If the result contains a protocol version field, use that version
-            if (json.contains("protocolVersion"_L1)) {
-                QString resultVersion = json.value("protocolVersion"_L1).toString();
-                QtMcp::ProtocolVersion resultVerEnum = QtMcp::stringToProtocolVersion(resultVersion);
-                if (supportedProtocolVersions().contains(resultVerEnum)) {
-                    versionToUse = resultVerEnum;
-                }
-            }
-
+            // By now an initialize result has set the negotiated version.
+            const auto versionToUse = protocolVersion();
             Result result;
             result.fromJsonObject(json, versionToUse);
             if (!error.isEmpty()) {
@@ -177,6 +188,70 @@ public:
         });
     }
 
+    /*!
+        Sends a request to the server and returns a future for its result.
+
+        The future fails with a QMcpRequestError when the server answers
+        with an error or the request times out (or, built without
+        exceptions, is canceled then). It is canceled when the client is
+        destroyed first. Any number of requests may be in flight at once;
+        each completes as soon as its own answer arrives, whatever the
+        order, so fanning out is a loop and fanning in is
+        QtMcp::whenAll():
+
+        \code
+        QList<QFuture<QMcpCallToolResult>> calls;
+        for (const auto &request : requests)
+            calls.append(client->requestAsync<QMcpCallToolResult>(request));
+        QtMcp::whenAll(calls).then(this, [](const QList<QMcpCallToolResult> &results) {
+            ...
+        });
+        \endcode
+
+        Results are decoded in the client's thread unless \a decodePool is
+        given, in which case they are decoded there and the future finishes
+        in one of its threads; worth it for large results such as long
+        resource contents, when the client's thread has better things to
+        do.
+
+        \sa QMcpTask
+    */
+    template<typename Result, typename Request>
+    QFuture<Result> requestAsync(const Request &request, QThreadPool *decodePool = nullptr)
+    {
+        static_assert(std::is_base_of<QMcpRequest, Request>::value, "Request must inherit from QMcpRequest");
+        static_assert(std::is_base_of<QMcpResult, Result>::value, "Result must inherit from QMcpResult");
+
+        auto promise = std::make_shared<QPromise<Result>>();
+        promise->start();
+        auto future = promise->future();
+        auto json = request.toJsonObject(protocolVersion());
+        send(json, [promise, decodePool, this](const QJsonObject &json, const QJsonObject &error) {
+            const auto versionToUse = protocolVersion();
+            auto decode = [promise, versionToUse, json, error]() {
+                if (!error.isEmpty()) {
+#ifndef QT_NO_EXCEPTIONS
+                    QMcpJSONRPCErrorError e;
+                    e.fromJsonObject(error, versionToUse);
+                    promise->setException(QMcpRequestError(e));
+#else
+                    promise->future().cancel();
+#endif
+                } else {
+                    Result result;
+                    result.fromJsonObject(json, versionToUse);
+                    promise->addResult(std::move(result));
+                }
+                promise->finish();
+            };
+            if (decodePool)
+                decodePool->start(decode);
+            else
+                decode();
+        });
+        return future;
+    }
+
     /*!
         Sends a request to the server without expecting a response.
 
@@ -353,6 +428,40 @@ public slots:
     void setTasksExtensionEnabled(bool enabled);
     bool isTasksExtensionEnabled() const;
 
+    /*!
+        Asks for the result of every tools/call that carries a progress
+        token in pieces (\c{"io.qtmcp/partialResults"} in its \c _meta). A
+        QtMcp server that can deliver them while the call is pending then
+        sends the content as the tool produces it, reported through
+        partialToolResult(); the final result only has what was not sent
+        before.
+    */
+    void setPartialToolResultsEnabled(bool enabled);
+    bool isPartialToolResultsEnabled() const;
+
+    /*!
+        Sets how long a request may stay unanswered, in milliseconds. Past
+        that the request is given up and its callback receives a timeout
+        error. 0 waits forever. Applies to requests sent afterwards; the
+        default is five minutes.
+    */
+    void setRequestTimeout(int msecs);
+    int requestTimeout() const;
+
+    /*!
+        Keeps track of the task \a taskId until it reaches a terminal status,
+        reporting every change through taskStatusChanged().
+
+        The client polls tasks/get, first after \a pollIntervalMs and then at
+        the interval the server suggests, until the server pushes a status
+        for the task (notifications/tasks, or notifications/tasks/status
+        before 2026-07-28); from then on the pushes alone drive the updates.
+        On MCP 2026-07-28 the server only pushes to a client with an open
+        subscriptions/listen stream.
+    */
+    void followTask(const QString &taskId, int pollIntervalMs = 0);
+    void unfollowTask(const QString &taskId);
+
 signals:
     /*!
         Emitted when the protocol version changes.
@@ -376,6 +485,26 @@ signals:
     */
     void inputRequired(const QJsonValue &requestId, const QJsonObject &interimResult);
 
+    /*!
+        Emitted when the server pushes a task status, or when polling a task
+        passed to followTask() finds a new status.
+
+        \param taskId The task whose status changed
+        \param status The new status
+        \param task The raw task as pushed or polled, including the result
+        once \a status is \c completed
+    */
+    void taskStatusChanged(const QString &taskId, QMcpTaskStatus::QMcpTaskStatus status, const QJsonObject &task);
+
+    /*!
+        Emitted when the server sends part of the result of a pending
+        tools/call, see setPartialToolResultsEnabled().
+
+        \param progressToken The progress token of the tools/call
+        \param content The content blocks, in the order the tool produced them
+    */
+    void partialToolResult(const QJsonValue &progressToken, const QList<QMcpCallToolResultContent> &content);
+
     /*!
         Emitted when the client has successfully started.
     */
@@ -2,18 +2,22 @@
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qmcpclientbackendinterface.h"
+#include <QtMcpCommon/private/qmcppendingrequests_p.h>
 
 QT_BEGIN_NAMESPACE
 
 QMcpClientBackendInterface::QMcpClientBackendInterface(QObject *parent)
     : QObject{parent}
+    , pending(std::make_unique<QMcpPendingRequests>())
 {
     connect(this, &QMcpClientBackendInterface::received, this, [this](const QJsonObject &object) {
         if (object.contains("id"_L1)) {
-            const auto id = object.value("id"_L1);
             const auto result = object.value("result"_L1).toObject();
-            if (callbacks.contains(id)) {
-                callbacks.take(id)(result);
+            // Only a response completes a request; a server request may
+            // carry the same id.
+            if (!object.contains("method"_L1)) {
+                if (const auto callback = pending->take(QUuid(), object.value("id"_L1)))
+                    callback(result, object.value("error"_L1).toObject());
             }
             emit this->result(result);
         } else {
@@ -22,16 +26,20 @@ QMcpClientBackendInterface::QMcpClientBackendInterface(QObject *parent)
     });
 }
 
+QMcpClientBackendInterface::~QMcpClientBackendInterface() = default;
+
 void QMcpClientBackendInterface::request(const QJsonObject &request, std::function<void(const QJsonObject &)> callback)
 {
-    static int id = 0;
     if (request.contains("id"_L1)) {
         auto request2 = request;
+        const auto id = pending->nextId();
         request2.insert("id"_L1, id);
 
-        if (callback)
-            callbacks.insert(id, callback);
-        id++;
+        if (callback) {
+            pending->insert(id, QUuid(), [callback](const QJsonObject &result, const QJsonObject &) {
+                callback(result);
+            });
+        }
         send(request2);
     } else {
         send(request);
@@ -9,8 +9,13 @@
 #include <QtMcpClient/qmcpclientglobal.h>
 #include <QtMcpCommon/qtmcpnamespace.h>
 
+#include <functional>
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
+class QMcpPendingRequests;
+
 /*!
     \class QMcpClientBackendInterface
     \inmodule QtMcpClient
@@ -36,9 +41,13 @@ public:
         \param parent The parent object
     */
     explicit QMcpClientBackendInterface(QObject *parent = nullptr);
+    ~QMcpClientBackendInterface() override;
 
     /*!
         Sends a request to the server and optionally handles the response with a callback.
+
+        A request the server does not answer within five minutes is
+        completed with an empty result, so callbacks never pile up.
         
         \param request The request as a JSON object
         \param callback Optional callback to handle the response
@@ -110,7 +119,7 @@ signals:
     void result(const QJsonObject &result);
 
 private:
-    QHash<QJsonValue, std::function<void(const QJsonObject &)>> callbacks;
+    std::unique_ptr<QMcpPendingRequests> pending;
 };
 
 QT_END_NAMESPACE
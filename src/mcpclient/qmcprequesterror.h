@@ -0,0 +1,58 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPREQUESTERROR_H
+#define QMCPREQUESTERROR_H
+
+#include <QtMcpClient/qmcpclientglobal.h>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+
+#ifndef QT_NO_EXCEPTIONS
+#include <QtCore/QException>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpRequestError
+    \inmodule QtMcpClient
+    \brief The QMcpRequestError class is the exception a QFuture returned by QMcpClient::requestAsync() fails with.
+
+    It carries the error the server answered with, or the timeout error of
+    a request left unanswered. Catch it in QFuture::onFailed(), or around
+    \c co_await in a QMcpTask.
+
+    \code
+    client->requestAsync<QMcpCallToolResult>(request)
+        .then([](const QMcpCallToolResult &result) { ... })
+        .onFailed([](const QMcpRequestError &e) {
+            qWarning() << e.error().code() << e.error().message();
+        });
+    \endcode
+
+    Only available where exceptions are; elsewhere such a future is
+    canceled instead.
+*/
+class QMcpRequestError : public QException
+{
+public:
+    explicit QMcpRequestError(const QMcpJSONRPCErrorError &error)
+        : m_error(error)
+        , m_what(error.message().toUtf8())
+    {}
+
+    QMcpJSONRPCErrorError error() const { return m_error; }
+
+    const char *what() const noexcept override { return m_what.constData(); }
+    void raise() const override { throw *this; }
+    QMcpRequestError *clone() const override { return new QMcpRequestError(*this); }
+
+private:
+    QMcpJSONRPCErrorError m_error;
+    QByteArray m_what;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_EXCEPTIONS
+
+#endif // QMCPREQUESTERROR_H
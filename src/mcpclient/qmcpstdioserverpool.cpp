@@ -0,0 +1,438 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpstdioserverpool.h"
+#include "qmcpstdioserverpool_p.h"
+#include "qmcpclient.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonParseError>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
+#include <QtMcpCommon/QMcpInitializeRequest>
+
+#include <algorithm>
+#include <list>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpStdioServerPool, "qt.mcpclient.stdioserverpool")
+
+namespace {
+
+// The id of the initialize a worker sends while warming; clients number
+// their requests, so it cannot be taken for the answer to one of theirs.
+constexpr auto WarmUpId = "qtmcp-pool-warm-up";
+// How long a retired server gets to exit at EOF before it is killed.
+constexpr int RetireTimeout = 1000;
+// How long the pool waits before replacing a process that failed before
+// it was warm, so that a broken command does not spin.
+constexpr int RestartDelay = 1000;
+
+} // namespace
+
+QMcpStdioPoolWorker::QMcpStdioPoolWorker(const QStringList &command, QtMcp::ProtocolVersion protocolVersion, QObject *parent)
+    : QObject(parent)
+    , m_protocolVersion(protocolVersion)
+{
+    connect(&m_process, &QProcess::started, this, [this]() {
+        warmUp();
+    });
+    connect(&m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        qCWarning(lcQMcpStdioServerPool) << error << m_process.errorString();
+        emit errorOccurred(m_process.errorString());
+    });
+    connect(&m_process, &QProcess::finished, this, [this]() {
+        emit finished();
+    });
+    connect(&m_process, &QProcess::readyReadStandardOutput, this, [this]() {
+        readMessages();
+    });
+    connect(&m_process, &QProcess::readyReadStandardError, this, [this]() {
+        qCWarning(lcQMcpStdioServerPool).noquote() << m_process.readAllStandardError();
+    });
+    if (!command.isEmpty())
+        m_process.start(command.first(), command.mid(1));
+}
+
+void QMcpStdioPoolWorker::warmUp()
+{
+    // There is no handshake to do ahead on a stateless protocol version.
+    if (m_protocolVersion >= QtMcp::ProtocolVersion::v2026_07_28) {
+        m_warm = true;
+        emit warmed();
+        return;
+    }
+    QMcpInitializeRequest request;
+    auto params = request.params();
+    params.setProtocolVersion(m_protocolVersion);
+    auto clientInfo = params.clientInfo();
+    clientInfo.setName(QCoreApplication::applicationName());
+    clientInfo.setVersion(QCoreApplication::applicationVersion());
+    params.setClientInfo(clientInfo);
+    request.setParams(params);
+    auto json = request.toJsonObject(m_protocolVersion);
+    json.insert("id"_L1, QLatin1StringView(WarmUpId));
+    send(json);
+}
+
+void QMcpStdioPoolWorker::readMessages()
+{
+    m_input.append(m_process.readAllStandardOutput());
+    while (const auto line = m_input.nextLine()) {
+        QJsonParseError error;
+        const auto json = QJsonDocument::fromJson(QByteArray::fromRawData(line->data(), line->size()), &error);
+        if (error.error != QJsonParseError::NoError) {
+            qCWarning(lcQMcpStdioServerPool) << error.errorString();
+            continue;
+        }
+        const auto object = json.object();
+        if (!m_warm && object.value("id"_L1) == QLatin1StringView(WarmUpId)) {
+            if (object.contains("error"_L1)) {
+                const auto message = object.value("error"_L1).toObject().value("message"_L1).toString();
+                qCWarning(lcQMcpStdioServerPool) << "initialize failed:" << message;
+                emit errorOccurred(message);
+                // Whoever holds the worker ends it: the pool, or the client
+                // it was leased to, which gives it back to be retired.
+                emit warmUpFailed();
+                continue;
+            }
+            m_initializeResult = object.value("result"_L1).toObject();
+            QJsonObject initialized;
+            initialized.insert("jsonrpc"_L1, "2.0"_L1);
+            initialized.insert("method"_L1, "notifications/initialized"_L1);
+            send(initialized);
+            m_warm = true;
+            emit warmed();
+            continue;
+        }
+        emit received(object);
+    }
+}
+
+void QMcpStdioPoolWorker::send(const QJsonObject &object)
+{
+    m_process.write(QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void QMcpStdioPoolWorker::retire()
+{
+    m_warm = false;
+    if (m_process.state() == QProcess::NotRunning) {
+        deleteLater();
+        return;
+    }
+    connect(&m_process, &QProcess::finished, this, &QObject::deleteLater);
+    m_process.closeWriteChannel();
+    QTimer::singleShot(RetireTimeout, this, [this]() {
+        m_process.kill();
+    });
+}
+
+class QMcpStdioServerPool::Private
+{
+public:
+    Private(const QString &command, QMcpStdioServerPool *parent);
+
+    void topUp();
+    QMcpStdioPoolWorker *spawn();
+    void adopt(QMcpStdioPoolWorker *worker);
+    void remove(QMcpStdioPoolWorker *worker);
+    void release(QMcpStdioPoolWorker *worker);
+    void updateIdleCount();
+
+    QMcpStdioServerPool *q;
+    const QString command;
+    const QStringList arguments;
+    int size = 4;
+    int maxUses = 1;
+    QtMcp::ProtocolVersion protocolVersion = QtMcp::ProtocolVersion::Latest;
+    bool running = false;
+    int idleCount = 0;
+    // Processes not leased, warm ones first.
+    std::list<QMcpStdioPoolWorker *> workers;
+};
+
+QMcpStdioServerPool::Private::Private(const QString &command, QMcpStdioServerPool *parent)
+    : q(parent)
+    , command(command)
+    , arguments(QProcess::splitCommand(command))
+{}
+
+void QMcpStdioServerPool::Private::topUp()
+{
+    if (!running)
+        return;
+    while (workers.size() < size_t(size))
+        adopt(spawn());
+}
+
+QMcpStdioPoolWorker *QMcpStdioServerPool::Private::spawn()
+{
+    auto *worker = new QMcpStdioPoolWorker(arguments, protocolVersion, q);
+    qCDebug(lcQMcpStdioServerPool) << "Starting" << command;
+    return worker;
+}
+
+void QMcpStdioServerPool::Private::adopt(QMcpStdioPoolWorker *worker)
+{
+    worker->setParent(q);
+    if (worker->isWarm())
+        workers.push_front(worker);
+    else
+        workers.push_back(worker);
+    connect(worker, &QMcpStdioPoolWorker::warmed, q, [this, worker]() {
+        // Moved ahead of those still warming.
+        workers.remove(worker);
+        workers.push_front(worker);
+        updateIdleCount();
+    });
+    connect(worker, &QMcpStdioPoolWorker::warmUpFailed, q, [this, worker]() {
+        remove(worker);
+        worker->retire();
+        QTimer::singleShot(RestartDelay, q, [this]() { topUp(); });
+    });
+    connect(worker, &QMcpStdioPoolWorker::received, q, [](const QJsonObject &object) {
+        qCDebug(lcQMcpStdioServerPool) << "Dropped while idle:" << object;
+    });
+    connect(worker, &QMcpStdioPoolWorker::errorOccurred, q, &QMcpStdioServerPool::errorOccurred);
+    connect(worker, &QMcpStdioPoolWorker::finished, q, [this, worker]() {
+        const bool wasWarm = worker->isWarm();
+        remove(worker);
+        worker->deleteLater();
+        if (wasWarm)
+            topUp();
+        else
+            QTimer::singleShot(RestartDelay, q, [this]() { topUp(); });
+    });
+    updateIdleCount();
+}
+
+void QMcpStdioServerPool::Private::remove(QMcpStdioPoolWorker *worker)
+{
+    QObject::disconnect(worker, nullptr, q, nullptr);
+    workers.remove(worker);
+    updateIdleCount();
+}
+
+void QMcpStdioServerPool::Private::release(QMcpStdioPoolWorker *worker)
+{
+    // Answers still on their way would reach the next client, which may
+    // have sent a request with the same id.
+    bool reusable = worker->isWarm() && worker->isRunning() && worker->inFlight.isEmpty()
+            && (maxUses == 0 || worker->uses < maxUses) && size > 0 && running;
+    if (reusable && workers.size() >= size_t(size)) {
+        // A warm process is worth more than the newest one still warming,
+        // which lease() started in its place; with all warm, it goes.
+        auto *newest = workers.back();
+        reusable = !newest->isWarm();
+        if (reusable) {
+            remove(newest);
+            newest->retire();
+        }
+    }
+    if (!reusable) {
+        qCDebug(lcQMcpStdioServerPool) << "Retiring a process after" << worker->uses << "uses";
+        worker->setParent(q);
+        worker->retire();
+        topUp();
+        return;
+    }
+    adopt(worker);
+}
+
+void QMcpStdioServerPool::Private::updateIdleCount()
+{
+    const int count = std::count_if(workers.cbegin(), workers.cend(), [](const auto *worker) {
+        return worker->isWarm();
+    });
+    if (count == idleCount)
+        return;
+    idleCount = count;
+    emit q->idleCountChanged(count);
+}
+
+QMcpStdioServerPool::QMcpStdioServerPool(const QString &command, QObject *parent)
+    : QObject(parent)
+    , d(new Private(command, this))
+{}
+
+QMcpStdioServerPool::~QMcpStdioServerPool()
+{
+    for (auto *worker : std::exchange(d->workers, {})) {
+        QObject::disconnect(worker, nullptr, this, nullptr);
+        worker->retire();
+    }
+}
+
+QString QMcpStdioServerPool::command() const
+{
+    return d->command;
+}
+
+int QMcpStdioServerPool::size() const
+{
+    return d->size;
+}
+
+void QMcpStdioServerPool::setSize(int size)
+{
+    size = std::max(size, 0);
+    if (d->size == size)
+        return;
+    d->size = size;
+    // Surplus processes go, those still warming first.
+    while (d->workers.size() > size_t(size)) {
+        auto *worker = d->workers.back();
+        d->remove(worker);
+        worker->retire();
+    }
+    d->topUp();
+    emit sizeChanged(size);
+}
+
+int QMcpStdioServerPool::maxUses() const
+{
+    return d->maxUses;
+}
+
+void QMcpStdioServerPool::setMaxUses(int maxUses)
+{
+    maxUses = std::max(maxUses, 0);
+    if (d->maxUses == maxUses)
+        return;
+    d->maxUses = maxUses;
+    emit maxUsesChanged(maxUses);
+}
+
+QtMcp::ProtocolVersion QMcpStdioServerPool::protocolVersion() const
+{
+    return d->protocolVersion;
+}
+
+void QMcpStdioServerPool::setProtocolVersion(QtMcp::ProtocolVersion protocolVersion)
+{
+    if (d->protocolVersion == protocolVersion)
+        return;
+    d->protocolVersion = protocolVersion;
+    emit protocolVersionChanged(protocolVersion);
+}
+
+int QMcpStdioServerPool::idleCount() const
+{
+    return d->idleCount;
+}
+
+void QMcpStdioServerPool::start()
+{
+    d->running = true;
+    d->topUp();
+}
+
+QMcpClient *QMcpStdioServerPool::lease(QObject *parent)
+{
+    QMcpStdioPoolWorker *worker = nullptr;
+    if (!d->workers.empty()) {
+        worker = d->workers.front();
+        d->remove(worker);
+    } else {
+        worker = d->spawn();
+    }
+    ++worker->uses;
+    auto *client = new QMcpClient(new QMcpStdioPoolBackend(worker, this), parent);
+    client->setProtocolVersion(d->protocolVersion);
+    d->topUp();
+    return client;
+}
+
+QMcpStdioPoolBackend::QMcpStdioPoolBackend(QMcpStdioPoolWorker *worker, QMcpStdioServerPool *pool)
+    : m_worker(worker)
+    , m_pool(pool)
+{
+    worker->setParent(this);
+    worker->inFlight.clear();
+    connect(worker, &QMcpStdioPoolWorker::warmed, this, [this]() {
+        // What the client sent while the process was warming goes out
+        // now, its initialize answered from the worker's cache.
+        for (const auto &object : std::exchange(m_queued, {}))
+            send(object);
+        if (m_startRequested)
+            emit started();
+    });
+    connect(worker, &QMcpStdioPoolWorker::warmUpFailed, this, [this]() {
+        m_queued.clear();
+    });
+    connect(worker, &QMcpStdioPoolWorker::received, this, [this](const QJsonObject &object) {
+        handleReceived(object);
+    });
+    connect(worker, &QMcpStdioPoolWorker::errorOccurred, this, &QMcpClientBackendInterface::errorOccurred);
+    connect(worker, &QMcpStdioPoolWorker::finished, this, &QMcpClientBackendInterface::finished);
+}
+
+QMcpStdioPoolBackend::~QMcpStdioPoolBackend()
+{
+    // Before QObject's destructor would take the worker along.
+    QObject::disconnect(m_worker, nullptr, this, nullptr);
+    if (m_pool) {
+        m_pool->d->release(m_worker);
+    } else {
+        m_worker->setParent(nullptr);
+        m_worker->retire();
+    }
+}
+
+void QMcpStdioPoolBackend::start(const QString &server)
+{
+    Q_UNUSED(server);
+    m_startRequested = true;
+    if (m_worker->isWarm()) {
+        QMetaObject::invokeMethod(this, [this]() {
+            emit started();
+        }, Qt::QueuedConnection);
+    }
+}
+
+void QMcpStdioPoolBackend::send(const QJsonObject &object)
+{
+    // A second initialize must not reach a process that is still going
+    // through the handshake the pool started.
+    if (!m_worker->isWarm()) {
+        m_queued.append(object);
+        return;
+    }
+    const auto method = object.value("method"_L1).toString();
+    const auto initializeResult = m_worker->initializeResult();
+    if (!initializeResult.isEmpty()) {
+        // The process went through the handshake while warming already.
+        if (method == "initialize"_L1) {
+            QJsonObject response;
+            response.insert("jsonrpc"_L1, "2.0"_L1);
+            response.insert("id"_L1, object.value("id"_L1));
+            response.insert("result"_L1, initializeResult);
+            QMetaObject::invokeMethod(this, [this, response]() {
+                emit received(response);
+            }, Qt::QueuedConnection);
+            return;
+        }
+        if (method == "notifications/initialized"_L1)
+            return;
+    }
+    if (!method.isEmpty() && object.contains("id"_L1))
+        m_worker->inFlight.append(object.value("id"_L1));
+    m_worker->send(object);
+}
+
+void QMcpStdioPoolBackend::notify(const QJsonObject &object)
+{
+    send(object);
+}
+
+void QMcpStdioPoolBackend::handleReceived(const QJsonObject &object)
+{
+    if (!object.contains("method"_L1) && object.contains("id"_L1))
+        m_worker->inFlight.removeOne(object.value("id"_L1));
+    emit received(object);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,132 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSTDIOSERVERPOOL_H
+#define QMCPSTDIOSERVERPOOL_H
+
+#include <QtMcpClient/qmcpclientglobal.h>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtMcpCommon/qtmcpnamespace.h>
+
+QT_BEGIN_NAMESPACE
+
+class QMcpClient;
+
+/*!
+    \class QMcpStdioServerPool
+    \inmodule QtMcpClient
+    \brief The QMcpStdioServerPool class keeps stdio MCP server processes started and initialized ahead of use.
+
+    Starting a stdio server and going through \c initialize costs every new
+    QMcpClient a process start and a round trip. The pool keeps size()
+    processes of one command warm: started, and on protocol versions with a
+    handshake also initialized. lease() hands one to a new QMcpClient, whose
+    \c initialize is then answered with the result the server gave the pool.
+
+    A client's process returns to the pool when the client is destroyed,
+    provided it is still running, has answered every request and has
+    served fewer than maxUses() clients; otherwise it is ended and replaced.
+
+    \code
+    auto pool = new QMcpStdioServerPool("my-mcp-server --stdio"_L1, this);
+    pool->setSize(8);
+    pool->start();
+    ...
+    auto client = pool->lease(this);
+    connect(client, &QMcpClient::started, ...);
+    client->start(QString());
+    \endcode
+
+    \sa QMcpClient
+*/
+class Q_MCPCLIENT_EXPORT QMcpStdioServerPool : public QObject
+{
+    Q_OBJECT
+
+    /*!
+        \property QMcpStdioServerPool::size
+        This property holds how many processes the pool keeps warm. The
+        default is 4.
+    */
+    Q_PROPERTY(int size READ size WRITE setSize NOTIFY sizeChanged FINAL)
+
+    /*!
+        \property QMcpStdioServerPool::maxUses
+        This property holds how many clients one process serves before it
+        is replaced. The default, 1, gives every client a process nobody
+        used before; 0 reuses processes for as long as they run.
+    */
+    Q_PROPERTY(int maxUses READ maxUses WRITE setMaxUses NOTIFY maxUsesChanged FINAL)
+
+    /*!
+        \property QMcpStdioServerPool::protocolVersion
+        This property holds the protocol version processes are initialized
+        with, and that leased clients use. Changing it only affects
+        processes started afterwards.
+    */
+    Q_PROPERTY(QtMcp::ProtocolVersion protocolVersion READ protocolVersion WRITE setProtocolVersion NOTIFY protocolVersionChanged FINAL)
+
+    /*!
+        \property QMcpStdioServerPool::idleCount
+        This property holds how many warm processes wait to be leased.
+    */
+    Q_PROPERTY(int idleCount READ idleCount NOTIFY idleCountChanged FINAL)
+
+public:
+    /*!
+        Constructs a pool of servers started with \a command, a program
+        followed by its arguments as QProcess::splitCommand() reads them.
+    */
+    explicit QMcpStdioServerPool(const QString &command, QObject *parent = nullptr);
+    ~QMcpStdioServerPool() override;
+
+    QString command() const;
+
+    int size() const;
+    int maxUses() const;
+    QtMcp::ProtocolVersion protocolVersion() const;
+    int idleCount() const;
+
+    /*!
+        Returns a new client, owned by \a parent, talking to a warm process.
+        With none warm yet it gets the one closest to it, or a new one; its
+        started() is then emitted once that process is ready, and what it
+        sends before waits until then. Should that process fail its
+        handshake, the client gets errorOccurred() and the process is
+        retired once the client is destroyed. The client still has to be
+        started, with any argument, to be told so.
+    */
+    QMcpClient *lease(QObject *parent = nullptr);
+
+public slots:
+    /*!
+        Starts warming processes, and keeps doing so as they are leased.
+    */
+    void start();
+
+    void setSize(int size);
+    void setMaxUses(int maxUses);
+    void setProtocolVersion(QtMcp::ProtocolVersion protocolVersion);
+
+signals:
+    void sizeChanged(int size);
+    void maxUsesChanged(int maxUses);
+    void protocolVersionChanged(QtMcp::ProtocolVersion protocolVersion);
+    void idleCountChanged(int idleCount);
+
+    /*!
+        Emitted when a process could not be started or failed while warming.
+        \param errorString Description of the error
+    */
+    void errorOccurred(const QString &errorString);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+    friend class QMcpStdioPoolBackend;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSTDIOSERVERPOOL_H
@@ -0,0 +1,113 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSTDIOSERVERPOOL_P_H
+#define QMCPSTDIOSERVERPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpClient/qmcpclientbackendinterface.h>
+#include <QtMcpClient/qmcpstdioserverpool.h>
+#include <QtMcpCommon/private/qmcplinebuffer_p.h>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QList>
+#include <QtCore/QPointer>
+#include <QtCore/QProcess>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpStdioPoolWorker
+    \internal
+    \inmodule QtMcpClient
+    \brief One server process of a QMcpStdioServerPool.
+
+    Reads the process's output into a buffer of its own and emits every
+    message, except the answer to the initialize it sent while warming,
+    which it keeps for the clients the process is leased to. It does not
+    end a process whose warm-up failed by itself, since a client may hold
+    it already.
+*/
+class QMcpStdioPoolWorker : public QObject
+{
+    Q_OBJECT
+public:
+    QMcpStdioPoolWorker(const QStringList &command, QtMcp::ProtocolVersion protocolVersion, QObject *parent);
+
+    bool isWarm() const { return m_warm; }
+    bool isRunning() const { return m_process.state() == QProcess::Running; }
+    QJsonObject initializeResult() const { return m_initializeResult; }
+
+    void send(const QJsonObject &object);
+    // Ends the process, politely first: a stdio server stops at EOF.
+    void retire();
+
+    int uses = 0;
+    // Ids of the requests the current client still awaits answers to.
+    QList<QJsonValue> inFlight;
+
+signals:
+    void warmed();
+    // The server answered the initialize sent while warming with an error.
+    void warmUpFailed();
+    void received(const QJsonObject &object);
+    void finished();
+    void errorOccurred(const QString &errorString);
+
+private:
+    void readMessages();
+    void warmUp();
+
+    QProcess m_process;
+    QMcpLineBuffer m_input;
+    QtMcp::ProtocolVersion m_protocolVersion;
+    bool m_warm = false;
+    QJsonObject m_initializeResult;
+};
+
+/*!
+    \class QMcpStdioPoolBackend
+    \internal
+    \inmodule QtMcpClient
+    \brief The backend of a client leased from a QMcpStdioServerPool.
+
+    Talks to the worker it was given and answers the client's initialize
+    from the worker's cache. What the client sends before the worker is
+    warm waits for it. Destroyed with its client, it gives the worker back
+    to the pool.
+*/
+class QMcpStdioPoolBackend : public QMcpClientBackendInterface
+{
+    Q_OBJECT
+public:
+    QMcpStdioPoolBackend(QMcpStdioPoolWorker *worker, QMcpStdioServerPool *pool);
+    ~QMcpStdioPoolBackend() override;
+
+public slots:
+    void start(const QString &server) override;
+    void send(const QJsonObject &object) override;
+    void notify(const QJsonObject &object) override;
+
+private:
+    void handleReceived(const QJsonObject &object);
+
+    QMcpStdioPoolWorker *m_worker;
+    QPointer<QMcpStdioServerPool> m_pool;
+    bool m_startRequested = false;
+    // Messages sent before the worker was warm.
+    QList<QJsonObject> m_queued;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSTDIOSERVERPOOL_P_H
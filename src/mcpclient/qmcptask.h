@@ -0,0 +1,207 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPTASK_H
+#define QMCPTASK_H
+
+#include <QtMcpClient/qmcpclientglobal.h>
+#include <QtMcpClient/qmcprequesterror.h>
+#include <QtCore/QFuture>
+#include <QtCore/QList>
+#include <QtCore/QPromise>
+
+#include <memory>
+
+#if !defined(QT_NO_EXCEPTIONS) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define QT_MCP_HAS_COROUTINES
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QtMcp {
+
+/*!
+    Returns a future for the results of all \a futures, in their order,
+    once all of them finished. It fails with the first failure among them,
+    and is canceled if one of them was.
+
+    \sa QMcpClient::requestAsync()
+*/
+template<typename T>
+QFuture<QList<T>> whenAll(const QList<QFuture<T>> &futures)
+{
+    auto promise = std::make_shared<QPromise<QList<T>>>();
+    promise->start();
+    auto all = promise->future();
+    QtFuture::whenAll(futures.cbegin(), futures.cend()).then([promise](const QList<QFuture<T>> &finished) {
+        QList<T> results;
+        results.reserve(finished.size());
+        for (const auto &future : finished) {
+#ifndef QT_NO_EXCEPTIONS
+            try {
+                // Rethrows what the future failed with.
+                future.waitForFinished();
+            } catch (...) {
+                promise->setException(std::current_exception());
+                promise->finish();
+                return;
+            }
+#endif
+            if (future.resultCount() == 0) {
+                promise->future().cancel();
+                promise->finish();
+                return;
+            }
+            results.append(future.result());
+        }
+        promise->addResult(std::move(results));
+        promise->finish();
+    });
+    return all;
+}
+
+} // namespace QtMcp
+
+#ifdef QT_MCP_HAS_COROUTINES
+
+template<typename T>
+class QMcpTask;
+
+namespace QtMcpPrivate {
+
+// Suspends a QMcpTask until a future finished, then resumes it in the
+// thread that finished the future: the client's thread for the futures of
+// QMcpClient::requestAsync(), unless it was given a decode pool.
+template<typename T>
+struct FutureAwaiter
+{
+    QFuture<T> future;
+
+    bool await_ready() const { return future.isFinished(); }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        future.then(QtFuture::Launch::Sync, [handle](QFuture<T>) {
+            handle.resume();
+        }).onCanceled([handle]() {
+            handle.resume();
+        });
+    }
+    T await_resume()
+    {
+        // Rethrows what the future failed with.
+        future.waitForFinished();
+        if (future.isCanceled()) {
+            QMcpJSONRPCErrorError error;
+            error.setMessage(u"Request canceled"_s);
+            throw QMcpRequestError(error);
+        }
+        if constexpr (!std::is_void_v<T>)
+            return future.result();
+    }
+};
+
+template<typename T>
+struct TaskPromiseBase
+{
+    QPromise<T> promise;
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void unhandled_exception()
+    {
+        promise.setException(std::current_exception());
+        promise.finish();
+    }
+
+    template<typename U>
+    FutureAwaiter<U> await_transform(QFuture<U> future) { return { std::move(future) }; }
+    template<typename U>
+    FutureAwaiter<U> await_transform(QMcpTask<U> task) { return { task.future() }; }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase<T>
+{
+    QMcpTask<T> get_return_object();
+    void return_value(T value)
+    {
+        this->promise.addResult(std::move(value));
+        this->promise.finish();
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase<void>
+{
+    QMcpTask<void> get_return_object();
+    void return_void() { promise.finish(); }
+};
+
+} // namespace QtMcpPrivate
+
+/*!
+    \class QMcpTask
+    \inmodule QtMcpClient
+    \brief The QMcpTask class is the return type of coroutines that await MCP requests.
+
+    A function returning QMcpTask<T> may \c co_await the QFuture of
+    QMcpClient::requestAsync(), any other QFuture, and other QMcpTasks; a
+    failed request throws its QMcpRequestError there. The coroutine starts
+    right away and runs until it first waits; future() then tells when it
+    returned, so that tasks combine like requests:
+
+    \code
+    QMcpTask<QString> describe(QMcpClient *client)
+    {
+        const auto tools = co_await client->requestAsync<QMcpListToolsResult>(QMcpListToolsRequest());
+        QList<QFuture<QMcpCallToolResult>> calls;
+        for (const auto &tool : tools.tools())
+            calls.append(client->requestAsync<QMcpCallToolResult>(callFor(tool)));
+        const auto results = co_await QtMcp::whenAll(calls);
+        co_return summarize(results);
+    }
+    \endcode
+
+    Only available with C++20 coroutines and exceptions enabled.
+
+    \sa QMcpClient::requestAsync()
+*/
+template<typename T = void>
+class QMcpTask
+{
+public:
+    using promise_type = QtMcpPrivate::TaskPromise<T>;
+
+    QFuture<T> future() const { return m_future; }
+    operator QFuture<T>() const { return m_future; }
+
+private:
+    friend promise_type;
+    explicit QMcpTask(QFuture<T> future) : m_future(std::move(future)) {}
+
+    QFuture<T> m_future;
+};
+
+namespace QtMcpPrivate {
+
+template<typename T>
+QMcpTask<T> TaskPromise<T>::get_return_object()
+{
+    this->promise.start();
+    return QMcpTask<T>(this->promise.future());
+}
+
+inline QMcpTask<void> TaskPromise<void>::get_return_object()
+{
+    promise.start();
+    return QMcpTask<void>(promise.future());
+}
+
+} // namespace QtMcpPrivate
+
+#endif // QT_MCP_HAS_COROUTINES
+
+QT_END_NAMESPACE
+
+#endif // QMCPTASK_H
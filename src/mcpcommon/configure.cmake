@@ -9,6 +9,8 @@
 
 #### Libraries
 
+qt_find_package(WrapZLIB 1.0.8 PROVIDED_TARGETS WrapZLIB::WrapZLIB MODULE_NAME mcpcommon QMAKE_LIB zlib)
+
 
 
 #### Tests
@@ -0,0 +1,237 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpcompression_p.h"
+
+#include <QtCore/QList>
+
+#include <zlib.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+constexpr int ChunkSize = 16 * 1024;
+
+int windowBits(QMcpCompression::Encoding encoding)
+{
+    // 16 added selects the gzip wrapper instead of the zlib one.
+    return encoding == QMcpCompression::Encoding::Gzip ? MAX_WBITS + 16 : MAX_WBITS;
+}
+
+/*!
+    \internal
+    Runs deflate() over \a data with \a flush, appending everything it
+    produces to \a out.
+*/
+bool deflateInto(z_stream *stream, QByteArrayView data, int flush, QByteArray *out)
+{
+    stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream->avail_in = uInt(data.size());
+    int result = Z_OK;
+    do {
+        const auto offset = out->size();
+        out->resize(offset + ChunkSize);
+        stream->next_out = reinterpret_cast<Bytef *>(out->data() + offset);
+        stream->avail_out = ChunkSize;
+        result = deflate(stream, flush);
+        out->resize(offset + ChunkSize - stream->avail_out);
+        if (result == Z_STREAM_ERROR)
+            return false;
+    } while (stream->avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    return true;
+}
+
+std::optional<QByteArray> inflateWith(QByteArrayView data, int bits, qint64 maxSize, bool *tooLarge)
+{
+    z_stream stream = {};
+    if (inflateInit2(&stream, bits) != Z_OK)
+        return std::nullopt;
+
+    QByteArray out;
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = uInt(data.size());
+    int result = Z_OK;
+    while (result != Z_STREAM_END) {
+        const auto offset = out.size();
+        out.resize(offset + ChunkSize);
+        stream.next_out = reinterpret_cast<Bytef *>(out.data() + offset);
+        stream.avail_out = ChunkSize;
+        result = inflate(&stream, Z_NO_FLUSH);
+        out.resize(offset + ChunkSize - stream.avail_out);
+        if (out.size() > maxSize) {
+            if (tooLarge)
+                *tooLarge = true;
+            inflateEnd(&stream);
+            return std::nullopt;
+        }
+        // Out of input before the end of the stream: truncated.
+        if (result == Z_BUF_ERROR || (result == Z_OK && stream.avail_in == 0 && stream.avail_out != 0))
+            break;
+        if (result != Z_OK && result != Z_STREAM_END)
+            break;
+    }
+    inflateEnd(&stream);
+    if (result != Z_STREAM_END)
+        return std::nullopt;
+    return out;
+}
+
+} // namespace
+
+std::optional<QMcpCompression::Encoding> QMcpCompression::fromName(QByteArrayView name)
+{
+    const auto trimmed = name.trimmed();
+    if (trimmed.isEmpty() || trimmed.compare("identity", Qt::CaseInsensitive) == 0)
+        return Encoding::Identity;
+    if (trimmed.compare("gzip", Qt::CaseInsensitive) == 0
+            || trimmed.compare("x-gzip", Qt::CaseInsensitive) == 0) {
+        return Encoding::Gzip;
+    }
+    if (trimmed.compare("deflate", Qt::CaseInsensitive) == 0)
+        return Encoding::Deflate;
+    return std::nullopt;
+}
+
+QByteArray QMcpCompression::name(Encoding encoding)
+{
+    switch (encoding) {
+    case Encoding::Identity: return "identity"_ba;
+    case Encoding::Gzip: return "gzip"_ba;
+    case Encoding::Deflate: return "deflate"_ba;
+    }
+    return {};
+}
+
+QMcpCompression::Encoding QMcpCompression::negotiate(QByteArrayView acceptEncoding)
+{
+    // q-values in thousandths; -1 for a coding not mentioned.
+    int gzip = -1;
+    int deflate = -1;
+    int any = -1;
+    const auto elements = acceptEncoding.toByteArray().split(',');
+    for (const auto &element : elements) {
+        const auto parts = element.split(';');
+        const auto coding = parts.first().trimmed();
+        int quality = 1000;
+        for (qsizetype i = 1; i < parts.size(); ++i) {
+            const auto parameter = parts.at(i).trimmed();
+            if (parameter.size() > 2 && (parameter.startsWith("q=") || parameter.startsWith("Q="))) {
+                bool ok = false;
+                const double value = parameter.sliced(2).toDouble(&ok);
+                quality = ok ? qBound(0, int(value * 1000), 1000) : 0;
+            }
+        }
+        if (coding.compare("gzip", Qt::CaseInsensitive) == 0 || coding.compare("x-gzip", Qt::CaseInsensitive) == 0)
+            gzip = quality;
+        else if (coding.compare("deflate", Qt::CaseInsensitive) == 0)
+            deflate = quality;
+        else if (coding == "*")
+            any = quality;
+    }
+    if (gzip < 0)
+        gzip = any;
+    if (deflate < 0)
+        deflate = any;
+    if (gzip > 0 && gzip >= deflate)
+        return Encoding::Gzip;
+    if (deflate > 0)
+        return Encoding::Deflate;
+    return Encoding::Identity;
+}
+
+bool QMcpCompression::isCompressible(QByteArrayView contentType)
+{
+    const auto type = contentType.trimmed();
+    return type.startsWith("text/") || type.startsWith("application/json")
+            || type.contains("+json") || type.startsWith("application/javascript")
+            || type.startsWith("application/xml");
+}
+
+QByteArray QMcpCompression::compress(QByteArrayView data, Encoding encoding, int level)
+{
+    if (encoding == Encoding::Identity)
+        return data.toByteArray();
+
+    z_stream stream = {};
+    if (deflateInit2(&stream, level, Z_DEFLATED, windowBits(encoding), 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return {};
+    QByteArray out;
+    out.reserve(qsizetype(deflateBound(&stream, uLong(data.size()))));
+    const bool ok = deflateInto(&stream, data, Z_FINISH, &out);
+    deflateEnd(&stream);
+    return ok ? out : QByteArray();
+}
+
+std::optional<QByteArray> QMcpCompression::decompress(QByteArrayView data, Encoding encoding,
+                                                      qint64 maxSize, bool *tooLarge)
+{
+    if (tooLarge)
+        *tooLarge = false;
+    if (encoding == Encoding::Identity) {
+        if (data.size() > maxSize) {
+            if (tooLarge)
+                *tooLarge = true;
+            return std::nullopt;
+        }
+        return data.toByteArray();
+    }
+
+    // 32 added detects a zlib or gzip header by itself.
+    auto result = inflateWith(data, MAX_WBITS + 32, maxSize, tooLarge);
+    if (!result && encoding == Encoding::Deflate && !(tooLarge && *tooLarge))
+        result = inflateWith(data, -MAX_WBITS, maxSize, tooLarge);
+    return result;
+}
+
+class QMcpStreamCompressor::Private
+{
+public:
+    QMcpCompression::Encoding encoding;
+    z_stream stream = {};
+    bool valid = false;
+};
+
+QMcpStreamCompressor::QMcpStreamCompressor(QMcpCompression::Encoding encoding, int level)
+    : d(new Private)
+{
+    d->encoding = encoding;
+    if (encoding != QMcpCompression::Encoding::Identity) {
+        d->valid = deflateInit2(&d->stream, level, Z_DEFLATED, windowBits(encoding), 8,
+                                Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+}
+
+QMcpStreamCompressor::~QMcpStreamCompressor()
+{
+    if (d->valid)
+        deflateEnd(&d->stream);
+}
+
+QMcpCompression::Encoding QMcpStreamCompressor::encoding() const
+{
+    return d->encoding;
+}
+
+QByteArray QMcpStreamCompressor::compress(QByteArrayView data)
+{
+    if (d->encoding == QMcpCompression::Encoding::Identity)
+        return data.toByteArray();
+    QByteArray out;
+    if (!d->valid || !deflateInto(&d->stream, data, Z_SYNC_FLUSH, &out))
+        return {};
+    return out;
+}
+
+QByteArray QMcpStreamCompressor::finish()
+{
+    if (!d->valid)
+        return {};
+    QByteArray out;
+    deflateInto(&d->stream, {}, Z_FINISH, &out);
+    deflateEnd(&d->stream);
+    d->valid = false;
+    return out;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,111 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPCOMPRESSION_P_H
+#define QMCPCOMPRESSION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpCommon/qmcpcommonglobal.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QScopedPointer>
+
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpCompression
+    \internal
+    \inmodule QtMcpCommon
+    \brief HTTP content codings: \c gzip and \c deflate through zlib.
+
+    \c deflate is the zlib format (RFC 9110); raw deflate data, which some
+    clients send under that name, is accepted when decompressing as well.
+*/
+class Q_MCPCOMMON_EXPORT QMcpCompression
+{
+public:
+    enum class Encoding {
+        Identity,
+        Gzip,
+        Deflate,
+    };
+
+    // Fast rather than small: JSON compresses well at any level, and the
+    // time is spent per response.
+    static constexpr int DefaultLevel = 5;
+
+    /*!
+        Returns the coding named \a name, e.g. by Content-Encoding, or
+        std::nullopt when it is not supported.
+    */
+    static std::optional<Encoding> fromName(QByteArrayView name);
+    static QByteArray name(Encoding encoding);
+
+    /*!
+        Returns the coding to answer a request with, given its
+        Accept-Encoding \a acceptEncoding: the supported coding with the
+        highest q-value, gzip on a tie, Identity when none is acceptable.
+    */
+    static Encoding negotiate(QByteArrayView acceptEncoding);
+
+    /*!
+        Returns whether content of type \a contentType is worth compressing.
+        Text and JSON are; images and archives are compressed already.
+    */
+    static bool isCompressible(QByteArrayView contentType);
+
+    static QByteArray compress(QByteArrayView data, Encoding encoding, int level = DefaultLevel);
+
+    /*!
+        Returns \a data decoded, or std::nullopt when it is corrupt. Output
+        beyond \a maxSize bytes is an error too, which sets \a tooLarge, so
+        a small compressed body cannot expand into unbounded memory.
+    */
+    static std::optional<QByteArray> decompress(QByteArrayView data, Encoding encoding,
+                                                qint64 maxSize, bool *tooLarge = nullptr);
+};
+
+/*!
+    \class QMcpStreamCompressor
+    \internal
+    \inmodule QtMcpCommon
+    \brief Compresses a stream, e.g. of SSE events, one message at a time.
+
+    Each compress() call returns output the peer can decode completely, so
+    a message is never held back waiting for the next; the dictionary is
+    shared across messages all the same, which is where repetitive JSON
+    gains the most.
+*/
+class Q_MCPCOMMON_EXPORT QMcpStreamCompressor
+{
+public:
+    explicit QMcpStreamCompressor(QMcpCompression::Encoding encoding,
+                                  int level = QMcpCompression::DefaultLevel);
+    ~QMcpStreamCompressor();
+
+    QMcpCompression::Encoding encoding() const;
+    QByteArray compress(QByteArrayView data);
+    // Ends the stream; nothing can be compressed after.
+    QByteArray finish();
+
+private:
+    Q_DISABLE_COPY(QMcpStreamCompressor)
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPCOMPRESSION_P_H
@@ -0,0 +1,177 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpinprocesschannel_p.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonParseError>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+
+QT_BEGIN_NAMESPACE
+
+struct QMcpInProcessChannel::Link
+{
+    struct Side {
+        QPointer<QObject> context;
+        Handler received;
+        std::function<void()> closed;
+        // Sent before the receiver was set.
+        QList<QJsonObject> pending;
+        bool ready = false;
+    };
+
+    // Held while posting too, so that messages from several threads keep
+    // the order they were sent in.
+    QMutex mutex;
+    Side sides[2];
+    bool open = true;
+};
+
+namespace {
+
+struct Listener {
+    QPointer<QObject> context;
+    QMcpInProcessChannel::AcceptHandler accept;
+};
+
+struct Registry {
+    QMutex mutex;
+    QHash<QString, Listener> listeners;
+};
+
+Q_GLOBAL_STATIC(Registry, registry)
+
+/*!
+    \internal
+    Returns \a object as it comes out of its JSON text, warning if that is
+    not what went in, e.g. for a number JSON cannot represent.
+*/
+QJsonObject roundTrip(const QJsonObject &object)
+{
+    const auto text = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    QJsonParseError error;
+    const auto result = QJsonDocument::fromJson(text, &error).object();
+    if (error.error != QJsonParseError::NoError)
+        qWarning() << "in-process message is no valid JSON:" << error.errorString() << text;
+    else if (result != object)
+        qWarning() << "in-process message changes when encoded as JSON:" << text;
+    return result;
+}
+
+void post(QObject *context, const QMcpInProcessChannel::Handler &handler, const QJsonObject &object)
+{
+    if (!context || !handler)
+        return;
+    QMetaObject::invokeMethod(context, [handler, object]() { handler(object); }, Qt::QueuedConnection);
+}
+
+void postClosed(QObject *context, const std::function<void()> &closed)
+{
+    if (!context || !closed)
+        return;
+    QMetaObject::invokeMethod(context, [closed]() { closed(); }, Qt::QueuedConnection);
+}
+
+} // namespace
+
+QMcpInProcessChannel::QMcpInProcessChannel(std::shared_ptr<Link> link, int side)
+    : m_link(std::move(link))
+    , m_side(side)
+{}
+
+QMcpInProcessChannel::~QMcpInProcessChannel()
+{
+    close();
+}
+
+bool QMcpInProcessChannel::listen(const QString &name, QObject *context, AcceptHandler accept)
+{
+    QMutexLocker locker(&registry->mutex);
+    const auto it = registry->listeners.constFind(name);
+    if (it != registry->listeners.cend() && it->context)
+        return false;
+    registry->listeners.insert(name, { context, std::move(accept) });
+    return true;
+}
+
+void QMcpInProcessChannel::unlisten(const QString &name)
+{
+    QMutexLocker locker(&registry->mutex);
+    registry->listeners.remove(name);
+}
+
+std::shared_ptr<QMcpInProcessChannel> QMcpInProcessChannel::connect(const QString &name, QObject *context,
+                                                                    Handler received,
+                                                                    std::function<void()> closed)
+{
+    QMutexLocker locker(&registry->mutex);
+    const auto it = registry->listeners.constFind(name);
+    if (it == registry->listeners.cend() || !it->context)
+        return nullptr;
+
+    auto link = std::make_shared<Link>();
+    std::shared_ptr<QMcpInProcessChannel> client(new QMcpInProcessChannel(link, 0));
+    std::shared_ptr<QMcpInProcessChannel> server(new QMcpInProcessChannel(link, 1));
+    client->setReceiver(context, std::move(received), std::move(closed));
+    QMetaObject::invokeMethod(it->context, [accept = it->accept, server]() {
+        accept(server);
+    }, Qt::QueuedConnection);
+    return client;
+}
+
+void QMcpInProcessChannel::setReceiver(QObject *context, Handler received, std::function<void()> closed)
+{
+    QMutexLocker locker(&m_link->mutex);
+    auto &side = m_link->sides[m_side];
+    side.context = context;
+    side.received = std::move(received);
+    side.closed = std::move(closed);
+    side.ready = true;
+    for (const auto &object : std::as_const(side.pending))
+        post(side.context, side.received, object);
+    side.pending.clear();
+    if (!m_link->open)
+        postClosed(side.context, side.closed);
+}
+
+bool QMcpInProcessChannel::isValidating() const
+{
+    return m_validating;
+}
+
+void QMcpInProcessChannel::setValidating(bool validating)
+{
+    m_validating = validating;
+}
+
+void QMcpInProcessChannel::send(const QJsonObject &object)
+{
+    const auto payload = m_validating ? roundTrip(object) : object;
+    QMutexLocker locker(&m_link->mutex);
+    if (!m_link->open)
+        return;
+    auto &to = m_link->sides[1 - m_side];
+    if (!to.ready)
+        to.pending.append(payload);
+    else
+        post(to.context, to.received, payload);
+}
+
+void QMcpInProcessChannel::close()
+{
+    QMutexLocker locker(&m_link->mutex);
+    if (!m_link->open)
+        return;
+    m_link->open = false;
+    const auto &to = m_link->sides[1 - m_side];
+    if (to.ready)
+        postClosed(to.context, to.closed);
+    // What this end's handlers hold on to is released with the channel.
+    m_link->sides[m_side] = {};
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,97 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPINPROCESSCHANNEL_P_H
+#define QMCPINPROCESSCHANNEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpCommon/qmcpcommonglobal.h>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <functional>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpInProcessChannel
+    \internal
+    \inmodule QtMcpCommon
+    \brief Connects an MCP client and server living in the same process.
+
+    A server listen()s on a name; a client connecting to it gets one end of
+    a channel, the server's accept handler the other. What one end sends
+    arrives at the other end's handler, queued to the thread its context
+    object lives in, so either side may run in any thread.
+
+    Messages are handed over as they are: a QJsonObject is implicitly
+    shared, so nothing is encoded to text or parsed again. With validation
+    on, each message is round-tripped through its JSON text instead, which
+    is what a transport across processes would deliver.
+
+    The registry of listening names lives here, in the one library both
+    backend plugins load, so that a client and a server backend from
+    different plugins find each other.
+*/
+class Q_MCPCOMMON_EXPORT QMcpInProcessChannel
+{
+public:
+    using Handler = std::function<void(const QJsonObject &object)>;
+    using AcceptHandler = std::function<void(std::shared_ptr<QMcpInProcessChannel> channel)>;
+
+    ~QMcpInProcessChannel();
+
+    /*!
+        Makes \a name reachable for connect(); \a accept is called with the
+        server's end of every channel, in the thread of \a context. Returns
+        false if another server listens on \a name.
+    */
+    static bool listen(const QString &name, QObject *context, AcceptHandler accept);
+    static void unlisten(const QString &name);
+
+    /*!
+        Connects to the server listening on \a name and returns the
+        client's end of the channel, or nullptr if there is none. Messages
+        arrive at \a received and the end of the channel at \a closed, both
+        in the thread of \a context.
+    */
+    static std::shared_ptr<QMcpInProcessChannel> connect(const QString &name, QObject *context,
+                                                         Handler received, std::function<void()> closed);
+
+    /*!
+        Sets where the messages to this end go. Those sent before are
+        delivered now, in order.
+    */
+    void setReceiver(QObject *context, Handler received, std::function<void()> closed);
+
+    bool isValidating() const;
+    void setValidating(bool validating);
+
+    void send(const QJsonObject &object);
+    // Ends the channel; the other end's closed handler is called.
+    void close();
+
+private:
+    struct Link;
+    QMcpInProcessChannel(std::shared_ptr<Link> link, int side);
+
+    std::shared_ptr<Link> m_link;
+    int m_side = 0;
+    bool m_validating = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPINPROCESSCHANNEL_P_H
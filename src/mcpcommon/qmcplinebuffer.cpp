@@ -0,0 +1,53 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcplinebuffer_p.h"
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+void QMcpLineBuffer::append(QByteArrayView data)
+{
+    // Drop what was handed on once it is at least half of the buffer, which
+    // keeps the moves linear in what is appended.
+    if (m_consumed > 0 && m_consumed * 2 >= m_buffer.size()) {
+        m_buffer.remove(0, m_consumed);
+        m_scanned -= m_consumed;
+        m_consumed = 0;
+    }
+    m_buffer.append(data);
+}
+
+std::optional<QByteArrayView> QMcpLineBuffer::nextLine()
+{
+    while (m_scanned < m_buffer.size()) {
+        // memchr is vectorized by the C library; nothing scans a byte twice.
+        const char *begin = m_buffer.constData();
+        const auto *lf = static_cast<const char *>(std::memchr(begin + m_scanned, '\n', m_buffer.size() - m_scanned));
+        if (!lf) {
+            m_scanned = m_buffer.size();
+            break;
+        }
+        const qsizetype end = lf - begin;
+        const auto line = QByteArrayView(begin + m_consumed, end - m_consumed).trimmed();
+        m_consumed = m_scanned = end + 1;
+        if (!line.isEmpty())
+            return line;
+    }
+
+    if (m_consumed == m_buffer.size()) {
+        // Keeps the capacity for the next message.
+        m_buffer.resize(0);
+        m_consumed = m_scanned = 0;
+    }
+    return std::nullopt;
+}
+
+void QMcpLineBuffer::clear()
+{
+    m_buffer.clear();
+    m_consumed = m_scanned = 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,65 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPLINEBUFFER_P_H
+#define QMCPLINEBUFFER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpCommon/qmcpcommonglobal.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpLineBuffer
+    \internal
+    \inmodule QtMcpCommon
+    \brief Splits a byte stream into newline delimited messages.
+
+    Bytes are appended in place and searched for a newline from where the
+    last search stopped, so a message arriving in many reads is scanned
+    once and moved rarely, however large it is.
+*/
+class Q_MCPCOMMON_EXPORT QMcpLineBuffer
+{
+public:
+    void append(QByteArrayView data);
+
+    /*!
+        Returns the next complete line, without its newline and trimmed;
+        blank lines are skipped. Returns std::nullopt when no complete line
+        is left. The view is valid until the buffer is next changed or
+        nextLine() is called again.
+    */
+    std::optional<QByteArrayView> nextLine();
+
+    /*!
+        Returns the number of bytes not handed on yet.
+    */
+    qsizetype size() const { return m_buffer.size() - m_consumed; }
+    void clear();
+
+private:
+    // Bytes before m_consumed are handed on already, those before
+    // m_scanned are known to hold no newline.
+    QByteArray m_buffer;
+    qsizetype m_consumed = 0;
+    qsizetype m_scanned = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPLINEBUFFER_P_H
@@ -0,0 +1,28 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcplocalserver_p.h"
+
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+QT_BEGIN_NAMESPACE
+
+bool QMcpLocalServer::listen(QLocalServer *server, const QString &name)
+{
+    if (server->listen(name))
+        return true;
+    if (server->serverError() != QAbstractSocket::AddressInUseError)
+        return false;
+
+    // A socket file nobody answers on is left over; one that is answered
+    // belongs to a running server, which must not be taken over.
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(StaleSocketProbeTimeout))
+        return false;
+    QLocalServer::removeServer(name);
+    return server->listen(name);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,50 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPLOCALSERVER_P_H
+#define QMCPLOCALSERVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpCommon/qmcpcommonglobal.h>
+#include <QtCore/QString>
+
+QT_BEGIN_NAMESPACE
+
+class QLocalServer;
+
+/*!
+    \class QMcpLocalServer
+    \internal
+    \inmodule QtMcpCommon
+    \brief Listening on a local socket name the way the server backends do.
+
+    Shared by the backends that accept their clients on a QLocalServer.
+*/
+class Q_MCPCOMMON_EXPORT QMcpLocalServer
+{
+public:
+    // How long listen() waits to tell a live server on the same name from
+    // a socket file a crashed one left behind.
+    static constexpr int StaleSocketProbeTimeout = 100;
+
+    /*!
+        Makes \a server listen on \a name. A socket file by that name that
+        nobody answers on is removed and the name taken over; one that is
+        answered belongs to a running server, and listening fails.
+    */
+    static bool listen(QLocalServer *server, const QString &name);
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPLOCALSERVER_P_H
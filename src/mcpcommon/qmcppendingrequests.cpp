@@ -0,0 +1,114 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcppendingrequests_p.h"
+
+QT_BEGIN_NAMESPACE
+
+QMcpPendingRequests::QMcpPendingRequests()
+{
+    m_timer.setInterval(TickMs);
+    QObject::connect(&m_timer, &QTimer::timeout, &m_timer, [this]() { tick(); });
+}
+
+QMcpPendingRequests::~QMcpPendingRequests() = default;
+
+int QMcpPendingRequests::timeout() const
+{
+    return m_timeoutMs;
+}
+
+// Applies to requests inserted from now on; 0 disables the deadline.
+void QMcpPendingRequests::setTimeout(int msecs)
+{
+    m_timeoutMs = qMax(0, msecs);
+}
+
+qint64 QMcpPendingRequests::nextId()
+{
+    return m_nextId++;
+}
+
+void QMcpPendingRequests::insert(qint64 id, const QUuid &owner, Callback callback)
+{
+    Entry entry;
+    entry.owner = owner;
+    entry.callback = std::move(callback);
+    if (m_timeoutMs > 0) {
+        const int ticks = qMax(1, (m_timeoutMs + TickMs - 1) / TickMs);
+        entry.rounds = (ticks - 1) / WheelSlots;
+        m_wheel[(m_cursor + ticks) % WheelSlots].append(id);
+        if (!m_timer.isActive())
+            m_timer.start();
+    }
+    m_entries.insert(id, std::move(entry));
+}
+
+QMcpPendingRequests::Callback QMcpPendingRequests::take(const QUuid &owner, const QJsonValue &id)
+{
+    // Ids are only ever handed out as integers; anything else is not ours.
+    if (!id.isDouble())
+        return nullptr;
+    const qint64 key = id.toInteger(-1);
+    const auto it = m_entries.constFind(key);
+    if (it == m_entries.cend() || it->owner != owner)
+        return nullptr;
+    auto callback = it->callback;
+    m_entries.erase(it);
+    // The wheel keeps the id until its slot comes up; tick() skips it.
+    return callback;
+}
+
+// Drops the owner's requests without invoking their callbacks: the owner is
+// going away, and the callbacks may well refer to it.
+void QMcpPendingRequests::removeOwner(const QUuid &owner)
+{
+    m_entries.removeIf([&owner](const auto &it) { return it.value().owner == owner; });
+}
+
+qsizetype QMcpPendingRequests::size() const
+{
+    return m_entries.size();
+}
+
+QJsonObject QMcpPendingRequests::timeoutError()
+{
+    QJsonObject error;
+    error.insert("code"_L1, TimeoutErrorCode);
+    error.insert("message"_L1, "Request timed out"_L1);
+    return error;
+}
+
+void QMcpPendingRequests::tick()
+{
+    m_cursor = (m_cursor + 1) % WheelSlots;
+    const auto ids = std::exchange(m_wheel[m_cursor], {});
+    QList<Callback> expired;
+    for (const qint64 id : ids) {
+        const auto it = m_entries.find(id);
+        if (it == m_entries.end())
+            continue;
+        if (it->rounds > 0) {
+            --it->rounds;
+            m_wheel[m_cursor].append(id);
+            continue;
+        }
+        if (it->callback)
+            expired.append(std::move(it->callback));
+        m_entries.erase(it);
+    }
+
+    if (m_entries.isEmpty()) {
+        // Whatever is left on the wheel was answered already.
+        m_timer.stop();
+        for (auto &slot : m_wheel)
+            slot.clear();
+    }
+
+    // Last, as a callback may well send the next request.
+    const auto error = timeoutError();
+    for (const auto &callback : std::as_const(expired))
+        callback(QJsonObject(), error);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,93 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPPENDINGREQUESTS_P_H
+#define QMCPPENDINGREQUESTS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpCommon/qmcpcommonglobal.h>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QList>
+#include <QtCore/QTimer>
+#include <QtCore/QUuid>
+
+#include <array>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpPendingRequests
+    \internal
+    \inmodule QtMcpCommon
+    \brief Tracks the requests a peer still owes an answer for.
+
+    Each instance hands out its own JSON-RPC ids and keys the callbacks by
+    them. Every request gets a deadline on a coarse timer wheel: a request
+    whose answer never arrives is completed with a timeout error once its
+    deadline passed, so the number of pending callbacks stays bounded however
+    long the process runs. The wheel only ticks while requests are pending.
+
+    The owner is the server session a request was sent on; the client uses a
+    null QUuid. A response only completes a request of the owner it arrived
+    on.
+*/
+class Q_MCPCOMMON_EXPORT QMcpPendingRequests
+{
+public:
+    using Callback = std::function<void(const QJsonObject &result, const QJsonObject &error)>;
+
+    // The code MCP SDKs report a request timeout with.
+    static constexpr int TimeoutErrorCode = -32001;
+    static constexpr int DefaultTimeoutMs = 300000;
+
+    QMcpPendingRequests();
+    ~QMcpPendingRequests();
+
+    int timeout() const;
+    void setTimeout(int msecs);
+
+    // 64 bits, so that ids are never reused however long the process runs;
+    // JSON numbers hold them exactly up to 2^53.
+    qint64 nextId();
+    void insert(qint64 id, const QUuid &owner, Callback callback);
+    Callback take(const QUuid &owner, const QJsonValue &id);
+    void removeOwner(const QUuid &owner);
+    qsizetype size() const;
+
+    static QJsonObject timeoutError();
+
+private:
+    void tick();
+
+    static constexpr int TickMs = 100;
+    static constexpr int WheelSlots = 256;
+
+    struct Entry {
+        QUuid owner;
+        Callback callback;
+        int rounds = 0;
+    };
+    QHash<qint64, Entry> m_entries;
+    std::array<QList<qint64>, WheelSlots> m_wheel;
+    int m_cursor = 0;
+    qint64 m_nextId = 0;
+    int m_timeoutMs = DefaultTimeoutMs;
+    QTimer m_timer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPPENDINGREQUESTS_P_H
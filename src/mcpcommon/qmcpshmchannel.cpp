@@ -0,0 +1,529 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpshmchannel_p.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonParseError>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedMemory>
+#include <QtCore/QSystemSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QtEndian>
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+static_assert(std::atomic<quint64>::is_always_lock_free && std::atomic<quint32>::is_always_lock_free,
+              "the rings are shared between processes, which locks cannot be");
+
+constexpr quint32 SegmentMagic = 0x514d4350; // "QMCP"
+constexpr quint32 SegmentVersion = 1;
+constexpr qsizetype FrameHeaderSize = sizeof(quint32);
+// How long send() waits for a peer that does not make room before it gives
+// the message up; one that slow is as good as gone.
+constexpr int SendTimeoutMs = 30 * 1000;
+// How often a blocked send() looks at the ring in case a wake-up was missed.
+constexpr int SendPollMs = 100;
+// Cursors written by different processes live on different cache lines.
+constexpr std::size_t CacheLine = 64;
+
+/*!
+    \internal
+    One direction of the channel. The cursors count bytes ever written and
+    read; their difference is what is in the ring.
+*/
+struct RingHeader
+{
+    alignas(CacheLine) std::atomic<quint64> head; // written by the producer
+    alignas(CacheLine) std::atomic<quint64> tail; // written by the consumer
+    // Set by an end about to wait on its semaphore, cleared by whoever
+    // wakes it.
+    alignas(CacheLine) std::atomic<quint32> consumerWaiting;
+    std::atomic<quint32> producerWaiting;
+};
+
+struct SegmentHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint64 capacity;
+    // Ring 0 carries what the server sends, ring 1 what the client sends.
+    RingHeader rings[2];
+};
+
+/*!
+    \internal
+    Returns the smallest power of two that is not less than \a size, so
+    that positions wrap with a mask.
+*/
+qsizetype roundUpToPowerOfTwo(qsizetype size)
+{
+    qsizetype result = 4096;
+    while (result < size)
+        result <<= 1;
+    return result;
+}
+
+struct Ring
+{
+    RingHeader *header = nullptr;
+    char *data = nullptr;
+    quint64 capacity = 0;
+
+    quint64 mask() const { return capacity - 1; }
+
+    void copyIn(quint64 position, const char *from, qsizetype size)
+    {
+        const auto offset = position & mask();
+        const auto first = std::min<quint64>(size, capacity - offset);
+        std::memcpy(data + offset, from, first);
+        std::memcpy(data, from + first, size - first);
+    }
+
+    void copyOut(quint64 position, char *to, qsizetype size) const
+    {
+        const auto offset = position & mask();
+        const auto first = std::min<quint64>(size, capacity - offset);
+        std::memcpy(to, data + offset, first);
+        std::memcpy(to + first, data, size - first);
+    }
+};
+
+/*!
+    \internal
+    Returns the semaphore key of the end that \a side is.
+*/
+QNativeIpcKey semaphoreKey(const QString &key, int side)
+{
+    return QSystemSemaphore::platformSafeKey(key + "-wake%1"_L1.arg(side));
+}
+
+} // namespace
+
+class QMcpShmChannel::Private
+{
+public:
+    Private(Handler received);
+    ~Private();
+
+    struct Message {
+        QJsonObject object;
+        qsizetype bytes;
+    };
+
+    bool setUp(const QString &key, int side, QSystemSemaphore::AccessMode mode);
+    void startWaiter();
+    void postService();
+    void service();
+    void drain(QList<Message> *messages);
+    // Waits for the queue to take \a bytes more; returns false on timeout.
+    bool waitForRoom(qsizetype bytes);
+    // Writes queued bytes into the outgoing ring; returns whether all fit.
+    bool flush();
+    bool hasRoom() const;
+    void wakePeer();
+
+    // Where service() is queued to; going with the channel, it takes what
+    // is still queued along.
+    QObject target;
+    Handler received;
+    QString errorString;
+
+    QSharedMemory memory;
+    std::unique_ptr<QSystemSemaphore> ownWake;
+    std::unique_ptr<QSystemSemaphore> peerWake;
+    Ring in;
+    Ring out;
+
+    // Frame being read: its length, and its bytes when they came in pieces.
+    quint64 seenHead = 0;
+    qint64 frameLength = -1;
+    QByteArray partial;
+    // What is left of a frame too large to take, read past unseen.
+    qint64 skipLength = 0;
+    qsizetype maxFrameSize = DefaultMaxFrameSize;
+    // Read while send() waited for room, handed on by service().
+    QList<Message> inbox;
+
+    // Frame headers and payloads that did not fit yet, the first one
+    // partly written up to queuedOffset.
+    QList<QByteArray> queue;
+    qsizetype queuedOffset = 0;
+    qsizetype queuedSize = 0;
+    qsizetype maxQueuedBytes = DefaultMaxQueuedBytes;
+
+    QThread *waiter = nullptr;
+    // Counts the waiter's wake-ups, for a send() blocked on a full queue.
+    QMutex wakeMutex;
+    QWaitCondition wakeCondition;
+    quint64 wakeups = 0;
+    std::atomic<bool> stopping = false;
+    std::atomic<bool> servicePosted = false;
+};
+
+QMcpShmChannel::Private::Private(Handler received)
+    : received(std::move(received))
+{}
+
+QMcpShmChannel::Private::~Private()
+{
+    if (waiter) {
+        stopping = true;
+        ownWake->release();
+        waiter->wait();
+        delete waiter;
+    }
+}
+
+bool QMcpShmChannel::Private::setUp(const QString &key, int side, QSystemSemaphore::AccessMode mode)
+{
+    auto *segment = static_cast<SegmentHeader *>(memory.data());
+    const auto capacity = segment->capacity;
+    auto *rings = static_cast<char *>(memory.data()) + sizeof(SegmentHeader);
+    Ring ring[2];
+    for (int i = 0; i < 2; ++i)
+        ring[i] = { &segment->rings[i], rings + i * capacity, capacity };
+    out = ring[side];
+    in = ring[1 - side];
+
+    ownWake = std::make_unique<QSystemSemaphore>(semaphoreKey(key, side), 0, mode);
+    peerWake = std::make_unique<QSystemSemaphore>(semaphoreKey(key, 1 - side), 0, mode);
+    for (const auto *semaphore : { ownWake.get(), peerWake.get() }) {
+        if (semaphore->error() != QSystemSemaphore::NoError) {
+            errorString = semaphore->errorString();
+            return false;
+        }
+    }
+    startWaiter();
+    return true;
+}
+
+void QMcpShmChannel::Private::startWaiter()
+{
+    // Sleeps on this end's semaphore and has the channel's thread look at
+    // the rings when woken; the rings themselves are only touched there.
+    waiter = QThread::create([this]() {
+        while (true) {
+            ownWake->acquire();
+            if (stopping)
+                return;
+            {
+                QMutexLocker locker(&wakeMutex);
+                ++wakeups;
+            }
+            wakeCondition.wakeAll();
+            postService();
+        }
+    });
+    waiter->setObjectName("QMcpShmChannel waiter"_L1);
+    waiter->start();
+    // Whatever the peer sent before this end was there is read now, and
+    // the peer learns that this end sleeps.
+    postService();
+}
+
+void QMcpShmChannel::Private::postService()
+{
+    if (servicePosted.exchange(true))
+        return;
+    QMetaObject::invokeMethod(&target, [this]() { service(); }, Qt::QueuedConnection);
+}
+
+void QMcpShmChannel::Private::service()
+{
+    servicePosted = false;
+    while (true) {
+        drain(&inbox);
+        const bool flushed = flush();
+
+        // Announce the sleep, then look once more: the peer checks the
+        // flag only after it moved its cursor.
+        in.header->consumerWaiting.store(1);
+        if (!flushed)
+            out.header->producerWaiting.store(1);
+        // Against what drain() saw, not the tail: the last bytes may be a
+        // piece of a frame header it waits for the rest of.
+        const bool moreToRead = in.header->head.load() != seenHead;
+        if (!moreToRead && (flushed || !hasRoom()))
+            break;
+        in.header->consumerWaiting.store(0);
+        out.header->producerWaiting.store(0);
+    }
+
+    // Handed on last: a receiver may do anything, including deleting this.
+    const auto messages = std::exchange(inbox, {});
+    const QPointer<QObject> guard = &target;
+    const auto handler = received;
+    for (const auto &message : std::as_const(messages)) {
+        if (!guard)
+            return;
+        handler(message.object, message.bytes);
+    }
+}
+
+void QMcpShmChannel::Private::drain(QList<Message> *messages)
+{
+    auto &header = *in.header;
+    const auto head = header.head.load(std::memory_order_acquire);
+    auto tail = header.tail.load(std::memory_order_relaxed);
+    seenHead = head;
+    if (head == tail)
+        return;
+
+    const auto decode = [messages](const QByteArray &json) {
+        QJsonParseError error;
+        const auto document = QJsonDocument::fromJson(json, &error);
+        if (error.error != QJsonParseError::NoError)
+            qWarning() << "shared memory message is no valid JSON:" << error.errorString();
+        else if (!document.isObject())
+            qWarning() << "shared memory message is not an object" << document;
+        else
+            messages->append({ document.object(), FrameHeaderSize + json.size() });
+    };
+
+    while (head != tail) {
+        const auto available = qint64(head - tail);
+        if (skipLength > 0) {
+            const auto size = std::min(available, skipLength);
+            tail += size;
+            skipLength -= size;
+            continue;
+        }
+        if (frameLength < 0) {
+            if (available < FrameHeaderSize)
+                break;
+            quint32 length;
+            in.copyOut(tail, reinterpret_cast<char *>(&length), FrameHeaderSize);
+            tail += FrameHeaderSize;
+            const qint64 size = qFromLittleEndian(length);
+            // Not buffered on the peer's word: the frame is read past,
+            // which keeps the framing of what follows.
+            if (size > maxFrameSize) {
+                qWarning() << "dropping a shared memory message of" << size << "bytes, more than"
+                           << maxFrameSize;
+                skipLength = size;
+                continue;
+            }
+            frameLength = size;
+            continue;
+        }
+
+        const auto offset = tail & in.mask();
+        if (partial.isEmpty() && available >= frameLength && offset + frameLength <= in.capacity) {
+            // Parsed in place; the producer cannot reuse these bytes before
+            // the tail moves past them.
+            decode(QByteArray::fromRawData(in.data + offset, frameLength));
+            tail += frameLength;
+            frameLength = -1;
+            continue;
+        }
+
+        // Wrapped around or not all there yet, maybe larger than the ring.
+        const auto size = std::min<qint64>(available, frameLength - partial.size());
+        const auto from = partial.size();
+        partial.resize(from + size);
+        in.copyOut(tail, partial.data() + from, size);
+        tail += size;
+        if (partial.size() == frameLength) {
+            decode(std::exchange(partial, {}));
+            frameLength = -1;
+        }
+    }
+
+    header.tail.store(tail, std::memory_order_seq_cst);
+    if (header.producerWaiting.exchange(0))
+        wakePeer();
+}
+
+bool QMcpShmChannel::Private::flush()
+{
+    if (queue.isEmpty())
+        return true;
+    auto &header = *out.header;
+    auto head = header.head.load(std::memory_order_relaxed);
+    const auto tail = header.tail.load(std::memory_order_acquire);
+    auto room = qint64(out.capacity - (head - tail));
+    const auto before = head;
+
+    while (!queue.isEmpty() && room > 0) {
+        const auto &bytes = queue.first();
+        const auto size = std::min<qint64>(room, bytes.size() - queuedOffset);
+        out.copyIn(head, bytes.constData() + queuedOffset, size);
+        head += size;
+        room -= size;
+        queuedOffset += size;
+        queuedSize -= size;
+        if (queuedOffset == bytes.size()) {
+            queue.removeFirst();
+            queuedOffset = 0;
+        }
+    }
+
+    if (head != before) {
+        header.head.store(head, std::memory_order_seq_cst);
+        if (header.consumerWaiting.exchange(0))
+            wakePeer();
+    }
+    return queue.isEmpty();
+}
+
+bool QMcpShmChannel::Private::waitForRoom(qsizetype bytes)
+{
+    const QDeadlineTimer deadline(SendTimeoutMs);
+    while (queuedSize > 0 && queuedSize + bytes > maxQueuedBytes) {
+        // Reading on meanwhile: a peer blocked on a full ring of its own
+        // would otherwise wait for this end, and this end for it.
+        drain(&inbox);
+        if (!inbox.isEmpty())
+            postService();
+        if (flush() || queuedSize + bytes <= maxQueuedBytes)
+            break;
+
+        QMutexLocker locker(&wakeMutex);
+        const auto seen = wakeups;
+        in.header->consumerWaiting.store(1);
+        out.header->producerWaiting.store(1);
+        // The peer may have moved a cursor before it could see the flags.
+        if (hasRoom() || in.header->head.load() != seenHead)
+            continue;
+        if (deadline.hasExpired())
+            return false;
+        while (wakeups == seen) {
+            if (!wakeCondition.wait(&wakeMutex, QDeadlineTimer(std::min<qint64>(SendPollMs, deadline.remainingTime()))))
+                break;
+        }
+    }
+    return true;
+}
+
+bool QMcpShmChannel::Private::hasRoom() const
+{
+    return out.header->head.load(std::memory_order_relaxed) - out.header->tail.load() < out.capacity;
+}
+
+void QMcpShmChannel::Private::wakePeer()
+{
+    peerWake->release();
+}
+
+QMcpShmChannel::QMcpShmChannel(Handler received)
+    : d(new Private(std::move(received)))
+{}
+
+QMcpShmChannel::~QMcpShmChannel() = default;
+
+bool QMcpShmChannel::create(const QString &key, qsizetype capacity)
+{
+    capacity = roundUpToPowerOfTwo(capacity);
+    d->memory.setNativeKey(QSharedMemory::platformSafeKey(key));
+    if (!d->memory.create(sizeof(SegmentHeader) + 2 * capacity)) {
+        d->errorString = d->memory.errorString();
+        return false;
+    }
+    auto *segment = new (d->memory.data()) SegmentHeader;
+    segment->magic = SegmentMagic;
+    segment->version = SegmentVersion;
+    segment->capacity = capacity;
+    for (auto &ring : segment->rings) {
+        ring.head = 0;
+        ring.tail = 0;
+        ring.consumerWaiting = 0;
+        ring.producerWaiting = 0;
+    }
+    return d->setUp(key, 0, QSystemSemaphore::Create);
+}
+
+bool QMcpShmChannel::attach(const QString &key)
+{
+    d->memory.setNativeKey(QSharedMemory::platformSafeKey(key));
+    if (!d->memory.attach()) {
+        d->errorString = d->memory.errorString();
+        return false;
+    }
+    const auto *segment = static_cast<const SegmentHeader *>(d->memory.constData());
+    if (d->memory.size() < qsizetype(sizeof(SegmentHeader))
+            || segment->magic != SegmentMagic || segment->version != SegmentVersion
+            || d->memory.size() < qsizetype(sizeof(SegmentHeader) + 2 * segment->capacity)) {
+        d->errorString = "%1 is no MCP shared memory segment"_L1.arg(key);
+        return false;
+    }
+    return d->setUp(key, 1, QSystemSemaphore::Open);
+}
+
+QString QMcpShmChannel::errorString() const
+{
+    return d->errorString;
+}
+
+qsizetype QMcpShmChannel::send(const QJsonObject &object)
+{
+    if (!d->out.header)
+        return 0;
+    const auto json = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    if (json.size() > d->maxFrameSize) {
+        qWarning() << "not sending a shared memory message of" << json.size()
+                   << "bytes, more than" << d->maxFrameSize;
+        return 0;
+    }
+    if (!d->waitForRoom(FrameHeaderSize + json.size())) {
+        qWarning() << "the shared memory peer made no room for" << SendTimeoutMs
+                   << "ms; dropping a message";
+        return 0;
+    }
+    QByteArray frameHeader(FrameHeaderSize, Qt::Uninitialized);
+    qToLittleEndian(quint32(json.size()), frameHeader.data());
+    d->queue.append(frameHeader);
+    d->queue.append(json);
+    const auto bytes = frameHeader.size() + json.size();
+    d->queuedSize += bytes;
+    if (d->queue.size() > 2)
+        return bytes; // behind what waits for room already
+    if (d->flush())
+        return bytes;
+    d->out.header->producerWaiting.store(1);
+    // The consumer may have made room before it could see the flag.
+    if (d->hasRoom())
+        d->postService();
+    return bytes;
+}
+
+qsizetype QMcpShmChannel::queuedBytes() const
+{
+    return d->queuedSize;
+}
+
+qsizetype QMcpShmChannel::maxQueuedBytes() const
+{
+    return d->maxQueuedBytes;
+}
+
+void QMcpShmChannel::setMaxQueuedBytes(qsizetype bytes)
+{
+    d->maxQueuedBytes = bytes;
+}
+
+qsizetype QMcpShmChannel::maxFrameSize() const
+{
+    return d->maxFrameSize;
+}
+
+void QMcpShmChannel::setMaxFrameSize(qsizetype bytes)
+{
+    d->maxFrameSize = std::min<qsizetype>(bytes, std::numeric_limits<quint32>::max());
+}
+
+QT_END_NAMESPACE
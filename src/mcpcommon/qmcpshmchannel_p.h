@@ -0,0 +1,95 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSHMCHANNEL_P_H
+#define QMCPSHMCHANNEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpCommon/qmcpcommonglobal.h>
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpShmChannel
+    \internal
+    \inmodule QtMcpCommon
+    \brief Carries MCP messages between two processes through shared memory.
+
+    The server end create()s a segment holding one single-producer,
+    single-consumer ring per direction; the client end attach()es to it by
+    the same key. Messages are compact JSON, framed by a 32-bit length, and
+    are read straight out of the ring when a frame does not wrap around.
+
+    Neither end makes a system call while the other keeps up: a peer is
+    only woken, through a QSystemSemaphore, when it said it is about to
+    sleep on an empty ring or on a full one. What does not fit into a full
+    ring waits in this end's queue, in order, until the peer made room.
+    Once maxQueuedBytes() wait there, send() blocks until the peer took
+    some, still reading what the peer sends meanwhile, and gives the
+    message up after 30 seconds. Frames larger than maxFrameSize() are
+    neither sent nor taken: a peer announcing one is read past.
+
+    Messages arrive at the handler in the thread the channel was created
+    in. Telling that the peer went away is left to the caller, which needs a
+    connection to exchange the key over anyway.
+*/
+class Q_MCPCOMMON_EXPORT QMcpShmChannel
+{
+    Q_DISABLE_COPY_MOVE(QMcpShmChannel)
+public:
+    // Called with each message and the bytes it took in the ring.
+    using Handler = std::function<void(const QJsonObject &object, qsizetype bytes)>;
+
+    // Bytes per direction unless create() is told otherwise.
+    static constexpr qsizetype DefaultCapacity = 1 << 20;
+    static constexpr qsizetype DefaultMaxQueuedBytes = 16 * DefaultCapacity;
+    static constexpr qsizetype DefaultMaxFrameSize = 64 * DefaultCapacity;
+
+    explicit QMcpShmChannel(Handler received);
+    ~QMcpShmChannel();
+
+    /*!
+        Creates the segment for \a key with rings of \a capacity bytes,
+        rounded up to a power of two, and makes this the server end.
+    */
+    bool create(const QString &key, qsizetype capacity = DefaultCapacity);
+    // Attaches to the segment the server end created for \a key.
+    bool attach(const QString &key);
+    QString errorString() const;
+
+    // Returns the bytes the message takes in the ring, 0 when it was not
+    // sent.
+    qsizetype send(const QJsonObject &object);
+    // Bytes sent but still waiting for room in the ring.
+    qsizetype queuedBytes() const;
+    // How many bytes may wait before send() blocks. One message always
+    // fits into an empty queue.
+    qsizetype maxQueuedBytes() const;
+    void setMaxQueuedBytes(qsizetype bytes);
+    // The largest message this end sends or takes.
+    qsizetype maxFrameSize() const;
+    void setMaxFrameSize(qsizetype bytes);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSHMCHANNEL_P_H
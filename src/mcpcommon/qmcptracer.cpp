@@ -0,0 +1,433 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcptracer_p.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QRandomGenerator>
+
+QT_BEGIN_NAMESPACE
+
+std::atomic<bool> QMcpTracer::s_enabled = false;
+
+namespace {
+
+// Child span ids carry the top bit, so they never collide with the root span
+// id, which is the trace id itself.
+constexpr quint64 ChildSpanBit = Q_UINT64_C(1) << 63;
+constexpr qint64 FlushIntervalNs = 1000000000;
+
+struct Span {
+    quint64 trace = 0;
+    quint64 id = 0;
+    bool isRoot = false;
+    QByteArray name;
+    qint64 startNs = 0;
+    qint64 endNs = 0;
+    QMcpTracer::Attributes attributes;
+};
+
+struct OpenTrace {
+    qint64 startNs = 0;
+    QByteArray name = "request"_ba;
+    QMcpTracer::Attributes attributes;
+};
+
+} // namespace
+
+// Outside the anonymous namespace, so QMcpTracer can befriend it.
+struct QMcpTracerState {
+    ~QMcpTracerState();
+
+    void close();
+    void write();
+
+    QMutex mutex;
+    QFile file;
+    QMcpTracer::Format format = QMcpTracer::Format::ChromeTrace;
+    double sampleRate = 1.0;
+    QElapsedTimer clock;
+    qint64 epochNs = 0;
+    qint64 lastFlushNs = 0;
+    quint64 traceIdPrefix = 0;
+    quint64 nextTrace = 1;
+    quint64 nextSpan = 1;
+    bool firstEvent = true;
+    QHash<quint64, OpenTrace> open;
+    QList<Span> spans;
+};
+
+Q_GLOBAL_STATIC(QMcpTracerState, tracerState)
+
+namespace {
+
+struct Current {
+    quint64 trace = 0;
+    // Set while a QMcpTraceScope is current whose trace is still up for
+    // adoption.
+    bool *adopted = nullptr;
+};
+thread_local Current t_current;
+
+QByteArray hex64(quint64 value)
+{
+    return QByteArray::number(value, 16).rightJustified(16, '0');
+}
+
+/*!
+    \internal
+    Writes a span as a Chrome trace-event "complete" event. Each trace gets
+    its own row, so overlapping requests do not stack into one another.
+*/
+QByteArray chromeEvent(const Span &span)
+{
+    QJsonObject args;
+    for (const auto &attribute : span.attributes)
+        args.insert(QString::fromLatin1(attribute.first), attribute.second);
+    args.insert("trace"_L1, QString::number(span.trace));
+
+    QJsonObject event;
+    event.insert("name"_L1, QString::fromUtf8(span.name));
+    event.insert("cat"_L1, "mcp"_L1);
+    event.insert("ph"_L1, "X"_L1);
+    event.insert("ts"_L1, span.startNs / 1000.0);
+    event.insert("dur"_L1, (span.endNs - span.startNs) / 1000.0);
+    event.insert("pid"_L1, QCoreApplication::applicationPid());
+    event.insert("tid"_L1, double(span.trace));
+    event.insert("args"_L1, args);
+    return QJsonDocument(event).toJson(QJsonDocument::Compact);
+}
+
+QJsonObject otlpSpan(const Span &span, quint64 traceIdPrefix, qint64 epochNs)
+{
+    QJsonArray attributes;
+    for (const auto &attribute : span.attributes) {
+        QJsonObject value;
+        value.insert("stringValue"_L1, attribute.second);
+        QJsonObject keyValue;
+        keyValue.insert("key"_L1, QString::fromLatin1(attribute.first));
+        keyValue.insert("value"_L1, value);
+        attributes.append(keyValue);
+    }
+
+    QJsonObject ret;
+    ret.insert("traceId"_L1, QString::fromLatin1(hex64(traceIdPrefix) + hex64(span.trace)));
+    ret.insert("spanId"_L1, QString::fromLatin1(hex64(span.id)));
+    if (!span.isRoot)
+        ret.insert("parentSpanId"_L1, QString::fromLatin1(hex64(span.trace)));
+    ret.insert("name"_L1, QString::fromUtf8(span.name));
+    // SPAN_KIND_SERVER for the request, SPAN_KIND_INTERNAL for its stages.
+    ret.insert("kind"_L1, span.isRoot ? 2 : 1);
+    ret.insert("startTimeUnixNano"_L1, QString::number(epochNs + span.startNs));
+    ret.insert("endTimeUnixNano"_L1, QString::number(epochNs + span.endNs));
+    ret.insert("attributes"_L1, attributes);
+    return ret;
+}
+
+} // namespace
+
+QMcpTracerState::~QMcpTracerState()
+{
+    QMcpTracer::s_enabled = false;
+    close();
+}
+
+// Expects the mutex held.
+void QMcpTracerState::close()
+{
+    if (!file.isOpen())
+        return;
+    write();
+    if (format == QMcpTracer::Format::ChromeTrace)
+        file.write("\n]\n");
+    file.close();
+    open.clear();
+}
+
+// Writes out the finished spans; expects the mutex held. OTLP gets one
+// ExportTraceServiceRequest per call, so this runs per finished request
+// rather than per span.
+void QMcpTracerState::write()
+{
+    if (spans.isEmpty())
+        return;
+
+    if (format == QMcpTracer::Format::ChromeTrace) {
+        for (const auto &span : std::as_const(spans)) {
+            file.write(firstEvent ? "" : ",\n");
+            file.write(chromeEvent(span));
+            firstEvent = false;
+        }
+    } else {
+        QJsonArray otlpSpans;
+        for (const auto &span : std::as_const(spans))
+            otlpSpans.append(otlpSpan(span, traceIdPrefix, epochNs));
+
+        QJsonObject scope;
+        scope.insert("name"_L1, "qtmcp"_L1);
+        QJsonObject scopeSpans;
+        scopeSpans.insert("scope"_L1, scope);
+        scopeSpans.insert("spans"_L1, otlpSpans);
+
+        QJsonObject serviceName;
+        serviceName.insert("key"_L1, "service.name"_L1);
+        serviceName.insert("value"_L1, QJsonObject { { "stringValue"_L1, QCoreApplication::applicationName() } });
+        QJsonObject resource;
+        resource.insert("attributes"_L1, QJsonArray { serviceName });
+
+        QJsonObject resourceSpans;
+        resourceSpans.insert("resource"_L1, resource);
+        resourceSpans.insert("scopeSpans"_L1, QJsonArray { scopeSpans });
+
+        QJsonObject request;
+        request.insert("resourceSpans"_L1, QJsonArray { resourceSpans });
+        file.write(QJsonDocument(request).toJson(QJsonDocument::Compact));
+        file.write("\n");
+    }
+    spans.clear();
+
+    // Keep the file close to current for a process that never exits cleanly,
+    // without flushing on every request.
+    const auto nowNs = clock.nsecsElapsed();
+    if (nowNs - lastFlushNs >= FlushIntervalNs) {
+        file.flush();
+        lastFlushNs = nowNs;
+    }
+}
+
+/*!
+    Starts tracing as the environment asks for, once per process; later calls
+    do nothing. QMcpServer calls this on construction.
+*/
+void QMcpTracer::initialize()
+{
+    static const bool started = []() {
+        const auto fileName = qEnvironmentVariable("QT_MCP_TRACE_FILE");
+        if (fileName.isEmpty())
+            return false;
+        const auto format = qEnvironmentVariable("QT_MCP_TRACE_FORMAT").compare("otlp"_L1, Qt::CaseInsensitive) == 0
+                ? Format::OtlpJson : Format::ChromeTrace;
+        bool ok = false;
+        const double sampleRate = qEnvironmentVariable("QT_MCP_TRACE_SAMPLE_RATE").toDouble(&ok);
+        return start(fileName, format, ok ? sampleRate : 1.0);
+    }();
+    Q_UNUSED(started);
+}
+
+/*!
+    Starts writing traces to \a fileName in \a format, replacing a trace
+    already being written. \a sampleRate, from 0 to 1, is the fraction of
+    requests traced.
+*/
+bool QMcpTracer::start(const QString &fileName, Format format, double sampleRate)
+{
+    auto *state = tracerState();
+    QMutexLocker locker(&state->mutex);
+    s_enabled = false;
+    state->close();
+
+    state->file.setFileName(fileName);
+    if (!state->file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot open trace file" << fileName << state->file.errorString();
+        return false;
+    }
+    state->format = format;
+    state->sampleRate = qBound(0.0, sampleRate, 1.0);
+    state->clock.start();
+    state->epochNs = QDateTime::currentMSecsSinceEpoch() * 1000000;
+    state->lastFlushNs = 0;
+    state->traceIdPrefix = QRandomGenerator::global()->generate64() | 1;
+    state->firstEvent = true;
+    if (format == Format::ChromeTrace)
+        state->file.write("[\n");
+    s_enabled = true;
+    return true;
+}
+
+/*!
+    Stops tracing and completes the file. Requests still open are dropped.
+*/
+void QMcpTracer::stop()
+{
+    if (!tracerState.exists())
+        return;
+    auto *state = tracerState();
+    QMutexLocker locker(&state->mutex);
+    s_enabled = false;
+    state->close();
+}
+
+/*!
+    Returns the time in nanoseconds on the clock spans are measured with.
+*/
+qint64 QMcpTracer::now()
+{
+    if (!isEnabled())
+        return 0;
+    return tracerState()->clock.nsecsElapsed();
+}
+
+/*!
+    Opens a trace, started at \a startNs or now, and returns its id, which is
+    0 if tracing is off or the dice decided against this request.
+*/
+quint64 QMcpTracer::beginTrace(qint64 startNs)
+{
+    if (!isEnabled())
+        return 0;
+    auto *state = tracerState();
+    QMutexLocker locker(&state->mutex);
+    if (state->sampleRate < 1.0 && QRandomGenerator::global()->generateDouble() >= state->sampleRate)
+        return 0;
+    const auto trace = state->nextTrace++;
+    OpenTrace entry;
+    entry.startNs = startNs < 0 ? state->clock.nsecsElapsed() : startNs;
+    state->open.insert(trace, entry);
+    return trace;
+}
+
+/*!
+    Names the root span of \a trace, the method for a request, and attaches
+    \a attributes to it.
+*/
+void QMcpTracer::annotate(quint64 trace, const QByteArray &name, const Attributes &attributes)
+{
+    if (!trace || !isEnabled())
+        return;
+    auto *state = tracerState();
+    QMutexLocker locker(&state->mutex);
+    const auto it = state->open.find(trace);
+    if (it == state->open.end())
+        return;
+    if (!name.isEmpty())
+        it->name = name;
+    it->attributes += attributes;
+}
+
+/*!
+    Ends \a trace, recording its root span.
+*/
+void QMcpTracer::endTrace(quint64 trace)
+{
+    if (!trace || !isEnabled())
+        return;
+    auto *state = tracerState();
+    QMutexLocker locker(&state->mutex);
+    const auto it = state->open.constFind(trace);
+    // Already ended, or begun before a restart.
+    if (it == state->open.cend())
+        return;
+    const auto entry = *it;
+    state->open.erase(it);
+
+    Span span;
+    span.trace = trace;
+    span.id = trace;
+    span.isRoot = true;
+    span.name = entry.name;
+    span.startNs = entry.startNs;
+    span.endNs = state->clock.nsecsElapsed();
+    span.attributes = entry.attributes;
+    state->spans.append(span);
+    state->write();
+}
+
+/*!
+    Records a stage of \a trace that ran from \a startNs to \a endNs.
+*/
+void QMcpTracer::addSpan(quint64 trace, const QByteArray &name, qint64 startNs, qint64 endNs,
+                         const Attributes &attributes)
+{
+    if (!trace || !isEnabled())
+        return;
+    auto *state = tracerState();
+    QMutexLocker locker(&state->mutex);
+    Span span;
+    span.trace = trace;
+    span.id = state->nextSpan++ | ChildSpanBit;
+    span.name = name;
+    span.startNs = startNs;
+    span.endNs = endNs;
+    span.attributes = attributes;
+    state->spans.append(span);
+}
+
+/*!
+    Returns the trace current on this thread, 0 if there is none.
+*/
+quint64 QMcpTracer::current()
+{
+    return t_current.trace;
+}
+
+/*!
+    Takes over the trace of the current QMcpTraceScope, which then leaves
+    ending it to the caller. Without a scope to adopt from, as for a
+    transport that opens none or the second request of a batch, a new trace
+    is begun.
+*/
+quint64 QMcpTracer::adopt()
+{
+    if (!isEnabled())
+        return 0;
+    if (t_current.adopted && !*t_current.adopted) {
+        *t_current.adopted = true;
+        return t_current.trace;
+    }
+    return beginTrace();
+}
+
+QMcpTraceScope::QMcpTraceScope(qint64 startNs)
+{
+    if (!QMcpTracer::isEnabled())
+        return;
+    m_active = true;
+    m_trace = QMcpTracer::beginTrace(startNs);
+    m_previousTrace = t_current.trace;
+    m_previousAdopted = t_current.adopted;
+    t_current.trace = m_trace;
+    t_current.adopted = &m_adopted;
+}
+
+QMcpTraceScope::~QMcpTraceScope()
+{
+    if (!m_active)
+        return;
+    t_current.trace = m_previousTrace;
+    t_current.adopted = m_previousAdopted;
+    if (!m_adopted)
+        QMcpTracer::endTrace(m_trace);
+}
+
+QMcpTraceSpan::QMcpTraceSpan(quint64 trace, const char *name)
+{
+    if (!trace)
+        return;
+    m_trace = trace;
+    m_name = name;
+    m_startNs = QMcpTracer::now();
+    m_previousTrace = t_current.trace;
+    m_previousAdopted = t_current.adopted;
+    t_current.trace = trace;
+    t_current.adopted = nullptr;
+}
+
+QMcpTraceSpan::~QMcpTraceSpan()
+{
+    if (!m_trace)
+        return;
+    QMcpTracer::addSpan(m_trace, QByteArray(m_name), m_startNs, QMcpTracer::now());
+    t_current.trace = m_previousTrace;
+    t_current.adopted = m_previousAdopted;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,139 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPTRACER_P_H
+#define QMCPTRACER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpCommon/qmcpcommonglobal.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include <atomic>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpTracer
+    \internal
+    \inmodule QtMcpCommon
+    \brief Records per-request timing spans into a local trace file.
+
+    Tracing is off unless started, either through start() or by setting
+    \c QT_MCP_TRACE_FILE before the first QMcpServer is created. \c QT_MCP_TRACE_FORMAT selects \c chrome (the default, for
+    chrome://tracing and Perfetto) or \c otlp (OTLP-JSON, one
+    ExportTraceServiceRequest per line), and \c QT_MCP_TRACE_SAMPLE_RATE
+    the fraction of requests traced.
+
+    A trace is one request. Its id is 0 when tracing is off or the request
+    was not sampled, and every call taking a trace id returns at once for 0,
+    so the instrumentation costs an atomic load when disabled.
+
+    The stages of a request run in different layers: a transport parses the
+    bytes, the server decodes and dispatches, a tool may finish on another
+    thread. The transport opens a QMcpTraceScope around delivering a
+    message; the server adopts the scope's trace for the request, carries it
+    across the handler's QFuture and ends it once the response is written.
+    Spans are written as soon as they end, so a span may still arrive after
+    its request has been answered.
+*/
+class Q_MCPCOMMON_EXPORT QMcpTracer
+{
+public:
+    enum class Format {
+        ChromeTrace,
+        OtlpJson,
+    };
+
+    using Attributes = QList<std::pair<QByteArray, QString>>;
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    static void initialize();
+    static bool start(const QString &fileName, Format format = Format::ChromeTrace, double sampleRate = 1.0);
+    static void stop();
+
+    static qint64 now();
+    static quint64 beginTrace(qint64 startNs = -1);
+    static void annotate(quint64 trace, const QByteArray &name, const Attributes &attributes = {});
+    static void endTrace(quint64 trace);
+    static void addSpan(quint64 trace, const QByteArray &name, qint64 startNs, qint64 endNs,
+                        const Attributes &attributes = {});
+
+    static quint64 current();
+    static quint64 adopt();
+
+private:
+    friend struct QMcpTracerState;
+
+    static std::atomic<bool> s_enabled;
+};
+
+/*!
+    \class QMcpTraceScope
+    \internal
+    \inmodule QtMcpCommon
+    \brief Opens a trace for a message a transport is delivering.
+
+    The trace is current on this thread for the scope's lifetime, so the
+    layers the message passes through record into it. Unless one of them
+    adopts it with QMcpTracer::adopt(), as the server does for a request,
+    the scope ends the trace itself; a notification is over once delivered.
+*/
+class Q_MCPCOMMON_EXPORT QMcpTraceScope
+{
+public:
+    explicit QMcpTraceScope(qint64 startNs = -1);
+    ~QMcpTraceScope();
+
+    quint64 trace() const { return m_trace; }
+
+private:
+    Q_DISABLE_COPY_MOVE(QMcpTraceScope)
+
+    bool m_active = false;
+    quint64 m_trace = 0;
+    bool m_adopted = false;
+    quint64 m_previousTrace = 0;
+    bool *m_previousAdopted = nullptr;
+};
+
+/*!
+    \class QMcpTraceSpan
+    \internal
+    \inmodule QtMcpCommon
+    \brief Records the time until it goes out of scope as a span of \a trace.
+
+    The trace is current on this thread meanwhile.
+*/
+class Q_MCPCOMMON_EXPORT QMcpTraceSpan
+{
+public:
+    QMcpTraceSpan(quint64 trace, const char *name);
+    ~QMcpTraceSpan();
+
+private:
+    Q_DISABLE_COPY_MOVE(QMcpTraceSpan)
+
+    quint64 m_trace = 0;
+    const char *m_name = nullptr;
+    qint64 m_startNs = 0;
+    quint64 m_previousTrace = 0;
+    bool *m_previousAdopted = nullptr;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPTRACER_P_H
@@ -0,0 +1,651 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpproxy.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFuture>
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
+#include <QtCore/QPromise>
+#include <QtCore/QSet>
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpCallToolRequest>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpGetPromptRequest>
+#include <QtMcpCommon/QMcpGetPromptResult>
+#include <QtMcpCommon/QMcpInitializeRequest>
+#include <QtMcpCommon/QMcpInitializeResult>
+#include <QtMcpCommon/QMcpInitializedNotification>
+#include <QtMcpCommon/QMcpListPromptsRequest>
+#include <QtMcpCommon/QMcpListPromptsResult>
+#include <QtMcpCommon/QMcpListResourcesRequest>
+#include <QtMcpCommon/QMcpListResourcesResult>
+#include <QtMcpCommon/QMcpListToolsRequest>
+#include <QtMcpCommon/QMcpListToolsResult>
+#include <QtMcpCommon/QMcpPromptListChangedNotification>
+#include <QtMcpCommon/QMcpReadResourceRequest>
+#include <QtMcpCommon/QMcpReadResourceResult>
+#include <QtMcpCommon/QMcpResourceListChangedNotification>
+#include <QtMcpCommon/QMcpResourceUpdatedNotification>
+#include <QtMcpCommon/QMcpSubscribeRequest>
+#include <QtMcpCommon/QMcpSubscriptionsListenRequest>
+#include <QtMcpCommon/QMcpSubscriptionsListenResult>
+#include <QtMcpCommon/QMcpTextContent>
+#include <QtMcpCommon/QMcpToolListChangedNotification>
+#include <QtMcpCommon/QMcpUnsubscribeRequest>
+#include <QtMcpServer/QMcpServer>
+#include <QtMcpServer/QMcpServerSession>
+
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpProxy, "qt.mcpproxy")
+
+namespace {
+
+// What an upstream offers, fetched and merged separately.
+enum Kind { Tools, Resources, Prompts, KindCount };
+
+/*!
+    \internal
+    An upstream server: the client talking to it and its catalog as last
+    fetched, with the names as the upstream knows them.
+*/
+struct Upstream
+{
+    QString prefix;
+    std::unique_ptr<QMcpClient> client;
+    QList<QMcpTool> tools;
+    QList<QMcpResource> resources;
+    QList<QMcpPrompt> prompts;
+    // URIs subscribed to upstream on behalf of the proxy's clients.
+    QSet<QString> subscriptions;
+    // Bumped by every fetch, so that an older one still under way does not
+    // overwrite the result of a newer one.
+    std::array<int, KindCount> generations = {};
+};
+
+/*!
+    \internal
+    Fetches every page of a list from \a client and hands the items to
+    \a done. On an error nothing is handed over and the last list stays.
+*/
+template<typename Request, typename Result, typename Item>
+void fetchAll(QMcpClient *client, QList<Item> (Result::*items)() const,
+              std::function<void(const QList<Item> &)> done,
+              const QString &cursor = QString(), const QList<Item> &collected = {})
+{
+    Request request;
+    if (!cursor.isEmpty()) {
+        auto params = request.params();
+        params.setCursor(cursor);
+        request.setParams(params);
+    }
+    QPointer<QMcpClient> guard(client);
+    client->request(request, [guard, items, done, cursor, collected](const Result &result, const QMcpJSONRPCErrorError *error) {
+        if (error) {
+            qCWarning(lcQMcpProxy) << Request().method() << "failed:" << error->message();
+            return;
+        }
+        auto all = collected;
+        all += (result.*items)();
+        const auto next = result.nextCursor();
+        if (next.isEmpty() || next == cursor || !guard) {
+            done(all);
+            return;
+        }
+        fetchAll<Request>(guard.data(), items, done, next, all);
+    });
+}
+
+/*!
+    \internal
+    The downstream end of a request forwarded upstream. It fails the
+    downstream request with the upstream's error, and with an error of its
+    own when the upstream client goes away, taking the callback and with it
+    this, before it answered.
+*/
+template<typename Result>
+struct Forwarded
+{
+    QPromise<Result> promise;
+
+    ~Forwarded()
+    {
+        if (promise.future().isFinished())
+            return;
+        QMcpJSONRPCErrorError error;
+        error.setCode(QMcpServer::InternalErrorCode);
+        error.setMessage("The upstream server was removed"_L1);
+        fail(error);
+    }
+
+    void fail(const QMcpJSONRPCErrorError &error)
+    {
+#ifndef QT_NO_EXCEPTIONS
+        promise.setException(std::make_exception_ptr(error));
+#else
+        Q_UNUSED(error);
+        promise.future().cancel();
+#endif
+        promise.finish();
+    }
+};
+
+/*!
+    \internal
+    Sends \a request upstream and returns a future for the answer, which
+    fails with the upstream's error as is.
+*/
+template<typename Result, typename Request>
+QFuture<Result> forward(QMcpClient *client, const Request &request)
+{
+    auto forwarded = std::make_shared<Forwarded<Result>>();
+    forwarded->promise.start();
+    auto future = forwarded->promise.future();
+    client->request(request, [forwarded](const Result &result, const QMcpJSONRPCErrorError *error) {
+        if (error) {
+            forwarded->fail(*error);
+            return;
+        }
+        forwarded->promise.addResult(result);
+        forwarded->promise.finish();
+    });
+    return future;
+}
+
+/*! \internal */
+QMcpCallToolResult toolError(const QString &message)
+{
+    QMcpCallToolResult result;
+    result.setContent({ QMcpCallToolResultContent(QMcpTextContent(message)) });
+    result.setIsError(true);
+    return result;
+}
+
+} // namespace
+
+class QMcpProxy::Private
+{
+public:
+    Private(QMcpServer *server, QMcpProxy *parent);
+
+    void track(QMcpServerSession *session);
+    void installHandlers();
+    Upstream *find(const QMcpClient *client) const;
+    Upstream *route(const QString &name, QString *upstreamName) const;
+
+    void initialize(Upstream *upstream);
+    void listen(Upstream *upstream);
+    void fetch(Upstream *upstream, Kind kind);
+    void rebuild(Kind kind);
+
+    void subscribe(const QUrl &uri);
+    void unsubscribe(const QUrl &uri);
+
+    QMcpProxy *q;
+    QMcpServer *server;
+    QString separator = u"__"_s;
+    // Ordered by prefix, so that the merged catalogs keep their order.
+    std::map<QString, std::unique_ptr<Upstream>> upstreams;
+    QHash<QUuid, QMcpServerSession *> sessions;
+
+    // The merged catalogs, with the names prefixed, rebuilt on changes
+    // only: a list request just hands out the shared copy.
+    QList<QMcpTool> tools;
+    QList<QMcpResource> resources;
+    QList<QMcpPrompt> prompts;
+    // The prefix of the upstream each resource URI is read from.
+    QHash<QString, QString> resourceUpstreams;
+};
+
+QMcpProxy::Private::Private(QMcpServer *server, QMcpProxy *parent)
+    : q(parent)
+    , server(server)
+{
+    const auto existing = server->sessions();
+    for (auto *session : existing)
+        track(session);
+    connect(server, &QMcpServer::newSession, q, [this](QMcpServerSession *session) {
+        track(session);
+    });
+    installHandlers();
+}
+
+void QMcpProxy::Private::track(QMcpServerSession *session)
+{
+    const auto sessionId = session->sessionId();
+    sessions.insert(sessionId, session);
+    connect(session, &QObject::destroyed, q, [this, sessionId]() {
+        sessions.remove(sessionId);
+    });
+}
+
+void QMcpProxy::Private::installHandlers()
+{
+    // Lists are answered from the merged catalogs, after what the server
+    // offers itself.
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpListToolsRequest &, QMcpJSONRPCErrorError *) {
+        QMcpListToolsResult result;
+        auto *session = sessions.value(sessionId);
+        result.setTools(session ? session->tools() + tools : tools);
+        return result;
+    });
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpListResourcesRequest &, QMcpJSONRPCErrorError *) {
+        QMcpListResourcesResult result;
+        auto *session = sessions.value(sessionId);
+        result.setResources(session ? session->resources() + resources : resources);
+        return result;
+    });
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpListPromptsRequest &, QMcpJSONRPCErrorError *) {
+        QMcpListPromptsResult result;
+        auto *session = sessions.value(sessionId);
+        result.setPrompts(session ? session->prompts() + prompts : prompts);
+        return result;
+    });
+
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpCallToolRequest &request, QMcpJSONRPCErrorError *) -> QFuture<QMcpCallToolResult> {
+        const auto params = request.params();
+        QString name;
+        if (auto *upstream = route(params.name(), &name)) {
+            // A new request rather than the client's: its id and _meta
+            // belong to the connection it came in on.
+            QMcpCallToolRequest forwarded;
+            auto forwardedParams = forwarded.params();
+            forwardedParams.setName(name);
+            forwardedParams.setArguments(params.arguments());
+            forwarded.setParams(forwardedParams);
+            return forward<QMcpCallToolResult>(upstream->client.get(), forwarded);
+        }
+        if (auto *session = sessions.value(sessionId))
+            return session->callToolAsync(params.name(), params.arguments(), params.meta().progressToken());
+        return QtFuture::makeReadyValueFuture(toolError("Error: tool '%1' not found"_L1.arg(params.name())));
+    });
+
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpReadResourceRequest &request, QMcpJSONRPCErrorError *) -> QFuture<QMcpReadResourceResult> {
+        const auto uri = request.params().uri();
+        const auto it = upstreams.find(resourceUpstreams.value(uri.toString()));
+        if (it != upstreams.end()) {
+            QMcpReadResourceRequest forwarded;
+            auto forwardedParams = forwarded.params();
+            forwardedParams.setUri(uri);
+            forwarded.setParams(forwardedParams);
+            return forward<QMcpReadResourceResult>(it->second->client.get(), forwarded);
+        }
+        QMcpReadResourceResult result;
+        if (auto *session = sessions.value(sessionId))
+            result.setContents(session->contents(uri));
+        return QtFuture::makeReadyValueFuture(result);
+    });
+
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpGetPromptRequest &request, QMcpJSONRPCErrorError *) -> QFuture<QMcpGetPromptResult> {
+        const auto params = request.params();
+        QString name;
+        if (auto *upstream = route(params.name(), &name)) {
+            QMcpGetPromptRequest forwarded;
+            auto forwardedParams = forwarded.params();
+            forwardedParams.setName(name);
+            forwardedParams.setArguments(params.arguments());
+            forwarded.setParams(forwardedParams);
+            return forward<QMcpGetPromptResult>(upstream->client.get(), forwarded);
+        }
+        QMcpGetPromptResult result;
+        if (auto *session = sessions.value(sessionId))
+            result.setMessages(session->messages(params.name()));
+        return QtFuture::makeReadyValueFuture(result);
+    });
+
+    // The sessions keep track of their subscriptions as without a proxy;
+    // upstream is subscribed to while any of them is.
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpSubscribeRequest &request, QMcpJSONRPCErrorError *) {
+        const auto uri = request.params().uri();
+        if (auto *session = sessions.value(sessionId))
+            session->subscribe(uri);
+        subscribe(uri);
+        return QMcpEmptyResult();
+    });
+    server->addRequestHandler([this](const QUuid &sessionId, const QMcpUnsubscribeRequest &request, QMcpJSONRPCErrorError *) {
+        const auto uri = request.params().uri();
+        if (auto *session = sessions.value(sessionId))
+            session->unsubscribe(uri);
+        unsubscribe(uri);
+        return QMcpEmptyResult();
+    });
+}
+
+Upstream *QMcpProxy::Private::find(const QMcpClient *client) const
+{
+    for (const auto &[prefix, upstream] : upstreams) {
+        if (upstream->client.get() == client)
+            return upstream.get();
+    }
+    return nullptr;
+}
+
+// Returns the upstream a prefixed \a name belongs to, and the name as the
+// upstream knows it in \a upstreamName.
+Upstream *QMcpProxy::Private::route(const QString &name, QString *upstreamName) const
+{
+    const auto index = name.indexOf(separator);
+    if (index <= 0)
+        return nullptr;
+    const auto it = upstreams.find(name.left(index));
+    if (it == upstreams.end())
+        return nullptr;
+    *upstreamName = name.mid(index + separator.size());
+    return it->second.get();
+}
+
+void QMcpProxy::Private::initialize(Upstream *upstream)
+{
+    auto *client = upstream->client.get();
+    // There is no handshake on a stateless protocol version; list changes
+    // only come to a client that listens for them.
+    if (client->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
+        listen(upstream);
+        for (int kind = 0; kind < KindCount; ++kind)
+            fetch(upstream, Kind(kind));
+        return;
+    }
+
+    QMcpInitializeRequest request;
+    auto params = request.params();
+    params.setProtocolVersion(client->protocolVersion());
+    auto clientInfo = params.clientInfo();
+    clientInfo.setName(QCoreApplication::applicationName());
+    clientInfo.setVersion(QCoreApplication::applicationVersion());
+    params.setClientInfo(clientInfo);
+    request.setParams(params);
+    client->request(request, [this, client](const QMcpInitializeResult &, const QMcpJSONRPCErrorError *error) {
+        auto *upstream = find(client);
+        if (!upstream)
+            return;
+        if (error) {
+            qCWarning(lcQMcpProxy) << upstream->prefix << "failed to initialize:" << error->message();
+            emit q->upstreamErrorOccurred(upstream->prefix, error->message());
+            return;
+        }
+        client->notify(QMcpInitializedNotification());
+        for (int kind = 0; kind < KindCount; ++kind)
+            fetch(upstream, Kind(kind));
+    });
+}
+
+// Tells a stateless upstream which notifications the proxy wants; a new
+// listen replaces the last one.
+void QMcpProxy::Private::listen(Upstream *upstream)
+{
+    QMcpSubscriptionsListenRequest request;
+    auto params = request.params();
+    auto filter = params.notifications();
+    filter.setToolsListChanged(true);
+    filter.setResourcesListChanged(true);
+    filter.setPromptsListChanged(true);
+    filter.setResourceSubscriptions(upstream->subscriptions.values());
+    params.setNotifications(filter);
+    request.setParams(params);
+    upstream->client->request(request, [prefix = upstream->prefix](const QMcpSubscriptionsListenResult &, const QMcpJSONRPCErrorError *error) {
+        if (error)
+            qCWarning(lcQMcpProxy) << prefix << "refused to listen:" << error->message();
+    });
+}
+
+void QMcpProxy::Private::fetch(Upstream *upstream, Kind kind)
+{
+    auto *client = upstream->client.get();
+    const int generation = ++upstream->generations[kind];
+    // Applies what was fetched, unless the upstream went away or was asked
+    // again meanwhile.
+    auto current = [this, client, kind, generation]() -> Upstream * {
+        auto *upstream = find(client);
+        return upstream && upstream->generations[kind] == generation ? upstream : nullptr;
+    };
+    switch (kind) {
+    case Tools:
+        fetchAll<QMcpListToolsRequest>(client, &QMcpListToolsResult::tools, std::function([this, current](const QList<QMcpTool> &tools) {
+            if (auto *upstream = current()) {
+                upstream->tools = tools;
+                rebuild(Tools);
+            }
+        }));
+        break;
+    case Resources:
+        fetchAll<QMcpListResourcesRequest>(client, &QMcpListResourcesResult::resources, std::function([this, current](const QList<QMcpResource> &resources) {
+            if (auto *upstream = current()) {
+                upstream->resources = resources;
+                rebuild(Resources);
+            }
+        }));
+        break;
+    case Prompts:
+        fetchAll<QMcpListPromptsRequest>(client, &QMcpListPromptsResult::prompts, std::function([this, current](const QList<QMcpPrompt> &prompts) {
+            if (auto *upstream = current()) {
+                upstream->prompts = prompts;
+                rebuild(Prompts);
+            }
+        }));
+        break;
+    case KindCount:
+        break;
+    }
+}
+
+// Merges the catalogs of \a kind anew and tells every session the list
+// changed; the server holds the notification back from sessions that are
+// not initialized or, since 2026-07-28, did not ask for it.
+void QMcpProxy::Private::rebuild(Kind kind)
+{
+    switch (kind) {
+    case Tools:
+        tools.clear();
+        for (const auto &[prefix, upstream] : upstreams) {
+            for (auto tool : std::as_const(upstream->tools)) {
+                tool.setName(prefix + separator + tool.name());
+                tools.append(tool);
+            }
+        }
+        for (auto *session : std::as_const(sessions))
+            emit session->toolListChanged();
+        break;
+    case Resources:
+        resources.clear();
+        resourceUpstreams.clear();
+        for (const auto &[prefix, upstream] : upstreams) {
+            for (auto resource : std::as_const(upstream->resources)) {
+                const auto uri = resource.uri().toString();
+                if (resourceUpstreams.contains(uri)) {
+                    qCWarning(lcQMcpProxy) << prefix << "offers" << uri << "as well, ignored";
+                    continue;
+                }
+                resourceUpstreams.insert(uri, prefix);
+                resource.setName(prefix + separator + resource.name());
+                resources.append(resource);
+            }
+        }
+        for (auto *session : std::as_const(sessions))
+            emit session->resourceListChanged();
+        break;
+    case Prompts:
+        prompts.clear();
+        for (const auto &[prefix, upstream] : upstreams) {
+            for (auto prompt : std::as_const(upstream->prompts)) {
+                prompt.setName(prefix + separator + prompt.name());
+                prompts.append(prompt);
+            }
+        }
+        for (auto *session : std::as_const(sessions))
+            emit session->promptListChanged();
+        break;
+    case KindCount:
+        return;
+    }
+    emit q->catalogChanged();
+}
+
+void QMcpProxy::Private::subscribe(const QUrl &uri)
+{
+    const auto it = upstreams.find(resourceUpstreams.value(uri.toString()));
+    if (it == upstreams.end())
+        return;
+    auto *upstream = it->second.get();
+    if (upstream->subscriptions.contains(uri.toString()))
+        return;
+    upstream->subscriptions.insert(uri.toString());
+    if (upstream->client->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
+        listen(upstream);
+        return;
+    }
+    QMcpSubscribeRequest request;
+    auto params = request.params();
+    params.setUri(uri);
+    request.setParams(params);
+    upstream->client->request(request, [prefix = upstream->prefix](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *error) {
+        if (error)
+            qCWarning(lcQMcpProxy) << prefix << "refused to subscribe:" << error->message();
+    });
+}
+
+void QMcpProxy::Private::unsubscribe(const QUrl &uri)
+{
+    const auto it = upstreams.find(resourceUpstreams.value(uri.toString()));
+    if (it == upstreams.end())
+        return;
+    auto *upstream = it->second.get();
+    if (!upstream->subscriptions.contains(uri.toString()))
+        return;
+    for (const auto *session : std::as_const(sessions)) {
+        if (session->isSubscribed(uri))
+            return;
+    }
+    upstream->subscriptions.remove(uri.toString());
+    if (upstream->client->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
+        listen(upstream);
+        return;
+    }
+    QMcpUnsubscribeRequest request;
+    auto params = request.params();
+    params.setUri(uri);
+    request.setParams(params);
+    upstream->client->request(request, [](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *) {});
+}
+
+QMcpProxy::QMcpProxy(QMcpServer *server)
+    : QObject(server)
+    , d(new Private(server, this))
+{}
+
+QMcpProxy::~QMcpProxy()
+{
+    // The clients go first, while what their callbacks use is still there.
+    d->upstreams.clear();
+}
+
+QMcpServer *QMcpProxy::server() const
+{
+    return d->server;
+}
+
+QString QMcpProxy::separator() const
+{
+    return d->separator;
+}
+
+void QMcpProxy::setSeparator(const QString &separator)
+{
+    if (d->separator == separator || separator.isEmpty())
+        return;
+    d->separator = separator;
+    for (int kind = 0; kind < KindCount; ++kind)
+        d->rebuild(Kind(kind));
+    emit separatorChanged(separator);
+}
+
+void QMcpProxy::addUpstream(const QString &prefix, QMcpClient *client)
+{
+    if (prefix.isEmpty() || prefix.contains(d->separator)) {
+        qCWarning(lcQMcpProxy) << "Invalid upstream prefix" << prefix;
+        return;
+    }
+    removeUpstream(prefix);
+
+    auto upstream = std::make_unique<Upstream>();
+    upstream->prefix = prefix;
+    upstream->client.reset(client);
+    client->setParent(nullptr);
+
+    connect(client, &QMcpClient::started, this, [this, client]() {
+        if (auto *upstream = d->find(client))
+            d->initialize(upstream);
+    });
+    connect(client, &QMcpClient::errorOccurred, this, [this, client](const QString &errorString) {
+        if (auto *upstream = d->find(client))
+            emit upstreamErrorOccurred(upstream->prefix, errorString);
+    });
+    client->addNotificationHandler([this, client](const QMcpToolListChangedNotification &) {
+        if (auto *upstream = d->find(client))
+            d->fetch(upstream, Tools);
+    });
+    client->addNotificationHandler([this, client](const QMcpResourceListChangedNotification &) {
+        if (auto *upstream = d->find(client))
+            d->fetch(upstream, Resources);
+    });
+    client->addNotificationHandler([this, client](const QMcpPromptListChangedNotification &) {
+        if (auto *upstream = d->find(client))
+            d->fetch(upstream, Prompts);
+    });
+    // The server sends it on to the sessions subscribed to the resource.
+    client->addNotificationHandler([this](const QMcpResourceUpdatedNotification &notification) {
+        QMcpResource resource;
+        resource.setUri(notification.params().uri());
+        d->server->notifyResourceUpdated(resource);
+    });
+
+    d->upstreams.emplace(prefix, std::move(upstream));
+}
+
+void QMcpProxy::removeUpstream(const QString &prefix)
+{
+    const auto it = d->upstreams.find(prefix);
+    if (it == d->upstreams.end())
+        return;
+    const bool hadCatalog = !it->second->tools.isEmpty() || !it->second->resources.isEmpty()
+            || !it->second->prompts.isEmpty();
+    d->upstreams.erase(it);
+    if (!hadCatalog)
+        return;
+    for (int kind = 0; kind < KindCount; ++kind)
+        d->rebuild(Kind(kind));
+}
+
+QStringList QMcpProxy::upstreams() const
+{
+    QStringList prefixes;
+    for (const auto &[prefix, upstream] : d->upstreams)
+        prefixes.append(prefix);
+    return prefixes;
+}
+
+QMcpClient *QMcpProxy::upstream(const QString &prefix) const
+{
+    const auto it = d->upstreams.find(prefix);
+    return it == d->upstreams.end() ? nullptr : it->second->client.get();
+}
+
+void QMcpProxy::refresh(const QString &prefix)
+{
+    for (const auto &[upstreamPrefix, upstream] : d->upstreams) {
+        if (!prefix.isEmpty() && upstreamPrefix != prefix)
+            continue;
+        for (int kind = 0; kind < KindCount; ++kind)
+            d->fetch(upstream.get(), Kind(kind));
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,133 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPPROXY_H
+#define QMCPPROXY_H
+
+#include <QtMcpProxy/qmcpproxyglobal.h>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+
+QT_BEGIN_NAMESPACE
+
+class QMcpClient;
+class QMcpServer;
+
+/*!
+    \class QMcpProxy
+    \inmodule QtMcpProxy
+    \brief The QMcpProxy class serves the tools, resources and prompts of many MCP servers through one.
+
+    Agents that each connect to every server they use open agents × servers
+    connections. A proxy in front of the servers holds one connection to
+    each, its upstreams, shared by all the clients connected to its own
+    server, so that the count becomes agents + servers.
+
+    Every upstream is added under a prefix. The proxy's server lists the
+    upstreams' tools and prompts with their names prefixed, as in
+    \c{github__create_issue}, and routes calls and prompt requests by that
+    prefix. Resources keep their URIs, which clients may have stored, and
+    only get their names prefixed; reads are routed by the URI. What the
+    server offers itself, through tool sets, stays available next to it.
+
+    The catalogs of the upstreams are fetched once they are started and
+    kept; lists are answered from them without asking upstream. An upstream
+    that announces a changed list is asked again, and the change is passed
+    on to the clients. So are updates of resources a client subscribed to,
+    for which the proxy subscribes upstream on the first client's behalf.
+
+    \code
+    auto server = new QMcpServer("streamablehttp"_L1, this);
+    auto proxy = new QMcpProxy(server);
+
+    auto github = new QMcpClient("stdio"_L1);
+    proxy->addUpstream("github"_L1, github);
+    github->start("github-mcp-server stdio"_L1);
+
+    server->start("127.0.0.1:8000"_L1);
+    \endcode
+
+    Upstreams answer requests in any order, so one slow tool call does not
+    hold up others to the same upstream. A request an upstream answers with
+    a JSON-RPC error is answered with that error; one still open when its
+    upstream is removed, with QMcpServer::InternalErrorCode.
+    Tool calls to the server's own tools do not use the tasks extension
+    while a proxy is installed.
+*/
+class Q_MCPPROXY_EXPORT QMcpProxy : public QObject
+{
+    Q_OBJECT
+
+    /*!
+        \property QMcpProxy::separator
+        This property holds what goes between an upstream's prefix and the
+        names of its tools, prompts and resources. The default, \c{__},
+        keeps names within what model APIs accept for tool names.
+    */
+    Q_PROPERTY(QString separator READ separator WRITE setSeparator NOTIFY separatorChanged FINAL)
+
+public:
+    /*!
+        Constructs a proxy serving through \a server, whose child it
+        becomes. The server's handlers for listing and using tools,
+        resources and prompts are replaced.
+    */
+    explicit QMcpProxy(QMcpServer *server);
+    ~QMcpProxy() override;
+
+    QMcpServer *server() const;
+    QString separator() const;
+
+    /*!
+        Adds \a client as the upstream for \a prefix, which must not contain
+        separator(). The proxy takes ownership of the client, initializes it
+        once it started and then fetches its catalog. Add the client before
+        starting it.
+
+        An upstream already added under \a prefix is replaced.
+    */
+    void addUpstream(const QString &prefix, QMcpClient *client);
+
+    /*!
+        Removes and destroys the upstream for \a prefix. Requests it still
+        owes answers for are left unanswered.
+    */
+    void removeUpstream(const QString &prefix);
+
+    QStringList upstreams() const;
+    QMcpClient *upstream(const QString &prefix) const;
+
+public slots:
+    void setSeparator(const QString &separator);
+
+    /*!
+        Fetches the catalog of the upstream for \a prefix anew, or of all
+        upstreams if \a prefix is empty.
+    */
+    void refresh(const QString &prefix = QString());
+
+signals:
+    void separatorChanged(const QString &separator);
+
+    /*!
+        Emitted when the tools, resources or prompts of an upstream changed,
+        after the clients of the server were told so.
+    */
+    void catalogChanged();
+
+    /*!
+        Emitted when the upstream for \a prefix failed to start or to
+        initialize.
+        \param prefix The prefix of the upstream
+        \param errorString Description of the error
+    */
+    void upstreamErrorOccurred(const QString &prefix, const QString &errorString);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPPROXY_H
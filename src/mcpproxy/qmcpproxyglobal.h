@@ -0,0 +1,15 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPPROXYGLOBAL_H
+#define QMCPPROXYGLOBAL_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qglobal.h>
+#include <QtCore/qdebug.h>
+#include <QtMcpProxy/qtmcpproxyexports.h>
+#include <QtMcpCommon/QMcpGadget>
+
+using namespace Qt::Literals::StringLiterals;
+
+#endif // QMCPPROXYGLOBAL_H
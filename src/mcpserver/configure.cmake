@@ -17,4 +17,17 @@
 
 #### Features
 
-
+# QMcpAbstractHttpServer speaks HTTP/2 through QtNetwork's private
+# QHttp2Connection, whose API only holds for the Qt releases it was
+# checked against.
+qt_feature("mcp-h2c" PRIVATE
+    LABEL "HTTP/2 cleartext (h2c) server"
+    PURPOSE "Lets QMcpAbstractHttpServer serve HTTP/2 over cleartext, with prior knowledge or by upgrade."
+    AUTODETECT OFF
+    CONDITION QT_FEATURE_http AND Qt6Network_VERSION VERSION_GREATER_EQUAL 6.8
+        AND Qt6Network_VERSION VERSION_LESS 6.12
+)
+
+qt_configure_add_summary_section(NAME "Qt MCP Server")
+qt_configure_add_summary_entry(ARGS "mcp-h2c")
+qt_configure_end_summary_section()
@@ -1,64 +1,531 @@
 #include "qmcpabstracthttpserver.h"
+#include "qmcphttprequestparser_p.h"
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QHttpHeaders>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
-#include <QtCore/QMap>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <QtMcpCommon/private/qmcpcompression_p.h>
+#include <QtMcpCommon/private/qmcptracer_p.h>
+#include <QtMcpServer/private/qtmcpserver-config_p.h>
+#if QT_CONFIG(mcp_h2c)
+#include <QtNetwork/QHttp2Configuration>
+#include <QtNetwork/private/hpack_p.h>
+#include <QtNetwork/private/http2protocol_p.h>
+#include <QtNetwork/private/qhttp2connection_p.h>
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <memory>
+
+namespace {
+
+// Once this much is buffered but not read, the socket stops reading, so a
+// client pipelining requests behind a slow one is held back by TCP instead
+// of filling memory.
+constexpr qint64 ReadBufferSize = 256 * 1024;
+// Bounds the (method, path) -> slot cache against clients probing paths.
+constexpr qsizetype MaxRouteCacheSize = 256;
+
+// Off unless asked for: a client keeping a connection open between requests
+// is not misbehaving, and closing it would change what existing servers do.
+constexpr int DefaultIdleTimeoutMs = 0;
+// Long enough for any client on any link; a client trickling its headers
+// in slower than this is holding the connection, not sending a request.
+constexpr int DefaultReadHeaderTimeoutMs = 30 * 1000;
+// Gathered output is written out early once this much is pending, so a
+// large response does not wait for the end of the event loop iteration.
+constexpr qsizetype DefaultWriteCoalescingThreshold = 64 * 1024;
+// Below about a packet, compressing saves no round trip and costs time.
+constexpr qsizetype DefaultCompressionThreshold = 1024;
+
+#if QT_CONFIG(mcp_h2c)
+// What a client speaking HTTP/2 with prior knowledge sends first.
+constexpr QByteArrayView Http2Preface("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+constexpr qsizetype Http2FrameHeaderSize = 9;
+// The frame size every peer takes before SETTINGS say otherwise.
+constexpr qsizetype Http2DefaultMaxFrameSize = 16 * 1024;
+constexpr quint8 Http2HeadersFrame = 0x1;
+constexpr quint8 Http2ContinuationFrame = 0x9;
+constexpr quint8 Http2EndStreamFlag = 0x1;
+constexpr quint8 Http2EndHeadersFlag = 0x4;
+#endif
+
+QByteArray statusText(int statusCode)
+{
+    switch (statusCode) {
+    case 101: return "Switching Protocols"_ba;
+    case 200: return "OK"_ba;
+    case 202: return "Accepted"_ba;
+    case 400: return "Bad Request"_ba;
+    case 403: return "Forbidden"_ba;
+    case 404: return "Not Found"_ba;
+    case 405: return "Method Not Allowed"_ba;
+    case 408: return "Request Timeout"_ba;
+    case 413: return "Content Too Large"_ba;
+    case 414: return "URI Too Long"_ba;
+    case 415: return "Unsupported Media Type"_ba;
+    case 431: return "Request Header Fields Too Large"_ba;
+    case 501: return "Not Implemented"_ba;
+    case 505: return "HTTP Version Not Supported"_ba;
+    default: return "Unknown"_ba;
+    }
+}
+
+#if QT_CONFIG(mcp_h2c)
+
+/*!
+    \internal
+    Appends \a value as an HPACK integer (RFC 7541, 5.1) with a prefix of
+    \a prefixBits bits; \a flags fills the bits of the first byte above it.
+*/
+void appendHpackInteger(QByteArray *out, quint32 value, int prefixBits, quint8 flags)
+{
+    const quint32 max = (1u << prefixBits) - 1;
+    if (value < max) {
+        out->append(char(flags | value));
+        return;
+    }
+    out->append(char(flags | max));
+    value -= max;
+    while (value >= 0x80) {
+        out->append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->append(char(value));
+}
+
+/*!
+    \internal
+    Appends the field \a name: \a value as a literal without indexing and
+    without Huffman coding. It leaves the decoder's dynamic table alone,
+    which has to stay in step with what the client encodes.
+*/
+void appendHpackLiteral(QByteArray *out, QByteArrayView name, QByteArrayView value)
+{
+    out->append('\0');
+    appendHpackInteger(out, quint32(name.size()), 7, 0);
+    out->append(name);
+    appendHpackInteger(out, quint32(value.size()), 7, 0);
+    out->append(value);
+}
+
+void appendHttp2Frame(QByteArray *out, quint8 type, quint8 flags, quint32 streamId, QByteArrayView payload)
+{
+    const auto size = quint32(payload.size());
+    const char header[Http2FrameHeaderSize] = {
+        char(size >> 16), char(size >> 8), char(size),
+        char(type), char(flags),
+        char(streamId >> 24), char(streamId >> 16), char(streamId >> 8), char(streamId),
+    };
+    out->append(header, Http2FrameHeaderSize);
+    out->append(payload);
+}
+
+/*!
+    \internal
+    Returns whether \a name is one of the fields that only make sense on
+    an HTTP/1.1 connection and must not appear in HTTP/2 (RFC 9113, 8.2.2).
+*/
+bool isConnectionSpecific(QByteArrayView name)
+{
+    static const QByteArrayView names[] = {
+        "connection", "http2-settings", "keep-alive", "proxy-connection", "te",
+        "transfer-encoding", "upgrade",
+    };
+    return std::find(std::begin(names), std::end(names), name) != std::end(names);
+}
+
+bool hasToken(QByteArrayView list, QByteArrayView token)
+{
+    const auto elements = list.toByteArray().split(',');
+    return std::any_of(elements.cbegin(), elements.cend(), [token](const QByteArray &element) {
+        return element.trimmed().compare(token, Qt::CaseInsensitive) == 0;
+    });
+}
+
+/*!
+    \internal
+    Returns whether \a request asks to go on in HTTP/2 over cleartext.
+*/
+bool isH2cUpgrade(const QMcpHttpRequestParser::Request &request)
+{
+    return request.minorVersion == 1
+            && hasToken(request.headers.combinedValue(QHttpHeaders::WellKnownHeader::Upgrade), "h2c")
+            && hasToken(request.headers.combinedValue(QHttpHeaders::WellKnownHeader::Connection), "upgrade")
+            && request.headers.contains("http2-settings"_L1);
+}
+
+/*!
+    \internal
+    Returns the HTTP/1.1 \a request that asked for h2c as the HEADERS of
+    stream 1, which carries its response after the upgrade (RFC 7540,
+    3.2). Its body is not part of them.
+*/
+QByteArray upgradeRequestFrames(const QMcpHttpRequestParser::Request &request)
+{
+    QByteArray block;
+    appendHpackLiteral(&block, ":method", request.method);
+    appendHpackLiteral(&block, ":scheme", "http");
+    appendHpackLiteral(&block, ":path",
+                       request.query.isEmpty() ? request.path
+                                               : QByteArray(request.path + '?' + request.query));
+    const auto host = request.headers.value(QHttpHeaders::WellKnownHeader::Host);
+    if (!host.isEmpty())
+        appendHpackLiteral(&block, ":authority", host);
+    for (qsizetype i = 0; i < request.headers.size(); ++i) {
+        const auto name = request.headers.nameAt(i);
+        const QByteArrayView field(name.data(), name.size());
+        // Host became :authority; the body's length is told with the body.
+        if (!isConnectionSpecific(field) && field != "host" && field != "content-length")
+            appendHpackLiteral(&block, field, request.headers.valueAt(i));
+    }
+
+    QByteArray frames;
+    qsizetype pos = 0;
+    do {
+        const auto fragment = QByteArrayView(block).sliced(pos, qMin(Http2DefaultMaxFrameSize, block.size() - pos));
+        const bool first = pos == 0;
+        pos += fragment.size();
+        quint8 flags = pos == block.size() ? Http2EndHeadersFlag : 0;
+        if (first)
+            flags |= Http2EndStreamFlag;
+        appendHttp2Frame(&frames, first ? Http2HeadersFrame : Http2ContinuationFrame, flags, 1, fragment);
+    } while (pos < block.size());
+    return frames;
+}
+
+/*!
+    \internal
+    The device a QHttp2Connection speaks through: it is fed what the socket
+    received and hands what is written on to the server's output, so that
+    HTTP/2 frames are gathered like any other response.
+
+    After an h2c upgrade, \a splice, the frames standing for the upgraded
+    request, is passed on right after the client preface and its SETTINGS,
+    as if the client had sent it.
+*/
+class Http2Pipe : public QIODevice
+{
+public:
+    Http2Pipe(std::function<void(QByteArrayView)> sink, std::function<void()> closed, QByteArray splice)
+        : m_sink(std::move(sink))
+        , m_closed(std::move(closed))
+        , m_splice(std::move(splice))
+    {
+        QIODevice::open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+    }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return m_buffer.size() - m_pos; }
+
+    void feed(QByteArrayView data)
+    {
+        if (m_splice.isEmpty()) {
+            append(data);
+            return;
+        }
+        m_held.append(data);
+        const qsizetype settingsAt = Http2Preface.size();
+        if (m_held.size() < settingsAt + Http2FrameHeaderSize)
+            return;
+        const auto *length = reinterpret_cast<const uchar *>(m_held.constData() + settingsAt);
+        const qsizetype settingsEnd = settingsAt + Http2FrameHeaderSize
+                + ((qsizetype(length[0]) << 16) | (length[1] << 8) | length[2]);
+        if (m_held.size() < settingsEnd)
+            return;
+        append(QByteArrayView(m_held).first(settingsEnd));
+        append(std::exchange(m_splice, {}));
+        append(QByteArrayView(m_held).sliced(settingsEnd));
+        m_held.clear();
+    }
+
+    void close() override
+    {
+        QIODevice::close();
+        if (m_closed)
+            m_closed();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const auto size = qMin(maxSize, bytesAvailable());
+        memcpy(data, m_buffer.constData() + m_pos, size_t(size));
+        m_pos += size;
+        return size;
+    }
+
+    qint64 writeData(const char *data, qint64 size) override
+    {
+        m_sink(QByteArrayView(data, size));
+        return size;
+    }
+
+private:
+    void append(QByteArrayView data)
+    {
+        // What was read is dropped before the buffer grows.
+        if (m_pos > 0) {
+            m_buffer.remove(0, m_pos);
+            m_pos = 0;
+        }
+        m_buffer.append(data);
+    }
+
+    std::function<void(QByteArrayView)> m_sink;
+    std::function<void()> m_closed;
+    QByteArray m_splice;
+    QByteArray m_held;
+    QByteArray m_buffer;
+    qsizetype m_pos = 0;
+};
+#endif // QT_CONFIG(mcp_h2c)
+
+} // namespace
 
 class QMcpAbstractHttpServer::Private
 {
 public:
+    struct Connection;
+    // Connections a timeout applies to wait in one of two queues. Within a
+    // queue every connection has the same timeout, so ordering by the time
+    // it was queued orders by deadline, and a sweep looks at the front only.
+    using TimeoutQueue = std::list<Connection *>;
+    using Headers = QList<std::pair<QByteArray, QByteArray>>;
+#if QT_CONFIG(mcp_h2c)
+    struct Http2;
+#endif
+
+    struct Connection {
+        QTcpSocket *socket = nullptr;
+        QMcpHttpRequestParser parser;
+        // The request being answered; later pipelined ones wait in the
+        // parser until its response is out, so responses keep their order.
+        QNetworkRequest request;
+        // deferResponse() or SSE id while the connection is taken over.
+        QUuid id;
+        bool sse = false;
+        bool busy = false;
+        bool closeAfterResponse = false;
+        qint64 traceStartNs = -1;   // When the request's first bytes arrived
+        // Written but not handed to the socket yet.
+        QByteArray output;
+        // What the current request's Accept-Encoding asks responses in.
+        QMcpCompression::Encoding encoding = QMcpCompression::Encoding::Identity;
+        // Set while an SSE stream is sent compressed.
+        std::unique_ptr<QMcpStreamCompressor> sseCompressor;
+        // The request body was worth compressing but was not; the response
+        // tells the client it may.
+        bool advertiseEncoding = false;
+#if QT_CONFIG(mcp_h2c)
+        // Whether the first bytes may still turn out an HTTP/2 preface.
+        bool probing = false;
+        QByteArray probe;
+        // Set once the connection speaks HTTP/2.
+        std::unique_ptr<Http2> http2;
+#endif
+
+        // A Connection also stands for each stream of an HTTP/2 one; that
+        // is how requests on it are answered like any other.
+        bool isStream = false;
+#if QT_CONFIG(mcp_h2c)
+        // Reset once the stream closed.
+        QHttp2Stream *stream = nullptr;
+        QMcpHttpRequestParser::Request streamRequest;
+        // A stream sends one DATA at a time; what comes meanwhile waits.
+        QByteArray streamOutput;
+        bool streamEnd = false;
+        bool streamSending = false;
+        // Its response was sent in full.
+        bool done = false;
+#endif
+        TimeoutQueue *queue = nullptr;
+        TimeoutQueue::iterator queuePos;
+        qint64 queuedAt = 0;
+    };
+
+#if QT_CONFIG(mcp_h2c)
+    struct Http2 {
+        ~Http2() { qDeleteAll(streams); }
+
+        std::unique_ptr<Http2Pipe> pipe;
+        // Owned by the pipe, as are its streams.
+        QHttp2Connection *session = nullptr;
+        QHash<QHttp2Stream *, Connection *> streams;
+        // The body of the request that asked for the upgrade, stream 1's.
+        QByteArray upgradeBody;
+    };
+#endif
+
     Private(QMcpAbstractHttpServer *parent);
+    ~Private();
     void handleNewConnection();
     void handleDisconnected(QTcpSocket *socket);
-    void parseHttpRequest(QTcpSocket *socket);
+    void removeConnection(Connection *connection);
+    void processRequests(QTcpSocket *socket);
+    void dispatch(Connection *connection, QMcpHttpRequestParser::Request &&request);
+    void responseDone(QTcpSocket *socket);
+#if QT_CONFIG(mcp_h2c)
+    void startHttp2(Connection *connection, const QByteArray &splice = {});
+    void upgradeToHttp2(Connection *connection, QMcpHttpRequestParser::Request &&request);
+    void processHttp2(Connection *connection, const QByteArray &received);
+    void updateHttp2Connection(Connection *connection);
+    Connection *findStream(QTcpSocket *socket, QHttp2Stream *stream) const;
+    void addStream(QTcpSocket *socket, QHttp2Stream *stream);
+    void receiveHeaders(Connection *connection, const HPack::HttpHeader &fields, bool endStream);
+    void receiveData(Connection *connection, const QByteArray &data, bool endStream);
+    void dispatchStream(Connection *connection);
+    void streamClosed(QTcpSocket *socket, QHttp2Stream *stream);
+    void removeStream(Connection *connection);
+    void sendStreamHeaders(Connection *connection, int statusCode, const Headers &headers, bool end);
+    void sendStreamData(Connection *connection, const QByteArray &data, bool end);
+    void endStream(Connection *connection);
+#endif
+    void updateTimeout(Connection *connection);
+    void dequeue(Connection *connection);
+    void scheduleSweep();
+    void sweep();
+    void resumeAccepting();
+    int route(const QByteArray &method, const QString &path);
+    bool decodeBody(Connection *connection, QMcpHttpRequestParser::Request *request);
+    QByteArray encodeBody(Connection *connection, const QByteArray &body,
+                          QByteArrayView contentType, Headers *headers);
+    void respond(Connection *connection, int statusCode, const QByteArray &body,
+                 QByteArrayView contentType, const Headers &extraHeaders = {});
+    void startSse(Connection *connection, const Headers &extraHeaders);
     void sendHttpResponse(QTcpSocket *socket, const QByteArray &data,
                          const QString &contentType = QStringLiteral("text/plain"),
-                         int statusCode = 200);
+                         int statusCode = 200, bool close = false);
+    void write(QTcpSocket *socket, const QByteArray &data);
+    void writeSse(Connection *connection, const QByteArray &data);
+    void flush(Connection *connection);
+    void flushAll();
 
 private:
     QMcpAbstractHttpServer *q;
 public:
     QTcpServer *server = nullptr;
-    struct ParseData {
-        QByteArray data;
-        QNetworkRequest request;
-        int indexOfMethod = -1;
-        qint64 contentLength = -1;  // Store expected content length
-    };
+    QMetaObject::Connection serverConnection;
 
-    QMap<QTcpSocket*, ParseData> dataMap;
-    QMap<QUuid, QTcpSocket*> sessions;
-    QMap<QUuid, QTcpSocket*> deferred;
+    QHash<QTcpSocket *, Connection *> connections;
+    // Deferred and SSE connections by their id.
+    QHash<QUuid, Connection *> exchanges;
 
     // The socket whose request slot is currently running. The connection
     // cannot be identified by its QNetworkRequest alone because two clients
     // may issue byte-identical requests concurrently.
     QTcpSocket *currentSocket = nullptr;
+    // The HTTP/2 stream of currentSocket whose request slot runs, if any.
+    Connection *currentStream = nullptr;
     // Set by deferResponse() while currentSocket's slot runs, so that the
     // automatic response stays suppressed even when the slot already answered
     // synchronously through completeResponse().
     bool responseTakenOver = false;
+
+    // Explicit routes, "METHOD /path" -> slot name, taking precedence over
+    // the slot name derived from the path.
+    QHash<QByteArray, QByteArray> routes;
+    // Built once from the meta object: slot name -> method index.
+    QHash<QByteArray, int> slotIndexes;
+    // "METHOD /path" -> method index of the requests seen so far.
+    QHash<QByteArray, int> routeCache;
+
+    qsizetype maxHeaderSize = QMcpHttpRequestParser::DefaultMaxHeaderSize;
+    qint64 maxBodySize = QMcpHttpRequestParser::DefaultMaxBodySize;
+    int maxConnections = 0;
+    bool acceptPaused = false;
+
+    // Waiting for the next request, or for more of a request body.
+    TimeoutQueue idleQueue;
+    // Begun a request whose headers are not complete yet.
+    TimeoutQueue headerQueue;
+    int idleTimeout = DefaultIdleTimeoutMs;
+    int readHeaderTimeout = DefaultReadHeaderTimeoutMs;
+    QElapsedTimer clock;
+    QTimer sweepTimer;
+
+    bool draining = false;
+    QTimer drainTimer;
+
+    // Connections with output gathered, written out together by flushTimer.
+    QSet<Connection *> unflushed;
+    QTimer flushTimer;
+    int writeCoalescingDelay = 0;
+    qsizetype writeCoalescingThreshold = DefaultWriteCoalescingThreshold;
+
+    qsizetype compressionThreshold = DefaultCompressionThreshold;
+#if QT_CONFIG(mcp_h2c)
+    bool http2Enabled = true;
+#endif
+
+    quint64 bytesReceived = 0;
+    quint64 bytesSent = 0;
 };
 
 QMcpAbstractHttpServer::Private::Private(QMcpAbstractHttpServer *parent)
     : q(parent)
-{}
+{
+    clock.start();
+    sweepTimer.setSingleShot(true);
+    connect(&sweepTimer, &QTimer::timeout, q, [this]() { sweep(); });
+    flushTimer.setSingleShot(true);
+    connect(&flushTimer, &QTimer::timeout, q, [this]() { flushAll(); });
+    drainTimer.setSingleShot(true);
+    connect(&drainTimer, &QTimer::timeout, q, [this]() {
+        // What did not finish in time is cut off.
+        const auto sockets = connections.keys();
+        for (QTcpSocket *socket : sockets)
+            socket->abort();
+    });
+}
+
+QMcpAbstractHttpServer::Private::~Private()
+{
+    // Out of the map first: what a connection's destruction sets off finds
+    // nothing to act on.
+    qDeleteAll(std::exchange(connections, {}));
+}
 
 void QMcpAbstractHttpServer::Private::handleNewConnection()
 {
-    while (QTcpSocket *socket = server->nextPendingConnection()) {
-        dataMap.insert(socket, ParseData());
+    while (!draining && (maxConnections <= 0 || connections.size() < maxConnections)) {
+        QTcpSocket *socket = server->nextPendingConnection();
+        if (!socket)
+            return;
+        auto *connection = new Connection;
+        connection->socket = socket;
+        connection->parser.setMaxHeaderSize(maxHeaderSize);
+        connection->parser.setMaxBodySize(maxBodySize);
+#if QT_CONFIG(mcp_h2c)
+        connection->probing = http2Enabled;
+#endif
+        connections.insert(socket, connection);
+        socket->setReadBufferSize(ReadBufferSize);
         connect(socket, &QTcpSocket::readyRead, q, [this, socket]() {
-            parseHttpRequest(socket);
+            processRequests(socket);
         });
         connect(socket, &QTcpSocket::disconnected, q, [this, socket]() {
             handleDisconnected(socket);
         });
 
         if (socket->bytesAvailable() > 0)
-            parseHttpRequest(socket);
+            processRequests(socket);
+        else
+            updateTimeout(connection);
+    }
+    // At the limit, further clients wait in the listen backlog rather than
+    // being accepted only to find nobody serving them.
+    if (!draining && !acceptPaused) {
+        server->pauseAccepting();
+        acceptPaused = true;
     }
 }
 
@@ -67,127 +534,211 @@ void QMcpAbstractHttpServer::Private::handleDisconnected(QTcpSocket *socket)
     if (!socket)
         return;
 
-    if (dataMap.contains(socket)) {
-        dataMap.remove(socket);
+    if (auto *connection = connections.value(socket)) {
+        QList<QUuid> ids;
+        if (!connection->id.isNull())
+            ids.append(std::exchange(connection->id, QUuid()));
+#if QT_CONFIG(mcp_h2c)
+        if (connection->http2) {
+            for (const auto *stream : std::as_const(connection->http2->streams)) {
+                if (!stream->id.isNull() && !stream->done)
+                    ids.append(stream->id);
+            }
+        }
+#endif
+        removeConnection(connection);
+        // Deferred and SSE connections are tracked by UUID; tell the subclass
+        // the peer went away, e.g. to treat it as cancellation (2026-07-28).
+        for (const auto &id : std::as_const(ids))
+            emit q->connectionClosed(id);
     }
     if (currentSocket == socket)
         currentSocket = nullptr;
 
-    // Deferred and SSE connections are tracked by UUID; tell the subclass the
-    // peer went away, e.g. to treat it as cancellation (2026-07-28).
-    auto id = deferred.key(socket);
-    if (!id.isNull()) {
-        deferred.remove(id);
-        emit q->connectionClosed(id);
-    }
-    id = sessions.key(socket);
-    if (!id.isNull()) {
-        sessions.remove(id);
-        emit q->connectionClosed(id);
-    }
-
     socket->deleteLater();
 }
 
-void QMcpAbstractHttpServer::Private::parseHttpRequest(QTcpSocket *socket)
+/*!
+    \internal
+    Forgets \a connection. Everything it is known by points back at it, so
+    this costs the same however many connections are open.
+*/
+void QMcpAbstractHttpServer::Private::removeConnection(Connection *connection)
 {
-    const auto mo = q->metaObject();
-
-    ParseData &data = dataMap[socket];
-    data.data.append(socket->readAll());
-
-    if (!data.request.url().isValid()) {
-        int cr = data.data.indexOf('\r');
-        int lf = data.data.indexOf('\n');
-        if (lf < 0) {
-            return;
+    dequeue(connection);
+    unflushed.remove(connection);
+    if (!connection->id.isNull())
+        exchanges.remove(connection->id);
+#if QT_CONFIG(mcp_h2c)
+    if (connection->http2) {
+        for (auto *stream : std::as_const(connection->http2->streams)) {
+            if (!stream->id.isNull())
+                exchanges.remove(stream->id);
+            if (currentStream == stream)
+                currentStream = nullptr;
         }
-        if (cr + 1 != lf) {
-            qWarning() << cr << lf << data.data;
-        }
-        // Parse request line
-        const QList<QByteArray> requestLine = data.data.left(cr).split(' ');
-        if (requestLine.size() < 3) {
-            qWarning() << requestLine;
-            return;
+    }
+#endif
+    connections.remove(connection->socket);
+    delete connection;
+
+    if (draining) {
+        if (connections.isEmpty()) {
+            drainTimer.stop();
+            emit q->drained();
         }
+    } else if (acceptPaused && server) {
+        resumeAccepting();
+    }
+}
 
-        QByteArray method = requestLine.at(0).trimmed();
-        QByteArray path = requestLine.at(1).trimmed();
-
-        // parse headers
-        QHttpHeaders headers;
-        int prevLf = 0;
-        while (prevLf < data.data.length()) {
-            prevLf = lf + 1;
-            cr = data.data.indexOf('\r', prevLf);
-            lf = data.data.indexOf('\n', prevLf);
-            if (cr + 1 != lf) {
-                qWarning() << cr << lf << prevLf << data.data;
-            }
-            if (cr == prevLf)
-                break;
+void QMcpAbstractHttpServer::Private::resumeAccepting()
+{
+    acceptPaused = false;
+    server->resumeAccepting();
+    // Clients that queued up meanwhile are taken first.
+    QMetaObject::invokeMethod(q, [this, server = QPointer<QTcpServer>(server)]() {
+        if (server && server == this->server && server->hasPendingConnections())
+            handleNewConnection();
+    }, Qt::QueuedConnection);
+}
 
-            QByteArray header = data.data.mid(prevLf, cr - prevLf);
-            int colon = header.indexOf(':');
-            if (colon < 0) {
-                continue;
-            }
-            headers.append(QString::fromLatin1(header.left(colon)), QString::fromUtf8(header.mid(colon + 1).trimmed()));
-        }
+// Reads what arrived and answers every complete request, in order, until one
+// is deferred; the rest wait until its response went out.
+void QMcpAbstractHttpServer::Private::processRequests(QTcpSocket *socket)
+{
+    auto *connection = connections.value(socket);
+    if (!connection)
+        return;
+#if QT_CONFIG(mcp_h2c)
+    if (connection->http2) {
+        const auto received = socket->readAll();
+        bytesReceived += received.size();
+        processHttp2(connection, received);
+        return;
+    }
+#endif
+    if (connection->busy)
+        return;
 
-        // Extract Content-Length if present
-        if (headers.contains("Content-Length"_L1)) {
-            bool ok;
-            const auto contentLengthStr = headers.value("Content-Length"_L1);
-            data.contentLength = contentLengthStr.toLongLong(&ok);
-            if (!ok) {
-                data.contentLength = -1;  // No valid Content-Length header
+    auto received = socket->readAll();
+    if (!received.isEmpty()) {
+        bytesReceived += received.size();
+        if (connection->traceStartNs < 0 && QMcpTracer::isEnabled())
+            connection->traceStartNs = QMcpTracer::now();
+#if QT_CONFIG(mcp_h2c)
+        if (connection->probing) {
+            // A client speaking HTTP/2 with prior knowledge starts with the
+            // preface instead of a request.
+            connection->probe += received;
+            const auto size = qMin(connection->probe.size(), Http2Preface.size());
+            if (QByteArrayView(connection->probe).first(size) == Http2Preface.first(size)) {
+                if (size < Http2Preface.size()) {
+                    updateTimeout(connection);
+                    return;
+                }
+                const auto preface = std::exchange(connection->probe, {});
+                startHttp2(connection);
+                processHttp2(connection, preface);
+                return;
             }
+            connection->probing = false;
+            received = std::exchange(connection->probe, {});
         }
+#endif
+        connection->parser.feed(received);
+    }
 
-        QUrl url;
-        int question = path.indexOf('?');
-        if (question < 0) {
-            url.setPath(QString::fromUtf8(path));
-        } else {
-            url.setPath(QString::fromUtf8(path.left(question)));
-            url.setQuery(QString::fromUtf8(path.mid(question + 1)));
-        }
-
-        data.request = QNetworkRequest(url);
-        data.request.setHeaders(headers);
-        data.data = data.data.remove(0, prevLf + 2);
-
-        QByteArray slotName = method.toLower();
-        const auto pathElements = url.path().split("/"_L1, Qt::SkipEmptyParts);
-        for (const auto &pe : pathElements) {
-            slotName += pe.toUpper().toUtf8().at(0);
-            slotName += pe.toUtf8().mid(1).toLower();
-        }
+    while (true) {
+        // A slot may have closed the connection, or deferred its response;
+        // a request may have upgraded it to HTTP/2.
+        connection = connections.value(socket);
+        if (!connection || connection->busy)
+            return;
+#if QT_CONFIG(mcp_h2c)
+        if (connection->http2)
+            return;
+#endif
 
-        for (int i = mo->methodOffset(); i < mo->methodCount(); i++) {
-            if (mo->method(i).name() == slotName) {
-                data.indexOfMethod = i;
-                break;
-            }
+        switch (connection->parser.parse()) {
+        case QMcpHttpRequestParser::Status::NeedMoreData:
+            updateTimeout(connection);
+            return;
+        case QMcpHttpRequestParser::Status::Error:
+            // The framing is lost; nothing after this can be trusted.
+            connection->busy = true;
+            dequeue(connection);
+            sendHttpResponse(socket, connection->parser.errorString(), QStringLiteral("text/plain"),
+                             connection->parser.errorStatusCode(), true);
+            flush(connection);
+            socket->disconnectFromHost();
+            return;
+        case QMcpHttpRequestParser::Status::RequestReady:
+#if QT_CONFIG(mcp_h2c)
+            connection->probing = false;
+#endif
+            dispatch(connection, connection->parser.takeRequest());
+            break;
         }
     }
+}
+
+void QMcpAbstractHttpServer::Private::dispatch(Connection *connection, QMcpHttpRequestParser::Request &&request)
+{
+    auto &data = *connection;
+    auto *socket = data.socket;
 
-    // Check if we have received all expected data. data.data holds the body
-    // only; the request line and headers were stripped above.
-    if (data.contentLength >= 0 && data.data.size() < data.contentLength) {
-        return;  // Wait for more data
+    QUrl url;
+    url.setPath(QString::fromUtf8(request.path), QUrl::TolerantMode);
+    if (!request.query.isEmpty())
+        url.setQuery(QString::fromUtf8(request.query));
+    data.closeAfterResponse = !request.keepAlive || draining;
+    data.encoding = compressionThreshold < 0
+            ? QMcpCompression::Encoding::Identity
+            : QMcpCompression::negotiate(request.headers.value(QHttpHeaders::WellKnownHeader::AcceptEncoding));
+    const auto traceStartNs = std::exchange(data.traceStartNs, -1);
+    // Bytes of the next request may already be waiting behind this one.
+    if (data.parser.hasPendingData() && QMcpTracer::isEnabled())
+        data.traceStartNs = QMcpTracer::now();
+#if QT_CONFIG(mcp_h2c)
+    // Not when more requests were pipelined behind: they are HTTP/1.1.
+    if (http2Enabled && !data.isStream && !data.parser.hasPendingData() && isH2cUpgrade(request)) {
+        upgradeToHttp2(connection, std::move(request));
+        return;
     }
+#endif
+    if (!decodeBody(connection, &request))
+        return;
+    data.request = QNetworkRequest(url);
+    data.request.setHeaders(std::move(request.headers));
 
-    if (data.indexOfMethod < 0) {
-        sendHttpResponse(socket, "Not Found"_ba, QStringLiteral("text/plain"), 404);
+    const int indexOfMethod = route(request.method, url.path());
+    if (indexOfMethod < 0) {
+        respond(connection, 404, "Not Found"_ba, "text/plain");
+        if (!data.isStream)
+            responseDone(socket);
         return;
     }
 
-    auto mm = mo->method(data.indexOfMethod);
+    const auto mo = q->metaObject();
+
+    // Everything the slot does, up to handing a message to the server, is
+    // part of this request's trace.
+    QMcpTraceScope traceScope(traceStartNs);
+    if (traceScope.trace() && traceStartNs >= 0) {
+        QMcpTracer::addSpan(traceScope.trace(), "http.parse"_ba, traceStartNs, QMcpTracer::now(),
+                            { { "http.target"_ba, url.path() },
+                              { "http.handler"_ba, QString::fromLatin1(mo->method(indexOfMethod).name()) } });
+    }
+
+    auto mm = mo->method(indexOfMethod);
+    const auto networkRequest = data.request;
     QByteArray ret;
+#if QT_CONFIG(mcp_h2c)
+    auto *stream = data.stream;
+#endif
     currentSocket = socket;
+    currentStream = data.isStream ? connection : nullptr;
     responseTakenOver = false;
     switch (mm.parameterCount()) {
     case 0:
@@ -200,54 +751,681 @@ void QMcpAbstractHttpServer::Private::parseHttpRequest(QTcpSocket *socket)
         mm.invoke(q
                   , Qt::DirectConnection
                   , Q_RETURN_ARG(QByteArray, ret)
-                  , Q_ARG(QNetworkRequest, data.request)
+                  , Q_ARG(QNetworkRequest, networkRequest)
                   );
         break;
     case 2:
         mm.invoke(q
                   , Qt::DirectConnection
                   , Q_RETURN_ARG(QByteArray, ret)
-                  , Q_ARG(QNetworkRequest, data.request)
-                  , Q_ARG(QByteArray, data.data)
+                  , Q_ARG(QNetworkRequest, networkRequest)
+                  , Q_ARG(QByteArray, request.body)
                   );
-        data.data.clear();
         break;
     default:
         qFatal();
     }
     currentSocket = nullptr;
+    currentStream = nullptr;
     const bool takenOver = responseTakenOver;
     responseTakenOver = false;
-    if (takenOver) {
+#if QT_CONFIG(mcp_h2c)
+    const bool open = stream ? findStream(socket, stream) == connection
+                             : connections.value(socket) == connection;
+#else
+    const bool open = connections.value(socket) == connection;
+#endif
+    if (!open) {
+        // The slot closed the connection, or the client reset the stream.
+    } else if (takenOver) {
         // The slot took over the connection via deferResponse(); the response
         // was either already sent from within the slot or is sent later
         // through completeResponse() / upgradeToSse().
-    } else if (sessions.key(socket).isNull()) {
-        sendHttpResponse(socket, ret, "text/plain"_L1, 200);
+    } else if (!connection->sse) {
+        respond(connection, 200, ret, "text/plain");
+        if (!connection->isStream)
+            responseDone(socket);
     } else {
-        socket->write(ret);
+        writeSse(connection, ret);
+    }
+}
+
+/*!
+    \internal
+    Replaces the body of \a request, if sent with a Content-Encoding, by
+    the decoded one. Returns false when it was answered with an error
+    instead: 415 for a coding not supported, 400 for corrupt data and 413
+    when the decoded body exceeds maxBodySize.
+*/
+bool QMcpAbstractHttpServer::Private::decodeBody(Connection *connection, QMcpHttpRequestParser::Request *request)
+{
+    auto &data = *connection;
+    const auto contentEncoding = request->headers.value(QHttpHeaders::WellKnownHeader::ContentEncoding);
+    if (contentEncoding.isEmpty()) {
+        data.advertiseEncoding = compressionThreshold >= 0 && request->body.size() >= compressionThreshold;
+        return true;
+    }
+    data.advertiseEncoding = false;
+
+    int statusCode = 0;
+    QByteArray message;
+    const auto encoding = QMcpCompression::fromName(contentEncoding);
+    if (!encoding) {
+        statusCode = 415;
+        message = "Unsupported Content-Encoding"_ba;
+    } else {
+        bool tooLarge = false;
+        auto decoded = QMcpCompression::decompress(request->body, *encoding, maxBodySize, &tooLarge);
+        if (decoded) {
+            request->body = std::move(*decoded);
+            request->headers.removeAll(QHttpHeaders::WellKnownHeader::ContentEncoding);
+            request->headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentLength,
+                                             QByteArray::number(request->body.size()));
+            return true;
+        }
+        statusCode = tooLarge ? 413 : 400;
+        message = tooLarge ? "Content Too Large"_ba : "Malformed compressed body"_ba;
+    }
+    data.encoding = QMcpCompression::Encoding::Identity;
+    // What to send instead (RFC 9110, 15.5.16).
+    data.advertiseEncoding = statusCode == 415;
+    respond(connection, statusCode, message, "text/plain");
+    if (!data.isStream)
+        responseDone(data.socket);
+    return false;
+}
+
+/*!
+    \internal
+    Returns \a body compressed as \a connection's request accepts, adding
+    the headers that say so to \a headers, or \a body itself when it is too
+    small or of a type not worth it.
+
+    Accept-Encoding in a response lists the codings the server takes request
+    bodies in; a client may compress what it sends from then on.
+*/
+QByteArray QMcpAbstractHttpServer::Private::encodeBody(Connection *connection, const QByteArray &body,
+                                                       QByteArrayView contentType, Headers *headers)
+{
+    if (connection && std::exchange(connection->advertiseEncoding, false))
+        headers->append({ "Accept-Encoding"_ba, "gzip, deflate"_ba });
+    if (!connection || connection->encoding == QMcpCompression::Encoding::Identity
+            || body.size() < compressionThreshold || !QMcpCompression::isCompressible(contentType)) {
+        return body;
+    }
+    auto compressed = QMcpCompression::compress(body, connection->encoding);
+    if (compressed.isEmpty() || compressed.size() >= body.size())
+        return body;
+    headers->append({ "Content-Encoding"_ba, QMcpCompression::name(connection->encoding) });
+    headers->append({ "Vary"_ba, "Accept-Encoding"_ba });
+    return compressed;
+}
+
+/*!
+    \internal
+    Sends \a connection the head of an SSE stream with \a extraHeaders,
+    setting it up to compress the stream if its request accepts that.
+*/
+void QMcpAbstractHttpServer::Private::startSse(Connection *connection, const Headers &extraHeaders)
+{
+    connection->sse = true;
+    Headers headers {
+        { "Content-Type"_ba, "text/event-stream"_ba },
+        { "Cache-Control"_ba, "no-cache"_ba },
+    };
+    if (connection->encoding != QMcpCompression::Encoding::Identity) {
+        connection->sseCompressor = std::make_unique<QMcpStreamCompressor>(connection->encoding);
+        headers.append({ "Content-Encoding"_ba, QMcpCompression::name(connection->encoding) });
+        headers.append({ "Vary"_ba, "Accept-Encoding"_ba });
+    }
+    headers += extraHeaders;
+#if QT_CONFIG(mcp_h2c)
+    if (connection->isStream) {
+        sendStreamHeaders(connection, 200, headers, false);
+        return;
+    }
+#endif
+
+    QByteArray response = "HTTP/1.1 200 OK\r\n"
+                          "Connection: keep-alive\r\n"_ba;
+    for (const auto &header : std::as_const(headers))
+        response += header.first + ": " + header.second + "\r\n";
+    response += "\r\n";
+    write(connection->socket, response);
+}
+
+// The response to the connection's current request is out: close if the
+// client asked for it, or go on with the next pipelined request.
+void QMcpAbstractHttpServer::Private::responseDone(QTcpSocket *socket)
+{
+    auto *connection = connections.value(socket);
+    if (!connection)
+        return;
+    if (connection->closeAfterResponse) {
+        connection->busy = true;
+        dequeue(connection);
+        flush(connection);
+        socket->disconnectFromHost();
+        return;
+    }
+    if (!connection->busy)
+        return;
+    connection->busy = false;
+    // Not from within the slot that answered, which may still be running.
+    QMetaObject::invokeMethod(q, [this, socket = QPointer<QTcpSocket>(socket)]() {
+        if (socket)
+            processRequests(socket);
+    }, Qt::QueuedConnection);
+}
+
+#if QT_CONFIG(mcp_h2c)
+
+/*!
+    \internal
+    Goes on with \a connection in HTTP/2, \a splice being frames to take as
+    the client's after its preface and SETTINGS. The session reads from and
+    writes through a pipe, so what the socket is sent is still coalesced
+    and counted like HTTP/1.1 responses.
+*/
+void QMcpAbstractHttpServer::Private::startHttp2(Connection *connection, const QByteArray &splice)
+{
+    auto *socket = connection->socket;
+    auto http2 = std::make_unique<Http2>();
+    http2->pipe = std::make_unique<Http2Pipe>(
+            [this, socket](QByteArrayView data) { write(socket, data.toByteArray()); },
+            [this, socket = QPointer<QTcpSocket>(socket)]() {
+                // The session gave up on the connection, e.g. on a protocol
+                // error, from within a call that still uses it.
+                QMetaObject::invokeMethod(q, [this, socket]() {
+                    if (auto *connection = connections.value(socket)) {
+                        flush(connection);
+                        socket->disconnectFromHost();
+                    }
+                }, Qt::QueuedConnection);
+            },
+            splice);
+    connection->http2 = std::move(http2);
+    connection->probing = false;
+    connection->probe.clear();
+    auto *pipe = connection->http2->pipe.get();
+    connection->http2->session = QHttp2Connection::createDirectServerConnection(pipe, QHttp2Configuration());
+    // With the pipe as context nothing is delivered once the connection is
+    // being destroyed.
+    connect(connection->http2->session, &QHttp2Connection::newIncomingStream, pipe,
+            [this, socket](QHttp2Stream *stream) { addStream(socket, stream); });
+}
+
+/*!
+    \internal
+    Answers an h2c upgrade \a request with 101 Switching Protocols and goes
+    on with \a connection in HTTP/2; the request becomes stream 1 (RFC 7540,
+    3.2). The HTTP2-Settings it came with are not applied: the SETTINGS the
+    client sends after its preface take their place.
+*/
+void QMcpAbstractHttpServer::Private::upgradeToHttp2(Connection *connection,
+                                                     QMcpHttpRequestParser::Request &&request)
+{
+    write(connection->socket, "HTTP/1.1 101 Switching Protocols\r\n"
+                              "Connection: Upgrade\r\n"
+                              "Upgrade: h2c\r\n"
+                              "\r\n"_ba);
+    startHttp2(connection, upgradeRequestFrames(request));
+    connection->http2->upgradeBody = std::move(request.body);
+    updateHttp2Connection(connection);
+}
+
+// Hands what arrived on an HTTP/2 connection to its session, which calls
+// back per stream.
+void QMcpAbstractHttpServer::Private::processHttp2(Connection *connection, const QByteArray &received)
+{
+    auto *socket = connection->socket;
+    if (!received.isEmpty()) {
+        connection->http2->pipe->feed(received);
+        connection->http2->session->handleReadyRead();
+    }
+    if (auto *current = connections.value(socket); current && current->http2)
+        updateHttp2Connection(current);
+}
+
+/*!
+    \internal
+    An HTTP/2 connection is busy while it has streams open; a draining one
+    closes when the last is done.
+*/
+void QMcpAbstractHttpServer::Private::updateHttp2Connection(Connection *connection)
+{
+    connection->busy = !connection->http2->streams.isEmpty();
+    if (!connection->busy && connection->closeAfterResponse) {
+        // Not from within the session, which may still be running.
+        QMetaObject::invokeMethod(q, [this, socket = QPointer<QTcpSocket>(connection->socket)]() {
+            if (auto *connection = connections.value(socket)) {
+                flush(connection);
+                socket->disconnectFromHost();
+            }
+        }, Qt::QueuedConnection);
+        return;
+    }
+    updateTimeout(connection);
+}
+
+QMcpAbstractHttpServer::Private::Connection *
+QMcpAbstractHttpServer::Private::findStream(QTcpSocket *socket, QHttp2Stream *stream) const
+{
+    const auto *connection = connections.value(socket);
+    if (!connection || !connection->http2)
+        return nullptr;
+    return connection->http2->streams.value(stream);
+}
+
+/*!
+    \internal
+    Gives \a stream, opened by the client on \a socket, a Connection of its
+    own: from there on a stream is answered like an HTTP/1.1 connection,
+    through deferResponse(), completeResponse() and upgradeToSse().
+*/
+void QMcpAbstractHttpServer::Private::addStream(QTcpSocket *socket, QHttp2Stream *stream)
+{
+    auto *connection = connections.value(socket);
+    if (!connection || !connection->http2)
+        return;
+    if (draining) {
+        stream->sendRST_STREAM(Http2::REFUSE_STREAM);
+        return;
+    }
+
+    auto *exchange = new Connection;
+    exchange->socket = socket;
+    exchange->isStream = true;
+    exchange->stream = stream;
+    exchange->parser.setMaxBodySize(maxBodySize);
+    connection->http2->streams.insert(stream, exchange);
+    updateHttp2Connection(connection);
+
+    auto *context = connection->http2->pipe.get();
+    connect(stream, &QHttp2Stream::headersReceived, context,
+            [this, socket, stream](const HPack::HttpHeader &fields, bool endStream) {
+        if (auto *exchange = findStream(socket, stream))
+            receiveHeaders(exchange, fields, endStream);
+    });
+    connect(stream, &QHttp2Stream::dataReceived, context,
+            [this, socket, stream](const QByteArray &data, bool endStream) {
+        if (auto *exchange = findStream(socket, stream))
+            receiveData(exchange, data, endStream);
+    });
+    connect(stream, &QHttp2Stream::uploadFinished, context, [this, socket, stream]() {
+        if (auto *exchange = findStream(socket, stream)) {
+            exchange->streamSending = false;
+            sendStreamData(exchange, {}, false);
+        }
+    });
+    connect(stream, &QHttp2Stream::stateChanged, context, [this, socket, stream](QHttp2Stream::State state) {
+        if (state == QHttp2Stream::State::Closed)
+            streamClosed(socket, stream);
+    });
+    connect(stream, &QObject::destroyed, context, [this, socket, stream]() {
+        streamClosed(socket, stream);
+    });
+}
+
+void QMcpAbstractHttpServer::Private::receiveHeaders(Connection *connection, const HPack::HttpHeader &fields,
+                                                     bool endStream)
+{
+    auto &request = connection->streamRequest;
+    for (const auto &field : fields) {
+        if (field.name == ":method") {
+            request.method = field.value;
+        } else if (field.name == ":path") {
+            const auto query = field.value.indexOf('?');
+            request.path = query < 0 ? field.value : field.value.first(query);
+            request.query = query < 0 ? QByteArray() : field.value.sliced(query + 1);
+        } else if (field.name == ":authority") {
+            request.headers.append(QHttpHeaders::WellKnownHeader::Host, field.value);
+        } else if (!field.name.startsWith(':')) {
+            request.headers.append(field.name, field.value);
+        }
     }
-    dataMap.insert(socket, ParseData());
+    if (endStream)
+        dispatchStream(connection);
+}
+
+void QMcpAbstractHttpServer::Private::receiveData(Connection *connection, const QByteArray &data, bool endStream)
+{
+    connection->stream->clearDownloadBuffer();
+    // Answered early, e.g. as too large: the rest is read and dropped.
+    if (connection->done)
+        return;
+    auto &body = connection->streamRequest.body;
+    if (body.size() + data.size() > maxBodySize) {
+        respond(connection, 413, "Content Too Large"_ba, "text/plain");
+        return;
+    }
+    body += data;
+    if (endStream)
+        dispatchStream(connection);
+}
+
+void QMcpAbstractHttpServer::Private::dispatchStream(Connection *connection)
+{
+    auto request = std::exchange(connection->streamRequest, {});
+    request.minorVersion = 1;
+    request.keepAlive = true;
+    // The request that asked for the upgrade came with its body before.
+    if (auto *owner = connections.value(connection->socket);
+            owner && owner->http2 && connection->stream->streamID() == 1
+            && !owner->http2->upgradeBody.isEmpty()) {
+        request.body = std::exchange(owner->http2->upgradeBody, {});
+        request.headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentLength,
+                                        QByteArray::number(request.body.size()));
+    }
+    dispatch(connection, std::move(request));
+}
+
+/*!
+    \internal
+    Forgets \a stream once it closed. A stream closed before its response
+    was out was reset by the client, which is told like a connection the
+    peer closed.
+*/
+void QMcpAbstractHttpServer::Private::streamClosed(QTcpSocket *socket, QHttp2Stream *stream)
+{
+    auto *connection = findStream(socket, stream);
+    if (!connection)
+        return;
+    const auto id = connection->done ? QUuid() : connection->id;
+    removeStream(connection);
+    if (!id.isNull())
+        emit q->connectionClosed(id);
+}
+
+void QMcpAbstractHttpServer::Private::removeStream(Connection *connection)
+{
+    auto *owner = connections.value(connection->socket);
+    if (owner && owner->http2)
+        owner->http2->streams.remove(connection->stream);
+    if (!connection->id.isNull())
+        exchanges.remove(connection->id);
+    if (currentStream == connection)
+        currentStream = nullptr;
+    connection->stream = nullptr;
+    // Not deleted right away: the call that closed the stream, e.g. one
+    // sending its last DATA, may still use it.
+    QMetaObject::invokeMethod(q, [connection]() { delete connection; }, Qt::QueuedConnection);
+    if (owner && owner->http2)
+        updateHttp2Connection(owner);
+}
+
+void QMcpAbstractHttpServer::Private::sendStreamHeaders(Connection *connection, int statusCode,
+                                                        const Headers &headers, bool end)
+{
+    if (!connection->stream)
+        return;
+    HPack::HttpHeader fields;
+    fields.push_back({ ":status"_ba, QByteArray::number(statusCode) });
+    for (const auto &header : headers) {
+        const auto name = header.first.toLower();
+        if (!isConnectionSpecific(name))
+            fields.push_back({ name, header.second });
+    }
+    if (end)
+        connection->done = true;
+    connection->stream->sendHEADERS(fields, end);
+}
+
+/*!
+    \internal
+    Sends \a data on \a connection's stream, ending it if \a end is set. A
+    stream sends one DATA payload at a time, as flow control lets it; what
+    comes meanwhile is gathered and follows in one.
+*/
+void QMcpAbstractHttpServer::Private::sendStreamData(Connection *connection, const QByteArray &data, bool end)
+{
+    connection->streamOutput += data;
+    connection->streamEnd = connection->streamEnd || end;
+    if (!connection->stream || connection->streamSending)
+        return;
+    if (connection->streamOutput.isEmpty() && !connection->streamEnd)
+        return;
+    connection->streamSending = true;
+    if (connection->streamEnd)
+        connection->done = true;
+    connection->stream->sendDATA(std::exchange(connection->streamOutput, {}), connection->streamEnd);
+}
+
+// Ends the SSE stream of \a connection, an HTTP/2 stream, leaving the
+// connection it runs on open.
+void QMcpAbstractHttpServer::Private::endStream(Connection *connection)
+{
+    if (!connection->id.isNull())
+        exchanges.remove(std::exchange(connection->id, QUuid()));
+    sendStreamData(connection, connection->sseCompressor ? connection->sseCompressor->finish() : QByteArray(),
+                   true);
+}
+#endif // QT_CONFIG(mcp_h2c)
+
+/*!
+    \internal
+    Puts \a connection in the timeout queue its state calls for. A busy
+    connection waits for the server, not for its client, and times out
+    never. The header timeout runs from the first byte of a request and is
+    not extended by more bytes trickling in; the idle timeout is.
+*/
+void QMcpAbstractHttpServer::Private::updateTimeout(Connection *connection)
+{
+    TimeoutQueue *queue = nullptr;
+    if (!connection->busy) {
+        if (connection->parser.isReadingHeaders()) {
+            if (readHeaderTimeout > 0)
+                queue = &headerQueue;
+        } else if (idleTimeout > 0) {
+            queue = &idleQueue;
+        }
+    }
+
+    if (queue == &headerQueue && connection->queue == queue)
+        return;
+    dequeue(connection);
+    if (!queue)
+        return;
+    connection->queue = queue;
+    connection->queuedAt = clock.elapsed();
+    connection->queuePos = queue->insert(queue->end(), connection);
+    scheduleSweep();
+}
+
+void QMcpAbstractHttpServer::Private::dequeue(Connection *connection)
+{
+    if (!connection->queue)
+        return;
+    connection->queue->erase(connection->queuePos);
+    connection->queue = nullptr;
+}
+
+void QMcpAbstractHttpServer::Private::scheduleSweep()
+{
+    if (sweepTimer.isActive())
+        return;
+    qint64 next = -1;
+    if (!idleQueue.empty())
+        next = idleQueue.front()->queuedAt + idleTimeout;
+    if (!headerQueue.empty()) {
+        const auto deadline = headerQueue.front()->queuedAt + readHeaderTimeout;
+        next = next < 0 ? deadline : qMin(next, deadline);
+    }
+    if (next >= 0)
+        sweepTimer.start(int(qMax(qint64(0), next - clock.elapsed())));
+}
+
+void QMcpAbstractHttpServer::Private::sweep()
+{
+    const auto now = clock.elapsed();
+    while (!headerQueue.empty() && headerQueue.front()->queuedAt + readHeaderTimeout <= now) {
+        auto *connection = headerQueue.front();
+        dequeue(connection);
+        connection->busy = true;
+        auto *socket = connection->socket;
+        sendHttpResponse(socket, "Request Timeout"_ba, QStringLiteral("text/plain"), 408, true);
+        flush(connection);
+        socket->disconnectFromHost();
+    }
+    while (!idleQueue.empty() && idleQueue.front()->queuedAt + idleTimeout <= now) {
+        auto *connection = idleQueue.front();
+        dequeue(connection);
+        connection->busy = true;
+        connection->socket->disconnectFromHost();
+    }
+    scheduleSweep();
+}
+
+/*!
+    \internal
+    Returns the index of the slot answering \a method requests for \a path:
+    an explicit route, else the slot named after the method and the path
+    elements (\c {POST /mcp} is \c postMcp). Resolved routes are cached, so
+    a request costs one hash lookup.
+*/
+int QMcpAbstractHttpServer::Private::route(const QByteArray &method, const QString &path)
+{
+    if (slotIndexes.isEmpty()) {
+        const auto mo = q->metaObject();
+        // Backwards, so that of overloads the first declared one answers.
+        for (int i = mo->methodCount() - 1; i >= mo->methodOffset(); i--)
+            slotIndexes.insert(mo->method(i).name(), i);
+    }
+
+    const QByteArray key = method.toUpper() + ' ' + path.toUtf8();
+    const auto cached = routeCache.constFind(key);
+    if (cached != routeCache.cend())
+        return *cached;
+
+    QByteArray slotName = routes.value(key);
+    if (slotName.isEmpty()) {
+        slotName = method.toLower();
+        const auto pathElements = QStringView(path).split(u'/', Qt::SkipEmptyParts);
+        for (const auto &pe : pathElements) {
+            slotName += pe.first(1).toString().toUpper().toUtf8();
+            slotName += pe.sliced(1).toString().toLower().toUtf8();
+        }
+    }
+
+    const int ret = slotIndexes.value(slotName, -1);
+    if (ret >= 0 && routeCache.size() < MaxRouteCacheSize)
+        routeCache.insert(key, ret);
+    return ret;
 }
 
 void QMcpAbstractHttpServer::Private::sendHttpResponse(QTcpSocket *socket, const QByteArray &data,
-                                                     const QString &contentType, int statusCode)
-{
-    QString statusText = (statusCode == 200) ? "OK"_L1 : "Not Found"_L1;
-    QByteArray response = u"HTTP/1.1 %1 %2\r\n"
-                          "Content-Type: %3\r\n"
-                          "Content-Length: %4\r\n"
-                          "\r\n"_s
-                              .arg(statusCode)
-                              .arg(statusText)
-                              .arg(contentType)
-                              .arg(data.size())
-                              .toLatin1();
-    response += data;
-    socket->write(response);
+                                                     const QString &contentType, int statusCode, bool close)
+{
+    auto *connection = connections.value(socket);
+    if (!connection)
+        return;
+    if (close)
+        connection->closeAfterResponse = true;
+    respond(connection, statusCode, data, contentType.toLatin1());
+}
+
+/*!
+    \internal
+    Sends \a connection a response with \a statusCode, \a body of
+    \a contentType, compressed if the request accepts that, and
+    \a extraHeaders: one HTTP/1.1 message, or HEADERS and DATA ending the
+    connection's HTTP/2 stream.
+
+    A body \a extraHeaders give a Content-Encoding for is encoded already.
+*/
+void QMcpAbstractHttpServer::Private::respond(Connection *connection, int statusCode, const QByteArray &body,
+                                              QByteArrayView contentType, const Headers &extraHeaders)
+{
+    Headers headers;
+    if (!contentType.isEmpty())
+        headers.append({ "Content-Type"_ba, contentType.toByteArray() });
+    const bool encoded = std::any_of(extraHeaders.cbegin(), extraHeaders.cend(), [](const auto &header) {
+        return header.first.compare("content-encoding", Qt::CaseInsensitive) == 0;
+    });
+    const auto content = encoded ? body : encodeBody(connection, body, contentType, &headers);
+    headers += extraHeaders;
+
+#if QT_CONFIG(mcp_h2c)
+    if (connection->isStream) {
+        headers.append({ "Content-Length"_ba, QByteArray::number(content.size()) });
+        sendStreamHeaders(connection, statusCode, headers, content.isEmpty());
+        if (!content.isEmpty())
+            sendStreamData(connection, content, true);
+        return;
+    }
+#endif
+
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(statusCode) + ' ' + statusText(statusCode) + "\r\n";
+    for (const auto &header : std::as_const(headers))
+        response += header.first + ": " + header.second + "\r\n";
+    response += "Content-Length: " + QByteArray::number(content.size()) + "\r\n";
+    if (connection->closeAfterResponse)
+        response += "Connection: close\r\n";
+    response += "\r\n";
+    response += content;
+    write(connection->socket, response);
+}
+
+/*!
+    \internal
+    Queues \a data for \a socket. What a connection is sent during one event
+    loop iteration, e.g. a burst of notifications, goes out in one write
+    instead of one per message.
+*/
+void QMcpAbstractHttpServer::Private::write(QTcpSocket *socket, const QByteArray &data)
+{
+    bytesSent += data.size();
+    auto *connection = connections.value(socket);
+    if (!connection || writeCoalescingDelay < 0) {
+        socket->write(data);
+        socket->flush();
+        return;
+    }
+
+    connection->output += data;
+    if (connection->output.size() >= writeCoalescingThreshold) {
+        flush(connection);
+        return;
+    }
+    unflushed.insert(connection);
+    if (!flushTimer.isActive())
+        flushTimer.start(writeCoalescingDelay);
+}
+
+// An SSE stream's bytes go through its compressor, if it has one; each
+// message comes out complete, so none waits for the next.
+void QMcpAbstractHttpServer::Private::writeSse(Connection *connection, const QByteArray &data)
+{
+    if (!connection)
+        return;
+    const auto bytes = connection->sseCompressor ? connection->sseCompressor->compress(data) : data;
+#if QT_CONFIG(mcp_h2c)
+    if (connection->isStream) {
+        sendStreamData(connection, bytes, false);
+        return;
+    }
+#endif
+    write(connection->socket, bytes);
+}
+
+void QMcpAbstractHttpServer::Private::flush(Connection *connection)
+{
+    unflushed.remove(connection);
+    if (connection->output.isEmpty())
+        return;
+    // Writing may find the peer gone and delete the connection.
+    auto *socket = connection->socket;
+    socket->write(std::exchange(connection->output, {}));
     socket->flush();
 }
 
+void QMcpAbstractHttpServer::Private::flushAll()
+{
+    // Flushing may close a socket, which removes it from unflushed.
+    while (!unflushed.isEmpty())
+        flush(*unflushed.cbegin());
+}
+
 QMcpAbstractHttpServer::QMcpAbstractHttpServer(QObject *parent)
     : QObject{parent}
     , d(new Private(this))
@@ -258,55 +1436,268 @@ QMcpAbstractHttpServer::~QMcpAbstractHttpServer()
 
 bool QMcpAbstractHttpServer::bind(QTcpServer *server)
 {
-    static QMetaObject::Connection connection;
-
     if (d->server) {
-        disconnect(connection);
-        connection = QMetaObject::Connection();
+        disconnect(d->serverConnection);
+        if (d->acceptPaused)
+            d->server->resumeAccepting();
+        d->acceptPaused = false;
         // Clean up any existing connections
-        const auto sockets = d->dataMap.keys();
-        for (QTcpSocket *socket : sockets) {
-            socket->disconnect();
-            socket->deleteLater();
+        const auto connections = std::exchange(d->connections, {});
+        for (auto *connection : connections) {
+            connection->socket->disconnect();
+            connection->socket->deleteLater();
+            delete connection;
         }
-        d->dataMap.clear();
+        d->exchanges.clear();
+        d->currentStream = nullptr;
+        d->unflushed.clear();
+        d->idleQueue.clear();
+        d->headerQueue.clear();
     }
 
     d->server = server;
     if (d->server) {
-        while (server->hasPendingConnections())
-            d->handleNewConnection();
-        connection = connect(server, &QTcpServer::newConnection, this, [this]() {
+        d->handleNewConnection();
+        d->serverConnection = connect(server, &QTcpServer::newConnection, this, [this]() {
             d->handleNewConnection();
         });
     }
     return true;
 }
 
+quint64 QMcpAbstractHttpServer::bytesReceived() const
+{
+    return d->bytesReceived;
+}
+
+quint64 QMcpAbstractHttpServer::bytesSent() const
+{
+    return d->bytesSent;
+}
+
+qsizetype QMcpAbstractHttpServer::maxHeaderSize() const
+{
+    return d->maxHeaderSize;
+}
+
+void QMcpAbstractHttpServer::setMaxHeaderSize(qsizetype size)
+{
+    d->maxHeaderSize = size;
+    for (auto *connection : std::as_const(d->connections))
+        connection->parser.setMaxHeaderSize(size);
+}
+
+qint64 QMcpAbstractHttpServer::maxBodySize() const
+{
+    return d->maxBodySize;
+}
+
+void QMcpAbstractHttpServer::setMaxBodySize(qint64 size)
+{
+    d->maxBodySize = size;
+    for (auto *connection : std::as_const(d->connections))
+        connection->parser.setMaxBodySize(size);
+}
+
+int QMcpAbstractHttpServer::maxConnections() const
+{
+    return d->maxConnections;
+}
+
+void QMcpAbstractHttpServer::setMaxConnections(int count)
+{
+    d->maxConnections = count;
+    if (d->acceptPaused && (count <= 0 || d->connections.size() < count))
+        d->resumeAccepting();
+}
+
+int QMcpAbstractHttpServer::connectionCount() const
+{
+    return int(d->connections.size());
+}
+
+int QMcpAbstractHttpServer::idleTimeout() const
+{
+    return d->idleTimeout;
+}
+
+void QMcpAbstractHttpServer::setIdleTimeout(int msecs)
+{
+    if (d->idleTimeout == msecs)
+        return;
+    d->idleTimeout = msecs;
+    if (msecs <= 0) {
+        for (auto *connection : std::exchange(d->idleQueue, {}))
+            connection->queue = nullptr;
+    }
+    d->sweepTimer.stop();
+    d->scheduleSweep();
+}
+
+int QMcpAbstractHttpServer::readHeaderTimeout() const
+{
+    return d->readHeaderTimeout;
+}
+
+void QMcpAbstractHttpServer::setReadHeaderTimeout(int msecs)
+{
+    if (d->readHeaderTimeout == msecs)
+        return;
+    d->readHeaderTimeout = msecs;
+    if (msecs <= 0) {
+        for (auto *connection : std::exchange(d->headerQueue, {}))
+            connection->queue = nullptr;
+    }
+    d->sweepTimer.stop();
+    d->scheduleSweep();
+}
+
+int QMcpAbstractHttpServer::writeCoalescingDelay() const
+{
+    return d->writeCoalescingDelay;
+}
+
+void QMcpAbstractHttpServer::setWriteCoalescingDelay(int msecs)
+{
+    d->writeCoalescingDelay = msecs;
+    if (msecs < 0) {
+        d->flushTimer.stop();
+        d->flushAll();
+    }
+}
+
+qsizetype QMcpAbstractHttpServer::writeCoalescingThreshold() const
+{
+    return d->writeCoalescingThreshold;
+}
+
+void QMcpAbstractHttpServer::setWriteCoalescingThreshold(qsizetype bytes)
+{
+    d->writeCoalescingThreshold = bytes;
+}
+
+qsizetype QMcpAbstractHttpServer::compressionThreshold() const
+{
+    return d->compressionThreshold;
+}
+
+void QMcpAbstractHttpServer::setCompressionThreshold(qsizetype bytes)
+{
+    d->compressionThreshold = bytes;
+}
+
+bool QMcpAbstractHttpServer::isHttp2Enabled() const
+{
+#if QT_CONFIG(mcp_h2c)
+    return d->http2Enabled;
+#else
+    return false;
+#endif
+}
+
+void QMcpAbstractHttpServer::setHttp2Enabled(bool enabled)
+{
+#if QT_CONFIG(mcp_h2c)
+    d->http2Enabled = enabled;
+#else
+    if (enabled)
+        qWarning() << "HTTP/2 is not available: Qt MCP was built without the mcp-h2c feature";
+#endif
+}
+
+bool QMcpAbstractHttpServer::isDraining() const
+{
+    return d->draining;
+}
+
+void QMcpAbstractHttpServer::drain(int timeout)
+{
+    if (d->draining)
+        return;
+    d->draining = true;
+    if (d->server && !d->acceptPaused) {
+        d->server->pauseAccepting();
+        d->acceptPaused = true;
+    }
+
+    if (d->connections.isEmpty()) {
+        emit drained();
+        return;
+    }
+    if (timeout >= 0)
+        d->drainTimer.start(timeout);
+
+    const auto sockets = d->connections.keys();
+    for (QTcpSocket *socket : sockets) {
+        auto *connection = d->connections.value(socket);
+        if (!connection)
+            continue;
+#if QT_CONFIG(mcp_h2c)
+        if (connection->http2) {
+            // New streams are refused; SSE streams end, others are answered,
+            // then the connection closes.
+            connection->closeAfterResponse = true;
+            const auto streams = connection->http2->streams.values();
+            for (auto *stream : streams) {
+                if (stream->sse && !stream->done) {
+                    const auto id = stream->id;
+                    d->endStream(stream);
+                    if (!id.isNull())
+                        emit connectionClosed(id);
+                }
+            }
+            if (d->connections.value(socket) == connection)
+                d->updateHttp2Connection(connection);
+            continue;
+        }
+#endif
+        if (connection->sse || (!connection->busy && !connection->parser.hasPendingData())) {
+            // Nothing is on its way that would be lost: an SSE stream has no
+            // end to wait for, an idle connection no request.
+            connection->busy = true;
+            d->dequeue(connection);
+            d->flush(connection);
+            socket->disconnectFromHost();
+        } else {
+            // Answer what is in progress, then close.
+            connection->closeAfterResponse = true;
+        }
+    }
+}
+
+void QMcpAbstractHttpServer::addRoute(const QByteArray &method, const QString &path, const QByteArray &slot)
+{
+    d->routes.insert(method.toUpper() + ' ' + path.toUtf8(), slot);
+    d->routeCache.clear();
+}
+
+void QMcpAbstractHttpServer::removeRoute(const QByteArray &method, const QString &path)
+{
+    d->routes.remove(method.toUpper() + ' ' + path.toUtf8());
+    d->routeCache.clear();
+}
+
 QUuid QMcpAbstractHttpServer::registerSseRequest(const QNetworkRequest &request)
 {
     QUuid ret;
-    static QByteArray response = QByteArrayLiteral("HTTP/1.1 200 OK\r\n"
-                                            "Content-Type: text/event-stream\r\n"
-                                            "Cache-Control: no-cache\r\n"
-                                            "Connection: keep-alive\r\n"
-                                            "\r\n");
-    QTcpSocket *target = d->currentSocket;
+    Private::Connection *target = d->currentStream ? d->currentStream : d->connections.value(d->currentSocket);
     if (!target) {
         // Called outside of a request slot: fall back to matching the request.
-        const auto sockets = d->dataMap.keys();
-        for (QTcpSocket *socket : sockets) {
-            if (d->dataMap.value(socket).request == request) {
-                target = socket;
+        for (auto *connection : std::as_const(d->connections)) {
+            if (connection->request == request) {
+                target = connection;
                 break;
             }
         }
     }
     if (target) {
         ret = QUuid::createUuid();
-        d->sessions.insert(ret, target);
-        target->write(response);
-        target->flush();
+        target->id = ret;
+        d->exchanges.insert(ret, target);
+        // The stream is the connection's last response.
+        target->busy = true;
+        d->dequeue(target);
+        d->startSse(target, {});
     } else {
         qWarning() << "sse socket for" << request.url() << "not found";
     }
@@ -314,41 +1705,45 @@ QUuid QMcpAbstractHttpServer::registerSseRequest(const QNetworkRequest &request)
 }
 
 void QMcpAbstractHttpServer::sendSseEvent(const QUuid &id, const QByteArray &data,
-                                         const QString &event)
+                                         const QString &event, const QByteArray &eventId)
 {
-    if (!d->sessions.contains(id)) {
+    auto *connection = d->exchanges.value(id);
+    if (!connection || !connection->sse) {
         qWarning() << "sse" << id << "not found";
         return;
     }
-    auto *socket = d->sessions.value(id);
     QByteArray message;
+    if (!eventId.isEmpty())
+        message += "id: " + eventId + "\r\n";
     if (!event.isEmpty())
         message += "event: " + event.toUtf8() + "\r\n";
     message += "data: " + data + "\r\n\r\n";
-    socket->write(message);
-    socket->flush();
+    d->writeSse(connection, message);
 }
 
 void QMcpAbstractHttpServer::sendSseComment(const QUuid &id, const QByteArray &comment)
 {
-    if (!d->sessions.contains(id)) {
+    auto *connection = d->exchanges.value(id);
+    if (!connection || !connection->sse) {
         qWarning() << "sse" << id << "not found";
         return;
     }
-    auto *socket = d->sessions.value(id);
-    socket->write(": " + comment + "\r\n\r\n");
-    socket->flush();
+    d->writeSse(connection, ": " + comment + "\r\n\r\n");
 }
 
 QUuid QMcpAbstractHttpServer::deferResponse(const QNetworkRequest &request)
 {
-    if (!d->currentSocket) {
+    auto *connection = d->currentStream ? d->currentStream : d->connections.value(d->currentSocket);
+    if (!connection) {
         qWarning() << "deferResponse() for" << request.url()
                    << "must be called from within a request slot";
         return {};
     }
     const QUuid ret = QUuid::createUuid();
-    d->deferred.insert(ret, d->currentSocket);
+    connection->id = ret;
+    d->exchanges.insert(ret, connection);
+    connection->busy = true;
+    d->dequeue(connection);
     d->responseTakenOver = true;
     return ret;
 }
@@ -357,67 +1752,54 @@ void QMcpAbstractHttpServer::completeResponse(const QUuid &id, int statusCode, c
                                               const QString &contentType,
                                               const QList<std::pair<QByteArray, QByteArray>> &extraHeaders)
 {
-    if (!d->deferred.contains(id)) {
+    auto *connection = d->exchanges.value(id);
+    if (!connection || connection->sse) {
         qWarning() << "deferred response" << id << "not found";
         return;
     }
-    auto *socket = d->deferred.take(id);
+    d->exchanges.remove(id);
+    connection->id = QUuid();
 
-    QByteArray statusText;
-    switch (statusCode) {
-    case 200: statusText = "OK"_ba; break;
-    case 202: statusText = "Accepted"_ba; break;
-    case 400: statusText = "Bad Request"_ba; break;
-    case 403: statusText = "Forbidden"_ba; break;
-    case 404: statusText = "Not Found"_ba; break;
-    case 405: statusText = "Method Not Allowed"_ba; break;
-    default: statusText = "Unknown"_ba; break;
-    }
-
-    QByteArray response = "HTTP/1.1 " + QByteArray::number(statusCode) + ' ' + statusText + "\r\n";
-    if (!body.isEmpty())
-        response += "Content-Type: " + contentType.toLatin1() + "\r\n";
-    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
-    for (const auto &header : extraHeaders)
-        response += header.first + ": " + header.second + "\r\n";
-    response += "\r\n";
-    response += body;
-    socket->write(response);
-    socket->flush();
+    const auto type = contentType.toLatin1();
+    d->respond(connection, statusCode, body, body.isEmpty() ? QByteArrayView() : QByteArrayView(type),
+               extraHeaders);
+    if (!connection->isStream)
+        d->responseDone(connection->socket);
 }
 
 bool QMcpAbstractHttpServer::upgradeToSse(const QUuid &id, const QList<std::pair<QByteArray, QByteArray>> &extraHeaders)
 {
-    if (!d->deferred.contains(id)) {
+    auto *connection = d->exchanges.value(id);
+    if (!connection || connection->sse) {
         qWarning() << "deferred response" << id << "not found";
         return false;
     }
-    auto *socket = d->deferred.take(id);
-    d->sessions.insert(id, socket);
-
-    QByteArray response = "HTTP/1.1 200 OK\r\n"
-                          "Content-Type: text/event-stream\r\n"
-                          "Cache-Control: no-cache\r\n"
-                          "Connection: keep-alive\r\n"
-                          "X-Accel-Buffering: no\r\n"_ba;
-    for (const auto &header : extraHeaders)
-        response += header.first + ": " + header.second + "\r\n";
-    response += "\r\n";
-    socket->write(response);
-    socket->flush();
+    d->startSse(connection, Private::Headers { { "X-Accel-Buffering"_ba, "no"_ba } } + extraHeaders);
     return true;
 }
 
 void QMcpAbstractHttpServer::closeSseConnection(const QUuid &id)
 {
-    if (!d->sessions.contains(id)) {
+    auto *connection = d->exchanges.value(id);
+    if (!connection || !connection->sse) {
         qWarning() << "sse" << id << "not found";
         return;
     }
-    auto *socket = d->sessions.take(id);
-    d->dataMap.remove(socket);
+#if QT_CONFIG(mcp_h2c)
+    // Other streams may go on on the same connection.
+    if (connection->isStream) {
+        d->endStream(connection);
+        return;
+    }
+#endif
+    auto *socket = connection->socket;
+    // Ends the compressed stream properly, so the client sees no truncation.
+    if (connection->sseCompressor)
+        d->write(socket, connection->sseCompressor->finish());
+    d->flush(connection);
+    // Closed on purpose, so no connectionClosed() for it.
+    d->removeConnection(connection);
     socket->close();
     socket->deleteLater();
     return;
 }
-
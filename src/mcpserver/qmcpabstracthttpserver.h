@@ -19,6 +19,24 @@ class QTcpServer;
     allowing real-time communication from server to client. It handles the low-level details of
     HTTP connections and SSE event streaming.
 
+    Requests are parsed incrementally as their bytes arrive. Chunked request
+    bodies are decoded, and pipelined requests on a keep-alive connection
+    are answered one after the other, in the order they were sent.
+
+    Clients slower than readHeaderTimeout() to send a request's headers are
+    closed, as are connections waiting for their client longer than an
+    idleTimeout() set with setIdleTimeout();
+    setMaxConnections() bounds how many connections are served at once.
+
+    Responses are compressed when the client accepts it, see
+    compressionThreshold().
+
+    When built with the \c mcp-h2c feature, clients may speak HTTP/2 over
+    cleartext (h2c), with prior knowledge or by upgrading an HTTP/1.1
+    request. Each HTTP/2 stream is answered like a connection of its own,
+    so many requests share one TCP connection without waiting for each
+    other; see isHttp2Enabled().
+
     To implement a custom HTTP server:
     \list
     \li Inherit from QMcpAbstractHttpServer
@@ -51,7 +69,132 @@ public:
     */
     bool bind(QTcpServer *server);
 
+    /*!
+        Returns the number of bytes read from all connections so far.
+    */
+    quint64 bytesReceived() const;
+
+    /*!
+        Returns the number of bytes written to all connections so far.
+    */
+    quint64 bytesSent() const;
+
+    /*!
+        Returns the maximum size in bytes of a request's request line and
+        headers together. A request exceeding it is answered with status 431
+        (414 when the request line alone does) and its connection closed.
+        The default is 64 KiB.
+    */
+    qsizetype maxHeaderSize() const;
+    void setMaxHeaderSize(qsizetype size);
+
+    /*!
+        Returns the maximum size in bytes of a request body, after decoding
+        a chunked one. A larger body is answered with status 413 and its
+        connection closed. The default is 16 MiB.
+    */
+    qint64 maxBodySize() const;
+    void setMaxBodySize(qint64 size);
+
+    /*!
+        Returns the maximum number of connections served at once; 0, the
+        default, means no limit. At the limit no further connection is
+        accepted until one closes, so clients wait in the listen backlog.
+    */
+    int maxConnections() const;
+    void setMaxConnections(int count);
+
+    /*!
+        Returns the number of connections currently open.
+    */
+    int connectionCount() const;
+
+    /*!
+        Returns the time in milliseconds after which a connection waiting
+        for its client, between requests or in the middle of a body, is
+        closed. Deferred and SSE connections wait for the server and are not
+        affected. 0, the default, disables the timeout.
+    */
+    int idleTimeout() const;
+    void setIdleTimeout(int msecs);
+
+    /*!
+        Returns the time in milliseconds a client has, from the first byte
+        of a request, to complete its headers. It is answered with status
+        408 and closed otherwise. 0 disables the timeout; the default is 30
+        seconds.
+    */
+    int readHeaderTimeout() const;
+    void setReadHeaderTimeout(int msecs);
+
+    /*!
+        Returns how many milliseconds output is gathered before it is written
+        to a connection. Responses and SSE events are not written one by
+        one; everything a connection is sent meanwhile goes out in a single
+        write. With 0, the default, that is at the end of the current event
+        loop iteration. A negative value writes every message right away.
+    */
+    int writeCoalescingDelay() const;
+    void setWriteCoalescingDelay(int msecs);
+
+    /*!
+        Returns how many bytes of gathered output make a connection write
+        out before the writeCoalescingDelay() passed. The default is 64 KiB.
+    */
+    qsizetype writeCoalescingThreshold() const;
+    void setWriteCoalescingThreshold(qsizetype bytes);
+
+    /*!
+        Returns the size in bytes from which a response body is compressed,
+        with gzip or deflate as the request's Accept-Encoding allows. Only
+        text and JSON are; smaller bodies are not worth the time. SSE
+        streams are compressed whatever the size of their events. A negative
+        value disables compression; the default is 1024.
+
+        Request bodies sent with a Content-Encoding of gzip or deflate are
+        decoded regardless, before a slot sees them. A client that sent a
+        body of at least this size uncompressed is told so by an
+        Accept-Encoding header in the response.
+    */
+    qsizetype compressionThreshold() const;
+    void setCompressionThreshold(qsizetype bytes);
+
+    /*!
+        Returns whether clients may use HTTP/2 over cleartext: a connection
+        opening with the HTTP/2 preface, or a request asking to upgrade to
+        h2c, goes on in HTTP/2. The default is true when Qt MCP was built
+        with the \c mcp-h2c feature, which is off by default since it builds
+        on private QtNetwork API of Qt 6.8 to 6.11; without it this is
+        always false and enabling it only warns.
+
+        Deferred responses and SSE streams work on HTTP/2 streams as they do
+        on HTTP/1.1 connections; closeSseConnection() ends the stream, not
+        the connection it shares.
+    */
+    bool isHttp2Enabled() const;
+    void setHttp2Enabled(bool enabled);
+
+    /*!
+        Returns whether drain() was called.
+    */
+    bool isDraining() const;
+
+    /*!
+        Shuts the server down gracefully: no further connection is accepted,
+        idle connections and SSE streams are closed, and the remaining ones
+        are closed once the request in progress was answered. Connections
+        still open after \a timeout milliseconds are aborted; a negative
+        \a timeout waits indefinitely. drained() is emitted when no
+        connection is left.
+    */
+    void drain(int timeout = 30000);
+
 signals:
+    /*!
+        Emitted when the last connection closed after drain().
+    */
+    void drained();
+
     /*!
         Emitted when a deferred or SSE connection is closed by the peer.
         On the Streamable HTTP transport (2026-07-28) closing a request's
@@ -62,6 +205,18 @@ signals:
     void connectionClosed(const QUuid &id);
 
 protected:
+    /*!
+        Routes \a method requests for \a path to the slot named \a slot,
+        instead of the slot derived from the path (e.g. \c getMetrics for
+        \c {GET /metrics}). Use it for paths that are configurable.
+    */
+    void addRoute(const QByteArray &method, const QString &path, const QByteArray &slot);
+
+    /*!
+        Removes a route added with addRoute().
+    */
+    void removeRoute(const QByteArray &method, const QString &path);
+
     /*!
         Registers a new SSE request and returns a unique identifier for it.
 
@@ -111,8 +266,11 @@ protected:
         \param id UUID of the SSE connection
         \param data The event data to send
         \param event Optional event type name
+        \param eventId Optional event id, which the client reports back in
+               \c Last-Event-ID when it reconnects
     */
-    void sendSseEvent(const QUuid &id, const QByteArray &data, const QString &event = QString());
+    void sendSseEvent(const QUuid &id, const QByteArray &data, const QString &event = QString(),
+                      const QByteArray &eventId = {});
 
     /*!
         Sends an SSE comment line to a specific client. Comments are ignored by
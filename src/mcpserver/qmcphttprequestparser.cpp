@@ -0,0 +1,394 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcphttprequestparser_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// A chunk size line is a few hex digits; extensions are allowed but nobody
+// needs more than this.
+constexpr qsizetype MaxChunkLineLength = 1024;
+// Consumed bytes are dropped from the buffer once they make up at least half
+// of it and this much, so compaction costs amortized O(1) per byte.
+constexpr qsizetype CompactThreshold = 4096;
+// Content-Length only reserves this much up front; a client announcing a
+// large body has to actually send it before it occupies memory.
+constexpr qsizetype MaxBodyReservation = 1024 * 1024;
+
+bool isTokenChar(char c)
+{
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+        return true;
+    switch (c) {
+    case '!': case '#': case '$': case '%': case '&': case '\'': case '*': case '+':
+    case '-': case '.': case '^': case '_': case '`': case '|': case '~':
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isToken(QByteArrayView value)
+{
+    if (value.isEmpty())
+        return false;
+    for (const char c : value) {
+        if (!isTokenChar(c))
+            return false;
+    }
+    return true;
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/*!
+    \internal
+    Returns whether the comma separated \a list names \a token, compared
+    case-insensitively as Connection options are.
+*/
+bool listContains(QByteArrayView list, QByteArrayView token)
+{
+    qsizetype from = 0;
+    while (from <= list.size()) {
+        qsizetype comma = list.indexOf(',', from);
+        if (comma < 0)
+            comma = list.size();
+        if (list.sliced(from, comma - from).trimmed().compare(token, Qt::CaseInsensitive) == 0)
+            return true;
+        from = comma + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+void QMcpHttpRequestParser::feed(QByteArrayView data)
+{
+    // A body arriving on its own goes straight into the request, without a
+    // detour through the buffer.
+    if ((m_state == State::Body || m_state == State::ChunkData) && m_pos == m_buffer.size()) {
+        const auto n = qsizetype(qMin(m_remaining, qint64(data.size())));
+        m_request.body.append(data.first(n));
+        m_remaining -= n;
+        data = data.sliced(n);
+    }
+    if (data.isEmpty())
+        return;
+
+    if (m_pos == m_buffer.size()) {
+        m_buffer.truncate(0);
+        m_pos = m_scan = 0;
+    } else if (m_pos >= CompactThreshold && m_pos * 2 >= m_buffer.size()) {
+        m_buffer.remove(0, m_pos);
+        m_scan -= m_pos;
+        m_pos = 0;
+    }
+    m_buffer.append(data);
+}
+
+QMcpHttpRequestParser::Status QMcpHttpRequestParser::parse()
+{
+    while (true) {
+        switch (m_state) {
+        case State::RequestLine:
+        case State::Headers:
+        case State::Trailers: {
+            QByteArrayView line;
+            const auto start = m_pos;
+            // An overlong request line is a URI too long, an overlong header
+            // block a header too large.
+            if (!nextLine(&line, m_maxHeaderSize - m_headerBytes, m_state == State::RequestLine ? 414 : 431))
+                return m_state == State::Failed ? Status::Error : Status::NeedMoreData;
+            m_headerBytes += m_pos - start;
+
+            if (m_state == State::RequestLine) {
+                // Empty lines ahead of a request are to be ignored; they
+                // count towards the header limit all the same.
+                if (line.isEmpty())
+                    break;
+                if (!parseRequestLine(line))
+                    return Status::Error;
+                m_state = State::Headers;
+            } else if (m_state == State::Headers) {
+                if (!parseHeaderLine(line))
+                    return Status::Error;
+            } else if (line.isEmpty()) {
+                m_state = State::Complete;
+            } else if (++m_headerCount > m_maxHeaderCount) {
+                fail(431, "Too many trailer fields"_ba);
+                return Status::Error;
+            }
+            break;
+        }
+        case State::Body:
+            readBody();
+            if (m_remaining > 0)
+                return Status::NeedMoreData;
+            m_state = State::Complete;
+            break;
+        case State::ChunkSize: {
+            QByteArrayView line;
+            if (!nextLine(&line, MaxChunkLineLength, 400))
+                return m_state == State::Failed ? Status::Error : Status::NeedMoreData;
+            if (!parseChunkSize(line))
+                return Status::Error;
+            break;
+        }
+        case State::ChunkData:
+            readBody();
+            if (m_remaining > 0)
+                return Status::NeedMoreData;
+            m_state = State::ChunkDataEnd;
+            break;
+        case State::ChunkDataEnd: {
+            QByteArrayView line;
+            if (!nextLine(&line, MaxChunkLineLength, 400))
+                return m_state == State::Failed ? Status::Error : Status::NeedMoreData;
+            if (!line.isEmpty()) {
+                fail(400, "Chunk data longer than its size"_ba);
+                return Status::Error;
+            }
+            m_state = State::ChunkSize;
+            break;
+        }
+        case State::Complete:
+            return Status::RequestReady;
+        case State::Failed:
+            return Status::Error;
+        }
+    }
+}
+
+QMcpHttpRequestParser::Request QMcpHttpRequestParser::takeRequest()
+{
+    Q_ASSERT(m_state == State::Complete);
+    auto ret = std::move(m_request);
+    clearRequest();
+    return ret;
+}
+
+void QMcpHttpRequestParser::reset()
+{
+    m_buffer.clear();
+    m_pos = m_scan = 0;
+    clearRequest();
+    m_errorStatusCode = 0;
+    m_errorString.clear();
+}
+
+void QMcpHttpRequestParser::clearRequest()
+{
+    m_request = Request();
+    m_state = State::RequestLine;
+    m_headerBytes = 0;
+    m_headerCount = 0;
+    m_remaining = 0;
+}
+
+/*!
+    \internal
+    Takes the next line off the buffer, without its CRLF. A bare LF ends a
+    line as well. Returns false when the line is incomplete, or when it is
+    longer than \a maxLength, in which case the parser failed with
+    \a tooLongStatusCode.
+*/
+bool QMcpHttpRequestParser::nextLine(QByteArrayView *line, qsizetype maxLength, int tooLongStatusCode)
+{
+    const auto lf = m_buffer.indexOf('\n', m_scan);
+    if (lf < 0) {
+        m_scan = m_buffer.size();
+        if (m_buffer.size() - m_pos > maxLength)
+            return fail(tooLongStatusCode, "Line too long"_ba);
+        return false;
+    }
+    if (lf + 1 - m_pos > maxLength)
+        return fail(tooLongStatusCode, "Line too long"_ba);
+
+    auto end = lf;
+    if (end > m_pos && m_buffer.at(end - 1) == '\r')
+        --end;
+    *line = QByteArrayView(m_buffer).sliced(m_pos, end - m_pos);
+    m_pos = lf + 1;
+    m_scan = m_pos;
+    return true;
+}
+
+bool QMcpHttpRequestParser::parseRequestLine(QByteArrayView line)
+{
+    const auto firstSpace = line.indexOf(' ');
+    const auto lastSpace = line.lastIndexOf(' ');
+    if (firstSpace <= 0 || lastSpace == firstSpace)
+        return fail(400, "Malformed request line"_ba);
+
+    const auto method = line.first(firstSpace);
+    if (!isToken(method))
+        return fail(400, "Invalid method"_ba);
+
+    const auto version = line.sliced(lastSpace + 1);
+    if (version == "HTTP/1.1")
+        m_request.minorVersion = 1;
+    else if (version == "HTTP/1.0")
+        m_request.minorVersion = 0;
+    else if (version.startsWith("HTTP/"))
+        return fail(505, "HTTP version not supported"_ba);
+    else
+        return fail(400, "Malformed request line"_ba);
+
+    auto target = line.sliced(firstSpace + 1, lastSpace - firstSpace - 1);
+    for (const char c : target) {
+        if (uchar(c) <= ' ' || uchar(c) == 0x7f)
+            return fail(400, "Invalid request target"_ba);
+    }
+    // Absolute form, as sent to proxies; only the path matters here.
+    if (target.startsWith("http://") || target.startsWith("https://")) {
+        const auto slash = target.indexOf('/', target.indexOf("//") + 2);
+        target = slash < 0 ? QByteArrayView("/") : target.sliced(slash);
+    }
+    if (!target.startsWith('/') && target != "*")
+        return fail(400, "Invalid request target"_ba);
+
+    const auto hash = target.indexOf('#');
+    if (hash >= 0)
+        target = target.first(hash);
+    const auto question = target.indexOf('?');
+    m_request.method = method.toByteArray();
+    m_request.path = (question < 0 ? target : target.first(question)).toByteArray();
+    if (question >= 0)
+        m_request.query = target.sliced(question + 1).toByteArray();
+    m_request.keepAlive = m_request.minorVersion >= 1;
+    return true;
+}
+
+bool QMcpHttpRequestParser::parseHeaderLine(QByteArrayView line)
+{
+    if (line.isEmpty())
+        return headersComplete();
+
+    if (line.front() == ' ' || line.front() == '\t')
+        return fail(400, "Obsolete line folding is not supported"_ba);
+    if (++m_headerCount > m_maxHeaderCount)
+        return fail(431, "Too many header fields"_ba);
+
+    const auto colon = line.indexOf(':');
+    // No whitespace is allowed between the name and the colon; accepting it
+    // is how requests get smuggled past proxies that parse differently.
+    if (colon <= 0 || !isToken(line.first(colon)))
+        return fail(400, "Malformed header field"_ba);
+    if (!m_request.headers.append(line.first(colon), line.sliced(colon + 1).trimmed()))
+        return fail(400, "Invalid header field"_ba);
+    return true;
+}
+
+bool QMcpHttpRequestParser::headersComplete()
+{
+    const auto &headers = m_request.headers;
+    const auto connection = headers.combinedValue(QHttpHeaders::WellKnownHeader::Connection);
+    if (listContains(connection, "close"))
+        m_request.keepAlive = false;
+    else if (listContains(connection, "keep-alive"))
+        m_request.keepAlive = true;
+
+    const auto transferEncoding = headers.combinedValue(QHttpHeaders::WellKnownHeader::TransferEncoding);
+    const auto contentLengths = headers.values(QHttpHeaders::WellKnownHeader::ContentLength);
+
+    if (headers.contains(QHttpHeaders::WellKnownHeader::TransferEncoding)) {
+        // Either framing may be the one a proxy in front believed; refuse to
+        // pick one.
+        if (!contentLengths.isEmpty())
+            return fail(400, "Both Content-Length and Transfer-Encoding"_ba);
+        if (m_request.minorVersion == 0)
+            return fail(400, "Transfer-Encoding in an HTTP/1.0 request"_ba);
+        if (transferEncoding.trimmed().compare("chunked", Qt::CaseInsensitive) != 0)
+            return fail(501, "Unsupported transfer coding"_ba);
+        m_state = State::ChunkSize;
+        return true;
+    }
+
+    if (contentLengths.isEmpty()) {
+        m_state = State::Complete;
+        return true;
+    }
+
+    // Repeated fields, or a list in one, are fine as long as they agree.
+    qint64 length = -1;
+    for (const auto &field : contentLengths) {
+        for (const auto &element : field.split(',')) {
+            const auto digits = element.trimmed();
+            // 18 digits cannot overflow a qint64.
+            if (digits.isEmpty() || digits.size() > 18)
+                return fail(400, "Invalid Content-Length"_ba);
+            qint64 value = 0;
+            for (const char c : digits) {
+                if (c < '0' || c > '9')
+                    return fail(400, "Invalid Content-Length"_ba);
+                value = value * 10 + (c - '0');
+            }
+            if (length >= 0 && value != length)
+                return fail(400, "Conflicting Content-Length"_ba);
+            length = value;
+        }
+    }
+    if (length > m_maxBodySize)
+        return fail(413, "Request body too large"_ba);
+
+    m_remaining = length;
+    m_request.body.reserve(qsizetype(qMin(length, qint64(MaxBodyReservation))));
+    m_state = length > 0 ? State::Body : State::Complete;
+    return true;
+}
+
+bool QMcpHttpRequestParser::parseChunkSize(QByteArrayView line)
+{
+    const auto semicolon = line.indexOf(';');
+    const auto digits = (semicolon < 0 ? line : line.first(semicolon)).trimmed();
+    // 15 hex digits cannot overflow a qint64.
+    if (digits.isEmpty() || digits.size() > 15)
+        return fail(400, "Invalid chunk size"_ba);
+    qint64 size = 0;
+    for (const char c : digits) {
+        const int value = hexValue(c);
+        if (value < 0)
+            return fail(400, "Invalid chunk size"_ba);
+        size = size * 16 + value;
+    }
+
+    if (size == 0) {
+        m_state = State::Trailers;
+        return true;
+    }
+    if (m_request.body.size() + size > m_maxBodySize)
+        return fail(413, "Request body too large"_ba);
+    m_remaining = size;
+    m_state = State::ChunkData;
+    return true;
+}
+
+void QMcpHttpRequestParser::readBody()
+{
+    const auto n = qsizetype(qMin(m_remaining, qint64(m_buffer.size() - m_pos)));
+    m_request.body.append(QByteArrayView(m_buffer).sliced(m_pos, n));
+    m_pos += n;
+    m_scan = m_pos;
+    m_remaining -= n;
+}
+
+bool QMcpHttpRequestParser::fail(int statusCode, const QByteArray &message)
+{
+    m_state = State::Failed;
+    m_errorStatusCode = statusCode;
+    m_errorString = message;
+    return false;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,133 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPHTTPREQUESTPARSER_P_H
+#define QMCPHTTPREQUESTPARSER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpServer/qmcpserverglobal.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtNetwork/QHttpHeaders>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpHttpRequestParser
+    \internal
+    \inmodule QtMcpServer
+    \brief Incremental HTTP/1.1 request parser.
+
+    Bytes are fed as they arrive and parse() resumes exactly where it
+    stopped, so no byte is scanned twice however the stream is split. A
+    connection's requests are returned one by one in the order they were
+    sent; bytes of a pipelined next request stay buffered until the current
+    one was taken.
+
+    Bodies are framed by Content-Length or \c {Transfer-Encoding: chunked};
+    chunked bodies are decoded. A message carrying both is rejected, as is
+    anything the limits do not allow: the request line and headers together
+    may not exceed maxHeaderSize() bytes and maxHeaderCount() fields, and the
+    decoded body not maxBodySize() bytes. errorStatusCode() then tells the
+    status to answer with before closing the connection.
+*/
+class Q_MCPSERVER_EXPORT QMcpHttpRequestParser
+{
+public:
+    static constexpr qsizetype DefaultMaxHeaderSize = 64 * 1024;
+    static constexpr int DefaultMaxHeaderCount = 100;
+    static constexpr qint64 DefaultMaxBodySize = 16 * 1024 * 1024;
+
+    enum class Status {
+        NeedMoreData,
+        RequestReady,
+        Error,
+    };
+
+    struct Request {
+        QByteArray method;
+        // Percent-encoded, as sent.
+        QByteArray path;
+        QByteArray query;
+        int minorVersion = 1;
+        QHttpHeaders headers;
+        QByteArray body;
+        bool keepAlive = true;
+    };
+
+    qsizetype maxHeaderSize() const { return m_maxHeaderSize; }
+    void setMaxHeaderSize(qsizetype size) { m_maxHeaderSize = size; }
+    int maxHeaderCount() const { return m_maxHeaderCount; }
+    void setMaxHeaderCount(int count) { m_maxHeaderCount = count; }
+    qint64 maxBodySize() const { return m_maxBodySize; }
+    void setMaxBodySize(qint64 size) { m_maxBodySize = size; }
+
+    void feed(QByteArrayView data);
+    Status parse();
+    Request takeRequest();
+    void reset();
+
+    // Whether bytes of a request not yet complete are buffered.
+    bool hasPendingData() const { return m_pos < m_buffer.size() || m_state != State::RequestLine; }
+    // Whether a request was begun but its headers are not complete yet.
+    bool isReadingHeaders() const
+    {
+        return m_state == State::Headers || (m_state == State::RequestLine && m_pos < m_buffer.size());
+    }
+    int errorStatusCode() const { return m_errorStatusCode; }
+    QByteArray errorString() const { return m_errorString; }
+
+private:
+    enum class State {
+        RequestLine,
+        Headers,
+        Body,
+        ChunkSize,
+        ChunkData,
+        ChunkDataEnd,
+        Trailers,
+        Complete,
+        Failed,
+    };
+
+    bool nextLine(QByteArrayView *line, qsizetype maxLength, int tooLongStatusCode);
+    bool parseRequestLine(QByteArrayView line);
+    bool parseHeaderLine(QByteArrayView line);
+    bool headersComplete();
+    bool parseChunkSize(QByteArrayView line);
+    void readBody();
+    void clearRequest();
+    bool fail(int statusCode, const QByteArray &message);
+
+    QByteArray m_buffer;
+    // Start of the bytes not consumed yet.
+    qsizetype m_pos = 0;
+    // Where the search for the next line feed resumes.
+    qsizetype m_scan = 0;
+    State m_state = State::RequestLine;
+    Request m_request;
+    qsizetype m_headerBytes = 0;
+    int m_headerCount = 0;
+    qint64 m_remaining = 0;
+
+    qsizetype m_maxHeaderSize = DefaultMaxHeaderSize;
+    int m_maxHeaderCount = DefaultMaxHeaderCount;
+    qint64 m_maxBodySize = DefaultMaxBodySize;
+
+    int m_errorStatusCode = 0;
+    QByteArray m_errorString;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPHTTPREQUESTPARSER_P_H
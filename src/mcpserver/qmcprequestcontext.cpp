@@ -0,0 +1,136 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcprequestcontext.h"
+#include <QtCore/QDebug>
+#include <QtMcpCommon/QMcpInputRequiredResult>
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+// Handles are copied into the continuations of async handlers, which may run
+// on another thread; the request is only ever handled by one of them at a
+// time, so the data needs no lock.
+struct QMcpRequestContext::Data
+{
+    QUuid sessionId;
+    QJsonValue requestId;
+    QtMcp::ProtocolVersion protocolVersion = QtMcp::ProtocolVersion::Latest;
+    QJsonObject clientCapabilities;
+    QJsonObject inputResponses;
+    QJsonValue clientRequestState;
+    bool inputRequired = false;
+    QJsonObject requiredInputRequests;
+    QJsonValue requiredRequestState;
+    QJsonObject resultOverride;
+    PartialResultSink partialResultSink;
+};
+
+QMcpRequestContext::QMcpRequestContext() = default;
+
+QMcpRequestContext::QMcpRequestContext(const QUuid &sessionId, const QJsonValue &requestId, QtMcp::ProtocolVersion protocolVersion)
+    : d(std::make_shared<Data>())
+{
+    d->sessionId = sessionId;
+    d->requestId = requestId;
+    d->protocolVersion = protocolVersion;
+}
+
+bool QMcpRequestContext::isValid() const
+{
+    return bool(d);
+}
+
+QUuid QMcpRequestContext::sessionId() const
+{
+    return d ? d->sessionId : QUuid();
+}
+
+QJsonValue QMcpRequestContext::requestId() const
+{
+    return d ? d->requestId : QJsonValue();
+}
+
+QtMcp::ProtocolVersion QMcpRequestContext::protocolVersion() const
+{
+    return d ? d->protocolVersion : QtMcp::ProtocolVersion::Latest;
+}
+
+QJsonObject QMcpRequestContext::clientCapabilities() const
+{
+    return d ? d->clientCapabilities : QJsonObject();
+}
+
+void QMcpRequestContext::setClientCapabilities(const QJsonObject &capabilities)
+{
+    if (d)
+        d->clientCapabilities = capabilities;
+}
+
+QJsonObject QMcpRequestContext::inputResponses() const
+{
+    return d ? d->inputResponses : QJsonObject();
+}
+
+QJsonValue QMcpRequestContext::clientRequestState() const
+{
+    return d ? d->clientRequestState : QJsonValue();
+}
+
+void QMcpRequestContext::setInputResponses(const QJsonObject &responses, const QJsonValue &requestState)
+{
+    if (!d)
+        return;
+    d->inputResponses = responses;
+    d->clientRequestState = requestState;
+}
+
+void QMcpRequestContext::requireInput(const QJsonObject &inputRequests, const QJsonValue &requestState)
+{
+    if (!d)
+        return;
+    if (d->protocolVersion < QtMcp::ProtocolVersion::v2026_07_28) {
+        qWarning() << "requireInput() needs MCP 2026-07-28, session uses"
+                   << QtMcp::protocolVersionToString(d->protocolVersion);
+        return;
+    }
+    d->inputRequired = true;
+    d->requiredInputRequests = inputRequests;
+    d->requiredRequestState = requestState;
+}
+
+void QMcpRequestContext::overrideResult(const QJsonObject &result)
+{
+    if (d)
+        d->resultOverride = result;
+}
+
+QJsonObject QMcpRequestContext::takeResultOverride()
+{
+    if (!d)
+        return QJsonObject();
+    if (std::exchange(d->inputRequired, false)) {
+        QMcpInputRequiredResult result;
+        result.setInputRequests(std::exchange(d->requiredInputRequests, QJsonObject()));
+        auto object = result.toJsonObject(d->protocolVersion);
+        const auto requestState = std::exchange(d->requiredRequestState, QJsonValue());
+        if (!requestState.isUndefined() && !requestState.isNull())
+            object.insert("requestState"_L1, requestState);
+        return object;
+    }
+    return std::exchange(d->resultOverride, QJsonObject());
+}
+
+QMcpRequestContext::PartialResultSink QMcpRequestContext::partialResultSink() const
+{
+    return d ? d->partialResultSink : PartialResultSink();
+}
+
+void QMcpRequestContext::setPartialResultSink(const PartialResultSink &sink)
+{
+    if (d)
+        d->partialResultSink = sink;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,108 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPREQUESTCONTEXT_H
+#define QMCPREQUESTCONTEXT_H
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QUuid>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/qmcpserverglobal.h>
+
+#include <functional>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpRequestContext
+    \inmodule QtMcpServer
+    \brief The QMcpRequestContext class holds the state of one request a QMcpServer is handling.
+
+    Every request gets its own context: the client capabilities a stateless
+    (2026-07-28) client sent with it, the MRTR input responses and request
+    state of a retry, and the result that replaces the handler's, such as
+    an input_required interim result. Requests that share a session, like
+    all stateless clients of one Streamable HTTP server, therefore do not
+    see each other's state and may be handled concurrently.
+
+    The context is a handle: copies refer to the same request. A handler
+    that finishes asynchronously obtains it with
+    QMcpServerSession::currentRequest() while it is being called and keeps
+    the copy for later, for example to call requireInput() from a
+    continuation.
+
+    \sa QMcpServerSession::currentRequest()
+*/
+class Q_MCPSERVER_EXPORT QMcpRequestContext
+{
+public:
+    /*!
+        Constructs an invalid context, one that belongs to no request.
+    */
+    QMcpRequestContext();
+    QMcpRequestContext(const QUuid &sessionId, const QJsonValue &requestId, QtMcp::ProtocolVersion protocolVersion);
+
+    bool isValid() const;
+    QUuid sessionId() const;
+    QJsonValue requestId() const;
+    QtMcp::ProtocolVersion protocolVersion() const;
+
+    /*!
+        The client capabilities carried in the request's _meta, e.g. the
+        declared extensions. Only stateless (2026-07-28) clients send them
+        per request; empty otherwise.
+    */
+    QJsonObject clientCapabilities() const;
+    void setClientCapabilities(const QJsonObject &capabilities);
+
+    /*!
+        The input the client supplied on a retry of a request that required
+        input (MRTR, 2026-07-28), and the request state it echoed back. Both
+        are empty on a first attempt.
+    */
+    QJsonObject inputResponses() const;
+    QJsonValue clientRequestState() const;
+    void setInputResponses(const QJsonObject &responses, const QJsonValue &requestState);
+
+    /*!
+        Answers the request with an input_required interim result asking for
+        \a inputRequests instead of the handler's result. \a requestState
+        round-trips through the client. Needs MCP 2026-07-28.
+    */
+    void requireInput(const QJsonObject &inputRequests, const QJsonValue &requestState = QJsonValue());
+
+    /*!
+        Replaces the request's result with the pre-serialized \a result, e.g.
+        a CreateTaskResult from the tasks extension.
+    */
+    void overrideResult(const QJsonObject &result);
+
+    /*!
+        Returns the object that replaces the handler's result, or an empty
+        object, and consumes it: the input_required interim result when
+        requireInput() was called, otherwise the overridden result.
+    */
+    QJsonObject takeResultOverride();
+
+    /*!
+        Sends content blocks of a tool call's result ahead of its response.
+        Set by the server when the client asked for partial results and the
+        transport can deliver them while the call is pending; null
+        otherwise.
+        \sa QMcpToolResultWriter
+    */
+    using PartialResultSink = std::function<void(const QJsonArray &content)>;
+    PartialResultSink partialResultSink() const;
+    void setPartialResultSink(const PartialResultSink &sink);
+
+private:
+    struct Data;
+    std::shared_ptr<Data> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPREQUESTCONTEXT_H
@@ -3,16 +3,30 @@
 
 #include "qmcpserver.h"
 #include "qmcpserversession.h"
+#include "qmcpserverstatistics_p.h"
+#include "qmcpsubscriptionindex_p.h"
+#include "qmcptoolscheduler_p.h"
 #include <algorithm>
+#include <limits>
 #include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
 #include <QtCore/QMetaType>
+#include <QtCore/QPointer>
 #include <QtCore/QPromise>
+#include <QtCore/QScopeGuard>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtCore/private/qfactoryloader_p.h>
 #include <QtCore/qjsonobject.h>
 #ifdef QT_GUI_LIB
 #include <QtGui/QAction>
 #endif
 #include <QtMcpCommon>
+#include <QtMcpCommon/private/qmcppendingrequests_p.h>
+#include <QtMcpCommon/private/qmcptracer_p.h>
 #include <QtMcpServer/qmcpserverbackendinterface.h>
 #include <QtMcpServer/qmcpserverbackendplugin.h>
 QT_BEGIN_NAMESPACE
@@ -34,35 +48,101 @@ static const QStringList &methodsRemovedIn2026_07_28()
     return methods;
 }
 
+// Since 2026-07-28 change notifications carry the id of the subscription
+// they were sent for.
+static QJsonObject withSubscriptionId(QJsonObject object, const QString &subscriptionId)
+{
+    auto params = object.value("params"_L1).toObject();
+    auto meta = params.value("_meta"_L1).toObject();
+    meta.insert("io.modelcontextprotocol/subscriptionId"_L1, subscriptionId);
+    params.insert("_meta"_L1, meta);
+    object.insert("params"_L1, params);
+    return object;
+}
+
+// The change notifications sessions raise, by method. uri is only used by
+// notifications/resources/updated.
+static QJsonObject changeNotification(const QString &method, const QUrl &uri, QtMcp::ProtocolVersion version)
+{
+    if (method == "notifications/resources/updated"_L1) {
+        QMcpResourceUpdatedNotification notification;
+        auto params = notification.params();
+        params.setUri(uri);
+        notification.setParams(params);
+        return notification.toJsonObject(version);
+    }
+    if (method == "notifications/resources/list_changed"_L1)
+        return QMcpResourceListChangedNotification().toJsonObject(version);
+    if (method == "notifications/prompts/list_changed"_L1)
+        return QMcpPromptListChangedNotification().toJsonObject(version);
+    return QMcpToolListChangedNotification().toJsonObject(version);
+}
+
+// tasks extension: how long a task stays retrievable after creation, the
+// poll interval suggested for a tool with no history, and the bounds of the
+// interval. Only a tool's history lets it go below the default.
+static constexpr int TaskTtlMs = 300000;
+static constexpr int DefaultTaskPollIntervalMs = 500;
+static constexpr int MinTaskPollIntervalMs = 100;
+static constexpr int MaxTaskPollIntervalMs = 5000;
+
 class QMcpServer::Private
 {
 public:
     Private(const QString &type, QMcpServer *parent);
+    ~Private();
 
     QMcpServerSession *findSession(const QUuid &sessionId, bool isInitialized, QMcpJSONRPCErrorError *error = nullptr) const;
     void sendTaggedNotification(QMcpServerSession *session, const QMcpNotification &notification) const;
+    bool wantsChangeNotification(const QMcpServerSession *session, const QString &method, const QUrl &uri) const;
+    void postChangeNotification(const QUuid &sessionId, const QString &method, const QUrl &uri = {});
+    void sendChangeNotification(const QUuid &sessionId, const QString &method, const QUrl &uri);
+    void broadcastResourceUpdated(const QUrl &uri);
+    void flushChangeNotifications();
+    int taskPollIntervalMs(const QString &taskId) const;
+    void taskStatusChanged(const QString &taskId);
+    quint64 requestStarted(const QUuid &session, const QJsonValue &id, const QString &method, const QJsonObject &params);
+    quint64 requestFinished(const QUuid &session, const QJsonObject &response);
+    void admitRequest(const QUuid &session, const QJsonObject &object, quint64 trace);
+    void toolCallFinished(const QUuid &session, const QJsonValue &id);
+    void runQueuedToolCalls();
+    void dispatchRequest(const QUuid &session, const QJsonObject &object, quint64 trace);
+    void setPartialResultSink(QMcpRequestContext *context, const QUuid &session, const QJsonObject &params) const;
+    QString deduplicationKey(const QUuid &session, const QString &method, const QJsonObject &object) const;
+    void answerFollowers(const QUuid &session, const QJsonObject &response);
+    void endSession(const QUuid &sessionId);
+    void forgetSession(const QUuid &sessionId);
+    void sweepIdleSessions();
 private:
     QMcpServer *q;
 public:
     QMcpServerBackendInterface *backend = nullptr;
+    QString backendType;
     QMcpServerCapabilities capabilities;
     QString instructions;
     QtMcp::ProtocolVersion protocolVersion = QtMcp::ProtocolVersion::Latest; // Default to latest version
     QList<QtMcp::ProtocolVersion> supportedVersions = {QtMcp::ProtocolVersion::v2024_11_05, QtMcp::ProtocolVersion::v2025_03_26, QtMcp::ProtocolVersion::v2025_06_18, QtMcp::ProtocolVersion::v2025_11_25, QtMcp::ProtocolVersion::v2026_07_28};
-    QHash<QUuid, QHash<QJsonValue, std::function<void(const QUuid &session, const QJsonObject &)>>> callbacks;
+    // Requests sent to clients that still await an answer.
+    QMcpPendingRequests pending;
     QHash<QString, std::function<QJsonValue(const QUuid &, const QJsonObject&, QMcpJSONRPCErrorError *)>> requestHandlers;
     QMultiHash<QString, std::function<void(const QUuid &, const QJsonObject&)>> notificationHandlers;
     QHash<QUuid, QMcpServerSession *> sessions;
     QHash<QObject *, QHash<QString, QString>> toolSets;
+    QList<QPair<QMcpTool, QMcpServerSession::ToolFunction>> functionTools;
 
     // io.modelcontextprotocol/tasks extension
     struct TaskEntry {
         QUuid session;
+        QString toolName;
         QMcpTaskStatus::QMcpTaskStatus status = QMcpTaskStatus::working;
         QString createdAt;
         QString lastUpdatedAt;
+        qint64 startedAtMs = 0;
+        qint64 finishedAtMs = 0;
         QFuture<QMcpCallToolResult> future;
         QJsonObject result;
+        // The JSON-RPC error of a failed task.
+        QJsonObject error;
         QJsonObject inputResponses;
     };
     // Shared with the task futures' continuations: a continuation may fire
@@ -71,15 +151,98 @@ public:
     // rather than reach through the dangling d pointer.
     using TaskMap = QHash<QString, TaskEntry>;
     std::shared_ptr<TaskMap> tasks = std::make_shared<TaskMap>();
+    // How the continuations report a transition back. Cleared by ~Private, so
+    // a continuation fired during destruction only updates the registry.
+    using TaskListener = std::function<void(const QString &taskId)>;
+    std::shared_ptr<TaskListener> taskListener = std::make_shared<TaskListener>();
+    static void failTask(const std::shared_ptr<TaskMap> &tasks, const std::shared_ptr<TaskListener> &listener,
+                         const QString &taskId, const QJsonObject &error);
+    // Smoothed run time of the tasks each tool produced, the basis of the
+    // suggested poll interval.
+    QHash<QString, qint64> expectedTaskDurationMs;
     bool tasksExtensionEnabled = false;
 #ifdef QT_GUI_LIB
     QHash<QAction *, QString> actions;
 #endif
+
+    // Statistics. Requests are dispatched and answered on the server's own
+    // thread, so plain counters need no synchronization.
+    struct InFlight {
+        QString method;
+        QString tool;
+        QElapsedTimer timer;
+        // The request's QMcpTracer trace, 0 when not traced.
+        quint64 trace = 0;
+    };
+    QHash<QUuid, QHash<QJsonValue, InFlight>> inFlight;
+    QHash<QString, QMcpServerStatistics::Counter> methodStatistics;
+    QHash<QString, QMcpServerStatistics::Counter> toolStatistics;
+    QHash<int, quint64> errorCodes;
+
+    // Request deduplication: identical requests in flight at the same time
+    // share the first one's handler run and response.
+    QHash<QString, DeduplicationScope> deduplication;
+    struct Flight {
+        QUuid session;
+        QJsonValue id;
+        QJsonObject request;
+        QList<std::pair<QUuid, QJsonValue>> followers;
+    };
+    QHash<QString, Flight> flights;
+    QHash<QUuid, QHash<QJsonValue, QString>> flightLeaders;
+
+    // Session lifecycle: when each session last received a message, on
+    // activityClock, for evicting the idle ones.
+    int sessionIdleTimeout = 0;
+    QElapsedTimer activityClock;
+    QHash<QUuid, qint64> lastActivity;
+    QTimer idleSweep;
+
+    // Which sessions are subscribed to which resources, shared with the
+    // sessions, which keep it up to date.
+    std::shared_ptr<QMcpSubscriptionIndex> subscriptionIndex = std::make_shared<QMcpSubscriptionIndex>();
+
+    // Notification coalescing: change notifications raised again before
+    // the previous one went out are folded into it. Pending ones are keyed
+    // by session, method and URI; a null session stands for a
+    // notifyResourceUpdated() fan out.
+    struct Coalescing {
+        int window = 0;
+        int maxLatency = 0;
+    };
+    Coalescing notificationCoalescing;
+    QHash<QString, Coalescing> resourceCoalescing;
+    struct PendingNotification {
+        QUuid session;
+        QString method;
+        QUrl uri;
+        // Due at whichever comes first: window after the last change, or
+        // maxLatency after the first.
+        qint64 due = 0;
+        qint64 deadline = 0;
+        Coalescing coalescing;
+    };
+    QHash<QString, PendingNotification> pendingNotifications;
+    QTimer notificationFlush;
+    QHash<QString, quint64> notificationsCoalesced;
+
+    // Admission control: tools/call requests wait for the concurrency
+    // limits to leave room for them, in the order the scheduler picks.
+    QMcpToolScheduler scheduler;
+    QMcpServerStatistics::Counter toolQueueWait;
 };
 
 QMcpServer::Private::Private(const QString &type, QMcpServer *parent)
     : q(parent)
 {
+    *taskListener = [this](const QString &taskId) { taskStatusChanged(taskId); };
+    backendType = type;
+    QMcpTracer::initialize();
+    activityClock.start();
+    connect(&idleSweep, &QTimer::timeout, q, [this]() { sweepIdleSessions(); });
+    notificationFlush.setSingleShot(true);
+    connect(&notificationFlush, &QTimer::timeout, q, [this]() { flushChangeNotifications(); });
+
     QMcpServerCapabilitiesResources resources;
     resources.setListChanged(true);
     resources.setSubscribe(true);
@@ -102,8 +265,12 @@ QMcpServer::Private::Private(const QString &type, QMcpServer *parent)
     backend->setParent(q);
     connect(backend, &QMcpServerBackendInterface::started, q, &QMcpServer::started);
     connect(backend, &QMcpServerBackendInterface::finished, q, &QMcpServer::finished);
+    connect(backend, &QMcpServerBackendInterface::sessionEnded, q, [this](const QUuid &sessionId) {
+        endSession(sessionId);
+    });
     connect(backend, &QMcpServerBackendInterface::newSessionStarted, q, [this](const QUuid &sessionId) {
         auto session = new QMcpServerSession(sessionId, q);
+        session->setSubscriptionIndex(subscriptionIndex);
 
         // register self as tool set if it inherits from QMcpServer
         if (q->metaObject() != &QMcpServer::staticMetaObject)
@@ -112,87 +279,56 @@ QMcpServer::Private::Private(const QString &type, QMcpServer *parent)
         // register known tool set
         for (auto i = toolSets.cbegin(), end = toolSets.cend(); i != end; ++i)
             session->registerToolSet(i.key(), i.value());
+        for (const auto &pair : std::as_const(functionTools))
+            session->addTool(pair.first, pair.second);
 #ifdef QT_GUI_LIB
         for (auto i = actions.cbegin(), end = actions.cend(); i != end; ++i)
             session->registerTool(i.key(), i.value());
 #endif
 
         sessions.insert(sessionId, session);
+        lastActivity.insert(sessionId, activityClock.elapsed());
+        connect(session, &QObject::destroyed, q, [this, sessionId]() {
+            forgetSession(sessionId);
+        });
         // On sessions before 2026-07-28 change notifications flow freely once
         // the session is initialized; since 2026-07-28 they only go to clients
         // that opted in via subscriptions/listen, tagged with the
         // subscription id.
         connect(session, &QMcpServerSession::resourceUpdated, q, [this, session](const QMcpResource &resource) {
-            if (!session->isInitialized()) return;
             const auto uri = resource.uri();
-            if (session->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
-                if (!session->hasListenSubscriptions()
-                    || !session->listenSubscriptions().resourceSubscriptions().contains(uri.toString()))
-                    return;
-                QMcpResourceUpdatedNotification notification;
-                auto params = notification.params();
-                params.setUri(uri);
-                notification.setParams(params);
-                sendTaggedNotification(session, notification);
-                return;
-            }
-            if (session->isSubscribed(uri)) {
-                QMcpResourceUpdatedNotification notification;
-                auto params = notification.params();
-                params.setUri(uri);
-                notification.setParams(params);
-                q->notify(session->sessionId(), notification, session->protocolVersion());
-            }
+            if (wantsChangeNotification(session, "notifications/resources/updated"_L1, uri))
+                postChangeNotification(session->sessionId(), "notifications/resources/updated"_L1, uri);
         });
         connect(session, &QMcpServerSession::resourceListChanged, q, [this, session]() {
-            if (!session->isInitialized()) return;
-            QMcpResourceListChangedNotification notification;
-            if (session->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
-                if (session->hasListenSubscriptions() && session->listenSubscriptions().resourcesListChanged())
-                    sendTaggedNotification(session, notification);
-                return;
-            }
-            q->notify(session->sessionId(), notification, session->protocolVersion());
+            if (wantsChangeNotification(session, "notifications/resources/list_changed"_L1, {}))
+                postChangeNotification(session->sessionId(), "notifications/resources/list_changed"_L1);
         });
         connect(session, &QMcpServerSession::promptListChanged, q, [this, session]() {
-            if (!session->isInitialized()) return;
-            QMcpPromptListChangedNotification notification;
-            if (session->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
-                if (session->hasListenSubscriptions() && session->listenSubscriptions().promptsListChanged())
-                    sendTaggedNotification(session, notification);
-                return;
-            }
-            q->notify(session->sessionId(), notification, session->protocolVersion());
+            if (wantsChangeNotification(session, "notifications/prompts/list_changed"_L1, {}))
+                postChangeNotification(session->sessionId(), "notifications/prompts/list_changed"_L1);
         });
         connect(session, &QMcpServerSession::toolListChanged, q, [this, session]() {
-            if (!session->isInitialized()) return;
-            QMcpToolListChangedNotification notification;
-            if (session->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
-                if (session->hasListenSubscriptions() && session->listenSubscriptions().toolsListChanged())
-                    sendTaggedNotification(session, notification);
-                return;
-            }
-            q->notify(session->sessionId(), notification, session->protocolVersion());
+            if (wantsChangeNotification(session, "notifications/tools/list_changed"_L1, {}))
+                postChangeNotification(session->sessionId(), "notifications/tools/list_changed"_L1);
         });
 
         emit q->newSession(session);
     });
     connect(backend, &QMcpServerBackendInterface::received, q, [this](const QUuid &session, const QJsonObject &object) {
+        if (const auto it = lastActivity.find(session); it != lastActivity.end())
+            *it = activityClock.elapsed();
         // response
-        if (object.contains("id"_L1)) {
+        if (object.contains("id"_L1) && !object.contains("method"_L1)) {
             const auto id = object.value("id"_L1);
-            if (object.contains("result"_L1)) {
-                if (callbacks[session].contains(id)) {
-                    const auto result = object.value("result"_L1).toObject();
-                    callbacks[session].take(id)(session, result);
-                    return;
-                }
-            } else if (object.contains("error"_L1)) {
-                qWarning() << "TODO: error handling" << object;;
-                if (callbacks[session].contains(id)) {
-                    callbacks[session].take(id)(session, {});
+            if (object.contains("result"_L1) || object.contains("error"_L1)) {
+                if (const auto callback = pending.take(session, id)) {
+                    callback(object.value("result"_L1).toObject(), object.value("error"_L1).toObject());
                     return;
                 }
+                // Already timed out, or never ours.
+                qWarning() << "Response to an unknown request" << object;
+                return;
             }
         }
         if (object.contains("method"_L1)) {
@@ -211,10 +347,6 @@ QMcpServer::Private::Private(const QString &type, QMcpServer *parent)
                             sessionObj->setProtocolVersion(version);
                             sessionObj->setInitialized(true);
                         }
-                        // Stateless clients re-declare their capabilities,
-                        // including extensions, on every request.
-                        sessionObj->setClientCapabilitiesJson(
-                            requestMeta.value("io.modelcontextprotocol/clientCapabilities"_L1).toObject());
                     }
                 }
             }
@@ -222,6 +354,7 @@ QMcpServer::Private::Private(const QString &type, QMcpServer *parent)
             // request
             if (object.contains("id"_L1)) {
                 const auto id = object.value("id"_L1);
+                const auto trace = requestStarted(session, id, method, object.value("params"_L1).toObject());
                 const auto sessionForMethod = sessions.value(session);
                 if (sessionForMethod && sessionForMethod->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28
                     && methodsRemovedIn2026_07_28().contains(method)) {
@@ -234,69 +367,30 @@ QMcpServer::Private::Private(const QString &type, QMcpServer *parent)
                     q->send(session, response.toJsonObject(sessionForMethod->protocolVersion()));
                     return;
                 }
-                if (requestHandlers.contains(method)) {
-                    const auto handler = requestHandlers.value(method);
-                    // MRTR (2026-07-28): make the retry's inputResponses and
-                    // requestState available to the handler; both are empty on
-                    // a first attempt.
-                    if (sessionForMethod && sessionForMethod->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
-                        const auto params = object.value("params"_L1).toObject();
-                        sessionForMethod->provideInputResponses(params.value("inputResponses"_L1).toObject(),
-                                                                params.value("requestState"_L1));
-                    }
-                    QMcpJSONRPCErrorError error;
-                    auto result = handler(session, object, &error);
-                    // Substitute only for synchronous handlers: an async
-                    // handler returns an empty value here and its future
-                    // continuation performs the same substitution when it
-                    // sends the response.
-                    if (result.isObject()) {
-                        const auto interim = q->takePendingResultOverride(session);
-                        if (!interim.isEmpty())
-                            result = interim;
+                if (const auto key = deduplicationKey(session, method, object); !key.isEmpty()) {
+                    const auto it = flights.find(key);
+                    if (it != flights.end()) {
+                        // An identical request is already being handled;
+                        // this one is answered with its response.
+                        it->followers.append({ session, id });
+                        return;
                     }
-                    // JSON-RPC error codes are negative; any non-zero code
-                    // set by the handler is an error.
-                    if (error.code() != 0) {
-                        QMcpJSONRPCError response;
-                        response.setId(id);
-                        response.setError(error);
-                        auto sessionObj = sessions.value(session);
-                        q->send(session, response.toJsonObject(sessionObj ?
-                                sessionObj->protocolVersion() :
-                                protocolVersion));
-                    } else if (result.isObject()){
-                        QMcpJSONRPCResponse response;
-                        response.setId(id);
-                        auto sessionObj = sessions.value(session);
-                        const auto version = sessionObj ? sessionObj->protocolVersion() : protocolVersion;
-                        auto object = response.toJsonObject(version);
-                        auto resultObject = result.toObject();
-                        if (version >= QtMcp::ProtocolVersion::v2026_07_28) {
-                            // Since 2026-07-28 the server identifies itself in
-                            // every result instead of only in initialize.
-                            auto resultMeta = resultObject.value("_meta"_L1).toObject();
-                            QJsonObject serverInfo;
-                            serverInfo.insert("name"_L1, QCoreApplication::applicationName());
-                            serverInfo.insert("version"_L1, QCoreApplication::applicationVersion());
-                            resultMeta.insert("io.modelcontextprotocol/serverInfo"_L1, serverInfo);
-                            resultObject.insert("_meta"_L1, resultMeta);
-                        }
-                        object.insert("result"_L1, resultObject);
-                        q->send(session, object);
-                    }
-                } else {
-                    // Respond with error
-                    QMcpJSONRPCError response;
-                    response.setId(id.toVariant());
-                    auto error = response.error();
-                    error.setMessage("Server doesn't handle the request"_L1);
-                    response.setError(error);
-                    auto sessionObj = sessions.value(session);
-                    q->send(session, response.toJsonObject(sessionObj ?
-                            sessionObj->protocolVersion() :
-                            protocolVersion));
+                    flights.insert(key, { session, id, object, {} });
+                    flightLeaders[session].insert(id, key);
+                    // Run the handler once the messages that arrived along
+                    // with this one were read, so that identical requests
+                    // among them join it.
+                    QMetaObject::invokeMethod(q, [this, session, id, object, trace]() {
+                        // The session may have ended in the meantime;
+                        // forgetSession() then took the request and let
+                        // its followers go on their own.
+                        if (!sessions.contains(session) || !flightLeaders.value(session).contains(id))
+                            return;
+                        admitRequest(session, object, trace);
+                    }, Qt::QueuedConnection);
+                    return;
                 }
+                admitRequest(session, object, trace);
                 return;
             }
 
@@ -327,13 +421,587 @@ QMcpServer::Private::Private(const QString &type, QMcpServer *parent)
 // with the session's subscription id as the spec requires.
 void QMcpServer::Private::sendTaggedNotification(QMcpServerSession *session, const QMcpNotification &notification) const
 {
-    auto object = notification.toJsonObject(session->protocolVersion());
+    q->send(session->sessionId(),
+            withSubscriptionId(notification.toJsonObject(session->protocolVersion()),
+                               session->listenSubscriptionId()));
+}
+
+bool QMcpServer::Private::wantsChangeNotification(const QMcpServerSession *session, const QString &method, const QUrl &uri) const
+{
+    if (!session->isInitialized())
+        return false;
+    const bool listens = session->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28;
+    if (method == "notifications/resources/updated"_L1) {
+        if (!subscriptionIndex->isSubscribed(session->sessionId(), uri.toString()))
+            return false;
+        return !listens || session->hasListenSubscriptions();
+    }
+    if (!listens)
+        return true;
+    if (!session->hasListenSubscriptions())
+        return false;
+    const auto filter = session->listenSubscriptions();
+    if (method == "notifications/resources/list_changed"_L1)
+        return filter.resourcesListChanged();
+    if (method == "notifications/prompts/list_changed"_L1)
+        return filter.promptsListChanged();
+    return filter.toolsListChanged();
+}
+
+// Sends the notification, or folds it into the same one still waiting for
+// its coalescing window to close.
+void QMcpServer::Private::postChangeNotification(const QUuid &sessionId, const QString &method, const QUrl &uri)
+{
+    const auto coalescing = uri.isEmpty()
+            ? notificationCoalescing
+            : resourceCoalescing.value(uri.toString(), notificationCoalescing);
+    if (coalescing.window <= 0 && coalescing.maxLatency <= 0) {
+        sendChangeNotification(sessionId, method, uri);
+        return;
+    }
+
+    const auto now = activityClock.elapsed();
+    const auto key = sessionId.toString(QUuid::WithoutBraces) + u'\n' + method + u'\n' + uri.toString();
+    auto it = pendingNotifications.find(key);
+    if (it == pendingNotifications.end()) {
+        PendingNotification notification;
+        notification.session = sessionId;
+        notification.method = method;
+        notification.uri = uri;
+        notification.coalescing = coalescing;
+        notification.deadline = coalescing.maxLatency > 0 ? now + coalescing.maxLatency
+                                                          : std::numeric_limits<qint64>::max();
+        it = pendingNotifications.insert(key, notification);
+    } else {
+        ++notificationsCoalesced[method];
+    }
+    // Without a window the changes are batched until the deadline.
+    const auto quiet = it->coalescing.window > 0 ? now + it->coalescing.window : it->deadline;
+    it->due = qMin(quiet, it->deadline);
+
+    const auto remaining = it->due - now;
+    if (!notificationFlush.isActive() || notificationFlush.remainingTime() > remaining)
+        notificationFlush.start(int(remaining));
+}
+
+void QMcpServer::Private::sendChangeNotification(const QUuid &sessionId, const QString &method, const QUrl &uri)
+{
+    if (sessionId.isNull()) {
+        broadcastResourceUpdated(uri);
+        return;
+    }
+    // Checked again: the session may have unsubscribed while the
+    // notification waited.
+    const auto *session = sessions.value(sessionId);
+    if (!session || !wantsChangeNotification(session, method, uri))
+        return;
+    const auto version = session->protocolVersion();
+    const auto object = changeNotification(method, uri, version);
+    if (version >= QtMcp::ProtocolVersion::v2026_07_28)
+        q->send(sessionId, withSubscriptionId(object, session->listenSubscriptionId()));
+    else
+        q->send(sessionId, object);
+}
+
+void QMcpServer::Private::broadcastResourceUpdated(const QUrl &uri)
+{
+    const auto subscribers = subscriptionIndex->subscribers(uri.toString());
+    if (subscribers.isEmpty())
+        return;
+
+    // Serialized once per protocol version in use, not once per session.
+    QMap<QtMcp::ProtocolVersion, QJsonObject> messages;
+    for (const auto &sessionId : subscribers) {
+        const auto *session = sessions.value(sessionId);
+        if (!session || !wantsChangeNotification(session, "notifications/resources/updated"_L1, uri))
+            continue;
+        const auto version = session->protocolVersion();
+        auto message = messages.find(version);
+        if (message == messages.end())
+            message = messages.insert(version, changeNotification("notifications/resources/updated"_L1, uri, version));
+        if (version >= QtMcp::ProtocolVersion::v2026_07_28)
+            q->send(sessionId, withSubscriptionId(*message, session->listenSubscriptionId()));
+        else
+            q->send(sessionId, *message);
+    }
+}
+
+void QMcpServer::Private::flushChangeNotifications()
+{
+    const auto now = activityClock.elapsed();
+    QList<PendingNotification> due;
+    qint64 next = std::numeric_limits<qint64>::max();
+    for (auto it = pendingNotifications.begin(); it != pendingNotifications.end();) {
+        if (it->due <= now) {
+            due.append(*it);
+            it = pendingNotifications.erase(it);
+        } else {
+            next = qMin(next, it->due);
+            ++it;
+        }
+    }
+    if (!pendingNotifications.isEmpty())
+        notificationFlush.start(int(next - now));
+
+    for (const auto &notification : std::as_const(due))
+        sendChangeNotification(notification.session, notification.method, notification.uri);
+}
+
+QMcpServer::Private::~Private()
+{
+    *taskListener = nullptr;
+}
+
+// Called when the backend reports a session gone. Handlers of the session's
+// requests may still be on the stack, so the object goes later; everything
+// the server keeps for the session goes now.
+void QMcpServer::Private::endSession(const QUuid &sessionId)
+{
+    auto *session = sessions.value(sessionId);
+    if (!session)
+        return;
+    forgetSession(sessionId);
+    session->deleteLater();
+    emit q->sessionEnded(sessionId);
+}
+
+// Drops what the server keeps for a session. Called again when the session
+// object is destroyed, so it must be idempotent.
+void QMcpServer::Private::forgetSession(const QUuid &sessionId)
+{
+    sessions.remove(sessionId);
+    lastActivity.remove(sessionId);
+    subscriptionIndex->removeSubscriber(sessionId);
+    for (auto it = pendingNotifications.begin(); it != pendingNotifications.end();) {
+        if (it->session == sessionId)
+            it = pendingNotifications.erase(it);
+        else
+            ++it;
+    }
+    // The answers to requests sent on a session that is gone will not come;
+    // drop their callbacks with it.
+    pending.removeOwner(sessionId);
+    // Its queued tool calls are dropped; the capacity its running ones held
+    // goes to the other sessions.
+    if (scheduler.running(sessionId) > 0)
+        QMetaObject::invokeMethod(q, [this]() { runQueuedToolCalls(); }, Qt::QueuedConnection);
+    scheduler.removeSession(sessionId);
+    const auto requests = inFlight.take(sessionId);
+    for (const auto &request : requests)
+        QMcpTracer::endTrace(request.trace);
+
+    // Its tasks can no longer be polled. Taken out before cancelling, so
+    // that the continuations find nothing to update.
+    for (auto it = tasks->begin(); it != tasks->end();) {
+        if (it->session != sessionId) {
+            ++it;
+            continue;
+        }
+        auto future = it->future;
+        it = tasks->erase(it);
+        future.cancel();
+    }
+
+    // Requests that joined one of this session's flights are on their own
+    // again.
+    const auto keys = flightLeaders.take(sessionId);
+    for (const auto &key : keys) {
+        const auto flight = flights.take(key);
+        for (const auto &[followerSession, followerId] : flight.followers) {
+            auto request = flight.request;
+            request.insert("id"_L1, followerId);
+            admitRequest(followerSession, request, 0);
+        }
+    }
+}
+
+// Closes the sessions that received nothing for sessionIdleTimeout. One that
+// is still answering a request or running a task is not idle.
+void QMcpServer::Private::sweepIdleSessions()
+{
+    QSet<QUuid> busy;
+    for (const auto &task : std::as_const(*tasks)) {
+        if (task.status == QMcpTaskStatus::working || task.status == QMcpTaskStatus::input_required)
+            busy.insert(task.session);
+    }
+    const auto now = activityClock.elapsed();
+    QList<QUuid> idle;
+    for (auto it = lastActivity.cbegin(), end = lastActivity.cend(); it != end; ++it) {
+        if (now - it.value() >= sessionIdleTimeout && !inFlight.contains(it.key()) && !busy.contains(it.key()))
+            idle.append(it.key());
+    }
+    for (const auto &sessionId : std::as_const(idle))
+        q->closeSession(sessionId);
+}
+
+// Suggests when a client should poll the task next. A tool's earlier tasks
+// tell how long this one likely runs, so the client is sent back around the
+// time it should be done; without history, or once the task overran, the
+// interval starts at the default and grows with the task's age. A client
+// listening for pushes only needs polls as a safety net.
+int QMcpServer::Private::taskPollIntervalMs(const QString &taskId) const
+{
+    const auto entry = tasks->value(taskId);
+    const auto *session = sessions.value(entry.session);
+    if (session && session->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28
+        && session->hasListenSubscriptions())
+        return MaxTaskPollIntervalMs;
+
+    const auto ageMs = QDateTime::currentMSecsSinceEpoch() - entry.startedAtMs;
+    const auto expectedMs = expectedTaskDurationMs.value(entry.toolName, -1);
+    if (expectedMs > ageMs)
+        return int(qBound(qint64(MinTaskPollIntervalMs), (expectedMs - ageMs) / 2, qint64(MaxTaskPollIntervalMs)));
+    return int(qBound(qint64(DefaultTaskPollIntervalMs), ageMs / 4, qint64(MaxTaskPollIntervalMs)));
+}
+
+void QMcpServer::Private::failTask(const std::shared_ptr<TaskMap> &tasks, const std::shared_ptr<TaskListener> &listener,
+                                   const QString &taskId, const QJsonObject &error)
+{
+    const auto entry = tasks->find(taskId);
+    if (entry == tasks->end())
+        return;
+    entry->status = QMcpTaskStatus::failed;
+    entry->lastUpdatedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    entry->finishedAtMs = QDateTime::currentMSecsSinceEpoch();
+    entry->error = error;
+    if (*listener)
+        (*listener)(taskId);
+}
+
+// Pushes a task's new state to the session that created it, so the client
+// learns about each transition without polling tasks/get. Sessions on
+// 2026-07-28 get the extension's notifications/tasks on their listen stream;
+// older ones the core notifications/tasks/status.
+void QMcpServer::Private::taskStatusChanged(const QString &taskId)
+{
+    const auto entry = tasks->value(taskId);
+    if (entry.status == QMcpTaskStatus::completed && entry.finishedAtMs > 0) {
+        const auto durationMs = entry.finishedAtMs - entry.startedAtMs;
+        const auto previousMs = expectedTaskDurationMs.value(entry.toolName, -1);
+        expectedTaskDurationMs.insert(entry.toolName, previousMs < 0 ? durationMs : (3 * previousMs + durationMs) / 4);
+    }
+
+    auto *session = sessions.value(entry.session);
+    if (!session || !session->isInitialized())
+        return;
+
+    if (session->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
+        if (!session->hasListenSubscriptions())
+            return;
+        QMcpExtTaskStatusNotification notification;
+        auto params = notification.params();
+        params.setTaskId(taskId);
+        params.setStatus(entry.status);
+        params.setCreatedAt(entry.createdAt);
+        params.setLastUpdatedAt(entry.lastUpdatedAt);
+        params.setTtlMs(TaskTtlMs);
+        params.setPollIntervalMs(taskPollIntervalMs(taskId));
+        if (entry.status == QMcpTaskStatus::completed)
+            params.setResult(entry.result);
+        else if (entry.status == QMcpTaskStatus::failed)
+            params.setError(entry.error);
+        notification.setParams(params);
+        sendTaggedNotification(session, notification);
+        return;
+    }
+
+    QMcpTaskStatusNotification notification;
+    auto params = notification.params();
+    params.setTaskId(taskId);
+    params.setStatus(entry.status);
+    params.setCreatedAt(entry.createdAt);
+    params.setLastUpdatedAt(entry.lastUpdatedAt);
+    params.setTtl(TaskTtlMs);
+    params.setPollInterval(taskPollIntervalMs(taskId));
+    notification.setParams(params);
+    q->notify(session->sessionId(), notification, session->protocolVersion());
+}
+
+// Dispatches the request, or for a tools/call whatever the scheduler lets run:
+// it may have to wait for a running call to finish, or be turned away with
+// ServerBusyErrorCode when the queue it would wait in is full.
+void QMcpServer::Private::admitRequest(const QUuid &session, const QJsonObject &object, quint64 trace)
+{
+    if (object.value("method"_L1).toString() != "tools/call"_L1 || !scheduler.isLimited()) {
+        dispatchRequest(session, object, trace);
+        return;
+    }
+
+    QMcpToolScheduler::Call call;
+    call.session = session;
+    call.id = object.value("id"_L1);
+    call.tool = object.value("params"_L1).toObject().value("name"_L1).toString();
+    call.request = object;
+    call.trace = trace;
+    call.queuedAt = activityClock.elapsed();
+    const auto admission = scheduler.submit(call);
+    switch (admission) {
+    case QMcpToolScheduler::Admission::Run:
+        dispatchRequest(session, object, trace);
+        return;
+    case QMcpToolScheduler::Admission::Queued:
+        return;
+    case QMcpToolScheduler::Admission::SessionQueueFull:
+    case QMcpToolScheduler::Admission::ServerQueueFull:
+        break;
+    }
+
+    // "session" tells a transport that this client sends too much (HTTP
+    // 429), "server" that the server as a whole is overloaded (503).
+    const bool sessionFull = admission == QMcpToolScheduler::Admission::SessionQueueFull;
+    QMcpJSONRPCErrorError error;
+    error.setCode(ServerBusyErrorCode);
+    error.setMessage(sessionFull ? "Server busy: too many tool calls waiting for this session"_L1
+                                 : "Server busy: too many tool calls waiting"_L1);
+    error.setData(QJsonObject { { "scope"_L1, sessionFull ? "session"_L1 : "server"_L1 } });
+    q->sendError(session, call.id, error);
+}
+
+void QMcpServer::Private::toolCallFinished(const QUuid &session, const QJsonValue &id)
+{
+    if (scheduler.finish(session, id))
+        runQueuedToolCalls();
+}
+
+void QMcpServer::Private::runQueuedToolCalls()
+{
+    while (const auto call = scheduler.takeNext()) {
+        toolQueueWait.record(double(activityClock.elapsed() - call->queuedAt), false);
+        dispatchRequest(call->session, call->request, call->trace);
+    }
+}
+
+// A tool call's result is streamed as notifications/tools/partialResult when
+// the client opted in with io.qtmcp/partialResults and a progress token to tag
+// them with, and the transport delivers them before the response.
+void QMcpServer::Private::setPartialResultSink(QMcpRequestContext *context, const QUuid &session, const QJsonObject &params) const
+{
+    const auto meta = params.value("_meta"_L1).toObject();
+    const auto progressToken = meta.value("progressToken"_L1);
+    if (!meta.value("io.qtmcp/partialResults"_L1).toBool() || !(progressToken.isString() || progressToken.isDouble()))
+        return;
+    if (!backend || !backend->canNotifyDuringRequest(session))
+        return;
+    const QPointer<QMcpServer> server(q);
+    context->setPartialResultSink([server, session, progressToken](const QJsonArray &content) {
+        const auto send = [server, session, progressToken, content]() {
+            if (!server)
+                return;
+            server->send(session, QJsonObject {
+                { "jsonrpc"_L1, "2.0"_L1 },
+                { "method"_L1, "notifications/tools/partialResult"_L1 },
+                { "params"_L1, QJsonObject { { "progressToken"_L1, progressToken }, { "content"_L1, content } } },
+            });
+        };
+        // A tool appending from a worker waits until its content was handed
+        // to the transport: the response cannot overtake it, and the tool
+        // cannot produce faster than the server sends.
+        if (!server || QThread::currentThread() == server->thread())
+            send();
+        else
+            QMetaObject::invokeMethod(server.data(), send, Qt::BlockingQueuedConnection);
+    });
+}
+
+// Runs the handler registered for the request and answers it, directly for a
+// synchronous handler and from the handler's continuation for an async one.
+void QMcpServer::Private::dispatchRequest(const QUuid &session, const QJsonObject &object, quint64 trace)
+{
+    const auto method = object.value("method"_L1).toString();
+    const auto id = object.value("id"_L1);
+    const auto sessionForMethod = sessions.value(session);
+    if (requestHandlers.contains(method)) {
+        const auto handler = requestHandlers.value(method);
+        // Per-request state lives in a context of its own rather than in the
+        // session, which all stateless clients of a transport share.
+        QMcpRequestContext context(session, id, sessionForMethod ? sessionForMethod->protocolVersion() : protocolVersion);
+        if (sessionForMethod && sessionForMethod->protocolVersion() >= QtMcp::ProtocolVersion::v2026_07_28) {
+            const auto params = object.value("params"_L1).toObject();
+            // Stateless clients re-declare their capabilities, including
+            // extensions, on every request.
+            context.setClientCapabilities(params.value("_meta"_L1).toObject()
+                    .value("io.modelcontextprotocol/clientCapabilities"_L1).toObject());
+            // MRTR: the retry's inputResponses and requestState; both are
+            // empty on a first attempt.
+            context.setInputResponses(params.value("inputResponses"_L1).toObject(),
+                                      params.value("requestState"_L1));
+        }
+        if (method == "tools/call"_L1)
+            setPartialResultSink(&context, session, object.value("params"_L1).toObject());
+        QMcpJSONRPCErrorError error;
+        QJsonValue result;
+        {
+            // The context is the session's current request while the
+            // handler runs, and only then; the session may end meanwhile.
+            QPointer<QMcpServerSession> current = sessionForMethod;
+            const auto previous = current ? current->currentRequest() : QMcpRequestContext();
+            if (current)
+                current->setCurrentRequest(context);
+            const auto restore = qScopeGuard([current, previous]() {
+                if (current)
+                    current->setCurrentRequest(previous);
+            });
+
+            // Decoding the params and running a synchronous
+            // handler; an async one only starts here.
+            QMcpTraceSpan span(trace, "dispatch");
+            result = handler(session, object, &error);
+        }
+        // Substitute only for synchronous handlers: an async
+        // handler returns an empty value here and its future
+        // continuation performs the same substitution when it
+        // sends the response.
+        if (result.isObject()) {
+            const auto interim = context.takeResultOverride();
+            if (!interim.isEmpty())
+                result = interim;
+        }
+        // JSON-RPC error codes are negative; any non-zero code
+        // set by the handler is an error.
+        if (error.code() != 0) {
+            QMcpJSONRPCError response;
+            response.setId(id);
+            response.setError(error);
+            auto sessionObj = sessions.value(session);
+            q->send(session, response.toJsonObject(sessionObj ?
+                    sessionObj->protocolVersion() :
+                    protocolVersion));
+        } else if (result.isObject()){
+            QMcpJSONRPCResponse response;
+            response.setId(id);
+            auto sessionObj = sessions.value(session);
+            const auto version = sessionObj ? sessionObj->protocolVersion() : protocolVersion;
+            auto object = response.toJsonObject(version);
+            auto resultObject = result.toObject();
+            if (version >= QtMcp::ProtocolVersion::v2026_07_28) {
+                // Since 2026-07-28 the server identifies itself in
+                // every result instead of only in initialize.
+                auto resultMeta = resultObject.value("_meta"_L1).toObject();
+                QJsonObject serverInfo;
+                serverInfo.insert("name"_L1, QCoreApplication::applicationName());
+                serverInfo.insert("version"_L1, QCoreApplication::applicationVersion());
+                resultMeta.insert("io.modelcontextprotocol/serverInfo"_L1, serverInfo);
+                resultObject.insert("_meta"_L1, resultMeta);
+            }
+            object.insert("result"_L1, resultObject);
+            q->send(session, object);
+        }
+    } else {
+        // Respond with error
+        QMcpJSONRPCError response;
+        response.setId(id.toVariant());
+        auto error = response.error();
+        error.setMessage("Server doesn't handle the request"_L1);
+        response.setError(error);
+        auto sessionObj = sessions.value(session);
+        q->send(session, response.toJsonObject(sessionObj ?
+                sessionObj->protocolVersion() :
+                protocolVersion));
+    }
+}
+
+// Identifies a request for deduplication: the method, the params without
+// _meta, which only carries per-request metadata such as the progress token,
+// and the scope it may be shared in. QJsonObject keeps its keys sorted, so
+// the compact form is canonical. Empty when the method is not deduplicated.
+QString QMcpServer::Private::deduplicationKey(const QUuid &session, const QString &method, const QJsonObject &object) const
+{
+    const auto scope = deduplication.value(method, DeduplicationScope::None);
+    if (scope == DeduplicationScope::None)
+        return {};
     auto params = object.value("params"_L1).toObject();
-    auto meta = params.value("_meta"_L1).toObject();
-    meta.insert("io.modelcontextprotocol/subscriptionId"_L1, session->listenSubscriptionId());
-    params.insert("_meta"_L1, meta);
-    object.insert("params"_L1, params);
-    q->send(session->sessionId(), object);
+    params.remove("_meta"_L1);
+    // Sessions of different protocol versions are answered differently.
+    const auto sessionObj = sessions.value(session);
+    const auto version = sessionObj ? sessionObj->protocolVersion() : protocolVersion;
+    const auto scopeKey = scope == DeduplicationScope::Session
+            ? session.toString(QUuid::WithoutBraces)
+            : QtMcp::protocolVersionToString(version);
+    return method + u'\n' + scopeKey + u'\n'
+            + QString::fromUtf8(QJsonDocument(params).toJson(QJsonDocument::Compact));
+}
+
+// Sends the response of a request that led a flight to every request that
+// joined it, each under its own id. Error responses included: a leader whose
+// handler failed is answered with an error too, so no follower is left
+// waiting. send() calls this on the server thread only.
+void QMcpServer::Private::answerFollowers(const QUuid &session, const QJsonObject &response)
+{
+    const auto leaderIt = flightLeaders.find(session);
+    if (leaderIt == flightLeaders.end())
+        return;
+    const auto key = leaderIt->take(response.value("id"_L1));
+    if (leaderIt->isEmpty())
+        flightLeaders.erase(leaderIt);
+    if (key.isEmpty())
+        return;
+    const auto flight = flights.take(key);
+    for (const auto &[followerSession, followerId] : flight.followers) {
+        auto copy = response;
+        copy.insert("id"_L1, followerId);
+        q->send(followerSession, copy);
+    }
+}
+
+// Returns the request's trace, which stays open until the response is
+// written, however long an asynchronous handler takes.
+quint64 QMcpServer::Private::requestStarted(const QUuid &session, const QJsonValue &id, const QString &method, const QJsonObject &params)
+{
+    InFlight entry;
+    entry.method = method;
+    if (method == "tools/call"_L1)
+        entry.tool = params.value("name"_L1).toString();
+    entry.timer.start();
+    entry.trace = QMcpTracer::adopt();
+    if (entry.trace) {
+        QMcpTracer::Attributes attributes = {
+            { "mcp.session"_ba, session.toString(QUuid::WithoutBraces) },
+            { "mcp.request.id"_ba, id.isString() ? id.toString() : QString::number(id.toInteger()) },
+        };
+        if (!entry.tool.isEmpty())
+            attributes.append({ "mcp.tool"_ba, entry.tool });
+        QMcpTracer::annotate(entry.trace, method.toUtf8(), attributes);
+    }
+    inFlight[session].insert(id, entry);
+    return entry.trace;
+}
+
+// Called for every response the server sends, whichever path produced it, so
+// that asynchronous handlers are measured up to their actual answer. Returns
+// the request's trace for the caller to end once the response is written.
+// Runs on the server thread: addRequestHandler() brings the response of an
+// async handler back to it.
+quint64 QMcpServer::Private::requestFinished(const QUuid &session, const QJsonObject &response)
+{
+    const auto sessionIt = inFlight.find(session);
+    if (sessionIt == inFlight.end())
+        return 0;
+    const auto it = sessionIt->constFind(response.value("id"_L1));
+    if (it == sessionIt->cend())
+        return 0;
+    const auto trace = it->trace;
+
+    const double elapsedMs = it->timer.nsecsElapsed() / 1e6;
+    const bool isError = response.contains("error"_L1);
+    if (isError)
+        ++errorCodes[response.value("error"_L1).toObject().value("code"_L1).toInt()];
+    // This runs before the response is written; running the next call
+    // later keeps it from being answered ahead of this one.
+    if (it->method == "tools/call"_L1) {
+        QMetaObject::invokeMethod(q, [this, session, id = response.value("id"_L1)]() {
+            toolCallFinished(session, id);
+        }, Qt::QueuedConnection);
+    }
+    // A tool reporting failure answers with isError, not a JSON-RPC error.
+    const bool toolFailed = isError || response.value("result"_L1).toObject().value("isError"_L1).toBool();
+    methodStatistics[it->method].record(elapsedMs, isError);
+    if (!it->tool.isEmpty())
+        toolStatistics[it->tool].record(elapsedMs, toolFailed);
+
+    sessionIt->erase(it);
+    if (sessionIt->isEmpty())
+        inFlight.erase(sessionIt);
+    return trace;
 }
 
 QMcpServerSession *QMcpServer::Private::findSession(const QUuid &sessionId, bool isInitialized, QMcpJSONRPCErrorError *error) const
@@ -361,24 +1029,10 @@ QStringList QMcpServer::backends()
     return backendLoader()->keyMap().values();
 }
 
-QJsonObject QMcpServer::takePendingResultOverride(const QUuid &session)
+QMcpRequestContext QMcpServer::currentRequest(const QUuid &session) const
 {
     auto *sessionObj = d->sessions.value(session);
-    if (!sessionObj || sessionObj->protocolVersion() < QtMcp::ProtocolVersion::v2026_07_28)
-        return QJsonObject();
-
-    QJsonObject inputRequests;
-    QJsonValue requestState;
-    if (sessionObj->takeRequiredInput(&inputRequests, &requestState)) {
-        QMcpInputRequiredResult result;
-        result.setInputRequests(inputRequests);
-        auto object = result.toJsonObject(sessionObj->protocolVersion());
-        if (!requestState.isUndefined() && !requestState.isNull())
-            object.insert("requestState"_L1, requestState);
-        return object;
-    }
-
-    return sessionObj->takeResultOverride();
+    return sessionObj ? sessionObj->currentRequest() : QMcpRequestContext();
 }
 
 void QMcpServer::setTasksExtensionEnabled(bool enabled)
@@ -391,6 +1045,152 @@ bool QMcpServer::isTasksExtensionEnabled() const
     return d->tasksExtensionEnabled;
 }
 
+void QMcpServer::setRequestDeduplication(const QString &method, DeduplicationScope scope)
+{
+    if (scope == DeduplicationScope::None)
+        d->deduplication.remove(method);
+    else
+        d->deduplication.insert(method, scope);
+}
+
+QMcpServer::DeduplicationScope QMcpServer::requestDeduplication(const QString &method) const
+{
+    return d->deduplication.value(method, DeduplicationScope::None);
+}
+
+void QMcpServer::closeSession(const QUuid &session)
+{
+    if (d->backend)
+        d->backend->closeSession(session);
+    else
+        d->endSession(session);
+}
+
+void QMcpServer::notifyResourceUpdated(const QMcpResource &resource)
+{
+    d->postChangeNotification(QUuid(), "notifications/resources/updated"_L1, resource.uri());
+}
+
+void QMcpServer::setNotificationCoalescing(int windowMsecs, int maxLatencyMsecs)
+{
+    d->notificationCoalescing.window = qMax(0, windowMsecs);
+    d->notificationCoalescing.maxLatency = qMax(0, maxLatencyMsecs);
+}
+
+int QMcpServer::notificationCoalescingWindow() const
+{
+    return d->notificationCoalescing.window;
+}
+
+int QMcpServer::notificationCoalescingMaxLatency() const
+{
+    return d->notificationCoalescing.maxLatency;
+}
+
+void QMcpServer::setResourceUpdateCoalescing(const QUrl &uri, int windowMsecs, int maxLatencyMsecs)
+{
+    if (windowMsecs < 0) {
+        d->resourceCoalescing.remove(uri.toString());
+        return;
+    }
+    d->resourceCoalescing.insert(uri.toString(), { windowMsecs, qMax(0, maxLatencyMsecs) });
+}
+
+void QMcpServer::notifyResourceUpdated(const QUuid &session, const QMcpResource &resource)
+{
+    if (auto *s = d->sessions.value(session))
+        emit s->resourceUpdated(resource);
+}
+
+void QMcpServer::setConcurrencyLimits(int total, int perSession)
+{
+    d->scheduler.setConcurrencyLimits(total, perSession);
+    d->runQueuedToolCalls();
+}
+
+int QMcpServer::concurrencyLimit() const
+{
+    return d->scheduler.concurrencyLimit();
+}
+
+int QMcpServer::sessionConcurrencyLimit() const
+{
+    return d->scheduler.sessionConcurrencyLimit();
+}
+
+void QMcpServer::setToolConcurrencyLimit(const QString &name, int limit)
+{
+    d->scheduler.setToolConcurrencyLimit(name, limit);
+    d->runQueuedToolCalls();
+}
+
+int QMcpServer::toolConcurrencyLimit(const QString &name) const
+{
+    return d->scheduler.toolConcurrencyLimit(name);
+}
+
+void QMcpServer::setQueueLimits(int perSession, int total)
+{
+    d->scheduler.setQueueLimits(perSession, total);
+}
+
+int QMcpServer::sessionQueueLimit() const
+{
+    return d->scheduler.sessionQueueLimit();
+}
+
+int QMcpServer::queueLimit() const
+{
+    return d->scheduler.queueLimit();
+}
+
+void QMcpServer::setToolPriority(const QString &name, int priority)
+{
+    d->scheduler.setToolPriority(name, priority);
+}
+
+int QMcpServer::toolPriority(const QString &name) const
+{
+    return d->scheduler.toolPriority(name);
+}
+
+void QMcpServer::setSessionWeight(const QUuid &session, int weight)
+{
+    d->scheduler.setSessionWeight(session, weight);
+}
+
+int QMcpServer::sessionWeight(const QUuid &session) const
+{
+    return d->scheduler.sessionWeight(session);
+}
+
+void QMcpServer::setSessionIdleTimeout(int msecs)
+{
+    d->sessionIdleTimeout = qMax(0, msecs);
+    if (d->sessionIdleTimeout == 0) {
+        d->idleSweep.stop();
+        return;
+    }
+    // A session is closed between one and one and a half timeouts after
+    // its last message.
+    d->idleSweep.start(qMax(1, d->sessionIdleTimeout / 2));
+}
+
+int QMcpServer::sessionIdleTimeout() const
+{
+    return d->sessionIdleTimeout;
+}
+
+void QMcpServer::setRequestTimeout(int msecs)
+{
+    d->pending.setTimeout(msecs);
+}
+
+int QMcpServer::requestTimeout() const
+{
+    return d->pending.timeout();
+}
+
 QMcpServer::QMcpServer(const QString &backend, QObject *parent)
     : QObject(parent)
     , d(new Private(backend, this))
@@ -549,7 +1349,16 @@ QMcpServer::QMcpServer(const QString &backend, QObject *parent)
         }
         const auto params = request.params();
         const auto progressToken = params.meta().progressToken();
+        const auto trace = QMcpTracer::current();
+        const auto toolStartNs = QMcpTracer::now();
         auto future = session->callToolAsync(params.name(), params.arguments(), progressToken);
+        if (trace) {
+            // The tool may finish long after this handler returned, on
+            // another thread, or after a task handle was answered.
+            future.then([trace, toolStartNs, name = params.name()](const QMcpCallToolResult &) {
+                QMcpTracer::addSpan(trace, "tool"_ba, toolStartNs, QMcpTracer::now(), { { "mcp.tool"_ba, name } });
+            });
+        }
 
         // tasks extension: when both sides declared it and the tool has not
         // finished synchronously, hand out a durable task instead of keeping
@@ -561,21 +1370,48 @@ QMcpServer::QMcpServer(const QString &backend, QObject *parent)
             const auto now = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
             Private::TaskEntry entry;
             entry.session = sessionId;
+            entry.toolName = params.name();
             entry.createdAt = now;
             entry.lastUpdatedAt = now;
+            entry.startedAtMs = QDateTime::currentMSecsSinceEpoch();
             entry.future = future;
             d->tasks->insert(taskId, entry);
             const auto version = session->protocolVersion();
             auto tasks = d->tasks;
-            future.then(this, [tasks, taskId, version](const QMcpCallToolResult &result) {
-                auto &entry = (*tasks)[taskId];
-                entry.status = QMcpTaskStatus::completed;
-                entry.lastUpdatedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
-                entry.result = result.toJsonObject(version);
-            }).onCanceled(this, [tasks, taskId]() {
-                auto &entry = (*tasks)[taskId];
-                entry.status = QMcpTaskStatus::cancelled;
-                entry.lastUpdatedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+            auto listener = d->taskListener;
+            // A task is gone once its session ended.
+            future.then(this, [tasks, listener, taskId, version](const QMcpCallToolResult &result) {
+                const auto entry = tasks->find(taskId);
+                if (entry == tasks->end())
+                    return;
+                entry->status = QMcpTaskStatus::completed;
+                entry->lastUpdatedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+                entry->finishedAtMs = QDateTime::currentMSecsSinceEpoch();
+                entry->result = result.toJsonObject(version);
+                if (*listener)
+                    (*listener)(taskId);
+            })
+#ifndef QT_NO_EXCEPTIONS
+            // A tool failing with a JSON-RPC error fails the task with it.
+            .onFailed(this, [tasks, listener, taskId, version](const QMcpJSONRPCErrorError &error) {
+                Private::failTask(tasks, listener, taskId, error.toJsonObject(version));
+            })
+            .onFailed(this, [tasks, listener, taskId, version]() {
+                QMcpJSONRPCErrorError error;
+                error.setCode(InternalErrorCode);
+                error.setMessage("Internal error: the tool failed"_L1);
+                Private::failTask(tasks, listener, taskId, error.toJsonObject(version));
+            })
+#endif
+            .onCanceled(this, [tasks, listener, taskId]() {
+                const auto entry = tasks->find(taskId);
+                if (entry == tasks->end())
+                    return;
+                entry->status = QMcpTaskStatus::cancelled;
+                entry->lastUpdatedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+                entry->finishedAtMs = QDateTime::currentMSecsSinceEpoch();
+                if (*listener)
+                    (*listener)(taskId);
             });
 
             QMcpExtCreateTaskResult createTask;
@@ -583,9 +1419,9 @@ QMcpServer::QMcpServer(const QString &backend, QObject *parent)
             createTask.setStatus(QMcpTaskStatus::working);
             createTask.setCreatedAt(now);
             createTask.setLastUpdatedAt(now);
-            createTask.setTtlMs(300000);
-            createTask.setPollIntervalMs(500);
-            session->overrideResult(createTask.toJsonObject(version));
+            createTask.setTtlMs(TaskTtlMs);
+            createTask.setPollIntervalMs(d->taskPollIntervalMs(taskId));
+            session->currentRequest().overrideResult(createTask.toJsonObject(version));
 
             // The handler still must return a future; hand back a finished
             // placeholder, the override above is what reaches the client.
@@ -610,10 +1446,12 @@ QMcpServer::QMcpServer(const QString &backend, QObject *parent)
         result.setStatus(entry.status);
         result.setCreatedAt(entry.createdAt);
         result.setLastUpdatedAt(entry.lastUpdatedAt);
-        result.setTtlMs(300000);
-        result.setPollIntervalMs(500);
+        result.setTtlMs(TaskTtlMs);
+        result.setPollIntervalMs(d->taskPollIntervalMs(taskId));
         if (entry.status == QMcpTaskStatus::completed)
             result.setResult(entry.result);
+        else if (entry.status == QMcpTaskStatus::failed)
+            result.setError(entry.error);
         return result.toJsonObject(versionToUse(sessionId));
     });
     registerRequestHandler("tasks/cancel"_L1, [this](const QUuid &sessionId, const QJsonObject &object, QMcpJSONRPCErrorError *error) -> QJsonValue {
@@ -650,8 +1488,10 @@ QMcpServer::QMcpServer(const QString &backend, QObject *parent)
         // now (the entry keeps the latest responses).
         entry.inputResponses = params.value("inputResponses"_L1).toObject();
         entry.lastUpdatedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
-        if (entry.status == QMcpTaskStatus::input_required)
+        if (entry.status == QMcpTaskStatus::input_required) {
             entry.status = QMcpTaskStatus::working;
+            d->taskStatusChanged(taskId);
+        }
         QJsonObject result;
         result.insert("resultType"_L1, "complete"_L1);
         return result;
@@ -721,6 +1561,25 @@ void QMcpServer::unregisterToolSet(QObject *toolSet)
     d->toolSets.remove(toolSet);
 }
 
+void QMcpServer::addTool(const QMcpTool &tool, const QMcpServerSession::ToolFunction &function)
+{
+    removeTool(tool.name());
+    d->functionTools.append(qMakePair(tool, function));
+    const auto sessions = d->sessions.values();
+    for (auto *session : sessions) {
+        session->addTool(tool, function);
+    }
+}
+
+void QMcpServer::removeTool(const QString &name)
+{
+    const auto sessions = d->sessions.values();
+    for (auto *session : sessions) {
+        session->removeTool(name);
+    }
+    d->functionTools.removeIf([&name](const auto &pair) { return pair.first.name() == name; });
+}
+
 #ifdef QT_GUI_LIB
 void QMcpServer::registerTool(QAction *action, const QString &name)
 {
@@ -742,23 +1601,42 @@ void QMcpServer::unregisterTool(QAction *action)
 }
 #endif
 
-void QMcpServer::send(const QUuid &session, const QJsonObject &request, std::function<void(const QUuid &session, const QJsonObject &)> callback)
+void QMcpServer::send(const QUuid &session, const QJsonObject &request, std::function<void(const QUuid &session, const QJsonObject &, const QJsonObject &)> callback)
 {
     if (!d->backend) return;
-    static int id = 0;
+    quint64 trace = 0;
+    if (request.contains("id"_L1) && !request.contains("method"_L1))
+        trace = d->requestFinished(session, request);
     if (request.contains("id"_L1) && request.value("id"_L1).isNull()) {
         auto request2 = request;
+        const auto id = d->pending.nextId();
         request2.insert("id"_L1, id);
 
-        if (callback)
-            d->callbacks[session].insert(id, callback);
-        id++;
+        if (callback) {
+            d->pending.insert(id, session, [session, callback](const QJsonObject &result, const QJsonObject &error) {
+                callback(session, result, error);
+            });
+        }
         d->backend->send(session, request2);
     } else {
-        d->backend->send(session, request);
+        {
+            QMcpTraceSpan span(trace, "write");
+            d->backend->send(session, request);
+        }
+        QMcpTracer::endTrace(trace);
+        if (request.contains("id"_L1) && !request.contains("method"_L1))
+            d->answerFollowers(session, request);
     }
 }
 
+void QMcpServer::sendError(const QUuid &session, const QJsonValue &id, const QMcpJSONRPCErrorError &error)
+{
+    QMcpJSONRPCError response;
+    response.setId(id.toVariant());
+    response.setError(error);
+    send(session, response.toJsonObject(versionToUse(session)));
+}
+
 void QMcpServer::registerRequestHandler(const QString &method, std::function<QJsonValue(const QUuid &, const QJsonObject &, QMcpJSONRPCErrorError *)> callback)
 {
     d->requestHandlers.insert(method, callback);
@@ -852,5 +1730,33 @@ QList<QMcpServerSession *> QMcpServer::sessions() const
     return d->sessions.values();
 }
 
+QMcpServerStatistics QMcpServer::statistics() const
+{
+    QMcpServerStatistics ret;
+    ret.d->transport = d->backendType;
+    ret.d->methods = d->methodStatistics;
+    ret.d->tools = d->toolStatistics;
+    ret.d->errorCodes = d->errorCodes;
+    if (d->backend) {
+        ret.d->bytesReceived = d->backend->bytesReceived();
+        ret.d->bytesSent = d->backend->bytesSent();
+    }
+    ret.d->activeSessions = d->sessions.size();
+    ret.d->pendingRequests = d->pending.size();
+    for (const auto &requests : std::as_const(d->inFlight))
+        ret.d->inFlightRequests += requests.size();
+    ret.d->tasks = d->tasks->size();
+    ret.d->notificationsCoalesced = d->notificationsCoalesced;
+    ret.d->runningToolCalls = d->scheduler.running();
+    ret.d->queuedToolCalls = d->scheduler.queued();
+    if (ret.d->queuedToolCalls > 0) {
+        for (auto it = d->sessions.cbegin(); it != d->sessions.cend(); ++it) {
+            if (const qsizetype queued = d->scheduler.queued(it.key()))
+                ret.d->queuedToolCallsBySession.insert(it.key(), queued);
+        }
+    }
+    ret.d->toolQueueWait = d->toolQueueWait;
+    return ret;
+}
 
 QT_END_NAMESPACE
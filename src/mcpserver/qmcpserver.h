@@ -17,6 +17,9 @@
 #include <QtMcpCommon/qtmcpnamespace.h>
 #include <QtMcpServer/qmcpserverglobal.h>
 #include <QtMcpServer/qmcpserversession.h>
+#include <QtMcpServer/qmcprequestcontext.h>
+#include <QtMcpServer/qmcpserverstatistics.h>
+#include <QtMcpServer/qmcptoolargument.h>
 #include <concepts>
 #include <functional>
 #include <type_traits>
@@ -99,6 +102,46 @@ class Q_MCPSERVER_EXPORT QMcpServer : public QObject
     */
     Q_PROPERTY(QList<QtMcp::ProtocolVersion> supportedProtocolVersions READ supportedProtocolVersions NOTIFY supportedProtocolVersionsChanged FINAL)
 public:
+    /*!
+        Which requests an in-flight request of a deduplicated method is
+        shared with.
+
+        \value None        Every request runs its handler.
+        \value Session     Identical requests of the same session share one
+                           handler run.
+        \value Server      Identical requests of any session speaking the same
+                           protocol version share one handler run: the
+                           response computed for one session is sent to every
+                           other. Only for methods whose result does not
+                           depend on the caller; not for tools/list,
+                           resources/list or prompts/list when sessions
+                           register tools, resources or prompts of their own,
+                           nor for handlers that check the caller's access.
+
+        \sa setRequestDeduplication()
+    */
+    enum class DeduplicationScope {
+        None,
+        Session,
+        Server,
+    };
+    Q_ENUM(DeduplicationScope)
+
+    /*!
+        The JSON-RPC error code a tools/call is rejected with when the queue
+        it would wait in is full, see setQueueLimits(). The error's data
+        has \c scope \c session or \c server, which Streamable HTTP maps to
+        HTTP 429 and 503.
+    */
+    static constexpr int ServerBusyErrorCode = -32005;
+
+    /*!
+        The JSON-RPC error code a request is answered with when its async
+        handler's future is canceled, or fails with anything but a
+        QMcpJSONRPCErrorError.
+    */
+    static constexpr int InternalErrorCode = -32603;
+
     /*!
         Returns a list of available backend implementations for the MCP server.
     */
@@ -128,6 +171,11 @@ public:
         using type = Arg;
     };
 
+    template<typename T, typename Arg>
+    struct CallbackArg<void(T::*)(const QUuid &, const Arg &, const QMcpJSONRPCErrorError *) const> {
+        using type = Arg;
+    };
+
     template<typename T>
     struct CallbackArg : CallbackArg<decltype(&T::operator())> {};
 
@@ -138,6 +186,10 @@ public:
         Sends a request to a specific client session and handles the response with a callback.
 
         The callback will be invoked with the session ID and response result.
+        When the client answers with an error, or does not answer within
+        requestTimeout(), it receives a default-constructed result; use the
+        overload whose callback takes a QMcpJSONRPCErrorError pointer to tell
+        these cases apart.
 
         Example:
         \code
@@ -162,13 +214,52 @@ public:
         QtMcp::ProtocolVersion versionToUse = this->versionToUse(session);
 
         auto json = request.toJsonObject(versionToUse);
-        send(session, json, [callback, versionToUse](const QUuid & session, const QJsonObject &json) {
+        send(session, json, [callback, versionToUse](const QUuid & session, const QJsonObject &json, const QJsonObject &error) {
+            Q_UNUSED(error);
             Result result;
             result.fromJsonObject(json, versionToUse);
             callback(session, result);
         });
     }
 
+    /*!
+        Sends a request to a specific client session and handles the response
+        or the error with a callback.
+
+        If the client answers with a JSON-RPC error, or does not answer within
+        requestTimeout(), the callback receives the error, and a
+        default-constructed result; a timeout is reported with code -32001.
+        Otherwise the error parameter is nullptr.
+
+        \param session UUID of the client session
+        \param request Request object inheriting from QMcpRequest
+        \param callback Callback function to handle the response
+    */
+    template<typename Request, typename Callback>
+        requires std::invocable<Callback, const QUuid &, const CallbackResult<Callback>&, const QMcpJSONRPCErrorError *>
+    void request(const QUuid &session, const Request &request, Callback callback)
+    {
+        using Result = CallbackResult<Callback>;
+
+        static_assert(std::is_base_of<QMcpRequest, Request>::value, "Request must inherit from QMcpRequest");
+        static_assert(std::is_base_of<QMcpResult, Result>::value, "Result must inherit from QMcpResult");
+
+        QtMcp::ProtocolVersion versionToUse = this->versionToUse(session);
+
+        auto json = request.toJsonObject(versionToUse);
+        send(session, json, [callback, versionToUse](const QUuid & session, const QJsonObject &json, const QJsonObject &error) {
+            Result result;
+            result.fromJsonObject(json, versionToUse);
+            if (!error.isEmpty()) {
+                QMcpJSONRPCErrorError e;
+                e.fromJsonObject(error, versionToUse);
+                callback(session, result, &e);
+            } else {
+                callback(session, result, nullptr);
+            }
+        });
+    }
+
     /*!
         Sends a request without expecting a response.
 
@@ -254,23 +345,48 @@ public:
             req.fromJsonObject(json, versionToUse);
 
             if constexpr (is_future<Result>::value) {
-                // For async handlers
+                // For async handlers. The context is the calling request's
+                // only while the handler runs; keep it for the continuation.
+                auto context = currentRequest(session);
                 auto future = handler(session, req, error);
 
                 // Get the request ID from the JSON object
                 const auto id = json.value("id"_L1);
 
-                // Set up continuation to send response when ready
-                future.then([this, session, id, versionToUse](const typename is_future<Result>::inner_type &result) {
+                // Send the response when it is ready. The future may finish
+                // on a worker thread; the response goes out on the server's,
+                // which owns the in-flight bookkeeping send() updates.
+                auto answered = future.then(this, [this, session, id, versionToUse, context](const typename is_future<Result>::inner_type &result) mutable {
                     QMcpJSONRPCResponse response;
                     response.setId(id.toVariant());
                     auto object = response.toJsonObject(versionToUse);
                     // MRTR interim results and tasks-extension handles
                     // replace the handler's result (2026-07-28).
-                    const auto interim = takePendingResultOverride(session);
+                    const auto interim = context.takeResultOverride();
                     object.insert("result"_L1, interim.isEmpty() ? result.toJsonObject(versionToUse) : interim);
                     send(session, object);
                 });
+#ifndef QT_NO_EXCEPTIONS
+                // A handler fails a request by throwing the error to answer
+                // with, e.g. through QPromise::setException(); anything else
+                // it throws is an internal error.
+                answered = answered.onFailed(this, [this, session, id](const QMcpJSONRPCErrorError &error) {
+                    sendError(session, id, error);
+                }).onFailed(this, [this, session, id]() {
+                    QMcpJSONRPCErrorError error;
+                    error.setCode(InternalErrorCode);
+                    error.setMessage("Internal error: the request handler failed"_L1);
+                    sendError(session, id, error);
+                });
+#endif
+                // Every request is answered, or it would hold its place,
+                // e.g. a tool call's concurrency slot, for good.
+                answered.onCanceled(this, [this, session, id]() {
+                    QMcpJSONRPCErrorError error;
+                    error.setCode(InternalErrorCode);
+                    error.setMessage("Internal error: the request handler was canceled"_L1);
+                    sendError(session, id, error);
+                });
 
                 // Return empty value since we'll send response later
                 return QJsonValue();
@@ -351,6 +467,15 @@ public:
 
     QList<QMcpServerSession *> sessions() const;
 
+    /*!
+        Returns a snapshot of the server's request, tool, error and transport
+        counters. Collection is always on; it costs a hash lookup and a few
+        increments per request.
+
+        \sa QMcpServerStatistics::toPrometheusText()
+    */
+    QMcpServerStatistics statistics() const;
+
 public slots:
     /*!
         Sets the server capabilities.
@@ -394,8 +519,179 @@ public slots:
     void setTasksExtensionEnabled(bool enabled);
     bool isTasksExtensionEnabled() const;
 
+    /*!
+        Deduplicates requests of \a method within \a scope: a request with the
+        same params, ignoring _meta, as one still being handled does not run
+        the handler again but gets that request's response under its own id.
+        Meant for reads such as resources/read and prompts/get that many
+        clients repeat at once after a list_changed notification. An error
+        response, including that of a handler whose future failed or was
+        canceled, is shared the same way. Handlers of deduplicated methods run
+        from the event loop, after the messages that arrived along with the
+        request were read. Off for every method by default.
+
+        With DeduplicationScope::Server one session's response is shared
+        with other sessions; see DeduplicationScope for when it is safe.
+    */
+    void setRequestDeduplication(const QString &method, DeduplicationScope scope);
+    DeduplicationScope requestDeduplication(const QString &method) const;
+
+    /*!
+        Ends \a session: the backend closes the connection or forgets the
+        mapping the session is known by, and the session is destroyed along
+        with the requests it has pending, its subscriptions and its tasks.
+        sessionEnded() is emitted once it is gone.
+    */
+    void closeSession(const QUuid &session);
+
+    /*!
+        Sends notifications/resources/updated for \a resource to every
+        initialized session subscribed to it, through resources/subscribe or
+        subscriptions/listen. Subscriptions may name a URI, a prefix ending
+        in \c{*} or a URI template. The sessions are looked up in an index
+        kept across the server, so the cost follows the number of
+        subscribers, not the number of sessions.
+    */
+    void notifyResourceUpdated(const QMcpResource &resource);
+
+    /*!
+        Sets how change notifications (notifications/resources/updated and
+        the list_changed ones) are coalesced. A notification raised again
+        for the same session, method and URI within \a windowMsecs of the
+        previous change is folded into one, sent once the changes pause for
+        \a windowMsecs, and at the latest \a maxLatencyMsecs after the first
+        of them when that is not 0. Since the notification goes out after
+        the last change, clients that read the resource again see its final
+        state. 0 for both, the default, sends every notification as it is
+        raised. The folded notifications are counted in
+        QMcpServerStatistics::notificationsCoalesced().
+    */
+    void setNotificationCoalescing(int windowMsecs, int maxLatencyMsecs = 0);
+    int notificationCoalescingWindow() const;
+    int notificationCoalescingMaxLatency() const;
+
+    /*!
+        Overrides the coalescing of notifications/resources/updated for the
+        resource at \a uri, e.g. a shorter window for a document edited on
+        every keystroke. A negative \a windowMsecs drops the override.
+    */
+    void setResourceUpdateCoalescing(const QUrl &uri, int windowMsecs, int maxLatencyMsecs = 0);
+
+    /*!
+        Sets how long, in milliseconds, a session may receive nothing before
+        it is closed with closeSession(). A session answering a request or
+        running a task is not idle. 0, the default, keeps sessions until
+        their client ends them.
+    */
+    void setSessionIdleTimeout(int msecs);
+    int sessionIdleTimeout() const;
+
+    /*!
+        Limits how many tools/call requests run at once: \a total across the
+        server and \a perSession for each session. A call beyond a limit
+        waits until a running one was answered. Waiting calls run by the
+        priority of their tool, see setToolPriority(), and within a
+        priority the sessions take turns by weighted fair queuing, see
+        setSessionWeight(), so one client firing hundreds of calls does not
+        starve the others. 0 for both, the default, runs every call as it
+        arrives. How long calls waited is recorded in
+        QMcpServerStatistics::toolQueueWait().
+
+        Clients are told apart by their session. Over streamable HTTP, the
+        stateless clients of protocol version 2026-07-28 all share one
+        session, and with it one \a perSession limit, one queue and one
+        turn among the sessions; \a total is what bounds them.
+    */
+    void setConcurrencyLimits(int total, int perSession = 0);
+    int concurrencyLimit() const;
+    int sessionConcurrencyLimit() const;
+
+    /*!
+        Limits how many calls of the tool \a name run at once, e.g. for an
+        expensive one, on top of setConcurrencyLimits(). 0 drops the limit.
+    */
+    void setToolConcurrencyLimit(const QString &name, int limit);
+    int toolConcurrencyLimit(const QString &name) const;
+
+    /*!
+        Limits how many tool calls may wait: \a perSession for each session
+        and \a total across the server. A call that would wait beyond them
+        is answered with ServerBusyErrorCode right away. 0, the default,
+        lets any number wait. Only matters together with a concurrency
+        limit. Stateless clients share one queue; see
+        setConcurrencyLimits().
+    */
+    void setQueueLimits(int perSession, int total = 0);
+    int sessionQueueLimit() const;
+    int queueLimit() const;
+
+    /*!
+        Sets the \a priority of the tool \a name: a waiting call of a tool
+        with a higher priority runs before those of a lower one, whichever
+        session made it. The default is 0.
+    */
+    void setToolPriority(const QString &name, int priority);
+    int toolPriority(const QString &name) const;
+
+    /*!
+        Sets the share of the tool call capacity \a session gets when
+        sessions compete for it, relative to the others: a session of
+        \a weight 2 runs twice as many calls as one of weight 1. The
+        default is 1. Forgotten when the session ends.
+    */
+    void setSessionWeight(const QUuid &session, int weight);
+    int sessionWeight(const QUuid &session) const;
+
+    /*!
+        Sets how long a request sent to a client may stay unanswered, in
+        milliseconds. Past that the request is given up and its callback
+        completed with a timeout error. 0 waits forever. Applies to requests
+        sent afterwards; the default is five minutes.
+    */
+    void setRequestTimeout(int msecs);
+    int requestTimeout() const;
+
     void registerToolSet(QObject *toolSet, const QHash<QString, QString> &descriptions = {});
     void unregisterToolSet(QObject *toolSet);
+
+    /*!
+        Adds the tool \a name, implemented by \a function, to every session.
+
+        The input schema is derived from the function's parameter types,
+        named after \a parameterNames in order, and the arguments of a call
+        are decoded from JSON straight into those types: see
+        QMcpToolArgument for the supported ones, including lists, optional
+        parameters and structs. A leading QUuid parameter receives the
+        session id. The function may return QMcpCallToolResult, a list of
+        QMcpCallToolResultContent, QString, QStringList, \c bool, a number,
+        QJsonObject (as structured content), \c void, or a QFuture of one
+        of these. Arguments that do not decode are answered with an error
+        result without calling the function. A tool with a large result
+        takes a QMcpToolResultWriter after the QUuid, if any, returns
+        \c void and appends its content to the writer instead.
+
+        \a descriptions is keyed like the one of registerToolSet(): the
+        tool's name for its description, \c{name/parameter} for those of
+        its parameters.
+
+        \code
+        server->addTool(u"add"_s, { u"a"_s, u"b"_s }, [](int a, std::optional<int> b) {
+            return a + b.value_or(0);
+        }, { { u"add"_s, u"Adds two numbers"_s } });
+        \endcode
+    */
+    template<typename Function>
+    void addTool(const QString &name, const QStringList &parameterNames, Function function,
+                 const QHash<QString, QString> &descriptions = {})
+    {
+        using Tool = QtMcpPrivate::TypedTool<Function>;
+        Q_ASSERT_X(parameterNames.size() == qsizetype(Tool::ArgumentCount), "QMcpServer::addTool",
+                   "one name per parameter, not counting a leading QUuid or a QMcpToolResultWriter");
+        addTool(Tool::tool(name, parameterNames, descriptions),
+                Tool::invoker(parameterNames, std::move(function)));
+    }
+    void addTool(const QMcpTool &tool, const QMcpServerSession::ToolFunction &function);
+    void removeTool(const QString &name);
 #ifdef QT_GUI_LIB
     void registerTool(QAction *action, const QString &name = QString());
     void unregisterTool(QAction *action);
@@ -441,6 +737,13 @@ signals:
     */
     void newSession(QMcpServerSession *session);
 
+    /*!
+        Emitted when a client session has ended, because its client went
+        away or closeSession() ended it.
+        \param session UUID of the ended session
+    */
+    void sessionEnded(const QUuid &session);
+
     /*!
         Emitted when a raw JSON message is received from a client.
         \param session UUID of the client session
@@ -474,16 +777,16 @@ private:
 
     /*!
         \internal
-        Returns the pre-serialized result that replaces the handler's result
-        for the current request, or an empty object. Sources: an
-        input_required interim result when the handler called
-        QMcpServerSession::requireInput() (MRTR, 2026-07-28), or a
-        CreateTaskResult minted by the tasks extension. Consumes the state.
+        Returns the context of the request \a session is handling, which
+        carries the result that replaces the handler's: an input_required
+        interim result when the handler called requireInput() (MRTR,
+        2026-07-28), or a CreateTaskResult minted by the tasks extension.
     */
-    QJsonObject takePendingResultOverride(const QUuid &session);
+    QMcpRequestContext currentRequest(const QUuid &session) const;
 
 
-    void send(const QUuid &session, const QJsonObject &message, std::function<void(const QUuid &session, const QJsonObject &)> callback = nullptr);
+    void sendError(const QUuid &session, const QJsonValue &id, const QMcpJSONRPCErrorError &error);
+    void send(const QUuid &session, const QJsonObject &message, std::function<void(const QUuid &session, const QJsonObject &result, const QJsonObject &error)> callback = nullptr);
     void registerRequestHandler(const QString &method, std::function<QJsonValue(const QUuid &, const QJsonObject &, QMcpJSONRPCErrorError *)>);
     void registerNotificationHandler(const QString &method, std::function<void(const QUuid &, const QJsonObject &)>);
 
@@ -2,40 +2,82 @@
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qmcpserverbackendinterface.h"
+#include <QtMcpCommon/private/qmcppendingrequests_p.h>
 
 QT_BEGIN_NAMESPACE
 
 QMcpServerBackendInterface::QMcpServerBackendInterface(QObject *parent)
     : QObject{parent}
+    , pending(std::make_unique<QMcpPendingRequests>())
 {
     connect(this, &QMcpServerBackendInterface::received, this, [this](const QUuid &session, const QJsonObject &object) {
         if (object.contains("id"_L1)) {
-            const auto id = object.value("id"_L1);
             const auto result = object.value("result"_L1).toObject();
-            if (callbacks.value(session).contains(id)) {
-                callbacks[session].take(id)(result);
+            // Only a response completes a request; a client request may
+            // carry the same id.
+            if (!object.contains("method"_L1)) {
+                if (const auto callback = pending->take(session, object.value("id"_L1)))
+                    callback(result, object.value("error"_L1).toObject());
             }
             emit this->result(session, result);
         } else {
             // TODO: notification
         }
     });
+    connect(this, &QMcpServerBackendInterface::sessionEnded, this, [this](const QUuid &session) {
+        pending->removeOwner(session);
+    });
 }
 
+QMcpServerBackendInterface::~QMcpServerBackendInterface() = default;
+
 void QMcpServerBackendInterface::request(const QUuid &session, const QJsonObject &request, std::function<void(const QJsonObject &)> callback)
 {
-    static int id = 0;
     if (request.contains("id"_L1)) {
         auto request2 = request;
+        const auto id = pending->nextId();
         request2.insert("id"_L1, id);
 
-        if (callback)
-            callbacks[session].insert(id, callback);
-        id++;
+        if (callback) {
+            pending->insert(id, session, [callback](const QJsonObject &result, const QJsonObject &) {
+                callback(result);
+            });
+        }
         send(session, request2);
     } else {
         send(session, request);
     }
 }
 
+void QMcpServerBackendInterface::closeSession(const QUuid &session)
+{
+    emit sessionEnded(session);
+}
+
+bool QMcpServerBackendInterface::canNotifyDuringRequest(const QUuid &session) const
+{
+    Q_UNUSED(session);
+    return true;
+}
+
+quint64 QMcpServerBackendInterface::bytesReceived() const
+{
+    return receivedBytes;
+}
+
+quint64 QMcpServerBackendInterface::bytesSent() const
+{
+    return sentBytes;
+}
+
+void QMcpServerBackendInterface::addBytesReceived(qint64 bytes)
+{
+    receivedBytes += bytes;
+}
+
+void QMcpServerBackendInterface::addBytesSent(qint64 bytes)
+{
+    sentBytes += bytes;
+}
+
 QT_END_NAMESPACE
@@ -9,8 +9,13 @@
 #include <QtCore/QUuid>
 #include <QtMcpServer/qmcpserverglobal.h>
 
+#include <functional>
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
+class QMcpPendingRequests;
+
 /*!
     \class QMcpServerBackendInterface
     \inmodule QtMcpServer
@@ -37,9 +42,14 @@ public:
         \param parent The parent object
     */
     explicit QMcpServerBackendInterface(QObject *parent = nullptr);
+    ~QMcpServerBackendInterface() override;
 
     /*!
         Sends a request to a specific client session and optionally handles the response with a callback.
+
+        A request the client does not answer within five minutes is
+        completed with an empty result; the callbacks of a session that
+        ends are dropped. Either way they never pile up.
         
         \param session UUID of the client session
         \param request The request as a JSON object
@@ -47,6 +57,31 @@ public:
     */
     void request(const QUuid &session, const QJsonObject &request, std::function<void(const QJsonObject &)> callback = nullptr);
 
+    /*!
+        Returns the number of bytes the transport read from clients. Backends
+        either report them with addBytesReceived() or override this.
+    */
+    virtual quint64 bytesReceived() const;
+
+    /*!
+        Returns the number of bytes the transport wrote to clients. Backends
+        either report them with addBytesSent() or override this.
+    */
+    virtual quint64 bytesSent() const;
+
+    /*!
+        Returns whether a notification sent to \a session now reaches the
+        client while one of its requests is still pending. The default
+        implementation returns \c true, for transports that keep one
+        connection per session; QMcpToolResultWriter buffers when it is
+        \c false.
+    */
+    virtual bool canNotifyDuringRequest(const QUuid &session) const;
+
+protected:
+    void addBytesReceived(qint64 bytes);
+    void addBytesSent(qint64 bytes);
+
 public slots:
     /*!
         Starts the backend with the given server arguments.
@@ -74,6 +109,16 @@ public slots:
     */
     virtual void notify(const QUuid &session, const QJsonObject &object) = 0;
 
+    /*!
+        Ends a client session: the transport drops the connection or mapping
+        it is known by and emits sessionEnded(). The default implementation
+        only emits sessionEnded(), for transports that cannot end a session
+        from their side.
+
+        \param session UUID of the client session
+    */
+    virtual void closeSession(const QUuid &session);
+
 signals:
     /*!
         Emitted when a new client session is established.
@@ -81,6 +126,14 @@ signals:
     */
     void newSessionStarted(const QUuid &session);
 
+    /*!
+        Emitted when a client session is gone, whether the client
+        disconnected or terminated it, or closeSession() ended it. Emitted
+        once per session; nothing is received for it afterwards.
+        \param session UUID of the client session
+    */
+    void sessionEnded(const QUuid &session);
+
     /*!
         Emitted when the backend has successfully started.
     */
@@ -106,7 +159,9 @@ signals:
     void result(const QUuid &session, const QJsonObject &result);
 
 private:
-    QHash<QUuid, QHash<QJsonValue, std::function<void(const QJsonObject &)>>> callbacks;
+    std::unique_ptr<QMcpPendingRequests> pending;
+    quint64 receivedBytes = 0;
+    quint64 sentBytes = 0;
 };
 
 QT_END_NAMESPACE
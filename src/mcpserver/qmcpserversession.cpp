@@ -3,10 +3,12 @@
 
 #include "qmcpserversession.h"
 #include "qmcpserver.h"
+#include "qmcpsubscriptionindex_p.h"
 #include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
 #include <QtCore/QMultiHash>
 #include <QtCore/QPromise>
+#include <QtCore/QSet>
 #include <QtCore/QTimer>
 #ifdef QT_GUI_LIB
 #include <QtGui/QAction>
@@ -17,6 +19,12 @@
 
 QT_BEGIN_NAMESPACE
 
+static QSet<QString> resourceSubscriptions(const QMcpSubscriptionFilter &filter)
+{
+    const auto uris = filter.resourceSubscriptions();
+    return QSet<QString>(uris.cbegin(), uris.cend());
+}
+
 static QString buildParameterErrorMessage(const QString &toolName, const QJsonObject &providedParams, const QMcpToolInputSchema &schema)
 {
     using namespace Qt::Literals::StringLiterals;
@@ -88,24 +96,19 @@ public:
     QList<QPair<QMcpResource, QMcpReadResourceResultContents>> resources;
     QList<QPair<QMcpPrompt, QMcpPromptMessage>> prompts;
     QList<QPair<QMcpTool, QObject *>> tools;
+    QList<QPair<QMcpTool, ToolFunction>> functionTools;
 #ifdef QT_GUI_LIB
     QList<QPair<QMcpTool, QAction *>> actions;
 #endif
     QList<QMcpRoot> roots;
     QMultiHash<QUrl, QUrl> subscriptions;
+    std::shared_ptr<QMcpSubscriptionIndex> subscriptionIndex;
 
     bool listenSubscribed = false;
     QMcpSubscriptionFilter listenFilter;
     QString listenSubscriptionId;
 
-    QJsonObject inputResponses;
-    QJsonValue clientRequestState;
-    bool inputRequired = false;
-    QJsonObject requiredInputRequests;
-    QJsonValue requiredRequestState;
-
-    QJsonObject clientCapabilities;
-    QJsonObject resultOverride;
+    QMcpRequestContext currentRequest;
 
     QTimer notifyResourceListChanged;
     QTimer notifyPromptListChanged;
@@ -134,7 +137,11 @@ QMcpServerSession::QMcpServerSession(const QUuid &sessionId, QMcpServer *parent)
     , d(new Private(sessionId, this))
 {}
 
-QMcpServerSession::~QMcpServerSession() = default;
+QMcpServerSession::~QMcpServerSession()
+{
+    if (d->subscriptionIndex)
+        d->subscriptionIndex->removeSubscriber(d->sessionId);
+}
 
 QUuid QMcpServerSession::sessionId() const
 {
@@ -175,6 +182,16 @@ QMcpSubscriptionFilter QMcpServerSession::listenSubscriptions() const
 
 void QMcpServerSession::setListenSubscriptions(const QMcpSubscriptionFilter &filter)
 {
+    if (d->subscriptionIndex) {
+        // A new listen request replaces the resources the previous one
+        // named.
+        if (d->listenSubscribed) {
+            for (const auto &uri : resourceSubscriptions(d->listenFilter))
+                d->subscriptionIndex->unsubscribe(d->sessionId, uri);
+        }
+        for (const auto &uri : resourceSubscriptions(filter))
+            d->subscriptionIndex->subscribe(d->sessionId, uri);
+    }
     d->listenSubscribed = true;
     d->listenFilter = filter;
     if (d->listenSubscriptionId.isEmpty())
@@ -186,14 +203,24 @@ QString QMcpServerSession::listenSubscriptionId() const
     return d->listenSubscriptionId;
 }
 
+QMcpRequestContext QMcpServerSession::currentRequest() const
+{
+    return d->currentRequest;
+}
+
+void QMcpServerSession::setCurrentRequest(const QMcpRequestContext &context)
+{
+    d->currentRequest = context;
+}
+
 QJsonObject QMcpServerSession::inputResponses() const
 {
-    return d->inputResponses;
+    return d->currentRequest.inputResponses();
 }
 
 QJsonValue QMcpServerSession::clientRequestState() const
 {
-    return d->clientRequestState;
+    return d->currentRequest.clientRequestState();
 }
 
 void QMcpServerSession::requireInput(const QJsonObject &inputRequests, const QJsonValue &requestState)
@@ -203,9 +230,11 @@ void QMcpServerSession::requireInput(const QJsonObject &inputRequests, const QJs
                    << QtMcp::protocolVersionToString(protocolVersion());
         return;
     }
-    d->inputRequired = true;
-    d->requiredInputRequests = inputRequests;
-    d->requiredRequestState = requestState;
+    if (!d->currentRequest.isValid()) {
+        qWarning() << "requireInput() called outside of a request";
+        return;
+    }
+    d->currentRequest.requireInput(inputRequests, requestState);
 }
 
 QJsonObject QMcpServerSession::elicitationInputRequest(const QMcpElicitRequestParams &params)
@@ -216,47 +245,9 @@ QJsonObject QMcpServerSession::elicitationInputRequest(const QMcpElicitRequestPa
     return request;
 }
 
-void QMcpServerSession::provideInputResponses(const QJsonObject &responses, const QJsonValue &requestState)
-{
-    d->inputResponses = responses;
-    d->clientRequestState = requestState;
-    d->inputRequired = false;
-    d->requiredInputRequests = QJsonObject();
-    d->requiredRequestState = QJsonValue();
-}
-
 QJsonObject QMcpServerSession::clientCapabilitiesJson() const
 {
-    return d->clientCapabilities;
-}
-
-void QMcpServerSession::setClientCapabilitiesJson(const QJsonObject &capabilities)
-{
-    d->clientCapabilities = capabilities;
-}
-
-void QMcpServerSession::overrideResult(const QJsonObject &result)
-{
-    d->resultOverride = result;
-}
-
-QJsonObject QMcpServerSession::takeResultOverride()
-{
-    return std::exchange(d->resultOverride, QJsonObject());
-}
-
-bool QMcpServerSession::takeRequiredInput(QJsonObject *inputRequests, QJsonValue *requestState)
-{
-    if (!d->inputRequired)
-        return false;
-    if (inputRequests)
-        *inputRequests = d->requiredInputRequests;
-    if (requestState)
-        *requestState = d->requiredRequestState;
-    d->inputRequired = false;
-    d->requiredInputRequests = QJsonObject();
-    d->requiredRequestState = QJsonValue();
-    return true;
+    return d->currentRequest.clientCapabilities();
 }
 
 bool QMcpServerSession::isInitialized() const
@@ -583,6 +574,24 @@ void QMcpServerSession::unregisterToolSet(const QObject *toolSet)
         d->notifyChanged(d->notifyToolListChanged);
 }
 
+void QMcpServerSession::addTool(const QMcpTool &tool, const ToolFunction &function)
+{
+    removeTool(tool.name());
+    d->functionTools.append(qMakePair(tool, function));
+    d->notifyChanged(d->notifyToolListChanged);
+}
+
+void QMcpServerSession::removeTool(const QString &name)
+{
+    for (int i = d->functionTools.length() - 1; i >= 0; i--) {
+        if (d->functionTools.at(i).first.name() == name) {
+            d->functionTools.removeAt(i);
+            d->notifyChanged(d->notifyToolListChanged);
+            return;
+        }
+    }
+}
+
 #ifdef QT_GUI_LIB
 void QMcpServerSession::registerTool(QAction *action, const QString &name)
 {
@@ -682,6 +691,8 @@ QList<QMcpTool> QMcpServerSession::tools(QString *cursor) const
     QList<QMcpTool> ret;
     for (const auto &pair : std::as_const(d->tools))
         ret.append(pair.first);
+    for (const auto &pair : std::as_const(d->functionTools))
+        ret.append(pair.first);
 #ifdef QT_GUI_LIB
     for (const auto &pair : std::as_const(d->actions))
         ret.append(pair.first);
@@ -896,6 +907,13 @@ QFuture<QMcpCallToolResult> QMcpServerSession::callToolAsync(
 {
     using namespace Qt::Literals::StringLiterals;
 
+    // Function tools decode their arguments themselves and are called
+    // directly.
+    for (const auto &pair : std::as_const(d->functionTools)) {
+        if (pair.first.name() == name)
+            return pair.second(d->sessionId, params, d->currentRequest);
+    }
+
     for (const auto &pair : std::as_const(d->tools)) {
         const auto tool = pair.first;
         if (tool.name() != name)
@@ -1073,14 +1091,33 @@ void QMcpServerSession::setRoots(const QList<QMcpRoot> &roots)
 
 void QMcpServerSession::subscribe(const QUrl &uri)
 {
+    if (d->subscriptionIndex && !d->subscriptions.contains(uri))
+        d->subscriptionIndex->subscribe(d->sessionId, uri.toString());
     d->subscriptions.insert(uri, uri);
 }
 
 void QMcpServerSession::unsubscribe(const QUrl &uri)
 {
+    if (d->subscriptionIndex && d->subscriptions.contains(uri))
+        d->subscriptionIndex->unsubscribe(d->sessionId, uri.toString());
     d->subscriptions.remove(uri);
 }
 
+void QMcpServerSession::setSubscriptionIndex(std::shared_ptr<QMcpSubscriptionIndex> index)
+{
+    if (d->subscriptionIndex)
+        d->subscriptionIndex->removeSubscriber(d->sessionId);
+    d->subscriptionIndex = std::move(index);
+    if (!d->subscriptionIndex)
+        return;
+    for (const auto &uri : d->subscriptions.uniqueKeys())
+        d->subscriptionIndex->subscribe(d->sessionId, uri.toString());
+    if (d->listenSubscribed) {
+        for (const auto &uri : resourceSubscriptions(d->listenFilter))
+            d->subscriptionIndex->subscribe(d->sessionId, uri);
+    }
+}
+
 bool QMcpServerSession::isSubscribed(const QUrl &uri) const
 {
     return d->subscriptions.contains(uri);
@@ -25,8 +25,12 @@
 #include <QtMcpCommon/QMcpRoot>
 #include <QtMcpCommon/QMcpTool>
 #include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/qmcprequestcontext.h>
 #include <QtMcpServer/qmcpserverglobal.h>
 
+#include <functional>
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 #ifdef QT_GUI_LIB
@@ -34,6 +38,7 @@ class QAction;
 #endif
 
 class QMcpServer;
+class QMcpSubscriptionIndex;
 
 /*!
     \class QMcpServerSession
@@ -230,6 +235,17 @@ public slots:
 
     void registerToolSet(QObject *toolSet, const QHash<QString, QString> &descriptions = {});
     void unregisterToolSet(const QObject *toolSet);
+
+    /*!
+        A tool implemented by a function instead of a method of a tool set:
+        called with the session id, the call's arguments and the request
+        it is handled as, e.g. for a QMcpToolResultWriter.
+        \sa QMcpServer::addTool()
+     */
+    using ToolFunction = std::function<QFuture<QMcpCallToolResult>(const QUuid &session, const QJsonObject &arguments,
+                                                                   const QMcpRequestContext &request)>;
+    void addTool(const QMcpTool &tool, const ToolFunction &function);
+    void removeTool(const QString &name);
 #ifdef QT_GUI_LIB
     void registerTool(QAction *action, const QString &name);
     void unregisterTool(const QAction *action);
@@ -250,30 +266,32 @@ public slots:
     void setListenSubscriptions(const QMcpSubscriptionFilter &filter);
     QString listenSubscriptionId() const;
 
+    // Internal plumbing for QMcpServer: the server-wide index this
+    // session's resource subscriptions are kept in, for routing updates.
+    void setSubscriptionIndex(std::shared_ptr<QMcpSubscriptionIndex> index);
+
+    // The request being handled: its client capabilities, MRTR input and
+    // result override. Set by QMcpServer before each handler call, so it is
+    // the calling request's context for the synchronous part of a handler;
+    // an asynchronous handler keeps a copy for what it does later.
+    QMcpRequestContext currentRequest() const;
+    void setCurrentRequest(const QMcpRequestContext &context);
+
     // Multi round-trip requests (2026-07-28). During request handling a tool
     // or handler reads the input the client supplied on a retry with
     // inputResponses(), and calls requireInput() when it cannot finish
     // without more; the server then answers with an input_required interim
     // result instead of the handler's result. requestState round-trips
-    // through the client, so the server stays stateless.
+    // through the client, so the server stays stateless. These act on
+    // currentRequest().
     QJsonObject inputResponses() const;
     QJsonValue clientRequestState() const;
     void requireInput(const QJsonObject &inputRequests, const QJsonValue &requestState = QJsonValue());
     static QJsonObject elicitationInputRequest(const QMcpElicitRequestParams &params);
 
-    // Internal plumbing for QMcpServer.
-    void provideInputResponses(const QJsonObject &responses, const QJsonValue &requestState);
-    bool takeRequiredInput(QJsonObject *inputRequests, QJsonValue *requestState);
-
     // The client capabilities carried in the request _meta of a stateless
-    // (2026-07-28) session, e.g. declared extensions. Updated per request.
+    // (2026-07-28) session, e.g. declared extensions, for currentRequest().
     QJsonObject clientCapabilitiesJson() const;
-    void setClientCapabilitiesJson(const QJsonObject &capabilities);
-
-    // Replaces the pending request's result with a pre-serialized object,
-    // e.g. a CreateTaskResult from the tasks extension. Internal.
-    void overrideResult(const QJsonObject &result);
-    QJsonObject takeResultOverride();
 
 signals:
     void initializedChanged(bool initialized);
@@ -0,0 +1,250 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpserverstatistics_p.h"
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+/*!
+    \internal
+    Escapes a label value as the exposition format requires.
+*/
+QByteArray labelValue(const QString &value)
+{
+    QByteArray ret = value.toUtf8();
+    ret.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return ret;
+}
+
+QByteArray number(double value)
+{
+    return QByteArray::number(value, 'g', 12);
+}
+
+void appendHeader(QByteArray *out, const char *name, const char *type, const char *help)
+{
+    *out += "# HELP "_ba + name + ' ' + help + '\n';
+    *out += "# TYPE "_ba + name + ' ' + type + '\n';
+}
+
+void appendHistogram(QByteArray *out, const QByteArray &name, const QByteArray &labels,
+                     const QMcpServerStatistics::Counter &counter)
+{
+    const QByteArray separator = labels.isEmpty() ? QByteArray() : ","_ba;
+    quint64 cumulative = 0;
+    for (size_t i = 0; i < QMcpServerStatistics::LatencyBucketsMs.size(); ++i) {
+        cumulative += counter.bucket(i);
+        *out += name + "_bucket{" + labels + separator + "le=\"" + number(QMcpServerStatistics::LatencyBucketsMs[i] / 1000)
+                + "\"} " + QByteArray::number(cumulative) + '\n';
+    }
+    *out += name + "_bucket{" + labels + separator + "le=\"+Inf\"} " + QByteArray::number(counter.count()) + '\n';
+    const QByteArray braced = labels.isEmpty() ? QByteArray() : '{' + labels + '}';
+    *out += name + "_sum" + braced + ' ' + number(counter.totalMs() / 1000) + '\n';
+    *out += name + "_count" + braced + ' ' + QByteArray::number(counter.count()) + '\n';
+}
+
+void appendCounters(QByteArray *out, const char *prefix, const char *label,
+                    const QHash<QString, QMcpServerStatistics::Counter> &counters)
+{
+    if (counters.isEmpty())
+        return;
+    auto keys = counters.keys();
+    std::sort(keys.begin(), keys.end());
+
+    const QByteArray total = prefix + "_total"_ba;
+    const QByteArray errors = prefix + "_errors_total"_ba;
+    const QByteArray duration = prefix + "_duration_seconds"_ba;
+
+    appendHeader(out, total.constData(), "counter", "Number of calls.");
+    for (const auto &key : std::as_const(keys))
+        *out += total + '{' + label + "=\"" + labelValue(key) + "\"} " + QByteArray::number(counters.value(key).count()) + '\n';
+
+    appendHeader(out, errors.constData(), "counter", "Number of calls answered with an error.");
+    for (const auto &key : std::as_const(keys))
+        *out += errors + '{' + label + "=\"" + labelValue(key) + "\"} " + QByteArray::number(counters.value(key).errors()) + '\n';
+
+    appendHeader(out, duration.constData(), "histogram", "Time from receiving a call to sending its response.");
+    for (const auto &key : std::as_const(keys))
+        appendHistogram(out, duration, label + "=\""_ba + labelValue(key) + '"', counters[key]);
+}
+
+} // namespace
+
+void QMcpServerStatistics::Counter::record(double elapsedMs, bool error)
+{
+    ++m_count;
+    if (error)
+        ++m_errors;
+    m_totalMs += elapsedMs;
+    const auto bucket = std::lower_bound(LatencyBucketsMs.cbegin(), LatencyBucketsMs.cend(), elapsedMs);
+    ++m_buckets[bucket - LatencyBucketsMs.cbegin()];
+}
+
+double QMcpServerStatistics::Counter::percentile(double quantile) const
+{
+    if (m_count == 0)
+        return 0;
+    const double target = qBound(0.0, quantile, 1.0) * m_count;
+    quint64 cumulative = 0;
+    for (size_t i = 0; i < m_buckets.size(); ++i) {
+        if (m_buckets[i] == 0)
+            continue;
+        const quint64 previous = cumulative;
+        cumulative += m_buckets[i];
+        if (cumulative < target)
+            continue;
+        // The overflow bucket has no upper bound to interpolate towards.
+        if (i == LatencyBucketsMs.size())
+            return LatencyBucketsMs.back();
+        const double lower = i == 0 ? 0 : LatencyBucketsMs[i - 1];
+        const double upper = LatencyBucketsMs[i];
+        return lower + (upper - lower) * (target - previous) / m_buckets[i];
+    }
+    return LatencyBucketsMs.back();
+}
+
+QMcpServerStatistics::QMcpServerStatistics()
+    : d(new Private)
+{}
+
+QMcpServerStatistics::QMcpServerStatistics(const QMcpServerStatistics &other) = default;
+QMcpServerStatistics::QMcpServerStatistics(QMcpServerStatistics &&other) noexcept = default;
+QMcpServerStatistics &QMcpServerStatistics::operator=(const QMcpServerStatistics &other) = default;
+QMcpServerStatistics &QMcpServerStatistics::operator=(QMcpServerStatistics &&other) noexcept = default;
+QMcpServerStatistics::~QMcpServerStatistics() = default;
+
+QString QMcpServerStatistics::transport() const
+{
+    return d->transport;
+}
+
+QHash<QString, QMcpServerStatistics::Counter> QMcpServerStatistics::methods() const
+{
+    return d->methods;
+}
+
+QHash<QString, QMcpServerStatistics::Counter> QMcpServerStatistics::tools() const
+{
+    return d->tools;
+}
+
+QHash<int, quint64> QMcpServerStatistics::errorCodes() const
+{
+    return d->errorCodes;
+}
+
+quint64 QMcpServerStatistics::bytesReceived() const
+{
+    return d->bytesReceived;
+}
+
+quint64 QMcpServerStatistics::bytesSent() const
+{
+    return d->bytesSent;
+}
+
+qsizetype QMcpServerStatistics::activeSessions() const
+{
+    return d->activeSessions;
+}
+
+qsizetype QMcpServerStatistics::pendingRequests() const
+{
+    return d->pendingRequests;
+}
+
+qsizetype QMcpServerStatistics::inFlightRequests() const
+{
+    return d->inFlightRequests;
+}
+
+qsizetype QMcpServerStatistics::tasks() const
+{
+    return d->tasks;
+}
+
+QHash<QString, quint64> QMcpServerStatistics::notificationsCoalesced() const
+{
+    return d->notificationsCoalesced;
+}
+
+qsizetype QMcpServerStatistics::runningToolCalls() const
+{
+    return d->runningToolCalls;
+}
+
+qsizetype QMcpServerStatistics::queuedToolCalls() const
+{
+    return d->queuedToolCalls;
+}
+
+QHash<QUuid, qsizetype> QMcpServerStatistics::queuedToolCallsBySession() const
+{
+    return d->queuedToolCallsBySession;
+}
+
+QMcpServerStatistics::Counter QMcpServerStatistics::toolQueueWait() const
+{
+    return d->toolQueueWait;
+}
+
+QByteArray QMcpServerStatistics::toPrometheusText() const
+{
+    QByteArray out;
+    appendCounters(&out, "mcp_requests", "method", d->methods);
+    appendCounters(&out, "mcp_tool_calls", "tool", d->tools);
+
+    if (!d->errorCodes.isEmpty()) {
+        auto codes = d->errorCodes.keys();
+        std::sort(codes.begin(), codes.end());
+        appendHeader(&out, "mcp_errors_total", "counter", "JSON-RPC error responses by code.");
+        for (const int code : std::as_const(codes))
+            out += "mcp_errors_total{code=\"" + QByteArray::number(code) + "\"} " + QByteArray::number(d->errorCodes.value(code)) + '\n';
+    }
+
+    if (!d->notificationsCoalesced.isEmpty()) {
+        auto keys = d->notificationsCoalesced.keys();
+        std::sort(keys.begin(), keys.end());
+        appendHeader(&out, "mcp_notifications_coalesced_total", "counter", "Change notifications folded into another.");
+        for (const auto &method : std::as_const(keys))
+            out += "mcp_notifications_coalesced_total{method=\"" + labelValue(method) + "\"} "
+                    + QByteArray::number(d->notificationsCoalesced.value(method)) + '\n';
+    }
+
+    const QByteArray transportLabel = "{transport=\"" + labelValue(d->transport) + "\"} ";
+    appendHeader(&out, "mcp_transport_received_bytes_total", "counter", "Bytes read from clients.");
+    out += "mcp_transport_received_bytes_total" + transportLabel + QByteArray::number(d->bytesReceived) + '\n';
+    appendHeader(&out, "mcp_transport_sent_bytes_total", "counter", "Bytes written to clients.");
+    out += "mcp_transport_sent_bytes_total" + transportLabel + QByteArray::number(d->bytesSent) + '\n';
+
+    appendHeader(&out, "mcp_sessions", "gauge", "Active sessions.");
+    out += "mcp_sessions " + QByteArray::number(d->activeSessions) + '\n';
+    appendHeader(&out, "mcp_pending_requests", "gauge", "Requests sent to clients awaiting an answer.");
+    out += "mcp_pending_requests " + QByteArray::number(d->pendingRequests) + '\n';
+    appendHeader(&out, "mcp_in_flight_requests", "gauge", "Client requests being handled.");
+    out += "mcp_in_flight_requests " + QByteArray::number(d->inFlightRequests) + '\n';
+    appendHeader(&out, "mcp_tasks", "gauge", "Entries in the task store.");
+    out += "mcp_tasks " + QByteArray::number(d->tasks) + '\n';
+    appendHeader(&out, "mcp_running_tool_calls", "gauge", "Tool calls running.");
+    out += "mcp_running_tool_calls " + QByteArray::number(d->runningToolCalls) + '\n';
+    appendHeader(&out, "mcp_queued_tool_calls", "gauge", "Tool calls waiting for a concurrency limit.");
+    out += "mcp_queued_tool_calls " + QByteArray::number(d->queuedToolCalls) + '\n';
+    // Per session depths would make a label of every session id; the
+    // deepest queue is what tells a flooding client apart.
+    qsizetype deepest = 0;
+    for (const qsizetype depth : std::as_const(d->queuedToolCallsBySession))
+        deepest = std::max(deepest, depth);
+    appendHeader(&out, "mcp_session_queued_tool_calls_max", "gauge", "Tool calls waiting in the deepest session queue.");
+    out += "mcp_session_queued_tool_calls_max " + QByteArray::number(deepest) + '\n';
+    if (d->toolQueueWait.count() > 0) {
+        appendHeader(&out, "mcp_tool_queue_wait_seconds", "histogram", "Time tool calls waited before they ran.");
+        appendHistogram(&out, "mcp_tool_queue_wait_seconds"_ba, {}, d->toolQueueWait);
+    }
+    return out;
+}
+
+QT_END_NAMESPACE
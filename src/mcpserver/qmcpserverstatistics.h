@@ -0,0 +1,153 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSERVERSTATISTICS_H
+#define QMCPSERVERSTATISTICS_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSharedDataPointer>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+#include <QtMcpServer/qmcpserverglobal.h>
+
+#include <array>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpServerStatistics
+    \inmodule QtMcpServer
+    \brief The QMcpServerStatistics class is a snapshot of what a QMcpServer has been doing.
+
+    Obtained from QMcpServer::statistics(). Counters accumulate from the
+    server's construction; the gauges (sessions, pending requests, tasks,
+    tool call queues) describe the moment the snapshot was taken.
+
+    Latencies are kept as fixed bucket histograms, the same shape Prometheus
+    uses, so recording one is a handful of integer increments. Percentiles
+    are estimated from the buckets.
+
+    QMcpServerStatistics is implicitly shared; copying a snapshot is cheap.
+
+    \sa QMcpServer::statistics()
+*/
+class Q_MCPSERVER_EXPORT QMcpServerStatistics
+{
+public:
+    /*!
+        Upper bounds of the latency buckets in milliseconds. A last, implicit
+        bucket collects everything slower.
+    */
+    static constexpr std::array<double, 13> LatencyBucketsMs = {
+        1, 2.5, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000
+    };
+
+    /*!
+        Call count, error count and latency histogram of one method or tool.
+    */
+    class Q_MCPSERVER_EXPORT Counter
+    {
+    public:
+        quint64 count() const { return m_count; }
+        quint64 errors() const { return m_errors; }
+        double totalMs() const { return m_totalMs; }
+        /*!
+            Returns how many calls fell into the bucket at \a index of
+            LatencyBucketsMs; LatencyBucketsMs.size() is the overflow bucket.
+        */
+        quint64 bucket(qsizetype index) const { return m_buckets.at(index); }
+
+        void record(double elapsedMs, bool error);
+        /*!
+            Returns the estimated latency in milliseconds below which the
+            fraction \a quantile (0..1) of the calls finished.
+        */
+        double percentile(double quantile) const;
+
+    private:
+        quint64 m_count = 0;
+        quint64 m_errors = 0;
+        double m_totalMs = 0;
+        std::array<quint64, LatencyBucketsMs.size() + 1> m_buckets = {};
+    };
+
+    QMcpServerStatistics();
+    QMcpServerStatistics(const QMcpServerStatistics &other);
+    QMcpServerStatistics(QMcpServerStatistics &&other) noexcept;
+    QMcpServerStatistics &operator=(const QMcpServerStatistics &other);
+    QMcpServerStatistics &operator=(QMcpServerStatistics &&other) noexcept;
+    ~QMcpServerStatistics();
+
+    void swap(QMcpServerStatistics &other) noexcept { d.swap(other.d); }
+
+    QString transport() const;
+    QHash<QString, Counter> methods() const;
+    QHash<QString, Counter> tools() const;
+    QHash<int, quint64> errorCodes() const;
+    quint64 bytesReceived() const;
+    quint64 bytesSent() const;
+    qsizetype activeSessions() const;
+
+    /*!
+        Returns how many requests the server sent to clients still await an
+        answer.
+    */
+    qsizetype pendingRequests() const;
+
+    /*!
+        Returns how many client requests the server is still working on.
+    */
+    qsizetype inFlightRequests() const;
+    qsizetype tasks() const;
+
+    /*!
+        Returns how many change notifications
+        QMcpServer::setNotificationCoalescing() folded into another, by
+        method.
+    */
+    QHash<QString, quint64> notificationsCoalesced() const;
+
+    /*!
+        Returns how many tools/call requests are running.
+    */
+    qsizetype runningToolCalls() const;
+
+    /*!
+        Returns how many tools/call requests wait for
+        QMcpServer::setConcurrencyLimits() to leave room for them. The
+        count of those rejected because the queue was full is
+        errorCodes()[QMcpServer::ServerBusyErrorCode].
+
+        \sa queuedToolCallsBySession()
+    */
+    qsizetype queuedToolCalls() const;
+
+    /*!
+        Returns the depth of each session's tool call queue. Sessions with
+        no waiting call are left out.
+    */
+    QHash<QUuid, qsizetype> queuedToolCallsBySession() const;
+
+    /*!
+        Returns how long the tool calls that ran had waited in the queue.
+    */
+    Counter toolQueueWait() const;
+
+    /*!
+        Returns the statistics in the Prometheus text exposition format.
+    */
+    QByteArray toPrometheusText() const;
+
+private:
+    class Private;
+    QSharedDataPointer<Private> d;
+    friend class QMcpServer;
+};
+
+Q_DECLARE_SHARED(QMcpServerStatistics)
+
+QT_END_NAMESPACE
+
+#endif // QMCPSERVERSTATISTICS_H
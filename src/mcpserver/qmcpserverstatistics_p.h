@@ -0,0 +1,45 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSERVERSTATISTICS_P_H
+#define QMCPSERVERSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpServer/qmcpserverstatistics.h>
+#include <QtCore/QSharedData>
+
+QT_BEGIN_NAMESPACE
+
+class QMcpServerStatistics::Private : public QSharedData
+{
+public:
+    QString transport;
+    QHash<QString, Counter> methods;
+    QHash<QString, Counter> tools;
+    QHash<int, quint64> errorCodes;
+    quint64 bytesReceived = 0;
+    quint64 bytesSent = 0;
+    qsizetype activeSessions = 0;
+    qsizetype pendingRequests = 0;
+    qsizetype inFlightRequests = 0;
+    qsizetype tasks = 0;
+    QHash<QString, quint64> notificationsCoalesced;
+    qsizetype runningToolCalls = 0;
+    qsizetype queuedToolCalls = 0;
+    QHash<QUuid, qsizetype> queuedToolCallsBySession;
+    Counter toolQueueWait;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSERVERSTATISTICS_P_H
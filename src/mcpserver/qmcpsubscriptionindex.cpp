@@ -0,0 +1,174 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpsubscriptionindex_p.h"
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt::Literals::StringLiterals;
+
+bool QMcpSubscriptionIndex::Pattern::matches(const QString &uri) const
+{
+    if (!expression.pattern().isEmpty())
+        return expression.match(uri).hasMatch();
+    if (isPrefix)
+        return uri.startsWith(prefix);
+    return uri == prefix;
+}
+
+QString QMcpSubscriptionIndex::literalPrefix(const QString &pattern)
+{
+    const auto brace = pattern.indexOf(u'{');
+    if (brace >= 0)
+        return pattern.left(brace);
+    return pattern.endsWith(u'*') ? pattern.chopped(1) : pattern;
+}
+
+QMcpSubscriptionIndex::Pattern QMcpSubscriptionIndex::parse(const QString &pattern)
+{
+    Pattern ret;
+    ret.prefix = literalPrefix(pattern);
+    ret.isPrefix = ret.prefix != pattern;
+    const auto brace = pattern.indexOf(u'{');
+    if (brace < 0)
+        return ret;
+
+    QString expression;
+    qsizetype from = 0;
+    for (qsizetype open = brace; open >= 0; open = pattern.indexOf(u'{', from)) {
+        const auto close = pattern.indexOf(u'}', open);
+        if (close < 0)
+            break;
+        expression += QRegularExpression::escape(pattern.mid(from, open - from));
+        const auto op = open + 1 < close ? pattern.at(open + 1) : QChar();
+        // Reserved and fragment expansion keep slashes; the others do not.
+        expression += (op == u'+' || op == u'#') ? ".*"_L1 : "[^/]*"_L1;
+        from = close + 1;
+    }
+    expression += QRegularExpression::escape(pattern.mid(from));
+    ret.expression.setPattern(QRegularExpression::anchoredPattern(expression));
+    return ret;
+}
+
+void QMcpSubscriptionIndex::subscribe(const QUuid &subscriber, const QString &pattern)
+{
+    if (m_patterns[subscriber][pattern]++ == 0)
+        add(subscriber, pattern);
+}
+
+void QMcpSubscriptionIndex::unsubscribe(const QUuid &subscriber, const QString &pattern)
+{
+    const auto it = m_patterns.find(subscriber);
+    if (it == m_patterns.end())
+        return;
+    const auto count = it->find(pattern);
+    if (count == it->end())
+        return;
+    if (--*count > 0)
+        return;
+    it->erase(count);
+    if (it->isEmpty())
+        m_patterns.erase(it);
+    remove(subscriber, pattern);
+}
+
+void QMcpSubscriptionIndex::removeSubscriber(const QUuid &subscriber)
+{
+    const auto patterns = m_patterns.take(subscriber);
+    for (auto it = patterns.cbegin(), end = patterns.cend(); it != end; ++it)
+        remove(subscriber, it.key());
+}
+
+void QMcpSubscriptionIndex::add(const QUuid &subscriber, const QString &pattern)
+{
+    const auto prefix = literalPrefix(pattern);
+    if (prefix == pattern) {
+        m_exact[pattern].insert(subscriber);
+        return;
+    }
+    auto &entries = m_byPrefix[prefix];
+    if (entries.isEmpty())
+        ++m_prefixLengths[prefix.size()];
+    auto &entry = entries[pattern];
+    if (entry.subscribers.isEmpty())
+        entry.pattern = parse(pattern);
+    entry.subscribers.insert(subscriber);
+}
+
+void QMcpSubscriptionIndex::remove(const QUuid &subscriber, const QString &pattern)
+{
+    const auto prefix = literalPrefix(pattern);
+    if (prefix == pattern) {
+        const auto it = m_exact.find(pattern);
+        if (it == m_exact.end())
+            return;
+        it->remove(subscriber);
+        if (it->isEmpty())
+            m_exact.erase(it);
+        return;
+    }
+    const auto entries = m_byPrefix.find(prefix);
+    if (entries == m_byPrefix.end())
+        return;
+    const auto entry = entries->find(pattern);
+    if (entry == entries->end())
+        return;
+    entry->subscribers.remove(subscriber);
+    if (!entry->subscribers.isEmpty())
+        return;
+    entries->erase(entry);
+    if (!entries->isEmpty())
+        return;
+    m_byPrefix.erase(entries);
+    const auto length = m_prefixLengths.find(prefix.size());
+    if (--*length == 0)
+        m_prefixLengths.erase(length);
+}
+
+QList<QUuid> QMcpSubscriptionIndex::subscribers(const QString &uri) const
+{
+    QSet<QUuid> ret = m_exact.value(uri);
+    for (auto it = m_prefixLengths.cbegin(), end = m_prefixLengths.cend(); it != end; ++it) {
+        if (it.key() > uri.size())
+            break;
+        const auto entries = m_byPrefix.constFind(uri.left(it.key()));
+        if (entries == m_byPrefix.cend())
+            continue;
+        for (const auto &entry : *entries) {
+            if (entry.pattern.matches(uri))
+                ret.unite(entry.subscribers);
+        }
+    }
+    return ret.values();
+}
+
+bool QMcpSubscriptionIndex::isSubscribed(const QUuid &subscriber, const QString &uri) const
+{
+    const auto patterns = m_patterns.constFind(subscriber);
+    if (patterns == m_patterns.cend())
+        return false;
+    if (patterns->contains(uri))
+        return true;
+    // The compiled patterns are kept with the entries.
+    for (auto it = patterns->cbegin(), end = patterns->cend(); it != end; ++it) {
+        const auto entries = m_byPrefix.constFind(literalPrefix(it.key()));
+        if (entries == m_byPrefix.cend())
+            continue;
+        const auto entry = entries->constFind(it.key());
+        if (entry != entries->cend() && entry->pattern.matches(uri))
+            return true;
+    }
+    return false;
+}
+
+QStringList QMcpSubscriptionIndex::patterns(const QUuid &subscriber) const
+{
+    return m_patterns.value(subscriber).keys();
+}
+
+bool QMcpSubscriptionIndex::isEmpty() const
+{
+    return m_patterns.isEmpty();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,97 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSUBSCRIPTIONINDEX_P_H
+#define QMCPSUBSCRIPTIONINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpServer/qmcpserverglobal.h>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QUuid>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpSubscriptionIndex
+    \internal
+    \inmodule QtMcpServer
+    \brief Maps resource URIs to the sessions subscribed to them, server wide.
+
+    A subscription pattern is one of
+    \list
+    \li a URI, matching only itself;
+    \li a prefix ending in \c{*}, matching every URI that starts with it;
+    \li an RFC 6570 URI template such as \c{file:///logs/{name}}, matching
+        the URIs it expands to. \c{{+var}} and \c{{#var}} match any text,
+        other expressions anything up to the next \c{/}.
+    \endlist
+
+    Exact URIs are a hash lookup. Prefixes and templates are filed under
+    their literal prefix, and only the prefix lengths in use are tried, so
+    subscribers() costs one lookup per distinct prefix length plus the
+    subscribers found, however many sessions subscribed to other URIs.
+
+    A subscriber may subscribe to the same pattern more than once, e.g.
+    through resources/subscribe and through subscriptions/listen; it stays
+    subscribed until it unsubscribed as often.
+*/
+class Q_MCPSERVER_EXPORT QMcpSubscriptionIndex
+{
+public:
+    void subscribe(const QUuid &subscriber, const QString &pattern);
+    void unsubscribe(const QUuid &subscriber, const QString &pattern);
+    // Drops every subscription of the subscriber, e.g. when its session ends.
+    void removeSubscriber(const QUuid &subscriber);
+
+    QList<QUuid> subscribers(const QString &uri) const;
+    bool isSubscribed(const QUuid &subscriber, const QString &uri) const;
+    QStringList patterns(const QUuid &subscriber) const;
+    bool isEmpty() const;
+
+private:
+    struct Pattern {
+        QString prefix;
+        // Invalid for exact URIs and plain prefixes.
+        QRegularExpression expression;
+        bool isPrefix = false;
+
+        bool matches(const QString &uri) const;
+    };
+    struct Entry {
+        Pattern pattern;
+        QSet<QUuid> subscribers;
+    };
+
+    static QString literalPrefix(const QString &pattern);
+    static Pattern parse(const QString &pattern);
+    void add(const QUuid &subscriber, const QString &pattern);
+    void remove(const QUuid &subscriber, const QString &pattern);
+
+    QHash<QString, QSet<QUuid>> m_exact;
+    // Literal prefix -> pattern -> entry.
+    QHash<QString, QHash<QString, Entry>> m_byPrefix;
+    // The lengths of the keys of m_byPrefix, with how many keys have each.
+    QMap<qsizetype, int> m_prefixLengths;
+    // Subscriber -> pattern -> how often it was subscribed.
+    QHash<QUuid, QHash<QString, int>> m_patterns;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSUBSCRIPTIONINDEX_P_H
@@ -0,0 +1,542 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPTOOLARGUMENT_H
+#define QMCPTOOLARGUMENT_H
+
+#include <QtMcpServer/qmcpserverglobal.h>
+#include <QtCore/QFuture>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QList>
+#include <QtCore/QPromise>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QUrl>
+#include <QtCore/QUuid>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpCommon/QMcpCallToolResultContent>
+#include <QtMcpCommon/QMcpTextContent>
+#include <QtMcpCommon/QMcpTool>
+#include <QtMcpServer/qmcprequestcontext.h>
+#include <QtMcpServer/qmcptoolresultwriter.h>
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpToolArgument
+    \inmodule QtMcpServer
+    \brief Describes how a C++ type travels as a tool argument.
+
+    QMcpServer::addTool() derives a tool's input schema from the parameter
+    types of the function implementing it, and decodes each argument from
+    JSON straight into the parameter's type. Both go through this template,
+    specialized for \c bool, the integral and floating point types,
+    QString, QUrl, QJsonValue, QJsonObject, QJsonArray, QList, \c std::vector
+    and \c std::optional. A specialization provides
+    \list
+    \li \c{static QJsonObject schema()}, the JSON schema of the type;
+    \li \c{static bool fromJson(const QJsonValue &json, T *value)}, which
+        returns \c false when \a json does not hold a \c T;
+    \li \c{static constexpr bool optional}, whether the argument may be
+        left out.
+    \endlist
+
+    Structs are described by deriving the specialization from
+    QMcpToolStruct and listing their members:
+
+    \code
+    struct Range { int from = 0; int to = 0; };
+
+    template<>
+    struct QMcpToolArgument<Range> : QMcpToolStruct<Range>
+    {
+        static constexpr auto fields = std::make_tuple(
+                QMcpToolField{ "from", &Range::from, "First line" },
+                QMcpToolField{ "to", &Range::to });
+    };
+    \endcode
+*/
+template<typename T, typename Enable = void>
+struct QMcpToolArgument
+{
+    static_assert(sizeof(T) == 0, "Specialize QMcpToolArgument to use this type as a tool argument");
+};
+
+template<>
+struct QMcpToolArgument<bool>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return { { "type"_L1, "boolean"_L1 } }; }
+    static bool fromJson(const QJsonValue &json, bool *value)
+    {
+        if (!json.isBool())
+            return false;
+        *value = json.toBool();
+        return true;
+    }
+};
+
+template<typename T>
+struct QMcpToolArgument<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return { { "type"_L1, "integer"_L1 } }; }
+    static bool fromJson(const QJsonValue &json, T *value)
+    {
+        if (!json.isDouble())
+            return false;
+        const double number = json.toDouble();
+        // 2^digits is the first value out of range. For 64-bit types max()
+        // is no double and rounds up to it, so the bound is exclusive.
+        if (std::trunc(number) != number
+            || number < double(std::numeric_limits<T>::lowest())
+            || number >= std::ldexp(1.0, std::numeric_limits<T>::digits))
+            return false;
+        // Past 2^63 only a quint64 is left, which toInteger() cannot hold.
+        *value = number < 0x1p63 ? T(json.toInteger()) : T(number);
+        return true;
+    }
+};
+
+template<typename T>
+struct QMcpToolArgument<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return { { "type"_L1, "number"_L1 } }; }
+    static bool fromJson(const QJsonValue &json, T *value)
+    {
+        if (!json.isDouble())
+            return false;
+        *value = T(json.toDouble());
+        return true;
+    }
+};
+
+template<>
+struct QMcpToolArgument<QString>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return { { "type"_L1, "string"_L1 } }; }
+    static bool fromJson(const QJsonValue &json, QString *value)
+    {
+        if (!json.isString())
+            return false;
+        *value = json.toString();
+        return true;
+    }
+};
+
+template<>
+struct QMcpToolArgument<QUrl>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return { { "type"_L1, "string"_L1 }, { "format"_L1, "uri"_L1 } }; }
+    static bool fromJson(const QJsonValue &json, QUrl *value)
+    {
+        if (!json.isString())
+            return false;
+        *value = QUrl(json.toString());
+        return value->isValid();
+    }
+};
+
+template<>
+struct QMcpToolArgument<QJsonValue>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return {}; }
+    static bool fromJson(const QJsonValue &json, QJsonValue *value)
+    {
+        *value = json;
+        return true;
+    }
+};
+
+template<>
+struct QMcpToolArgument<QJsonObject>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return { { "type"_L1, "object"_L1 } }; }
+    static bool fromJson(const QJsonValue &json, QJsonObject *value)
+    {
+        if (!json.isObject())
+            return false;
+        *value = json.toObject();
+        return true;
+    }
+};
+
+template<>
+struct QMcpToolArgument<QJsonArray>
+{
+    static constexpr bool optional = false;
+    static QJsonObject schema() { return { { "type"_L1, "array"_L1 } }; }
+    static bool fromJson(const QJsonValue &json, QJsonArray *value)
+    {
+        if (!json.isArray())
+            return false;
+        *value = json.toArray();
+        return true;
+    }
+};
+
+namespace QtMcpPrivate {
+
+// Shared by the sequence containers: QList, std::vector.
+template<typename Container>
+struct ToolArrayArgument
+{
+    using Item = typename Container::value_type;
+
+    static constexpr bool optional = false;
+    static QJsonObject schema()
+    {
+        return { { "type"_L1, "array"_L1 }, { "items"_L1, QMcpToolArgument<Item>::schema() } };
+    }
+    static bool fromJson(const QJsonValue &json, Container *value)
+    {
+        if (!json.isArray())
+            return false;
+        const auto array = json.toArray();
+        Container items;
+        items.reserve(array.size());
+        for (const auto &element : array) {
+            Item item{};
+            if (!QMcpToolArgument<Item>::fromJson(element, &item))
+                return false;
+            items.push_back(std::move(item));
+        }
+        *value = std::move(items);
+        return true;
+    }
+};
+
+} // namespace QtMcpPrivate
+
+template<typename T>
+struct QMcpToolArgument<QList<T>> : QtMcpPrivate::ToolArrayArgument<QList<T>> {};
+
+template<typename T>
+struct QMcpToolArgument<std::vector<T>> : QtMcpPrivate::ToolArrayArgument<std::vector<T>> {};
+
+template<typename T>
+struct QMcpToolArgument<std::optional<T>>
+{
+    static constexpr bool optional = true;
+    static QJsonObject schema() { return QMcpToolArgument<T>::schema(); }
+    static bool fromJson(const QJsonValue &json, std::optional<T> *value)
+    {
+        if (json.isNull() || json.isUndefined()) {
+            value->reset();
+            return true;
+        }
+        T inner{};
+        if (!QMcpToolArgument<T>::fromJson(json, &inner))
+            return false;
+        *value = std::move(inner);
+        return true;
+    }
+};
+
+/*!
+    \class QMcpToolField
+    \inmodule QtMcpServer
+    \brief A member of a struct passed as a tool argument: its JSON name,
+    the member and an optional description.
+
+    \sa QMcpToolStruct
+*/
+template<typename Class, typename Member>
+struct QMcpToolField
+{
+    const char *name;
+    Member Class::*member;
+    const char *description = nullptr;
+};
+
+template<typename Class, typename Member>
+QMcpToolField(const char *, Member Class::*) -> QMcpToolField<Class, Member>;
+template<typename Class, typename Member>
+QMcpToolField(const char *, Member Class::*, const char *) -> QMcpToolField<Class, Member>;
+
+/*!
+    \class QMcpToolStruct
+    \inmodule QtMcpServer
+    \brief Base of the QMcpToolArgument specializations of structs.
+
+    The specialization lists the struct's members in a \c fields tuple of
+    QMcpToolField. The struct becomes a JSON object with a property per
+    field; fields whose type is optional may be left out.
+*/
+template<typename T>
+struct QMcpToolStruct
+{
+    static constexpr bool optional = false;
+
+    static QJsonObject schema()
+    {
+        QJsonObject properties;
+        QJsonArray required;
+        std::apply([&](const auto &...field) {
+            (addField(field, &properties, &required), ...);
+        }, QMcpToolArgument<T>::fields);
+        QJsonObject ret { { "type"_L1, "object"_L1 }, { "properties"_L1, properties } };
+        if (!required.isEmpty())
+            ret.insert("required"_L1, required);
+        return ret;
+    }
+
+    static bool fromJson(const QJsonValue &json, T *value)
+    {
+        if (!json.isObject())
+            return false;
+        const auto object = json.toObject();
+        return std::apply([&](const auto &...field) {
+            return (readField(object, field, value) && ...);
+        }, QMcpToolArgument<T>::fields);
+    }
+
+private:
+    template<typename Member>
+    static void addField(const QMcpToolField<T, Member> &field, QJsonObject *properties, QJsonArray *required)
+    {
+        const auto name = QString::fromUtf8(field.name);
+        auto schema = QMcpToolArgument<Member>::schema();
+        if (field.description)
+            schema.insert("description"_L1, QString::fromUtf8(field.description));
+        properties->insert(name, schema);
+        if (!QMcpToolArgument<Member>::optional)
+            required->append(name);
+    }
+
+    template<typename Member>
+    static bool readField(const QJsonObject &object, const QMcpToolField<T, Member> &field, T *value)
+    {
+        const auto json = object.value(QString::fromUtf8(field.name));
+        if (json.isUndefined() && !QMcpToolArgument<Member>::optional)
+            return false;
+        return QMcpToolArgument<Member>::fromJson(json, &(value->*field.member));
+    }
+};
+
+namespace QtMcpPrivate {
+
+template<typename T>
+struct ToolFunctionTraits : ToolFunctionTraits<decltype(&T::operator())> {};
+
+template<typename R, typename... Args>
+struct ToolFunctionTraits<R (*)(Args...)>
+{
+    using Result = R;
+    using Arguments = std::tuple<std::decay_t<Args>...>;
+};
+
+template<typename R, typename C, typename... Args>
+struct ToolFunctionTraits<R (C::*)(Args...)> : ToolFunctionTraits<R (*)(Args...)> {};
+
+template<typename R, typename C, typename... Args>
+struct ToolFunctionTraits<R (C::*)(Args...) const> : ToolFunctionTraits<R (*)(Args...)> {};
+
+template<typename T>
+struct IsToolFuture : std::false_type {};
+template<typename T>
+struct IsToolFuture<QFuture<T>> : std::true_type { using Inner = T; };
+
+template<typename R>
+QMcpCallToolResult toolResult(R &&value)
+{
+    using T = std::decay_t<R>;
+    QMcpCallToolResult result;
+    if constexpr (std::is_same_v<T, QMcpCallToolResult>) {
+        return std::forward<R>(value);
+    } else if constexpr (std::is_same_v<T, QList<QMcpCallToolResultContent>>) {
+        result.setContent(std::forward<R>(value));
+    } else if constexpr (std::is_same_v<T, QString>) {
+        result.setContent({ QMcpTextContent(value) });
+    } else if constexpr (std::is_same_v<T, QStringList>) {
+        QList<QMcpCallToolResultContent> content;
+        for (const auto &text : value)
+            content.append(QMcpTextContent(text));
+        result.setContent(content);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        result.setContent({ QMcpTextContent(value ? "true"_L1 : "false"_L1) });
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        result.setContent({ QMcpTextContent(QString::number(value)) });
+    } else if constexpr (std::is_same_v<T, QJsonObject>) {
+        // Structured content, with its serialization for clients that
+        // only read the text.
+        result.setStructuredContent(value);
+        result.setContent({ QMcpTextContent(QString::fromUtf8(QJsonDocument(value).toJson(QJsonDocument::Compact))) });
+    } else {
+        static_assert(sizeof(T) == 0, "Unsupported tool result type");
+    }
+    return result;
+}
+
+inline QFuture<QMcpCallToolResult> finishedToolResult(const QMcpCallToolResult &result)
+{
+    QPromise<QMcpCallToolResult> promise;
+    promise.start();
+    promise.addResult(result);
+    promise.finish();
+    return promise.future();
+}
+
+inline QFuture<QMcpCallToolResult> toolError(const QString &message)
+{
+    QMcpCallToolResult result;
+    result.setContent({ QMcpTextContent(message) });
+    result.setIsError(true);
+    return finishedToolResult(result);
+}
+
+/*
+    Turns a function into a tool: its schema from the parameter types, and
+    a call that decodes the JSON arguments into them and the return value
+    into a QMcpCallToolResult. A leading QUuid parameter receives the
+    session id and is not an argument, as with Q_INVOKABLE tools. A
+    QMcpToolResultWriter parameter after it is not an argument either: the
+    function gets the call's writer, returns void and finishes the writer.
+*/
+template<typename Function>
+struct TypedTool
+{
+    using Traits = ToolFunctionTraits<std::decay_t<Function>>;
+    using Arguments = typename Traits::Arguments;
+    using Result = typename Traits::Result;
+    static constexpr std::size_t Count = std::tuple_size_v<Arguments>;
+    static constexpr bool TakesSession = Count > 0
+            && std::is_same_v<std::tuple_element_t<0, Arguments>, QUuid>;
+    static constexpr std::size_t WriterIndex = TakesSession ? 1 : 0;
+    static constexpr bool TakesWriter = Count > WriterIndex
+            && std::is_same_v<std::tuple_element_t<WriterIndex, Arguments>, QMcpToolResultWriter>;
+    static constexpr std::size_t First = WriterIndex + (TakesWriter ? 1 : 0);
+    static constexpr std::size_t ArgumentCount = Count - First;
+    static_assert(!TakesWriter || std::is_void_v<Result>,
+                  "A tool that takes a QMcpToolResultWriter returns its result through it");
+
+    static QMcpTool tool(const QString &name, const QStringList &parameterNames,
+                         const QHash<QString, QString> &descriptions)
+    {
+        QMcpTool tool;
+        tool.setName(name);
+        if (descriptions.contains(name))
+            tool.setDescription(descriptions.value(name));
+        QJsonObject properties;
+        QStringList required;
+        addProperties(parameterNames, descriptions, name, &properties, &required,
+                      std::make_index_sequence<ArgumentCount>());
+        QMcpToolInputSchema inputSchema;
+        inputSchema.setProperties(properties);
+        inputSchema.setRequired(required);
+        tool.setInputSchema(inputSchema);
+        return tool;
+    }
+
+    static std::function<QFuture<QMcpCallToolResult>(const QUuid &, const QJsonObject &, const QMcpRequestContext &)>
+    invoker(const QStringList &parameterNames, Function function)
+    {
+        return [parameterNames, function = std::move(function)](const QUuid &session, const QJsonObject &json,
+                                                                const QMcpRequestContext &request) mutable {
+            for (auto it = json.constBegin(); it != json.constEnd(); ++it) {
+                if (!parameterNames.contains(it.key()))
+                    return toolError("Unknown argument '%1'"_L1.arg(it.key()));
+            }
+            Arguments arguments;
+            if constexpr (TakesSession)
+                std::get<0>(arguments) = session;
+            QString error;
+            if (!decode(parameterNames, json, &arguments, &error, std::make_index_sequence<ArgumentCount>()))
+                return toolError(error);
+            if constexpr (TakesWriter) {
+                const QMcpToolResultWriter writer(request);
+                std::get<WriterIndex>(arguments) = writer;
+                std::apply(function, std::move(arguments));
+                return writer.future();
+            } else {
+                Q_UNUSED(request);
+                return call(function, std::move(arguments));
+            }
+        };
+    }
+
+private:
+    template<std::size_t... I>
+    static void addProperties(const QStringList &names, const QHash<QString, QString> &descriptions,
+                              const QString &toolName, QJsonObject *properties, QStringList *required,
+                              std::index_sequence<I...>)
+    {
+        (addProperty<I>(names.value(qsizetype(I)), descriptions, toolName, properties, required), ...);
+    }
+
+    template<std::size_t I>
+    static void addProperty(const QString &name, const QHash<QString, QString> &descriptions,
+                            const QString &toolName, QJsonObject *properties, QStringList *required)
+    {
+        using Argument = QMcpToolArgument<std::tuple_element_t<First + I, Arguments>>;
+        auto schema = Argument::schema();
+        const auto key = "%1/%2"_L1.arg(toolName, name);
+        if (descriptions.contains(key))
+            schema.insert("description"_L1, descriptions.value(key));
+        properties->insert(name, schema);
+        if (!Argument::optional)
+            required->append(name);
+    }
+
+    template<std::size_t... I>
+    static bool decode(const QStringList &names, const QJsonObject &json, Arguments *arguments,
+                       QString *error, std::index_sequence<I...>)
+    {
+        return (decodeOne<I>(names.value(qsizetype(I)), json, arguments, error) && ...);
+    }
+
+    template<std::size_t I>
+    static bool decodeOne(const QString &name, const QJsonObject &json, Arguments *arguments, QString *error)
+    {
+        using Argument = QMcpToolArgument<std::tuple_element_t<First + I, Arguments>>;
+        const auto value = json.value(name);
+        if (value.isUndefined() && !Argument::optional) {
+            *error = "Missing required argument '%1'"_L1.arg(name);
+            return false;
+        }
+        if (!Argument::fromJson(value, &std::get<First + I>(*arguments))) {
+            *error = "Invalid argument '%1', expected %2"_L1
+                    .arg(name, QString::fromUtf8(QJsonDocument(Argument::schema()).toJson(QJsonDocument::Compact)));
+            return false;
+        }
+        return true;
+    }
+
+    static QFuture<QMcpCallToolResult> call(Function &function, Arguments &&arguments)
+    {
+        if constexpr (std::is_void_v<Result>) {
+            std::apply(function, std::move(arguments));
+            return finishedToolResult(QMcpCallToolResult());
+        } else if constexpr (IsToolFuture<std::decay_t<Result>>::value) {
+            return std::apply(function, std::move(arguments)).then([](const typename IsToolFuture<std::decay_t<Result>>::Inner &value) {
+                return toolResult(value);
+            });
+        } else {
+            return finishedToolResult(toolResult(std::apply(function, std::move(arguments))));
+        }
+    }
+};
+
+} // namespace QtMcpPrivate
+
+QT_END_NAMESPACE
+
+#endif // QMCPTOOLARGUMENT_H
@@ -0,0 +1,182 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcptoolresultwriter.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
+#include <QtCore/QPromise>
+#include <QtMcpCommon/QMcpTextContent>
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+struct QMcpToolResultWriter::Data
+{
+    ~Data();
+    void resolve();
+
+    // Guards the state below; never held while content is handed to the
+    // sink, which may wait for the server thread.
+    mutable QMutex mutex;
+    QPromise<QMcpCallToolResult> promise;
+    QMcpRequestContext::PartialResultSink sink;
+    QtMcp::ProtocolVersion protocolVersion = QtMcp::ProtocolVersion::Latest;
+    QList<QMcpCallToolResultContent> content;
+    qsizetype bufferLimit = DefaultBufferLimit;
+    qsizetype buffered = 0;
+    bool truncated = false;
+    bool finished = false;
+    bool finishedWithError = false;
+    // Streamed content not handed to the sink yet, in append order. One
+    // thread at a time hands it over, draining is set meanwhile; content
+    // other threads append is queued for it, so the notifications keep
+    // their order without any thread waiting on another.
+    QList<QJsonArray> outbox;
+    bool draining = false;
+};
+
+// The last copy of the writer went away: the call is answered all the same.
+QMcpToolResultWriter::Data::~Data()
+{
+    if (finished)
+        return;
+    finished = true;
+    finishedWithError = true;
+    content.append(QMcpTextContent("Result incomplete: the tool dropped its writer without finishing it"_L1));
+    resolve();
+}
+
+// Called once finished is set and no content is left to hand over, so
+// nothing changes content or truncated anymore.
+void QMcpToolResultWriter::Data::resolve()
+{
+    QMcpCallToolResult result;
+    auto content = std::exchange(this->content, {});
+    bool isError = finishedWithError;
+    if (truncated) {
+        content.append(QMcpTextContent(
+                "Result truncated: it exceeds the %1 byte limit"_L1.arg(bufferLimit)));
+        isError = true;
+    }
+    result.setContent(content);
+    result.setIsError(isError);
+    promise.addResult(result);
+    promise.finish();
+}
+
+QMcpToolResultWriter::QMcpToolResultWriter() = default;
+
+QMcpToolResultWriter::QMcpToolResultWriter(const QMcpRequestContext &request)
+    : d(std::make_shared<Data>())
+{
+    d->sink = request.partialResultSink();
+    d->protocolVersion = request.protocolVersion();
+    d->promise.start();
+}
+
+bool QMcpToolResultWriter::isValid() const
+{
+    return bool(d);
+}
+
+bool QMcpToolResultWriter::isStreaming() const
+{
+    return d && bool(d->sink);
+}
+
+qsizetype QMcpToolResultWriter::bufferLimit() const
+{
+    if (!d)
+        return DefaultBufferLimit;
+    QMutexLocker locker(&d->mutex);
+    return d->bufferLimit;
+}
+
+void QMcpToolResultWriter::setBufferLimit(qsizetype bytes)
+{
+    if (!d)
+        return;
+    QMutexLocker locker(&d->mutex);
+    d->bufferLimit = bytes;
+}
+
+bool QMcpToolResultWriter::append(const QMcpCallToolResultContent &content)
+{
+    return append(QList<QMcpCallToolResultContent> { content });
+}
+
+bool QMcpToolResultWriter::append(const QList<QMcpCallToolResultContent> &content)
+{
+    if (!d)
+        return false;
+    QJsonArray array;
+    for (const auto &item : content)
+        array.append(item.toJsonObject(d->protocolVersion));
+
+    QMutexLocker locker(&d->mutex);
+    if (d->finished || d->truncated)
+        return false;
+    if (d->sink) {
+        d->outbox.append(array);
+        if (d->draining)
+            return true;
+        d->draining = true;
+        while (!d->outbox.isEmpty()) {
+            const auto next = d->outbox.takeFirst();
+            locker.unlock();
+            d->sink(next);
+            locker.relock();
+        }
+        d->draining = false;
+        // finish() called meanwhile left the response to this thread, to
+        // go out after the content.
+        const bool resolve = d->finished;
+        locker.unlock();
+        if (resolve)
+            d->resolve();
+        return true;
+    }
+
+    // The compact JSON is what the final response will carry, so it is what
+    // counts against the limit.
+    const auto size = QJsonDocument(array).toJson(QJsonDocument::Compact).size();
+    if (d->buffered + size > d->bufferLimit) {
+        d->truncated = true;
+        return false;
+    }
+    d->buffered += size;
+    d->content.append(content);
+    return true;
+}
+
+void QMcpToolResultWriter::finish(bool isError)
+{
+    if (!d)
+        return;
+    QMutexLocker locker(&d->mutex);
+    if (d->finished)
+        return;
+    d->finished = true;
+    d->finishedWithError = isError;
+    const bool resolve = !d->draining;
+    locker.unlock();
+    if (resolve)
+        d->resolve();
+}
+
+bool QMcpToolResultWriter::isFinished() const
+{
+    if (!d)
+        return false;
+    QMutexLocker locker(&d->mutex);
+    return d->finished;
+}
+
+QFuture<QMcpCallToolResult> QMcpToolResultWriter::future() const
+{
+    return d ? d->promise.future() : QFuture<QMcpCallToolResult>();
+}
+
+QT_END_NAMESPACE
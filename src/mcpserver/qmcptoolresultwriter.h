@@ -0,0 +1,109 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPTOOLRESULTWRITER_H
+#define QMCPTOOLRESULTWRITER_H
+
+#include <QtCore/QFuture>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpServer/qmcprequestcontext.h>
+#include <QtMcpServer/qmcpserverglobal.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpToolResultWriter
+    \inmodule QtMcpServer
+    \brief The QMcpToolResultWriter class lets a tool produce its result a content block at a time.
+
+    A tool that returns a large result, such as a bulk export, creates a
+    writer for the request it is handling, returns future() and append()s
+    content as it is produced. finish() completes the call.
+
+    When the client asked for partial results, by sending a progress token
+    and \c{"io.qtmcp/partialResults": true} in the request's \c _meta, and
+    the transport can deliver notifications while the request is pending,
+    each append() goes out right away as a
+    \c notifications/tools/partialResult notification carrying the
+    progress token and the content. The final response then only has the
+    \c isError flag. Otherwise the content is buffered up to
+    bufferLimit() bytes of JSON and sent in the final response; content
+    beyond the limit is dropped and the result is marked as an error.
+
+    The writer is a handle: copies refer to the same result, so a copy may
+    be kept by a worker that produces the content. Appending is
+    thread-safe, from any number of threads including the server's: the
+    content goes out in the order append() was called, and the response
+    does not overtake content appended before finish(). A thread whose
+    content is streamed waits until the server thread took it over, which
+    keeps a tool from producing faster than the client is sent. When the
+    last copy is destroyed without finish(), the call is finished as an
+    error.
+
+    \sa QMcpServerSession::currentRequest(), QMcpServer::addTool()
+*/
+class Q_MCPSERVER_EXPORT QMcpToolResultWriter
+{
+public:
+    /*!
+        The default bufferLimit(), 16 MiB.
+    */
+    static constexpr qsizetype DefaultBufferLimit = 16 * 1024 * 1024;
+
+    /*!
+        Constructs an invalid writer, one that belongs to no call.
+    */
+    QMcpToolResultWriter();
+    /*!
+        Constructs a writer for the tool call handled as \a request. An
+        invalid \a request gives a writer that always buffers.
+    */
+    explicit QMcpToolResultWriter(const QMcpRequestContext &request);
+
+    bool isValid() const;
+
+    /*!
+        Returns whether appended content is sent to the client right away
+        rather than buffered.
+    */
+    bool isStreaming() const;
+
+    /*!
+        The number of bytes of serialized content a buffering writer keeps
+        before it drops the rest. Has no effect on a streaming writer.
+    */
+    qsizetype bufferLimit() const;
+    void setBufferLimit(qsizetype bytes);
+
+    /*!
+        Adds \a content to the result. Returns \c false once the call is
+        finished or the buffer limit was hit, so the tool can stop
+        producing.
+    */
+    bool append(const QMcpCallToolResultContent &content);
+    bool append(const QList<QMcpCallToolResultContent> &content);
+
+    /*!
+        Completes the call, with the result marked as an error when
+        \a isError is set. Later calls are ignored.
+    */
+    void finish(bool isError = false);
+
+    bool isFinished() const;
+
+    /*!
+        The result of the call, for the tool to return. It resolves once
+        finish() was called.
+    */
+    QFuture<QMcpCallToolResult> future() const;
+
+private:
+    struct Data;
+    std::shared_ptr<Data> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPTOOLRESULTWRITER_H
@@ -0,0 +1,161 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcptoolscheduler_p.h"
+
+QT_BEGIN_NAMESPACE
+
+void QMcpToolScheduler::setConcurrencyLimits(int total, int perSession)
+{
+    m_concurrencyLimit = qMax(0, total);
+    m_sessionConcurrencyLimit = qMax(0, perSession);
+}
+
+void QMcpToolScheduler::setToolConcurrencyLimit(const QString &tool, int limit)
+{
+    if (limit > 0)
+        m_toolConcurrencyLimits.insert(tool, limit);
+    else
+        m_toolConcurrencyLimits.remove(tool);
+}
+
+void QMcpToolScheduler::setQueueLimits(int perSession, int total)
+{
+    m_sessionQueueLimit = qMax(0, perSession);
+    m_queueLimit = qMax(0, total);
+}
+
+void QMcpToolScheduler::setToolPriority(const QString &tool, int priority)
+{
+    if (priority != 0)
+        m_toolPriorities.insert(tool, priority);
+    else
+        m_toolPriorities.remove(tool);
+}
+
+void QMcpToolScheduler::setSessionWeight(const QUuid &session, int weight)
+{
+    if (weight > 1)
+        m_sessionWeights.insert(session, weight);
+    else
+        m_sessionWeights.remove(session);
+}
+
+bool QMcpToolScheduler::isLimited() const
+{
+    return m_concurrencyLimit > 0 || m_sessionConcurrencyLimit > 0 || !m_toolConcurrencyLimits.isEmpty();
+}
+
+bool QMcpToolScheduler::mayRun(const QUuid &session, const QString &tool) const
+{
+    if (m_concurrencyLimit > 0 && m_running >= m_concurrencyLimit)
+        return false;
+    if (m_sessionConcurrencyLimit > 0 && running(session) >= m_sessionConcurrencyLimit)
+        return false;
+    const auto toolLimit = m_toolConcurrencyLimits.value(tool);
+    return toolLimit <= 0 || m_runningPerTool.value(tool) < toolLimit;
+}
+
+void QMcpToolScheduler::start(const Call &call)
+{
+    auto &calls = m_runningCalls[call.session];
+    // A client reusing the id of a call that still runs is not counted twice.
+    if (calls.contains(call.id))
+        return;
+    calls.insert(call.id, call.tool);
+    ++m_runningPerTool[call.tool];
+    ++m_running;
+}
+
+QMcpToolScheduler::Admission QMcpToolScheduler::submit(const Call &call)
+{
+    const bool runNow = mayRun(call.session, call.tool);
+    if (!runNow) {
+        if (m_sessionQueueLimit > 0 && queued(call.session) >= m_sessionQueueLimit)
+            return Admission::SessionQueueFull;
+        if (m_queueLimit > 0 && queued() >= m_queueLimit)
+            return Admission::ServerQueueFull;
+    }
+
+    // Calls that run at once are charged too, so that a session that had
+    // the server to itself is behind the others once they compete.
+    const double startTag = qMax(m_virtualTime, m_lastFinishTag.value(call.session));
+    const double finishTag = startTag + 1.0 / sessionWeight(call.session);
+    m_lastFinishTag.insert(call.session, finishTag);
+
+    if (runNow) {
+        m_virtualTime = qMax(m_virtualTime, startTag);
+        start(call);
+        return Admission::Run;
+    }
+    Entry entry;
+    entry.call = call;
+    entry.priority = toolPriority(call.tool);
+    entry.startTag = startTag;
+    entry.finishTag = finishTag;
+    entry.sequence = m_sequence++;
+    m_queue.append(entry);
+    ++m_queuedPerSession[call.session];
+    return Admission::Queued;
+}
+
+bool QMcpToolScheduler::finish(const QUuid &session, const QJsonValue &id)
+{
+    const auto sessionIt = m_runningCalls.find(session);
+    if (sessionIt == m_runningCalls.end())
+        return false;
+    const auto it = sessionIt->find(id);
+    if (it == sessionIt->end())
+        return false;
+    const auto toolIt = m_runningPerTool.find(*it);
+    if (--*toolIt == 0)
+        m_runningPerTool.erase(toolIt);
+    --m_running;
+    sessionIt->erase(it);
+    if (sessionIt->isEmpty())
+        m_runningCalls.erase(sessionIt);
+    return true;
+}
+
+std::optional<QMcpToolScheduler::Call> QMcpToolScheduler::takeNext()
+{
+    qsizetype best = -1;
+    for (qsizetype i = 0; i < m_queue.size(); ++i) {
+        const auto &entry = m_queue.at(i);
+        if (!mayRun(entry.call.session, entry.call.tool))
+            continue;
+        if (best >= 0) {
+            const auto &current = m_queue.at(best);
+            if (entry.priority < current.priority)
+                continue;
+            if (entry.priority == current.priority
+                && (entry.finishTag > current.finishTag
+                    || (entry.finishTag == current.finishTag && entry.sequence > current.sequence)))
+                continue;
+        }
+        best = i;
+    }
+    if (best < 0)
+        return std::nullopt;
+
+    const auto entry = m_queue.takeAt(best);
+    const auto queuedIt = m_queuedPerSession.find(entry.call.session);
+    if (--*queuedIt == 0)
+        m_queuedPerSession.erase(queuedIt);
+    m_virtualTime = qMax(m_virtualTime, entry.startTag);
+    start(entry.call);
+    return entry.call;
+}
+
+void QMcpToolScheduler::removeSession(const QUuid &session)
+{
+    m_queue.removeIf([&session](const Entry &entry) { return entry.call.session == session; });
+    m_queuedPerSession.remove(session);
+    const auto calls = m_runningCalls.value(session);
+    for (auto it = calls.cbegin(); it != calls.cend(); ++it)
+        finish(session, it.key());
+    m_lastFinishTag.remove(session);
+    m_sessionWeights.remove(session);
+}
+
+QT_END_NAMESPACE
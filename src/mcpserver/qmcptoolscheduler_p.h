@@ -0,0 +1,140 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPTOOLSCHEDULER_P_H
+#define QMCPTOOLSCHEDULER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMcpServer/qmcpserverglobal.h>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpToolScheduler
+    \internal
+    \inmodule QtMcpServer
+    \brief Decides when the tool calls of all sessions run.
+
+    A call runs right away when the server-wide, per-session and per-tool
+    concurrency limits leave room for it; otherwise it waits in the queue,
+    unless the session's or the server's queue is full, in which case it is
+    rejected. Whenever a running call finishes, takeNext() hands out the
+    waiting call that should run next.
+
+    Waiting calls are ordered by the priority of their tool first. Within a
+    priority, sessions share the capacity by weighted fair queuing: every
+    call a session submits, whether it runs at once or waits, advances the
+    session's virtual finish time by 1 / weight, and the call with the
+    earliest finish time goes first. A session that fires hundreds of calls
+    thus only gets ahead of the others by its weight, and one that was idle
+    does not bank credit, as its next call starts from the current virtual
+    time.
+
+    The queue is scanned linearly; the queue limits bound it.
+*/
+class Q_MCPSERVER_EXPORT QMcpToolScheduler
+{
+public:
+    struct Call {
+        QUuid session;
+        QJsonValue id;
+        QString tool;
+        // What the server needs to dispatch the call once it may run.
+        QJsonObject request;
+        quint64 trace = 0;
+        qint64 queuedAt = 0;
+    };
+
+    enum class Admission {
+        Run,
+        Queued,
+        SessionQueueFull,
+        ServerQueueFull,
+    };
+
+    // 0 means no limit, for all of them.
+    void setConcurrencyLimits(int total, int perSession);
+    int concurrencyLimit() const { return m_concurrencyLimit; }
+    int sessionConcurrencyLimit() const { return m_sessionConcurrencyLimit; }
+    void setToolConcurrencyLimit(const QString &tool, int limit);
+    int toolConcurrencyLimit(const QString &tool) const { return m_toolConcurrencyLimits.value(tool); }
+    void setQueueLimits(int perSession, int total);
+    int sessionQueueLimit() const { return m_sessionQueueLimit; }
+    int queueLimit() const { return m_queueLimit; }
+
+    // Higher runs first; 0 by default.
+    void setToolPriority(const QString &tool, int priority);
+    int toolPriority(const QString &tool) const { return m_toolPriorities.value(tool); }
+    // At least 1; 1 by default.
+    void setSessionWeight(const QUuid &session, int weight);
+    int sessionWeight(const QUuid &session) const { return m_sessionWeights.value(session, 1); }
+
+    // Whether any concurrency limit is set, i.e. whether a call can wait.
+    bool isLimited() const;
+
+    Admission submit(const Call &call);
+    // Marks the call finished. Returns false for one that was not running.
+    bool finish(const QUuid &session, const QJsonValue &id);
+    // Takes the waiting call that runs next, if one may run now.
+    std::optional<Call> takeNext();
+    // Drops the session's waiting calls and forgets its running ones.
+    void removeSession(const QUuid &session);
+
+    qsizetype queued() const { return m_queue.size(); }
+    qsizetype queued(const QUuid &session) const { return m_queuedPerSession.value(session); }
+    qsizetype running() const { return m_running; }
+    qsizetype running(const QUuid &session) const { return m_runningCalls.value(session).size(); }
+
+private:
+    struct Entry {
+        Call call;
+        int priority = 0;
+        double startTag = 0;
+        double finishTag = 0;
+        quint64 sequence = 0;
+    };
+
+    bool mayRun(const QUuid &session, const QString &tool) const;
+    void start(const Call &call);
+
+    int m_concurrencyLimit = 0;
+    int m_sessionConcurrencyLimit = 0;
+    QHash<QString, int> m_toolConcurrencyLimits;
+    int m_sessionQueueLimit = 0;
+    int m_queueLimit = 0;
+    QHash<QString, int> m_toolPriorities;
+    QHash<QUuid, int> m_sessionWeights;
+
+    QList<Entry> m_queue;
+    QHash<QUuid, qsizetype> m_queuedPerSession;
+    // Session -> request id -> tool of its running calls.
+    QHash<QUuid, QHash<QJsonValue, QString>> m_runningCalls;
+    QHash<QString, int> m_runningPerTool;
+    qsizetype m_running = 0;
+
+    double m_virtualTime = 0;
+    QHash<QUuid, double> m_lastFinishTag;
+    quint64 m_sequence = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPTOOLSCHEDULER_P_H
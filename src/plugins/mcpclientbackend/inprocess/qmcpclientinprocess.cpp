@@ -0,0 +1,91 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpclientinprocess.h"
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtMcpCommon/private/qmcpinprocesschannel_p.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpClientInProcessPlugin, "qt.mcpclient.plugins.backend.inprocess")
+
+class QMcpClientInProcess::Private
+{
+public:
+    Private(QMcpClientInProcess *parent);
+
+    QMcpClientInProcess *q;
+    bool validating = qEnvironmentVariableIntValue("QT_MCP_INPROCESS_VALIDATE") != 0;
+    std::shared_ptr<QMcpInProcessChannel> channel;
+    // Messages sent before start().
+    QList<QJsonObject> pending;
+};
+
+QMcpClientInProcess::Private::Private(QMcpClientInProcess *parent)
+    : q(parent)
+{}
+
+QMcpClientInProcess::QMcpClientInProcess(QObject *parent)
+    : QMcpClientBackendInterface(parent)
+    , d(new Private(this))
+{}
+
+QMcpClientInProcess::~QMcpClientInProcess() = default;
+
+bool QMcpClientInProcess::isValidating() const
+{
+    return d->validating;
+}
+
+void QMcpClientInProcess::setValidating(bool validating)
+{
+    if (d->validating == validating)
+        return;
+    d->validating = validating;
+    if (d->channel)
+        d->channel->setValidating(validating);
+    emit validatingChanged(validating);
+}
+
+void QMcpClientInProcess::start(const QString &server)
+{
+    d->channel = QMcpInProcessChannel::connect(server, this, [this](const QJsonObject &object) {
+        emit received(object);
+    }, [this]() {
+        d->channel.reset();
+        emit finished();
+    });
+    // Reported queued, as a transport that really connects would.
+    if (!d->channel) {
+        const auto message = "No in-process server named %1"_L1.arg(server);
+        qCWarning(lcQMcpClientInProcessPlugin) << message;
+        QMetaObject::invokeMethod(this, [this, message]() {
+            emit errorOccurred(message);
+        }, Qt::QueuedConnection);
+        return;
+    }
+    d->channel->setValidating(d->validating);
+    for (const auto &object : std::exchange(d->pending, {}))
+        d->channel->send(object);
+    QMetaObject::invokeMethod(this, [this]() {
+        emit started();
+    }, Qt::QueuedConnection);
+}
+
+void QMcpClientInProcess::send(const QJsonObject &object)
+{
+    if (d->channel)
+        d->channel->send(object);
+    else
+        d->pending.append(object);
+}
+
+void QMcpClientInProcess::notify(const QJsonObject &object)
+{
+    send(object);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,67 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPCLIENTINPROCESS_H
+#define QMCPCLIENTINPROCESS_H
+
+#include <QtMcpClient/qmcpclientbackendplugin.h>
+#include <QtMcpClient/qmcpclientbackendinterface.h>
+#include <QtCore/QJsonObject>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpClientInProcess
+    \internal
+    \brief Connects to an MCP server in the same process, without serializing.
+
+    start() takes the name a QMcpServer with the \c inprocess backend was
+    started with. Messages are handed over as shared JSON objects and
+    delivered queued, so the server may live in another thread.
+*/
+class QMcpClientInProcess : public QMcpClientBackendInterface
+{
+    Q_OBJECT
+    /*!
+        \property QMcpClientInProcess::validating
+        Whether every message sent is round-tripped through its JSON text,
+        with a warning where that changes it. Defaults to true when the
+        environment variable \c QT_MCP_INPROCESS_VALIDATE is set to a
+        non-zero value.
+    */
+    Q_PROPERTY(bool validating READ isValidating WRITE setValidating NOTIFY validatingChanged)
+public:
+    explicit QMcpClientInProcess(QObject *parent = nullptr);
+    ~QMcpClientInProcess() override;
+
+    bool isValidating() const;
+
+public slots:
+    void start(const QString &server) override;
+    void send(const QJsonObject &object) override;
+    void notify(const QJsonObject &object) override;
+    void setValidating(bool validating);
+
+signals:
+    void validatingChanged(bool validating);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+class QMcpClientInProcessPlugin : public QMcpClientBackendPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QMcpClientBackendPluginFactoryInterface_iid FILE "qmcpclientinprocess.json")
+public:
+    QMcpClientBackendInterface *create(const QString &key, QObject *parent = nullptr) override
+    {
+        Q_ASSERT(key == "inprocess"_L1);
+        return new QMcpClientInProcess(parent);
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPCLIENTINPROCESS_H
@@ -0,0 +1,98 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpclientshm.h"
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtMcpCommon/private/qmcpshmchannel_p.h>
+#include <QtNetwork/QLocalSocket>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpClientShmPlugin, "qt.mcpclient.plugins.backend.shm")
+
+class QMcpClientShm::Private
+{
+public:
+    Private(QMcpClientShm *parent);
+
+    void readKey();
+
+    QMcpClientShm *q;
+    QLocalSocket socket;
+    // The key line, until its newline arrived.
+    QByteArray buffer;
+    std::unique_ptr<QMcpShmChannel> channel;
+    // Messages sent before the segment was attached.
+    QList<QJsonObject> pending;
+};
+
+QMcpClientShm::Private::Private(QMcpClientShm *parent)
+    : q(parent)
+{
+    connect(&socket, &QLocalSocket::disconnected, q, [this]() {
+        emit q->finished();
+    });
+    connect(&socket, &QLocalSocket::errorOccurred, q, [this](QLocalSocket::LocalSocketError error) {
+        // The server going away is reported by finished().
+        if (error == QLocalSocket::PeerClosedError)
+            return;
+        qCWarning(lcQMcpClientShmPlugin) << error << socket.errorString();
+        emit q->errorOccurred(socket.errorString());
+    });
+    connect(&socket, &QLocalSocket::readyRead, q, [this]() {
+        readKey();
+    });
+}
+
+void QMcpClientShm::Private::readKey()
+{
+    buffer += socket.readAll();
+    if (channel || !buffer.contains('\n'))
+        return;
+    const auto key = QString::fromUtf8(buffer.left(buffer.indexOf('\n')));
+    channel = std::make_unique<QMcpShmChannel>([this](const QJsonObject &object, qsizetype bytes) {
+        Q_UNUSED(bytes);
+        emit q->received(object);
+    });
+    if (!channel->attach(key)) {
+        const auto message = channel->errorString();
+        qCWarning(lcQMcpClientShmPlugin) << "Cannot attach to" << key << message;
+        channel.reset();
+        socket.abort();
+        emit q->errorOccurred(message);
+        return;
+    }
+    for (const auto &object : std::exchange(pending, {}))
+        channel->send(object);
+    emit q->started();
+}
+
+QMcpClientShm::QMcpClientShm(QObject *parent)
+    : QMcpClientBackendInterface(parent)
+    , d(new Private(this))
+{}
+
+QMcpClientShm::~QMcpClientShm() = default;
+
+void QMcpClientShm::start(const QString &server)
+{
+    d->socket.connectToServer(server);
+}
+
+void QMcpClientShm::send(const QJsonObject &object)
+{
+    if (d->channel)
+        d->channel->send(object);
+    else
+        d->pending.append(object);
+}
+
+void QMcpClientShm::notify(const QJsonObject &object)
+{
+    send(object);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,53 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPCLIENTSHM_H
+#define QMCPCLIENTSHM_H
+
+#include <QtMcpClient/qmcpclientbackendplugin.h>
+#include <QtMcpClient/qmcpclientbackendinterface.h>
+#include <QtCore/QJsonObject>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpClientShm
+    \internal
+    \brief Connects to an MCP server on the same host through shared memory.
+
+    start() takes the local socket name the server listens on. The server
+    answers with the key of a shared memory segment, which carries the
+    messages from then on; what is sent before goes out once attached.
+*/
+class QMcpClientShm : public QMcpClientBackendInterface
+{
+    Q_OBJECT
+public:
+    explicit QMcpClientShm(QObject *parent = nullptr);
+    ~QMcpClientShm() override;
+
+public slots:
+    void start(const QString &server) override;
+    void send(const QJsonObject &object) override;
+    void notify(const QJsonObject &object) override;
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+class QMcpClientShmPlugin : public QMcpClientBackendPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QMcpClientBackendPluginFactoryInterface_iid FILE "qmcpclientshm.json")
+public:
+    QMcpClientBackendInterface *create(const QString &key, QObject *parent = nullptr) override
+    {
+        Q_ASSERT(key == "shm"_L1);
+        return new QMcpClientShm(parent);
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPCLIENTSHM_H
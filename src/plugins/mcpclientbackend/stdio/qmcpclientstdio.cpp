@@ -11,6 +11,7 @@
 #include <QtCore/QUrl>
 #include <QtCore/QStringList>
 #include <QtCore/QMetaEnum>
+#include <QtMcpCommon/private/qmcplinebuffer_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -25,14 +26,18 @@ private:
     QMcpClientStdio *q;
 
 public:
+    void readMessages();
+
     QProcess server;
+    // Output of this client's server not handed on yet.
+    QMcpLineBuffer output;
 };
 
 QMcpClientStdio::Private::Private(QMcpClientStdio *parent)
     : q(parent)
 {
     connect(&server, &QProcess::stateChanged, q, [](QProcess::ProcessState state) {
-        qDebug() << state;
+        qCDebug(lcQMcpClientStdioPlugin) << state;
     });
     connect(&server, &QProcess::errorOccurred, q, [this](QProcess::ProcessError error) {
         qWarning() << error << server.errorString();
@@ -45,29 +50,28 @@ QMcpClientStdio::Private::Private(QMcpClientStdio *parent)
         emit q->finished();
     });
     connect(&server, &QProcess::readyReadStandardOutput, q, [this]() {
-        static QByteArray data;
-        data.append(server.readAllStandardOutput());
-        while (true) {
-            int lf = data.indexOf('\n');
-            if (lf < 0)
-                break;
-            const auto line = data.left(lf);
-            data.remove(0, lf + 1);
-            QJsonParseError error;
-            const auto json = QJsonDocument::fromJson(line, &error);
-            if (error.error) {
-                qWarning() << error.errorString();
-            } else {
-                qDebug() << json;
-                emit q->received(json.object());
-            }
-        }
+        readMessages();
     });
     connect(&server, &QProcess::readyReadStandardError, q, [this]() {
         qWarning() << server.readAllStandardError();
     });
 }
 
+void QMcpClientStdio::Private::readMessages()
+{
+    output.append(server.readAllStandardOutput());
+    while (const auto line = output.nextLine()) {
+        QJsonParseError error;
+        const auto json = QJsonDocument::fromJson(QByteArray::fromRawData(line->data(), line->size()), &error);
+        if (error.error) {
+            qWarning() << error.errorString();
+        } else {
+            qCDebug(lcQMcpClientStdioPlugin) << json;
+            emit q->received(json.object());
+        }
+    }
+}
+
 QMcpClientStdio::QMcpClientStdio(QObject *parent)
     : QMcpClientBackendInterface(parent)
     , d(new Private(this))
@@ -84,9 +88,8 @@ void QMcpClientStdio::start(const QString &server)
 
 void QMcpClientStdio::send(const QJsonObject &object)
 {
-    qDebug() << d->server.state();
     const auto data = QJsonDocument(object).toJson(QJsonDocument::Compact);
-    qDebug().noquote() << data;
+    qCDebug(lcQMcpClientStdioPlugin).noquote() << data;
     d->server.write(data + "\n");
 }
 
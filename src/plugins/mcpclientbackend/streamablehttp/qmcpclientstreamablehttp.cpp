@@ -7,15 +7,20 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <utility>
 
+#include <QtCore/QDateTime>
+#include <QtCore/QDeadlineTimer>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonValue>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QRandomGenerator>
 #include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtNetwork/QNetworkRequest>
+#include <QtMcpCommon/private/qmcpcompression_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -25,11 +30,22 @@ Q_LOGGING_CATEGORY(lcQMcpClientStreamableHttpPlugin, "qt.mcpclient.plugins.backe
 
 namespace {
 
-// The GET stream is reopened this long after the server closed it. The spec
-// allows resuming with Last-Event-ID; that is not implemented yet, so a
-// reconnect always starts a fresh stream.
-// TODO: honour the SSE id field and resume with Last-Event-ID.
-constexpr int ServerStreamReconnectIntervalMs = 5000;
+// The GET stream is reopened after the server closed it, resuming with
+// Last-Event-ID. The delay doubles with every attempt that brought no event,
+// up to the maximum, and is jittered so that clients cut off together do not
+// come back together. A retry field from the server replaces the initial
+// delay.
+constexpr int ServerStreamInitialReconnectDelayMs = 500;
+constexpr int ServerStreamMaxReconnectDelayMs = 30 * 1000;
+
+// Request bodies are compressed from this size on, once the server listed
+// the codings it accepts in an Accept-Encoding response header; servers
+// that never do are sent plain bodies only.
+constexpr qsizetype RequestCompressionThreshold = 1024;
+
+// A server answering 429 or 503 is sent no further requests until the
+// Retry-After it gave has passed, for at most this long.
+constexpr int MaxRetryAfterSeconds = 60;
 
 // Sentinel wrapper for header values that cannot be written as plain ASCII,
 // e.g. a tool named in Japanese: "=?base64?<base64 of the UTF-8 value>?=".
@@ -87,7 +103,8 @@ QByteArray encodeHeaderValue(const QString &value)
     \internal
     Incremental Server-Sent Events parser. Chunks are appended as they arrive
     and every complete event is reported through the callback passed to
-    append(), carrying the concatenated payload of its \c data: fields.
+    append(), carrying the concatenated payload of its \c data: fields. The
+    \c id: and \c retry: fields are kept in lastEventId() and retry().
 */
 class SseParser
 {
@@ -125,8 +142,22 @@ public:
                 const auto line = event.mid(from, next - from);
                 from = next + separator.length();
 
-                // Comments (": ping" and friends) and fields other than data
-                // carry no JSON-RPC payload.
+                if (line.startsWith("id:")) {
+                    const auto id = fieldValue(line, 3);
+                    // An id with a NUL in it is ignored, as EventSource does.
+                    if (!id.contains('\0'))
+                        eventId = id;
+                    continue;
+                }
+                if (line.startsWith("retry:")) {
+                    bool ok = false;
+                    const int value = fieldValue(line, 6).toInt(&ok);
+                    if (ok && value >= 0)
+                        retryMs = value;
+                    continue;
+                }
+                // Comments (": ping" and friends) and other fields carry no
+                // JSON-RPC payload.
                 if (!line.startsWith("data:"))
                     continue;
                 auto data = line.mid(5);
@@ -137,17 +168,54 @@ public:
                 payload.append(data);
             }
 
+            // The id counts once its event is complete, payload or not.
+            if (eventId)
+                lastId = *std::exchange(eventId, std::nullopt);
             if (!payload.isEmpty())
                 onEvent(payload);
         }
     }
 
+    QByteArray lastEventId() const { return lastId; }
+    // The reconnection delay the server asked for, or -1.
+    int retry() const { return retryMs; }
+
 private:
+    static QByteArray fieldValue(const QByteArray &line, qsizetype nameLength)
+    {
+        auto value = line.mid(nameLength);
+        if (value.startsWith(' '))
+            value.remove(0, 1);
+        return value;
+    }
+
+    QByteArray lastId;
+    std::optional<QByteArray> eventId;
+    int retryMs = -1;
     QByteArray buffer;
     QByteArray separator;
     QByteArray terminator; // separator twice, i.e. the end of one event
 };
 
+/*!
+    \internal
+    Returns the seconds of a Retry-After header, given either as a number of
+    seconds or as an HTTP date, or -1 for none.
+*/
+int retryAfterSeconds(const QByteArray &value)
+{
+    if (value.isEmpty())
+        return -1;
+    bool ok = false;
+    const auto seconds = value.trimmed().toInt(&ok);
+    if (ok)
+        return qBound(0, seconds, MaxRetryAfterSeconds);
+    const auto date = QDateTime::fromString(QString::fromLatin1(value.trimmed()), Qt::RFC2822Date);
+    if (!date.isValid())
+        return -1;
+    return int(qBound(qint64(0), QDateTime::currentDateTimeUtc().secsTo(date), qint64(MaxRetryAfterSeconds)));
+}
+
 /*!
     \internal
     Returns the value the Mcp-Name header must carry for \a method, or an empty
@@ -184,26 +252,43 @@ private:
     void applyToolCallHeaders(QNetworkRequest &request, const QJsonObject &params) const;
     void ignoreSslErrors(QNetworkReply *reply) const;
     void storeSessionId(QNetworkReply *reply);
+    void updateRequestEncoding(QNetworkReply *reply);
     void reportHttpError(QNetworkReply *reply, int statusCode, const QByteArray &body);
+    bool dispatchErrorResponse(QNetworkReply *reply, int statusCode, const QByteArray &body);
+    void postHeldBackRequests();
     void dispatch(const QByteArray &payload);
     void emitReceived(const QJsonObject &object);
     void cacheToolHeaderAnnotations(const QJsonObject &object);
     void openServerStream();
+    void scheduleServerStreamReconnect();
 
     QMcpClientStreamableHttp *q;
     QUrl endpoint;
     QNetworkAccessManager networkAccessManager;
     std::optional<QtMcp::ProtocolVersion> negotiatedProtocolVersion;
     QByteArray sessionId;
+    // What the server takes request bodies in, as its responses said.
+    QMcpCompression::Encoding requestEncoding = QMcpCompression::Encoding::Identity;
     QScopedPointer<QNetworkReply> serverStream;
     bool serverStreamRejected = false;
+    // Survives the stream, so that the next one resumes where it ended.
+    QByteArray serverStreamLastEventId;
+    int serverStreamRetryMs = -1;
+    int serverStreamAttempts = 0;
     // tool name -> (argument property name -> header name suffix)
     QHash<QString, QHash<QString, QString>> toolHeaderAnnotations;
+    // Requests held back until the Retry-After of a busy server passed.
+    QDeadlineTimer busyUntil;
+    QList<QJsonObject> heldBackRequests;
+    QTimer busyTimer;
 };
 
 QMcpClientStreamableHttp::Private::Private(QMcpClientStreamableHttp *parent)
     : q(parent)
-{}
+{
+    busyTimer.setSingleShot(true);
+    connect(&busyTimer, &QTimer::timeout, q, [this]() { postHeldBackRequests(); });
+}
 
 void QMcpClientStreamableHttp::Private::start(const QUrl &url)
 {
@@ -224,6 +309,10 @@ void QMcpClientStreamableHttp::Private::start(const QUrl &url)
 QNetworkRequest QMcpClientStreamableHttp::Private::createRequest(const QJsonObject &object) const
 {
     QNetworkRequest request(endpoint);
+    // Over https HTTP/2 is negotiated by ALPN anyway; over http it takes an
+    // upgrade. Requests then share one connection instead of queueing for
+    // a few, and the server stream holds none of its own.
+    request.setAttribute(QNetworkRequest::Http2CleartextAllowedAttribute, true);
     // The server picks the response format, so both must be accepted.
     request.setRawHeader("Accept", "application/json, text/event-stream");
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
@@ -308,10 +397,20 @@ void QMcpClientStreamableHttp::Private::storeSessionId(QNetworkReply *reply)
     const auto id = reply->rawHeader("Mcp-Session-Id");
     if (id.isEmpty())
         return;
+    // Event ids belong to the session they were sent on.
+    if (id != sessionId)
+        serverStreamLastEventId.clear();
     sessionId = id;
     qCDebug(lcQMcpClientStreamableHttpPlugin) << "session established" << sessionId;
 }
 
+void QMcpClientStreamableHttp::Private::updateRequestEncoding(QNetworkReply *reply)
+{
+    const auto acceptEncoding = reply->rawHeader("Accept-Encoding");
+    if (!acceptEncoding.isEmpty())
+        requestEncoding = QMcpCompression::negotiate(acceptEncoding);
+}
+
 void QMcpClientStreamableHttp::Private::reportHttpError(QNetworkReply *reply, int statusCode, const QByteArray &body)
 {
     const auto reason = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
@@ -328,6 +427,47 @@ void QMcpClientStreamableHttp::Private::reportHttpError(QNetworkReply *reply, in
     emit q->errorOccurred(message);
 }
 
+// A server that is too busy for a request (429 or 503) answers it with a
+// JSON-RPC error, such as QMcpServer's -32005. That error goes to the
+// request's callback like any other response, with the Retry-After added to
+// its data as retryAfter, in seconds; until it passed no further requests
+// are sent. Returns false for a body that answers no request.
+bool QMcpClientStreamableHttp::Private::dispatchErrorResponse(QNetworkReply *reply, int statusCode, const QByteArray &body)
+{
+    const auto contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+    if (!contentType.startsWith("application/json"_L1))
+        return false;
+    auto response = QJsonDocument::fromJson(body).object();
+    if (!response.contains("id"_L1) || !response.value("error"_L1).isObject())
+        return false;
+
+    if (statusCode == 429 || statusCode == 503) {
+        const auto seconds = retryAfterSeconds(reply->rawHeader("Retry-After"));
+        if (seconds >= 0) {
+            auto error = response.value("error"_L1).toObject();
+            auto data = error.value("data"_L1).toObject();
+            data.insert("retryAfter"_L1, seconds);
+            error.insert("data"_L1, data);
+            response.insert("error"_L1, error);
+            if (seconds > 0 && seconds * 1000 > busyUntil.remainingTime()) {
+                busyUntil.setRemainingTime(seconds * 1000);
+                busyTimer.start(seconds * 1000);
+            }
+        }
+    }
+    qCWarning(lcQMcpClientStreamableHttpPlugin) << "HTTP" << statusCode
+            << response.value("error"_L1).toObject().value("message"_L1).toString();
+    emitReceived(response);
+    return true;
+}
+
+void QMcpClientStreamableHttp::Private::postHeldBackRequests()
+{
+    const auto requests = std::exchange(heldBackRequests, {});
+    for (const auto &object : requests)
+        post(object);
+}
+
 void QMcpClientStreamableHttp::Private::dispatch(const QByteArray &payload)
 {
     QJsonParseError error;
@@ -448,10 +588,23 @@ void QMcpClientStreamableHttp::Private::post(const QJsonObject &object)
         return;
     }
 
+    // Responses and notifications go out regardless, e.g. the cancellation
+    // of a request the server is still running.
+    if (!busyUntil.hasExpired() && object.contains("method"_L1) && object.contains("id"_L1)) {
+        heldBackRequests.append(object);
+        return;
+    }
+
     const bool initialize = object.value("method"_L1).toString() == "initialize"_L1;
-    const auto request = createRequest(object);
-    const auto data = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    auto request = createRequest(object);
+    auto data = QJsonDocument(object).toJson(QJsonDocument::Compact);
     qCDebug(lcQMcpClientStreamableHttpPlugin) << data;
+    const auto encoding = data.size() < RequestCompressionThreshold
+            ? QMcpCompression::Encoding::Identity : requestEncoding;
+    if (encoding != QMcpCompression::Encoding::Identity) {
+        data = QMcpCompression::compress(data, encoding);
+        request.setRawHeader("Content-Encoding", QMcpCompression::name(encoding));
+    }
 
     auto *reply = networkAccessManager.post(request, data);
     ignoreSslErrors(reply);
@@ -488,12 +641,22 @@ void QMcpClientStreamableHttp::Private::post(const QJsonObject &object)
         }
     });
 
-    connect(reply, &QNetworkReply::finished, q, [this, reply, state, initialize]() {
+    connect(reply, &QNetworkReply::finished, q, [this, reply, state, initialize, encoding, object]() {
         reply->deleteLater();
         if (initialize)
             storeSessionId(reply);
 
         const auto statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (statusCode == 415 && encoding != QMcpCompression::Encoding::Identity) {
+            // The server changed its mind, e.g. one behind a load balancer
+            // that does not decode; send it again as the server says now.
+            updateRequestEncoding(reply);
+            if (requestEncoding == encoding)
+                requestEncoding = QMcpCompression::Encoding::Identity;
+            post(object);
+            return;
+        }
+        updateRequestEncoding(reply);
         if (statusCode == 0) {
             // The request never reached the server.
             qCWarning(lcQMcpClientStreamableHttpPlugin) << reply->errorString();
@@ -501,7 +664,10 @@ void QMcpClientStreamableHttp::Private::post(const QJsonObject &object)
             return;
         }
         if (statusCode >= 400) {
-            reportHttpError(reply, statusCode, state->body);
+            // An expired session (404) concerns the whole client, not
+            // the request.
+            if (statusCode == 404 || !dispatchErrorResponse(reply, statusCode, state->body))
+                reportHttpError(reply, statusCode, state->body);
             return;
         }
         // 202 Accepted acknowledges a notification and carries no body.
@@ -521,12 +687,15 @@ void QMcpClientStreamableHttp::Private::openServerStream()
         return;
 
     QNetworkRequest request(endpoint);
+    request.setAttribute(QNetworkRequest::Http2CleartextAllowedAttribute, true);
     request.setRawHeader("Accept", "text/event-stream");
     request.setRawHeader("Cache-Control", "no-cache");
     request.setRawHeader("MCP-Protocol-Version",
                          QtMcp::protocolVersionToString(*negotiatedProtocolVersion).toLatin1());
     if (!sessionId.isEmpty())
         request.setRawHeader("Mcp-Session-Id", sessionId);
+    if (!serverStreamLastEventId.isEmpty())
+        request.setRawHeader("Last-Event-ID", serverStreamLastEventId);
 
     auto *reply = networkAccessManager.get(request);
     serverStream.reset(reply);
@@ -537,8 +706,14 @@ void QMcpClientStreamableHttp::Private::openServerStream()
         const auto chunk = reply->readAll();
         qCDebug(lcQMcpClientStreamableHttpPlugin) << chunk;
         parser->append(chunk, [this](const QByteArray &payload) {
+            // The stream works, so the next reconnect starts from scratch.
+            serverStreamAttempts = 0;
             dispatch(payload);
         });
+        if (!parser->lastEventId().isEmpty())
+            serverStreamLastEventId = parser->lastEventId();
+        if (parser->retry() >= 0)
+            serverStreamRetryMs = parser->retry();
     });
 
     connect(reply, &QNetworkReply::finished, q, [this, reply]() {
@@ -555,9 +730,22 @@ void QMcpClientStreamableHttp::Private::openServerStream()
         }
         // The reply is owned by serverStream and is destroyed once the next
         // stream replaces it, so it must not be deleted from its own slot.
-        QTimer::singleShot(ServerStreamReconnectIntervalMs, q, [this]() {
-            openServerStream();
-        });
+        scheduleServerStreamReconnect();
+    });
+}
+
+void QMcpClientStreamableHttp::Private::scheduleServerStreamReconnect()
+{
+    const qint64 initial = serverStreamRetryMs >= 0 ? qMax(serverStreamRetryMs, 1)
+                                                    : ServerStreamInitialReconnectDelayMs;
+    const qint64 delay = qMin(initial << qMin(serverStreamAttempts, 16),
+                              qint64(ServerStreamMaxReconnectDelayMs));
+    ++serverStreamAttempts;
+    // Somewhere between half and all of it.
+    const auto jittered = delay / 2 + QRandomGenerator::global()->bounded(delay / 2 + 1);
+    qCDebug(lcQMcpClientStreamableHttpPlugin) << "reopening the GET stream in" << jittered << "ms";
+    QTimer::singleShot(std::chrono::milliseconds(jittered), q, [this]() {
+        openServerStream();
     });
 }
 
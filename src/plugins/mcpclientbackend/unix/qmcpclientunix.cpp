@@ -0,0 +1,94 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpclientunix.h"
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonParseError>
+#include <QtCore/QLoggingCategory>
+#include <QtMcpCommon/private/qmcplinebuffer_p.h>
+#include <QtNetwork/QLocalSocket>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpClientUnixPlugin, "qt.mcpclient.plugins.backend.unix")
+
+class QMcpClientUnix::Private
+{
+public:
+    Private(QMcpClientUnix *parent);
+
+    void readMessages();
+
+    QMcpClientUnix *q;
+    QLocalSocket socket;
+    // What was read and not handed on yet.
+    QMcpLineBuffer input;
+    // Messages sent before the connection was established.
+    QByteArray pending;
+};
+
+QMcpClientUnix::Private::Private(QMcpClientUnix *parent)
+    : q(parent)
+{
+    connect(&socket, &QLocalSocket::connected, q, [this]() {
+        if (!pending.isEmpty())
+            socket.write(std::exchange(pending, {}));
+        emit q->started();
+    });
+    connect(&socket, &QLocalSocket::disconnected, q, [this]() {
+        emit q->finished();
+    });
+    connect(&socket, &QLocalSocket::errorOccurred, q, [this](QLocalSocket::LocalSocketError error) {
+        // The server going away is reported by finished().
+        if (error == QLocalSocket::PeerClosedError)
+            return;
+        qCWarning(lcQMcpClientUnixPlugin) << error << socket.errorString();
+        emit q->errorOccurred(socket.errorString());
+    });
+    connect(&socket, &QLocalSocket::readyRead, q, [this]() {
+        readMessages();
+    });
+}
+
+void QMcpClientUnix::Private::readMessages()
+{
+    input.append(socket.readAll());
+    while (const auto line = input.nextLine()) {
+        QJsonParseError error;
+        const auto json = QJsonDocument::fromJson(QByteArray::fromRawData(line->data(), line->size()), &error);
+        if (error.error != QJsonParseError::NoError) {
+            qCWarning(lcQMcpClientUnixPlugin) << error.errorString();
+            continue;
+        }
+        emit q->received(json.object());
+    }
+}
+
+QMcpClientUnix::QMcpClientUnix(QObject *parent)
+    : QMcpClientBackendInterface(parent)
+    , d(new Private(this))
+{}
+
+QMcpClientUnix::~QMcpClientUnix() = default;
+
+void QMcpClientUnix::start(const QString &server)
+{
+    d->socket.connectToServer(server);
+}
+
+void QMcpClientUnix::send(const QJsonObject &object)
+{
+    const QByteArray data = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+    qCDebug(lcQMcpClientUnixPlugin).noquote() << data;
+    if (d->socket.state() == QLocalSocket::ConnectedState)
+        d->socket.write(data);
+    else
+        d->pending += data;
+}
+
+void QMcpClientUnix::notify(const QJsonObject &object)
+{
+    send(object);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,53 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPCLIENTUNIX_H
+#define QMCPCLIENTUNIX_H
+
+#include <QtMcpClient/qmcpclientbackendplugin.h>
+#include <QtMcpClient/qmcpclientbackendinterface.h>
+#include <QtCore/QJsonObject>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpClientUnix
+    \internal
+    \brief Connects to an MCP server on the same host through a local socket.
+
+    start() takes the name or path the server listens on. Messages are
+    JSON objects, one per line; what is sent before the connection is
+    established goes out once it is.
+*/
+class QMcpClientUnix : public QMcpClientBackendInterface
+{
+    Q_OBJECT
+public:
+    explicit QMcpClientUnix(QObject *parent = nullptr);
+    ~QMcpClientUnix() override;
+
+public slots:
+    void start(const QString &server) override;
+    void send(const QJsonObject &object) override;
+    void notify(const QJsonObject &object) override;
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+class QMcpClientUnixPlugin : public QMcpClientBackendPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QMcpClientBackendPluginFactoryInterface_iid FILE "qmcpclientunix.json")
+public:
+    QMcpClientBackendInterface *create(const QString &key, QObject *parent = nullptr) override
+    {
+        Q_ASSERT(key == "unix"_L1);
+        return new QMcpClientUnix(parent);
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPCLIENTUNIX_H
@@ -0,0 +1,115 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpserverinprocess.h"
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtMcpCommon/private/qmcpinprocesschannel_p.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpServerInProcessPlugin, "qt.mcpserver.plugins.backend.inprocess")
+
+class QMcpServerInProcess::Private
+{
+public:
+    Private(QMcpServerInProcess *parent);
+
+    void accept(std::shared_ptr<QMcpInProcessChannel> channel);
+
+    QMcpServerInProcess *q;
+    QString name;
+    bool listening = false;
+    bool validating = qEnvironmentVariableIntValue("QT_MCP_INPROCESS_VALIDATE") != 0;
+    QHash<QUuid, std::shared_ptr<QMcpInProcessChannel>> channels;
+};
+
+QMcpServerInProcess::Private::Private(QMcpServerInProcess *parent)
+    : q(parent)
+{}
+
+void QMcpServerInProcess::Private::accept(std::shared_ptr<QMcpInProcessChannel> channel)
+{
+    const auto session = QUuid::createUuid();
+    channel->setValidating(validating);
+    channels.insert(session, channel);
+    qCDebug(lcQMcpServerInProcessPlugin) << "New session" << session;
+    emit q->newSessionStarted(session);
+    // Whatever the client sent meanwhile follows, queued.
+    channel->setReceiver(q, [this, session](const QJsonObject &object) {
+        emit q->received(session, object);
+    }, [this, session]() {
+        channels.remove(session);
+        qCDebug(lcQMcpServerInProcessPlugin) << "Session" << session << "closed";
+        emit q->sessionEnded(session);
+    });
+}
+
+QMcpServerInProcess::QMcpServerInProcess(QObject *parent)
+    : QMcpServerBackendInterface(parent)
+    , d(new Private(this))
+{}
+
+QMcpServerInProcess::~QMcpServerInProcess()
+{
+    if (d->listening)
+        QMcpInProcessChannel::unlisten(d->name);
+}
+
+bool QMcpServerInProcess::isValidating() const
+{
+    return d->validating;
+}
+
+void QMcpServerInProcess::setValidating(bool validating)
+{
+    if (d->validating == validating)
+        return;
+    d->validating = validating;
+    for (const auto &channel : std::as_const(d->channels))
+        channel->setValidating(validating);
+    emit validatingChanged(validating);
+}
+
+void QMcpServerInProcess::start(const QString &server)
+{
+    const bool listening = QMcpInProcessChannel::listen(server, this,
+            [this](std::shared_ptr<QMcpInProcessChannel> channel) {
+        d->accept(std::move(channel));
+    });
+    if (!listening) {
+        qWarning() << "server start failed." << server << "is taken";
+        return;
+    }
+    d->name = server;
+    d->listening = true;
+    emit started();
+}
+
+void QMcpServerInProcess::send(const QUuid &session, const QJsonObject &object)
+{
+    const auto channel = d->channels.value(session);
+    if (!channel) {
+        qCWarning(lcQMcpServerInProcessPlugin) << "session" << session << "not found";
+        return;
+    }
+    channel->send(object);
+}
+
+void QMcpServerInProcess::notify(const QUuid &session, const QJsonObject &object)
+{
+    send(session, object);
+}
+
+void QMcpServerInProcess::closeSession(const QUuid &session)
+{
+    // Closing this end calls the client's closed handler, not ours.
+    if (const auto channel = d->channels.take(session))
+        channel->close();
+    qCDebug(lcQMcpServerInProcessPlugin) << "Session" << session << "closed by the server";
+    emit sessionEnded(session);
+}
+
+QT_END_NAMESPACE
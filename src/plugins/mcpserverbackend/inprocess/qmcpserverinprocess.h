@@ -0,0 +1,69 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSERVERINPROCESS_H
+#define QMCPSERVERINPROCESS_H
+
+#include <QtMcpServer/qmcpserverbackendplugin.h>
+#include <QtMcpServer/qmcpserverbackendinterface.h>
+#include <QtCore/QJsonObject>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpServerInProcess
+    \internal
+    \brief Serves MCP to clients in the same process, without serializing.
+
+    start() takes a name, which a QMcpClient with the \c inprocess backend
+    connects to; every client is a session of its own. Messages are handed
+    over as shared JSON objects, never encoded to text, and are delivered
+    queued, so client and server may live in different threads.
+*/
+class QMcpServerInProcess : public QMcpServerBackendInterface
+{
+    Q_OBJECT
+    /*!
+        \property QMcpServerInProcess::validating
+        Whether every message sent is round-tripped through its JSON text,
+        as a transport across processes would, with a warning where that
+        changes it. Meant for tests; defaults to true when the environment
+        variable \c QT_MCP_INPROCESS_VALIDATE is set to a non-zero value.
+    */
+    Q_PROPERTY(bool validating READ isValidating WRITE setValidating NOTIFY validatingChanged)
+public:
+    explicit QMcpServerInProcess(QObject *parent = nullptr);
+    ~QMcpServerInProcess() override;
+
+    bool isValidating() const;
+
+public slots:
+    void start(const QString &server) override;
+    void send(const QUuid &session, const QJsonObject &object) override;
+    void notify(const QUuid &session, const QJsonObject &object) override;
+    void closeSession(const QUuid &session) override;
+    void setValidating(bool validating);
+
+signals:
+    void validatingChanged(bool validating);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+class QMcpServerInProcessPlugin : public QMcpServerBackendPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QMcpServerBackendPluginFactoryInterface_iid FILE "qmcpserverinprocess.json")
+public:
+    QMcpServerBackendInterface *create(const QString &key, QObject *parent = nullptr) override
+    {
+        Q_ASSERT(key == "inprocess"_L1);
+        return new QMcpServerInProcess(parent);
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSERVERINPROCESS_H
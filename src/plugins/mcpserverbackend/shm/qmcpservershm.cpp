@@ -0,0 +1,129 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpservershm.h"
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtMcpCommon/private/qmcplocalserver_p.h>
+#include <QtMcpCommon/private/qmcpshmchannel_p.h>
+#include <QtMcpCommon/private/qmcptracer_p.h>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpServerShmPlugin, "qt.mcpserver.plugins.backend.shm")
+
+class QMcpServerShm::Private
+{
+public:
+    Private(QMcpServerShm *parent);
+
+    void handleNewConnection();
+    void removeClient(QLocalSocket *socket);
+
+    QMcpServerShm *q;
+    QString name;
+    QHash<QLocalSocket *, QUuid> sessions;
+    QHash<QUuid, std::shared_ptr<QMcpShmChannel>> channels;
+    // Last, so that the sockets it owns go before the tables they are in.
+    QLocalServer server;
+};
+
+QMcpServerShm::Private::Private(QMcpServerShm *parent)
+    : q(parent)
+{
+    // The segments are made for the user the server runs as; so is the
+    // socket handing out their keys.
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    connect(&server, &QLocalServer::newConnection, q, [this]() {
+        handleNewConnection();
+    });
+}
+
+void QMcpServerShm::Private::handleNewConnection()
+{
+    while (auto *socket = server.nextPendingConnection()) {
+        const auto session = QUuid::createUuid();
+        const auto key = name + u'-' + session.toString(QUuid::WithoutBraces);
+        auto channel = std::make_shared<QMcpShmChannel>([this, session](const QJsonObject &object, qsizetype bytes) {
+            q->addBytesReceived(bytes);
+            // One trace per message; the server adopts it for a request.
+            QMcpTraceScope traceScope;
+            emit q->received(session, object);
+        });
+        if (!channel->create(key)) {
+            qCWarning(lcQMcpServerShmPlugin) << "Cannot create shared memory for" << session << channel->errorString();
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+        sessions.insert(socket, session);
+        channels.insert(session, channel);
+        connect(socket, &QLocalSocket::disconnected, q, [this, socket]() {
+            removeClient(socket);
+        });
+        socket->write(key.toUtf8() + '\n');
+        qCDebug(lcQMcpServerShmPlugin) << "New session" << session << "in" << key;
+        emit q->newSessionStarted(session);
+    }
+}
+
+void QMcpServerShm::Private::removeClient(QLocalSocket *socket)
+{
+    const auto session = sessions.take(socket);
+    channels.remove(session);
+    socket->deleteLater();
+    qCDebug(lcQMcpServerShmPlugin) << "Session" << session << "disconnected";
+    if (!session.isNull())
+        emit q->sessionEnded(session);
+}
+
+QMcpServerShm::QMcpServerShm(QObject *parent)
+    : QMcpServerBackendInterface(parent)
+    , d(new Private(this))
+{}
+
+QMcpServerShm::~QMcpServerShm() = default;
+
+void QMcpServerShm::start(const QString &server)
+{
+    if (!QMcpLocalServer::listen(&d->server, server)) {
+        qWarning() << "server start failed." << server << d->server.errorString();
+        return;
+    }
+    // Keys are made from the name; a path would not make a valid one.
+    d->name = u"qtmcp-shm-"_s + QString::number(qHash(d->server.fullServerName()), 16);
+    qCDebug(lcQMcpServerShmPlugin) << "Listening on" << d->server.fullServerName();
+    emit started();
+}
+
+void QMcpServerShm::send(const QUuid &session, const QJsonObject &object)
+{
+    const auto channel = d->channels.value(session);
+    if (!channel) {
+        qCWarning(lcQMcpServerShmPlugin) << "session" << session << "not found";
+        return;
+    }
+    addBytesSent(channel->send(object));
+}
+
+void QMcpServerShm::notify(const QUuid &session, const QJsonObject &object)
+{
+    send(session, object);
+}
+
+void QMcpServerShm::closeSession(const QUuid &session)
+{
+    auto *socket = d->sessions.key(session);
+    if (!socket) {
+        emit sessionEnded(session);
+        return;
+    }
+    // The control socket going away is what ends a session either way.
+    socket->disconnectFromServer();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,55 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSERVERSHM_H
+#define QMCPSERVERSHM_H
+
+#include <QtMcpServer/qmcpserverbackendplugin.h>
+#include <QtMcpServer/qmcpserverbackendinterface.h>
+#include <QtCore/QJsonObject>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpServerShm
+    \internal
+    \brief Serves MCP to clients on the same host through shared memory.
+
+    start() takes a local socket name, as the \c unix backend does. A
+    client connecting to it is a session of its own and is told the key of
+    a shared memory segment made for it; messages then go through the rings
+    in that segment, and the socket only tells that the client went away.
+*/
+class QMcpServerShm : public QMcpServerBackendInterface
+{
+    Q_OBJECT
+public:
+    explicit QMcpServerShm(QObject *parent = nullptr);
+    ~QMcpServerShm() override;
+
+public slots:
+    void start(const QString &server) override;
+    void send(const QUuid &session, const QJsonObject &object) override;
+    void notify(const QUuid &session, const QJsonObject &object) override;
+    void closeSession(const QUuid &session) override;
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+class QMcpServerShmPlugin : public QMcpServerBackendPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QMcpServerBackendPluginFactoryInterface_iid FILE "qmcpservershm.json")
+public:
+    QMcpServerBackendInterface *create(const QString &key, QObject *parent = nullptr) override
+    {
+        Q_ASSERT(key == "shm"_L1);
+        return new QMcpServerShm(parent);
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSERVERSHM_H
@@ -13,6 +13,11 @@ HttpServer::HttpServer(QObject *parent)
     : QMcpAbstractHttpServer(parent)
     , d(new Private)
 {
+    // A session lives as long as its event stream.
+    connect(this, &QMcpAbstractHttpServer::connectionClosed, this, [this](const QUuid &id) {
+        if (d->sessions.remove(id))
+            emit sessionEnded(id);
+    });
 }
 
 HttpServer::~HttpServer() = default;
@@ -66,3 +71,10 @@ void HttpServer::send(const QUuid &session, const QJsonObject &object)
 {
     sendSseEvent(session, QJsonDocument(object).toJson(QJsonDocument::Compact), "message"_L1);
 }
+
+void HttpServer::closeSession(const QUuid &session)
+{
+    if (d->sessions.remove(session))
+        closeSseConnection(session);
+    emit sessionEnded(session);
+}
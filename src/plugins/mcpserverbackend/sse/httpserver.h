@@ -18,9 +18,11 @@ public:
 
 public slots:
     void send(const QUuid &session, const QJsonObject &object);
+    void closeSession(const QUuid &session);
 
 signals:
     void newSession(const QUuid &session);
+    void sessionEnded(const QUuid &session);
     void received(const QUuid &session, const QJsonObject &object);
 
 private:
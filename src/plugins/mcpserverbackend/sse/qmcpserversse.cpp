@@ -34,6 +34,9 @@ QMcpServerSse::Private::Private(QMcpServerSse *parent)
     connect(&httpServer, &HttpServer::newSession, q, [this](const QUuid &uuid) {
         uuids.insert(uuid);
     });
+    connect(&httpServer, &HttpServer::sessionEnded, q, [this](const QUuid &uuid) {
+        uuids.remove(uuid);
+    });
 }
 
 QMcpServerSse::QMcpServerSse(QObject *parent)
@@ -42,10 +45,21 @@ QMcpServerSse::QMcpServerSse(QObject *parent)
 {
     connect(&d->httpServer, &HttpServer::newSession, this, &QMcpServerSse::newSessionStarted);
     connect(&d->httpServer, &HttpServer::received, this, &QMcpServerSse::received);
+    connect(&d->httpServer, &HttpServer::sessionEnded, this, &QMcpServerSse::sessionEnded);
 }
 
 QMcpServerSse::~QMcpServerSse() = default;
 
+quint64 QMcpServerSse::bytesReceived() const
+{
+    return d->httpServer.bytesReceived();
+}
+
+quint64 QMcpServerSse::bytesSent() const
+{
+    return d->httpServer.bytesSent();
+}
+
 void QMcpServerSse::start(const QString &server)
 {
     QHostAddress address = QHostAddress::Any;
@@ -77,4 +91,9 @@ void QMcpServerSse::notify(const QUuid &session, const QJsonObject &object)
     send(session, object);
 }
 
+void QMcpServerSse::closeSession(const QUuid &session)
+{
+    d->httpServer.closeSession(session);
+}
+
 QT_END_NAMESPACE
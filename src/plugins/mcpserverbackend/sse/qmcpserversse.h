@@ -17,10 +17,14 @@ public:
     explicit QMcpServerSse(QObject *parent = nullptr);
     ~QMcpServerSse() override;
 
+    quint64 bytesReceived() const override;
+    quint64 bytesSent() const override;
+
 public slots:
     void start(const QString &server) override;
     void send(const QUuid &session, const QJsonObject &object) override;
     void notify(const QUuid &session, const QJsonObject &object) override;
+    void closeSession(const QUuid &session) override;
 
 private:
     class Private;
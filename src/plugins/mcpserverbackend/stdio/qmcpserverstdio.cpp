@@ -8,32 +8,63 @@
 #include <QtCore/QJsonObject>
 #include <QtCore/QDebug>
 #include <QtCore/QSocketNotifier>
+#include <QtMcpCommon/private/qmcptracer_p.h>
 #ifdef Q_OS_WIN
 #include <io.h>
 #include <fcntl.h>
 #define STDIN_FILENO _fileno(stdin)
+#define STDOUT_FILENO _fileno(stdout)
 #define read _read
+#define write _write
 #else
-#include <unistd.h>   // for STDIN_FILENO and ::read on POSIX
+#include <unistd.h>   // for STDIN_FILENO, ::read and ::write on POSIX
 #endif
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 
 QT_BEGIN_NAMESPACE
 
 Q_LOGGING_CATEGORY(lcQMcpServerStdioPlugin, "qt.mcpserver.plugins.backend.stdio")
 
+namespace {
+
+// Bytes asked from STDIN per read; the input buffer grows by at least this.
+constexpr qsizetype ReadChunkSize = 64 * 1024;
+// Replies pending beyond this are written right away rather than at the
+// end of the event loop turn.
+constexpr qsizetype OutputFlushThreshold = 1024 * 1024;
+
+} // namespace
+
 class QMcpServerStdio::Private
 {
 public:
     Private(QMcpServerStdio *parent);
 
+    void flush();
+    void scheduleFlush();
+
 private:
     void readData(QSocketDescriptor socket, QSocketNotifier::Type activationEvent);
+    void processLines();
 
 private:
     QMcpServerStdio *q;
     QSocketNotifier *notifier;
     const QUuid uuid = QUuid::createUuid();
+
+    // Bytes read from STDIN. Those before consumed are handed on already,
+    // those before scanned are known to hold no newline, so a message
+    // arriving in many reads is scanned once and moved rarely.
+    QByteArray input;
+    qsizetype consumed = 0;
+    qsizetype scanned = 0;
+
+    // Replies sent during this event loop turn, written together.
+    QByteArray output;
+    bool flushScheduled = false;
 };
 
 QMcpServerStdio::Private::Private(QMcpServerStdio *parent)
@@ -41,8 +72,9 @@ QMcpServerStdio::Private::Private(QMcpServerStdio *parent)
     , notifier(new QSocketNotifier(STDIN_FILENO, QSocketNotifier::Read, q))
 {
 #ifdef Q_OS_WIN
-    // Set stdin to binary mode to avoid CRLF translation
+    // Set stdin and stdout to binary mode to avoid CRLF translation
     _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
 #endif
     QMetaObject::invokeMethod(q, "newSessionStarted", Qt::QueuedConnection, Q_ARG(QUuid, uuid));
     connect(notifier, &QSocketNotifier::activated, q, [this](QSocketDescriptor socket, QSocketNotifier::Type activationEvent) {
@@ -53,44 +85,69 @@ QMcpServerStdio::Private::Private(QMcpServerStdio *parent)
 void QMcpServerStdio::Private::readData(QSocketDescriptor socket, QSocketNotifier::Type type) {
     Q_UNUSED(socket);
     Q_UNUSED(type);
+
+    // Drop what was handed on once it is at least half of the buffer, which
+    // keeps the moves linear in what is read.
+    if (consumed > 0 && consumed * 2 >= input.size()) {
+        input.remove(0, consumed);
+        scanned -= consumed;
+        consumed = 0;
+    }
+    const auto size = input.size();
+    if (input.capacity() - size < ReadChunkSize)
+        input.reserve(std::max(input.capacity() * 2, size + ReadChunkSize));
+    input.resize(size + ReadChunkSize);
+
     // Read available data from STDIN (non-blocking, as data is ready)
-    char buffer[1024];
-    const auto bytesRead = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    const auto bytesRead = ::read(STDIN_FILENO, input.data() + size, ReadChunkSize);
+    input.resize(size + std::max<qsizetype>(bytesRead, 0));
     if (bytesRead < 0) {
         std::perror("Error reading STDIN");
         notifier->setEnabled(false);
+        flush();
         emit q->finished();
         return;
     }
     if (bytesRead == 0) {
         // EOF reached (no more data)
         notifier->setEnabled(false);
+        flush();
         emit q->finished();
         return;
     }
 
-    // Append to buffer (may accumulate partial data from previous reads)
-    static QByteArray data;
-    data.append(buffer, static_cast<int>(bytesRead));
+    q->addBytesReceived(bytesRead);
+    processLines();
+}
 
-    // Process complete lines in the buffer (assuming JSON messages are newline-terminated)
-    while (true) {
-        int newlineIndex = data.indexOf('\n');
-        if (newlineIndex < 0)
+void QMcpServerStdio::Private::processLines()
+{
+    while (scanned < input.size()) {
+        // memchr is vectorized by the C library; nothing scans a byte twice.
+        const char *begin = input.constData();
+        const auto *lf = static_cast<const char *>(std::memchr(begin + scanned, '\n', input.size() - scanned));
+        if (!lf) {
+            scanned = input.size();
             break;
-
-        QByteArray lineData = data.left(newlineIndex);
-        data.remove(0, newlineIndex + 1);  // remove this line from buffer
-
+        }
+        const qsizetype end = lf - begin;
         // Trim to avoid empty lines
-        QByteArray jsonData = lineData.trimmed();
-        if (jsonData.isEmpty()) {
+        const auto jsonData = QByteArrayView(begin + consumed, end - consumed).trimmed();
+        consumed = scanned = end + 1;
+        if (jsonData.isEmpty())
             continue;
-        }
 
-        // Parse JSON data
+        // One trace per message; the server adopts it for a request.
+        QMcpTraceScope traceScope;
+
+        // Parse JSON data in place; the buffer does not change until the
+        // message is handed on below.
         QJsonParseError parseError;
-        QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
+        QJsonDocument jsonDoc;
+        {
+            QMcpTraceSpan span(traceScope.trace(), "json.decode");
+            jsonDoc = QJsonDocument::fromJson(QByteArray::fromRawData(jsonData.data(), jsonData.size()), &parseError);
+        }
         if (parseError.error != QJsonParseError::NoError) {
             qWarning() << "JSON parse error: "
                        << parseError.errorString().toStdString();
@@ -104,6 +161,41 @@ void QMcpServerStdio::Private::readData(QSocketDescriptor socket, QSocketNotifie
 
         emit q->received(uuid, jsonDoc.object());
     }
+
+    if (consumed == input.size()) {
+        // Keeps the capacity for the next message.
+        input.resize(0);
+        consumed = scanned = 0;
+    }
+}
+
+void QMcpServerStdio::Private::scheduleFlush()
+{
+    if (output.size() >= OutputFlushThreshold) {
+        flush();
+        return;
+    }
+    if (flushScheduled)
+        return;
+    flushScheduled = true;
+    QMetaObject::invokeMethod(q, [this]() { flush(); }, Qt::QueuedConnection);
+}
+
+void QMcpServerStdio::Private::flush()
+{
+    flushScheduled = false;
+    qsizetype written = 0;
+    while (written < output.size()) {
+        const auto bytesWritten = ::write(STDOUT_FILENO, output.constData() + written, output.size() - written);
+        if (bytesWritten < 0) {
+            if (errno == EINTR)
+                continue;
+            std::perror("Error writing STDOUT");
+            break;
+        }
+        written += bytesWritten;
+    }
+    output.resize(0);
 }
 
 QMcpServerStdio::QMcpServerStdio(QObject *parent)
@@ -111,7 +203,10 @@ QMcpServerStdio::QMcpServerStdio(QObject *parent)
     , d(new Private(this))
 {}
 
-QMcpServerStdio::~QMcpServerStdio() = default;
+QMcpServerStdio::~QMcpServerStdio()
+{
+    d->flush();
+}
 
 void QMcpServerStdio::start(const QString &server)
 {
@@ -123,7 +218,10 @@ void QMcpServerStdio::send(const QUuid &session, const QJsonObject &object)
     Q_UNUSED(session)
     const auto data = QJsonDocument(object).toJson(QJsonDocument::Compact);
     qCDebug(lcQMcpServerStdioPlugin) << data;
-    std::cout << data.toStdString() << std::endl;
+    d->output += data;
+    d->output += '\n';
+    addBytesSent(data.size() + 1);
+    d->scheduleFlush();
 }
 
 void QMcpServerStdio::notify(const QUuid &session, const QJsonObject &object)
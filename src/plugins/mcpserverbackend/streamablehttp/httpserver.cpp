@@ -3,12 +3,15 @@
 
 #include "httpserver.h"
 
+#include <QtCore/QDeadlineTimer>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonParseError>
 #include <QtCore/QJsonValue>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QTimer>
 #include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpCommon/private/qmcptracer_p.h>
+#include <QtMcpServer/qmcpserver.h>
 
 QT_USE_NAMESPACE
 
@@ -25,6 +28,16 @@ using HeaderList = QList<std::pair<QByteArray, QByteArray>>;
 // report yet.
 constexpr int KeepAliveIntervalMs = 60 * 1000;
 
+// Events kept per session for resumption. A client reconnecting within a
+// network blip gets what it missed instead of having to list everything
+// again.
+constexpr int DefaultReplayBufferSize = 256;
+// However few the events, a session's buffer holds no more than this.
+constexpr qsizetype MaxReplayBufferBytes = 1024 * 1024;
+// How long a client whose standalone stream closed has to come back for what
+// it missed; well past the client's 30 s reconnect backoff.
+constexpr int ResumeWindowMs = 2 * 60 * 1000;
+
 // The revision assumed when a request carries no MCP-Protocol-Version header.
 // The header only became mandatory in 2025-06-18, so its absence identifies a
 // client speaking the revision that introduced Streamable HTTP.
@@ -35,6 +48,10 @@ constexpr int HeaderMismatchErrorCode = -32020;
 constexpr int InvalidRequestErrorCode = -32600;
 constexpr int ParseErrorCode = -32700;
 
+// How long a client turned away by the server's queue limits is told to wait
+// before it tries again.
+constexpr auto BusyRetryAfterSeconds = "1";
+
 /*!
     \internal
     Decodes a header value the client wrapped in the \c {=?base64?<data>?=}
@@ -128,11 +145,27 @@ public:
     struct Session {
         QtMcp::ProtocolVersion version = DefaultProtocolVersion;
         QUuid stream;           // the SSE stream notifications are routed to
+        quint64 lastEventId = 0;
+        // Set once the client opened its standalone stream: only then can it
+        // come back with Last-Event-ID, until resumeDeadline once it closed.
+        bool resumable = false;
+        QDeadlineTimer resumeDeadline;
+        // The latest events, oldest first, for a client resuming its stream
+        // with Last-Event-ID, and their size.
+        QList<std::pair<quint64, QByteArray>> replay;
+        qsizetype replayBytes = 0;
     };
 
     bool isOriginAllowed(const QNetworkRequest &request) const;
+    void addPending(const QString &internalId, const Pending &entry);
+    Pending takePending(const QString &internalId);
+    // Drops the requests of an ended session still waiting for the core,
+    // answering those that are not streamed with 404.
+    void dropPending(const QUuid &session);
     void openStream(const QUuid &streamId, const QUuid &session, bool dedicated);
     void closeStream(const QUuid &streamId);
+    void sendEvent(Session &session, const QByteArray &data);
+    void replay(const Session &session, const QByteArray &lastEventId);
     // Resolves the session a non-initialize request belongs to. Answers the
     // exchange itself and returns false when it cannot be resolved. A POST
     // that forgot the header is a malformed request (400), while for GET and
@@ -142,12 +175,16 @@ public:
 
     HttpServer *q;
     QStringList allowedOrigins;
+    QString metricsPath;
+    std::function<QByteArray()> metricsProvider;
     QUuid statelessSession;
     QHash<QUuid, Session> sessions;
     QHash<QString, Pending> pending;   // internal request id -> pending request
+    QHash<QUuid, QString> pendingByExchange;   // exchange -> internal request id
     QHash<QUuid, Stream> streams;      // SSE connection id -> stream
     QTimer keepAlive;
     quint64 nextInternalId = 0;
+    int replayBufferSize = DefaultReplayBufferSize;
 };
 
 HttpServer::Private::Private(HttpServer *parent)
@@ -174,6 +211,35 @@ bool HttpServer::Private::isOriginAllowed(const QNetworkRequest &request) const
     return allowedOrigins.contains(origin);
 }
 
+void HttpServer::Private::addPending(const QString &internalId, const Pending &entry)
+{
+    pending.insert(internalId, entry);
+    pendingByExchange.insert(entry.exchange, internalId);
+}
+
+HttpServer::Private::Pending HttpServer::Private::takePending(const QString &internalId)
+{
+    const auto entry = pending.take(internalId);
+    pendingByExchange.remove(entry.exchange);
+    return entry;
+}
+
+void HttpServer::Private::dropPending(const QUuid &session)
+{
+    for (auto i = pending.begin(); i != pending.end();) {
+        if (i->session != session) {
+            ++i;
+            continue;
+        }
+        pendingByExchange.remove(i->exchange);
+        if (!i->stream) {
+            q->completeResponse(i->exchange, 404,
+                                jsonRpcErrorBody(i->originalId, InvalidRequestErrorCode, "Session not found"_L1));
+        }
+        i = pending.erase(i);
+    }
+}
+
 void HttpServer::Private::openStream(const QUuid &streamId, const QUuid &session, bool dedicated)
 {
     auto it = sessions.find(session);
@@ -204,22 +270,67 @@ void HttpServer::Private::closeStream(const QUuid &streamId)
 
     auto it = sessions.find(stream.session);
     if (it != sessions.end()) {
-        if (it->stream == streamId)
+        if (it->stream == streamId) {
             it->stream = QUuid();
+            it->resumeDeadline.setRemainingTime(ResumeWindowMs);
+        }
         if (stream.dedicated) {
-            // TODO: QMcpServer offers no API to destroy a session, so the core
-            // side QMcpServerSession outlives the stream it was created for.
-            // Only the transport side mapping is dropped here.
             sessions.erase(it);
+            emit q->sessionEnded(stream.session);
+        }
+    }
+
+    // Drop the request that was being answered through this stream.
+    const auto internalId = pendingByExchange.take(streamId);
+    if (!internalId.isEmpty())
+        pending.remove(internalId);
+}
+
+/*!
+    \internal
+    Numbers \a data with the session's next event id, keeps it for replay
+    and sends it down the session's stream, if one is open. Events are only
+    kept while a stream is open or the client may still resume its
+    standalone one, and within replayBufferSize and MaxReplayBufferBytes.
+    Sessions of 2026-07-28 cannot resume a stream, so nothing is kept for
+    them.
+*/
+void HttpServer::Private::sendEvent(Session &session, const QByteArray &data)
+{
+    const auto eventId = ++session.lastEventId;
+    const bool canResume = !session.stream.isNull()
+            || (session.resumable && !session.resumeDeadline.hasExpired());
+    if (!canResume) {
+        session.replay.clear();
+        session.replayBytes = 0;
+    } else if (session.version < QtMcp::ProtocolVersion::v2026_07_28 && replayBufferSize > 0) {
+        session.replay.append({eventId, data});
+        session.replayBytes += data.size();
+        while (session.replay.size() > replayBufferSize || session.replayBytes > MaxReplayBufferBytes) {
+            session.replayBytes -= session.replay.first().second.size();
+            session.replay.removeFirst();
         }
     }
+    if (!session.stream.isNull())
+        q->sendSseEvent(session.stream, data, {}, QByteArray::number(eventId));
+}
 
-    // Drop requests that were being answered through this stream.
-    for (auto pendingIt = pending.begin(); pendingIt != pending.end();) {
-        if (pendingIt->exchange == streamId)
-            pendingIt = pending.erase(pendingIt);
-        else
-            ++pendingIt;
+void HttpServer::Private::replay(const Session &session, const QByteArray &lastEventId)
+{
+    bool ok = false;
+    const auto last = lastEventId.trimmed().toULongLong(&ok);
+    if (!ok || last > session.lastEventId) {
+        qCDebug(lcQMcpServerStreamableHttpPlugin) << "ignoring unknown Last-Event-ID" << lastEventId;
+        return;
+    }
+    if (last < session.lastEventId
+            && (session.replay.isEmpty() || session.replay.first().first > last + 1)) {
+        qCWarning(lcQMcpServerStreamableHttpPlugin)
+                << "events after" << last << "are no longer buffered; the client missed some";
+    }
+    for (const auto &[eventId, data] : session.replay) {
+        if (eventId > last)
+            q->sendSseEvent(session.stream, data, {}, QByteArray::number(eventId));
     }
 }
 
@@ -255,16 +366,14 @@ HttpServer::HttpServer(QObject *parent)
         }
         // Closing the response stream of a request is how a Streamable HTTP
         // client cancels it.
-        for (auto it = d->pending.begin(); it != d->pending.end(); ++it) {
-            if (it->exchange != id)
-                continue;
-            // TODO: tell the core to abandon the request. QMcpServer has no API
-            // to cancel one in flight, so its response is discarded instead.
-            qCDebug(lcQMcpServerStreamableHttpPlugin)
-                    << "request" << it.key() << "cancelled by the client";
-            d->pending.erase(it);
+        const auto internalId = d->pendingByExchange.value(id);
+        if (internalId.isEmpty())
             return;
-        }
+        // TODO: tell the core to abandon the request. QMcpServer has no API
+        // to cancel one in flight, so its response is discarded instead.
+        qCDebug(lcQMcpServerStreamableHttpPlugin)
+                << "request" << internalId << "cancelled by the client";
+        d->takePending(internalId);
     });
 }
 
@@ -289,6 +398,57 @@ void HttpServer::startStatelessSession()
     emit newSession(d->statelessSession);
 }
 
+QString HttpServer::metricsPath() const
+{
+    return d->metricsPath;
+}
+
+void HttpServer::setMetricsPath(const QString &path)
+{
+    if (!d->metricsPath.isEmpty())
+        removeRoute("GET"_ba, d->metricsPath);
+    d->metricsPath = path;
+    if (!d->metricsPath.isEmpty())
+        addRoute("GET"_ba, d->metricsPath, "serveMetrics"_ba);
+}
+
+bool HttpServer::hasStream(const QUuid &session) const
+{
+    return !d->sessions.value(session).stream.isNull();
+}
+
+int HttpServer::replayBufferSize() const
+{
+    return d->replayBufferSize;
+}
+
+void HttpServer::setReplayBufferSize(int size)
+{
+    d->replayBufferSize = size;
+}
+
+void HttpServer::setMetricsProvider(std::function<QByteArray()> provider)
+{
+    d->metricsProvider = std::move(provider);
+}
+
+QByteArray HttpServer::serveMetrics(const QNetworkRequest &request)
+{
+    const auto exchange = deferResponse(request);
+    if (exchange.isNull())
+        return {};
+
+    // Only reachable through the route setMetricsPath() added, but the
+    // statistics are no business of a page a browser was tricked into.
+    if (!d->isOriginAllowed(request)) {
+        completeResponse(exchange, 403, "Origin not allowed"_ba, QStringLiteral("text/plain"));
+        return {};
+    }
+    const auto body = d->metricsProvider ? d->metricsProvider() : QByteArray();
+    completeResponse(exchange, 200, body, QStringLiteral("text/plain; version=0.0.4; charset=utf-8"));
+    return {};
+}
+
 QByteArray HttpServer::postMcp(const QNetworkRequest &request, const QByteArray &body)
 {
     const auto exchange = deferResponse(request);
@@ -305,7 +465,11 @@ QByteArray HttpServer::postMcp(const QNetworkRequest &request, const QByteArray
     const auto version = requestedProtocolVersion(request, &versionString);
 
     QJsonParseError parseError;
-    const auto document = QJsonDocument::fromJson(body, &parseError);
+    QJsonDocument document;
+    {
+        QMcpTraceSpan span(QMcpTracer::current(), "json.decode");
+        document = QJsonDocument::fromJson(body, &parseError);
+    }
     if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
         // TODO: 2025-03-26 allows a JSON-RPC batch, i.e. a top level array.
         // Only single messages are accepted for now.
@@ -439,7 +603,7 @@ QByteArray HttpServer::postMcp(const QNetworkRequest &request, const QByteArray
         d->openStream(exchange, session, version >= QtMcp::ProtocolVersion::v2026_07_28);
     }
 
-    d->pending.insert(internalId, entry);
+    d->addPending(internalId, entry);
     emit received(session, message);
     return {};
 }
@@ -476,12 +640,16 @@ QByteArray HttpServer::getMcp(const QNetworkRequest &request)
     if (!d->resolveSession(request, exchange, &session, 404))
         return {};
 
-    // TODO: resuming a stream with Last-Event-ID is not implemented, so the
-    // header is ignored and the client always gets a fresh stream.
     if (!upgradeToSse(exchange))
         return {};
     d->openStream(exchange, session, false);
+    if (const auto it = d->sessions.find(session); it != d->sessions.end())
+        it->resumable = true;
     qCDebug(lcQMcpServerStreamableHttpPlugin) << "standalone stream opened for session" << session;
+    // A client resuming gets what was sent since the last event it saw,
+    // ahead of anything new.
+    if (request.hasRawHeader("Last-Event-ID"))
+        d->replay(d->sessions.value(session), request.rawHeader("Last-Event-ID"));
     return {};
 }
 
@@ -514,14 +682,45 @@ QByteArray HttpServer::deleteMcp(const QNetworkRequest &request)
         d->closeStream(stream);
         closeSseConnection(stream);
     }
-    // TODO: QMcpServer offers no API to destroy a session, so its
-    // QMcpServerSession stays alive until the server shuts down.
     d->sessions.remove(session);
+    d->dropPending(session);
     completeResponse(exchange, 200);
     qCDebug(lcQMcpServerStreamableHttpPlugin) << "session" << session << "terminated";
+    emit sessionEnded(session);
     return {};
 }
 
+void HttpServer::closeSession(const QUuid &session)
+{
+    const auto it = d->sessions.constFind(session);
+    if (it == d->sessions.cend()) {
+        emit sessionEnded(session);
+        return;
+    }
+    const auto stream = it->stream;
+    if (!stream.isNull()) {
+        // Dedicated streams end their session themselves; take the entry
+        // first so that it ends only once.
+        d->streams.remove(stream);
+        if (d->streams.isEmpty())
+            d->keepAlive.stop();
+        closeSseConnection(stream);
+    }
+    d->sessions.remove(session);
+
+    // Requests still waiting for the core will not be answered.
+    d->dropPending(session);
+    qCDebug(lcQMcpServerStreamableHttpPlugin) << "session" << session << "closed by the server";
+    emit sessionEnded(session);
+
+    // Stateless requests keep coming without a session to name; they get a
+    // fresh shared one.
+    if (session == d->statelessSession) {
+        d->statelessSession = QUuid();
+        startStatelessSession();
+    }
+}
+
 void HttpServer::send(const QUuid &session, const QJsonObject &object)
 {
     // A response to a request forwarded earlier carries the internal id and no
@@ -529,7 +728,7 @@ void HttpServer::send(const QUuid &session, const QJsonObject &object)
     if (object.contains("id"_L1) && !object.contains("method"_L1)) {
         const auto internalId = object.value("id"_L1).toString();
         if (d->pending.contains(internalId)) {
-            const auto entry = d->pending.take(internalId);
+            const auto entry = d->takePending(internalId);
             if (entry.stream) {
                 // TODO: the JSON-RPC response to subscriptions/listen signals a
                 // graceful end of the subscription and should close the stream.
@@ -547,19 +746,31 @@ void HttpServer::send(const QUuid &session, const QJsonObject &object)
             else
                 response.insert("id"_L1, entry.originalId);
             // TODO: 2026-07-28 wants a -32601 from the core mapped to HTTP 404.
-            // Every JSON-RPC error is reported as 200 with an error body here.
-            completeResponse(entry.exchange, 200,
+            // Other JSON-RPC errors are reported as 200 with an error body,
+            // except a full queue: 429 when this client has too many calls
+            // waiting, 503 when the whole server has.
+            int statusCode = 200;
+            auto extraHeaders = entry.extraHeaders;
+            const auto error = response.value("error"_L1).toObject();
+            if (error.value("code"_L1).toInt() == QMcpServer::ServerBusyErrorCode) {
+                const auto scope = error.value("data"_L1).toObject().value("scope"_L1).toString();
+                statusCode = scope == "session"_L1 ? 429 : 503;
+                extraHeaders.append({ "Retry-After"_ba, BusyRetryAfterSeconds });
+            }
+            completeResponse(entry.exchange, statusCode,
                              QJsonDocument(response).toJson(QJsonDocument::Compact),
-                             QStringLiteral("application/json"), entry.extraHeaders);
+                             QStringLiteral("application/json"), extraHeaders);
             return;
         }
     }
 
     // Anything else - notifications and server initiated requests - belongs on
-    // the session's stream.
-    const auto it = d->sessions.constFind(session);
-    if (it != d->sessions.constEnd() && !it->stream.isNull()) {
-        sendSseEvent(it->stream, QJsonDocument(object).toJson(QJsonDocument::Compact));
+    // the session's stream. Without one open it is kept for the client to
+    // resume, if the session's revision allows that.
+    const auto it = d->sessions.find(session);
+    if (it != d->sessions.end()
+            && (!it->stream.isNull() || it->version < QtMcp::ProtocolVersion::v2026_07_28)) {
+        d->sendEvent(*it, QJsonDocument(object).toJson(QJsonDocument::Compact));
         return;
     }
 
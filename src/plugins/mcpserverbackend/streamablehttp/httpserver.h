@@ -9,6 +9,8 @@
 #include <QtMcpServer/qmcpabstracthttpserver.h>
 #include <QtNetwork/QNetworkRequest>
 
+#include <functional>
+
 /*!
     \class HttpServer
     \internal
@@ -21,7 +23,9 @@
     \li 2025-03-26 .. 2025-11-25: \c initialize mints a session that is returned
         in the \c Mcp-Session-Id response header and echoed back by the client
         on every subsequent request. \c GET opens a standalone SSE stream for
-        that session, \c DELETE terminates it.
+        that session, \c DELETE terminates it. Events carry increasing ids, and
+        a \c GET with \c Last-Event-ID resumes the stream with the events
+        sent since.
     \li 2026-07-28: sessions are gone from the wire. Ordinary requests run on a
         single shared, stateless session; \c subscriptions/listen gets a
         dedicated one because the core routes notifications per session.
@@ -48,15 +52,48 @@ public:
     */
     void startStatelessSession();
 
+    /*!
+        The path statistics are served on in the Prometheus text format, on
+        the same listener as \c /mcp. Empty, the default, serves none.
+        \a provider produces the body for each scrape.
+    */
+    QString metricsPath() const;
+    void setMetricsPath(const QString &path);
+    void setMetricsProvider(std::function<QByteArray()> provider);
+
+    /*!
+        The number of events kept per session for a client that resumes its
+        standalone stream with \c Last-Event-ID. 0 keeps none. Events are
+        only kept for a session with a stream open, or whose standalone
+        stream closed less than two minutes ago, and never more than 1 MiB
+        of them.
+    */
+    int replayBufferSize() const;
+    void setReplayBufferSize(int size);
+
+    /*!
+        Returns whether \a session has an SSE stream open that
+        notifications are sent down right away.
+    */
+    bool hasStream(const QUuid &session) const;
+
     Q_INVOKABLE QByteArray postMcp(const QNetworkRequest &request, const QByteArray &body);
     Q_INVOKABLE QByteArray getMcp(const QNetworkRequest &request);
     Q_INVOKABLE QByteArray deleteMcp(const QNetworkRequest &request);
+    Q_INVOKABLE QByteArray serveMetrics(const QNetworkRequest &request);
 
 public slots:
     void send(const QUuid &session, const QJsonObject &object);
+    /*!
+        Forgets \a session, closing its stream and answering the requests it
+        still has waiting with 404. Closing the shared stateless session
+        replaces it with a new one.
+    */
+    void closeSession(const QUuid &session);
 
 signals:
     void newSession(const QUuid &session);
+    void sessionEnded(const QUuid &session);
     void received(const QUuid &session, const QJsonObject &object);
 
 private:
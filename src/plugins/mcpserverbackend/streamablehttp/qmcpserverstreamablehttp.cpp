@@ -5,6 +5,7 @@
 #include "httpserver.h"
 
 #include <QtCore/QLoggingCategory>
+#include <QtMcpServer/qmcpserver.h>
 #include <QtNetwork/QHostAddress>
 #include <QtNetwork/QTcpServer>
 
@@ -28,6 +29,13 @@ QMcpServerStreamableHttp::QMcpServerStreamableHttp(QObject *parent)
             this, &QMcpServerStreamableHttp::newSessionStarted);
     connect(&d->httpServer, &HttpServer::received,
             this, &QMcpServerStreamableHttp::received);
+    connect(&d->httpServer, &HttpServer::sessionEnded,
+            this, &QMcpServerStreamableHttp::sessionEnded);
+    // The backend is a child of the QMcpServer it serves.
+    d->httpServer.setMetricsProvider([this]() {
+        const auto *server = qobject_cast<const QMcpServer *>(parent());
+        return server ? server->statistics().toPrometheusText() : QByteArray();
+    });
 }
 
 QMcpServerStreamableHttp::~QMcpServerStreamableHttp() = default;
@@ -45,6 +53,49 @@ void QMcpServerStreamableHttp::setAllowedOrigins(const QStringList &allowedOrigi
     emit allowedOriginsChanged(allowedOrigins);
 }
 
+QString QMcpServerStreamableHttp::metricsPath() const
+{
+    return d->httpServer.metricsPath();
+}
+
+void QMcpServerStreamableHttp::setMetricsPath(const QString &metricsPath)
+{
+    if (d->httpServer.metricsPath() == metricsPath)
+        return;
+    d->httpServer.setMetricsPath(metricsPath);
+    emit metricsPathChanged(metricsPath);
+}
+
+int QMcpServerStreamableHttp::replayBufferSize() const
+{
+    return d->httpServer.replayBufferSize();
+}
+
+void QMcpServerStreamableHttp::setReplayBufferSize(int replayBufferSize)
+{
+    if (d->httpServer.replayBufferSize() == replayBufferSize)
+        return;
+    d->httpServer.setReplayBufferSize(replayBufferSize);
+    emit replayBufferSizeChanged(replayBufferSize);
+}
+
+quint64 QMcpServerStreamableHttp::bytesReceived() const
+{
+    return d->httpServer.bytesReceived();
+}
+
+quint64 QMcpServerStreamableHttp::bytesSent() const
+{
+    return d->httpServer.bytesSent();
+}
+
+// A POST is answered with a single JSON body, so only a session with an
+// open SSE stream gets notifications before its response.
+bool QMcpServerStreamableHttp::canNotifyDuringRequest(const QUuid &session) const
+{
+    return d->httpServer.hasStream(session);
+}
+
 void QMcpServerStreamableHttp::start(const QString &server)
 {
     QHostAddress address = QHostAddress::Any;
@@ -80,4 +131,9 @@ void QMcpServerStreamableHttp::notify(const QUuid &session, const QJsonObject &o
     send(session, object);
 }
 
+void QMcpServerStreamableHttp::closeSession(const QUuid &session)
+{
+    d->httpServer.closeSession(session);
+}
+
 QT_END_NAMESPACE
@@ -31,20 +31,47 @@ class QMcpServerStreamableHttp : public QMcpServerBackendInterface
     */
     Q_PROPERTY(QStringList allowedOrigins READ allowedOrigins WRITE setAllowedOrigins
                NOTIFY allowedOriginsChanged)
+    /*!
+        \property QMcpServerStreamableHttp::metricsPath
+        Path, e.g. \c /metrics, on which QMcpServer::statistics() is served
+        in the Prometheus text format on the same listener. Empty, the
+        default, disables the endpoint.
+    */
+    Q_PROPERTY(QString metricsPath READ metricsPath WRITE setMetricsPath
+               NOTIFY metricsPathChanged)
+    /*!
+        \property QMcpServerStreamableHttp::replayBufferSize
+        Number of events kept per session so that a client reconnecting its
+        standalone stream with \c Last-Event-ID gets the ones it missed.
+        Defaults to 256; 0 disables resumption.
+    */
+    Q_PROPERTY(int replayBufferSize READ replayBufferSize WRITE setReplayBufferSize
+               NOTIFY replayBufferSizeChanged)
 public:
     explicit QMcpServerStreamableHttp(QObject *parent = nullptr);
     ~QMcpServerStreamableHttp() override;
 
     QStringList allowedOrigins() const;
+    QString metricsPath() const;
+    int replayBufferSize() const;
+
+    quint64 bytesReceived() const override;
+    quint64 bytesSent() const override;
+    bool canNotifyDuringRequest(const QUuid &session) const override;
 
 public slots:
     void start(const QString &server) override;
     void send(const QUuid &session, const QJsonObject &object) override;
     void notify(const QUuid &session, const QJsonObject &object) override;
+    void closeSession(const QUuid &session) override;
     void setAllowedOrigins(const QStringList &allowedOrigins);
+    void setMetricsPath(const QString &metricsPath);
+    void setReplayBufferSize(int replayBufferSize);
 
 signals:
     void allowedOriginsChanged(const QStringList &allowedOrigins);
+    void metricsPathChanged(const QString &metricsPath);
+    void replayBufferSizeChanged(int replayBufferSize);
 
 private:
     class Private;
@@ -0,0 +1,166 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmcpserverunix.h"
+#include <QtCore/QHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonParseError>
+#include <QtCore/QLoggingCategory>
+#include <QtMcpCommon/private/qmcplinebuffer_p.h>
+#include <QtMcpCommon/private/qmcplocalserver_p.h>
+#include <QtMcpCommon/private/qmcptracer_p.h>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcQMcpServerUnixPlugin, "qt.mcpserver.plugins.backend.unix")
+
+class QMcpServerUnix::Private
+{
+public:
+    Private(QMcpServerUnix *parent);
+
+    void handleNewConnection();
+    void readMessages(QLocalSocket *socket);
+    void removeClient(QLocalSocket *socket);
+
+    struct Client {
+        QUuid session;
+        // What was read and not handed on yet.
+        QMcpLineBuffer input;
+    };
+
+    QMcpServerUnix *q;
+    QHash<QLocalSocket *, Client> clients;
+    QHash<QUuid, QLocalSocket *> sockets;
+    // Last, so that the sockets it owns go before the tables they are in.
+    QLocalServer server;
+};
+
+QMcpServerUnix::Private::Private(QMcpServerUnix *parent)
+    : q(parent)
+{
+    // Only the user the server runs as may connect; the socket gives access
+    // to whatever the server's tools can do.
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    connect(&server, &QLocalServer::newConnection, q, [this]() {
+        handleNewConnection();
+    });
+}
+
+void QMcpServerUnix::Private::handleNewConnection()
+{
+    while (auto *socket = server.nextPendingConnection()) {
+        const auto session = QUuid::createUuid();
+        clients.insert(socket, { session, {} });
+        sockets.insert(session, socket);
+        connect(socket, &QLocalSocket::readyRead, q, [this, socket]() {
+            readMessages(socket);
+        });
+        connect(socket, &QLocalSocket::disconnected, q, [this, socket]() {
+            removeClient(socket);
+        });
+        qCDebug(lcQMcpServerUnixPlugin) << "New session" << session;
+        emit q->newSessionStarted(session);
+    }
+}
+
+void QMcpServerUnix::Private::readMessages(QLocalSocket *socket)
+{
+    auto it = clients.find(socket);
+    if (it == clients.end())
+        return;
+    const auto session = it->session;
+    const auto received = socket->readAll();
+    q->addBytesReceived(received.size());
+    it->input.append(received);
+
+    // Looked up again for every message: a receiver may do anything,
+    // including closing this client.
+    for (; it != clients.end(); it = clients.find(socket)) {
+        const auto line = it->input.nextLine();
+        if (!line)
+            break;
+
+        // One trace per message; the server adopts it for a request.
+        QMcpTraceScope traceScope;
+        QJsonParseError parseError;
+        QJsonDocument document;
+        {
+            // Parsed in place; the buffer does not change until the
+            // message is handed on below.
+            QMcpTraceSpan span(traceScope.trace(), "json.decode");
+            document = QJsonDocument::fromJson(QByteArray::fromRawData(line->data(), line->size()), &parseError);
+        }
+        if (parseError.error != QJsonParseError::NoError) {
+            qCWarning(lcQMcpServerUnixPlugin) << "JSON parse error:" << parseError.errorString();
+            continue;
+        }
+        if (!document.isObject()) {
+            qCWarning(lcQMcpServerUnixPlugin) << "JSON is not an object" << document;
+            continue;
+        }
+        emit q->received(session, document.object());
+    }
+}
+
+void QMcpServerUnix::Private::removeClient(QLocalSocket *socket)
+{
+    const auto client = clients.take(socket);
+    sockets.remove(client.session);
+    socket->deleteLater();
+    qCDebug(lcQMcpServerUnixPlugin) << "Session" << client.session << "disconnected";
+    if (!client.session.isNull())
+        emit q->sessionEnded(client.session);
+}
+
+QMcpServerUnix::QMcpServerUnix(QObject *parent)
+    : QMcpServerBackendInterface(parent)
+    , d(new Private(this))
+{}
+
+QMcpServerUnix::~QMcpServerUnix() = default;
+
+void QMcpServerUnix::start(const QString &server)
+{
+    if (!QMcpLocalServer::listen(&d->server, server)) {
+        qWarning() << "server start failed." << server << d->server.errorString();
+        return;
+    }
+    qCDebug(lcQMcpServerUnixPlugin) << "Listening on" << d->server.fullServerName();
+    emit started();
+}
+
+void QMcpServerUnix::send(const QUuid &session, const QJsonObject &object)
+{
+    auto *socket = d->sockets.value(session);
+    if (!socket) {
+        qCWarning(lcQMcpServerUnixPlugin) << "session" << session << "not found";
+        return;
+    }
+    // Written when the event loop runs again, together with whatever else
+    // is sent to this client until then.
+    const QByteArray data = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+    socket->write(data);
+    addBytesSent(data.size());
+}
+
+void QMcpServerUnix::notify(const QUuid &session, const QJsonObject &object)
+{
+    send(session, object);
+}
+
+void QMcpServerUnix::closeSession(const QUuid &session)
+{
+    auto *socket = d->sockets.value(session);
+    if (!socket) {
+        emit sessionEnded(session);
+        return;
+    }
+    // What was written is still delivered; disconnected() then ends the
+    // session.
+    socket->disconnectFromServer();
+}
+
+QT_END_NAMESPACE
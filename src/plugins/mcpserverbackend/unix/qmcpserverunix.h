@@ -0,0 +1,55 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMCPSERVERUNIX_H
+#define QMCPSERVERUNIX_H
+
+#include <QtMcpServer/qmcpserverbackendplugin.h>
+#include <QtMcpServer/qmcpserverbackendinterface.h>
+#include <QtCore/QJsonObject>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMcpServerUnix
+    \internal
+    \brief Serves MCP over a local socket, for clients on the same host.
+
+    Messages are JSON objects, one per line, as on stdio; unlike stdio the
+    server outlives its clients and every connection is a session of its
+    own. start() takes the socket's name or path. On Windows the socket is
+    a named pipe.
+*/
+class QMcpServerUnix : public QMcpServerBackendInterface
+{
+    Q_OBJECT
+public:
+    explicit QMcpServerUnix(QObject *parent = nullptr);
+    ~QMcpServerUnix() override;
+
+public slots:
+    void start(const QString &server) override;
+    void send(const QUuid &session, const QJsonObject &object) override;
+    void notify(const QUuid &session, const QJsonObject &object) override;
+    void closeSession(const QUuid &session) override;
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+class QMcpServerUnixPlugin : public QMcpServerBackendPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QMcpServerBackendPluginFactoryInterface_iid FILE "qmcpserverunix.json")
+public:
+    QMcpServerBackendInterface *create(const QString &key, QObject *parent = nullptr) override
+    {
+        Q_ASSERT(key == "unix"_L1);
+        return new QMcpServerUnix(parent);
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QMCPSERVERUNIX_H
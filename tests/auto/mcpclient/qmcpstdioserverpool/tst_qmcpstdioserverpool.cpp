@@ -0,0 +1,166 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpClient/QMcpStdioServerPool>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpInitializeRequest>
+#include <QtMcpCommon/QMcpInitializeResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpPingRequest>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+
+#include <memory>
+
+namespace {
+
+// Passed to this very binary to have it serve as the pooled server.
+constexpr auto StdioServerArgument = "--stdio-server";
+
+} // namespace
+
+class tst_QMcpStdioServerPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void leasedClientIsWarm();
+    void processesAreReusedUpToMaxUses();
+    void busyProcessIsNotReused();
+    void coldProcessIsInitializedOnce();
+
+private:
+    std::unique_ptr<QMcpClient> lease();
+    bool ping(QMcpClient *client);
+
+    std::unique_ptr<QMcpStdioServerPool> m_pool;
+};
+
+void tst_QMcpStdioServerPool::init()
+{
+    m_pool = std::make_unique<QMcpStdioServerPool>(
+        QCoreApplication::applicationFilePath() + u' ' + QLatin1StringView(StdioServerArgument));
+    m_pool->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    m_pool->setSize(2);
+    m_pool->start();
+    QTRY_COMPARE_WITH_TIMEOUT(m_pool->idleCount(), 2, 10000);
+}
+
+void tst_QMcpStdioServerPool::cleanup()
+{
+    m_pool.reset();
+}
+
+std::unique_ptr<QMcpClient> tst_QMcpStdioServerPool::lease()
+{
+    std::unique_ptr<QMcpClient> client(m_pool->lease());
+    QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+    client->start(QString());
+    if (!startedSpy.wait(5000))
+        return nullptr;
+    return client;
+}
+
+bool tst_QMcpStdioServerPool::ping(QMcpClient *client)
+{
+    bool answered = false;
+    client->request(QMcpPingRequest(), [&answered](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+    });
+    return QTest::qWaitFor([&answered]() { return answered; }, 5000);
+}
+
+void tst_QMcpStdioServerPool::leasedClientIsWarm()
+{
+    auto client = lease();
+    QVERIFY(client);
+    QCOMPARE(client->protocolVersion(), QtMcp::ProtocolVersion::v2025_06_18);
+
+    // Answered from what the server told the pool, without a round trip.
+    bool initialized = false;
+    QMcpInitializeRequest initialize;
+    client->request(initialize, [&](const QMcpInitializeResult &result, const QMcpJSONRPCErrorError *error) {
+        QVERIFY(!error);
+        QVERIFY(!result.serverInfo().name().isEmpty());
+        initialized = true;
+    });
+    QTRY_VERIFY(initialized);
+    QVERIFY(ping(client.get()));
+
+    // The pool warms a replacement.
+    QTRY_COMPARE_WITH_TIMEOUT(m_pool->idleCount(), 2, 10000);
+}
+
+// Released before the event loop ran, the process of a client replaces
+// the one lease() started in its place, which cannot be warm yet.
+void tst_QMcpStdioServerPool::processesAreReusedUpToMaxUses()
+{
+    m_pool->setSize(1);
+    m_pool->setMaxUses(2);
+
+    delete m_pool->lease();
+    QCOMPARE(m_pool->idleCount(), 1);
+
+    // Its second client was its last.
+    delete m_pool->lease();
+    QCOMPARE(m_pool->idleCount(), 0);
+    QTRY_COMPARE_WITH_TIMEOUT(m_pool->idleCount(), 1, 10000);
+}
+
+void tst_QMcpStdioServerPool::busyProcessIsNotReused()
+{
+    m_pool->setSize(1);
+    m_pool->setMaxUses(0);
+
+    // Its answer would reach the next client, which may use the same id.
+    std::unique_ptr<QMcpClient> client(m_pool->lease());
+    client->request(QMcpPingRequest(), [](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *) {});
+    client.reset();
+    QCOMPARE(m_pool->idleCount(), 0);
+}
+
+void tst_QMcpStdioServerPool::coldProcessIsInitializedOnce()
+{
+    // With no process left, lease() starts one that is not warm yet.
+    m_pool->setSize(0);
+    QCOMPARE(m_pool->idleCount(), 0);
+    std::unique_ptr<QMcpClient> client(m_pool->lease());
+
+    // Sent while the pool's own handshake is under way, the initialize
+    // waits for it and is answered from its result.
+    bool initialized = false;
+    client->request(QMcpInitializeRequest(), [&](const QMcpInitializeResult &result, const QMcpJSONRPCErrorError *error) {
+        QVERIFY(!error);
+        QVERIFY(!result.serverInfo().name().isEmpty());
+        initialized = true;
+    });
+    QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+    client->start(QString());
+    QVERIFY(startedSpy.wait(10000));
+    QTRY_VERIFY(initialized);
+    QVERIFY(ping(client.get()));
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && qstrcmp(argv[argc - 1], StdioServerArgument) == 0) {
+        QCoreApplication app(argc, argv);
+        QMcpServer server(u"stdio"_s);
+        server.start(QString());
+        return app.exec();
+    }
+
+    QCoreApplication app(argc, argv);
+    tst_QMcpStdioServerPool tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_qmcpstdioserverpool.moc"
@@ -0,0 +1,221 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QFuture>
+#include <QtCore/QThreadPool>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpClient/QMcpRequestError>
+#include <QtMcpClient/QMcpTask>
+#include <QtMcpCommon/QMcpCallToolRequest>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpPingRequest>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+
+#include <memory>
+
+namespace {
+
+class ToolSet : public QObject
+{
+    Q_OBJECT
+public:
+    using QObject::QObject;
+
+    Q_INVOKABLE QString echo(const QString &message) const { return message; }
+};
+
+QMcpCallToolRequest echo(const QString &message)
+{
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(u"echo"_s);
+    params.setArguments({ { "message"_L1, message } });
+    request.setParams(params);
+    return request;
+}
+
+QString text(const QMcpCallToolResult &result)
+{
+    const auto content = result.content();
+    return content.isEmpty() ? QString() : content.first().textContent().text();
+}
+
+#ifdef QT_MCP_HAS_COROUTINES
+QMcpTask<QStringList> echoAll(QMcpClient *client, const QStringList &messages)
+{
+    co_await client->requestAsync<QMcpEmptyResult>(QMcpPingRequest());
+    QList<QFuture<QMcpCallToolResult>> calls;
+    for (const auto &message : messages)
+        calls.append(client->requestAsync<QMcpCallToolResult>(echo(message)));
+    QStringList texts;
+    for (const auto &result : co_await QtMcp::whenAll(calls))
+        texts.append(text(result));
+    co_return texts;
+}
+
+QMcpTask<int> errorCodeOfPing(QMcpClient *client)
+{
+    try {
+        co_await client->requestAsync<QMcpEmptyResult>(QMcpPingRequest());
+    } catch (const QMcpRequestError &e) {
+        co_return e.error().code();
+    }
+    co_return 0;
+}
+#endif
+
+} // namespace
+
+class tst_RequestAsync : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void futureFinishesWithTheResult();
+    void requestsArePipelined();
+    void errorFailsTheFuture();
+    void decodingOnAPool();
+    void destroyedClientCancels();
+    void coroutines();
+
+private:
+    std::unique_ptr<QMcpClient> startClient(QtMcp::ProtocolVersion protocolVersion = QtMcp::ProtocolVersion::v2025_06_18);
+
+    QString m_name;
+    std::unique_ptr<QMcpServer> m_server;
+};
+
+void tst_RequestAsync::init()
+{
+    m_name = u"tst_requestasync-%1"_s.arg(QTest::currentTestFunction());
+    m_server = std::make_unique<QMcpServer>("inprocess"_L1);
+    m_server->registerToolSet(new ToolSet(m_server.get()));
+    m_server->start(m_name);
+}
+
+void tst_RequestAsync::cleanup()
+{
+    m_server.reset();
+}
+
+std::unique_ptr<QMcpClient> tst_RequestAsync::startClient(QtMcp::ProtocolVersion protocolVersion)
+{
+    auto client = std::make_unique<QMcpClient>("inprocess"_L1);
+    client->setProtocolVersion(protocolVersion);
+    QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+    client->start(m_name);
+    if (!startedSpy.wait(5000))
+        return nullptr;
+    return client;
+}
+
+void tst_RequestAsync::futureFinishesWithTheResult()
+{
+    auto client = startClient();
+    QVERIFY(client);
+
+    auto future = client->requestAsync<QMcpCallToolResult>(echo(u"hello"_s));
+    QVERIFY(!future.isFinished());
+    QTRY_VERIFY(future.isFinished());
+    QVERIFY(!future.isCanceled());
+    QCOMPARE(text(future.result()), u"hello"_s);
+}
+
+// All requests go out before the first answer is read.
+void tst_RequestAsync::requestsArePipelined()
+{
+    auto client = startClient();
+    QVERIFY(client);
+
+    constexpr int Calls = 100;
+    QList<QFuture<QMcpCallToolResult>> calls;
+    for (int i = 0; i < Calls; ++i)
+        calls.append(client->requestAsync<QMcpCallToolResult>(echo(QString::number(i))));
+    for (const auto &call : calls)
+        QVERIFY(!call.isFinished());
+
+    auto all = QtMcp::whenAll(calls);
+    QTRY_VERIFY(all.isFinished());
+    const auto results = all.result();
+    QCOMPARE(results.size(), Calls);
+    for (int i = 0; i < Calls; ++i)
+        QCOMPARE(text(results.at(i)), QString::number(i));
+}
+
+void tst_RequestAsync::errorFailsTheFuture()
+{
+    // Servers reject ping on 2026-07-28.
+    auto client = startClient(QtMcp::ProtocolVersion::v2026_07_28);
+    QVERIFY(client);
+
+    auto future = client->requestAsync<QMcpEmptyResult>(QMcpPingRequest())
+            .then([](const QMcpEmptyResult &) {
+                return 0;
+            })
+            .onFailed([](const QMcpRequestError &e) {
+                return e.error().code();
+            });
+    QTRY_VERIFY(future.isFinished());
+    QCOMPARE(future.result(), -32601);
+
+    // A failure fails the whole fan-in.
+    auto all = QtMcp::whenAll(QList<QFuture<QMcpEmptyResult>> {
+            client->requestAsync<QMcpEmptyResult>(QMcpPingRequest()) });
+    QTRY_VERIFY(all.isFinished());
+    QVERIFY_THROWS_EXCEPTION(QMcpRequestError, all.waitForFinished());
+}
+
+void tst_RequestAsync::decodingOnAPool()
+{
+    auto client = startClient();
+    QVERIFY(client);
+
+    QThreadPool pool;
+    auto future = client->requestAsync<QMcpCallToolResult>(echo(QString(1 << 20, u'x')), &pool);
+    QTRY_VERIFY(future.isFinished());
+    QCOMPARE(text(future.result()).size(), 1 << 20);
+}
+
+void tst_RequestAsync::destroyedClientCancels()
+{
+    auto client = startClient();
+    QVERIFY(client);
+
+    auto future = client->requestAsync<QMcpCallToolResult>(echo(u"lost"_s));
+    client.reset();
+    QVERIFY(future.isFinished());
+    QVERIFY(future.isCanceled());
+}
+
+void tst_RequestAsync::coroutines()
+{
+#ifdef QT_MCP_HAS_COROUTINES
+    auto client = startClient();
+    QVERIFY(client);
+
+    const QStringList messages = { u"a"_s, u"b"_s, u"c"_s };
+    QFuture<QStringList> texts = echoAll(client.get(), messages);
+    QTRY_VERIFY(texts.isFinished());
+    QCOMPARE(texts.result(), messages);
+
+    auto statelessClient = startClient(QtMcp::ProtocolVersion::v2026_07_28);
+    QVERIFY(statelessClient);
+    QFuture<int> code = errorCodeOfPing(statelessClient.get());
+    QTRY_VERIFY(code.isFinished());
+    QCOMPARE(code.result(), -32601);
+#else
+    QSKIP("Needs coroutines and exceptions");
+#endif
+}
+
+QTEST_MAIN(tst_RequestAsync)
+
+#include "tst_requestasync.moc"
@@ -0,0 +1,126 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtMcpCommon/private/qmcpcompression_p.h>
+#include <QtTest/QTest>
+
+using Encoding = QMcpCompression::Encoding;
+
+class tst_QMcpCompression : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void negotiate_data();
+    void negotiate();
+    void corruptDataIsRejected();
+    void expansionIsBounded();
+    void streamEmitsEveryMessage();
+
+private:
+    static QByteArray sample();
+};
+
+QByteArray tst_QMcpCompression::sample()
+{
+    QByteArray json = "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":["_ba;
+    for (int i = 0; i < 100; ++i)
+        json += "{\"name\":\"tool" + QByteArray::number(i) + "\",\"description\":\"Does things\"},";
+    json.chop(1);
+    return json + "]}}";
+}
+
+void tst_QMcpCompression::roundTrip_data()
+{
+    QTest::addColumn<Encoding>("encoding");
+    QTest::newRow("gzip") << Encoding::Gzip;
+    QTest::newRow("deflate") << Encoding::Deflate;
+    QTest::newRow("identity") << Encoding::Identity;
+}
+
+void tst_QMcpCompression::roundTrip()
+{
+    QFETCH(Encoding, encoding);
+
+    const auto data = sample();
+    const auto compressed = QMcpCompression::compress(data, encoding);
+    if (encoding != Encoding::Identity)
+        QVERIFY(compressed.size() < data.size() / 4);
+    const auto decompressed = QMcpCompression::decompress(compressed, encoding, data.size());
+    QVERIFY(decompressed);
+    QCOMPARE(*decompressed, data);
+    const auto named = QMcpCompression::fromName(QMcpCompression::name(encoding));
+    QVERIFY(named);
+    QCOMPARE(*named, encoding);
+}
+
+void tst_QMcpCompression::negotiate_data()
+{
+    QTest::addColumn<QByteArray>("acceptEncoding");
+    QTest::addColumn<Encoding>("expected");
+    QTest::newRow("none") << QByteArray() << Encoding::Identity;
+    QTest::newRow("gzip") << "gzip"_ba << Encoding::Gzip;
+    QTest::newRow("both") << "deflate, gzip"_ba << Encoding::Gzip;
+    QTest::newRow("deflate preferred") << "gzip;q=0.5, deflate"_ba << Encoding::Deflate;
+    QTest::newRow("gzip refused") << "gzip;q=0, deflate;q=0.1"_ba << Encoding::Deflate;
+    QTest::newRow("wildcard") << "br, *;q=0.8"_ba << Encoding::Gzip;
+    QTest::newRow("wildcard refused") << "*;q=0"_ba << Encoding::Identity;
+    QTest::newRow("unsupported") << "br, zstd"_ba << Encoding::Identity;
+}
+
+void tst_QMcpCompression::negotiate()
+{
+    QFETCH(QByteArray, acceptEncoding);
+    QFETCH(Encoding, expected);
+
+    QCOMPARE(QMcpCompression::negotiate(acceptEncoding), expected);
+}
+
+void tst_QMcpCompression::corruptDataIsRejected()
+{
+    QVERIFY(!QMcpCompression::decompress("not compressed at all", Encoding::Gzip, 1024));
+    // A stream cut short is no stream.
+    const auto compressed = QMcpCompression::compress(sample(), Encoding::Gzip);
+    QVERIFY(!QMcpCompression::decompress(compressed.first(compressed.size() / 2), Encoding::Gzip, 1 << 20));
+    QVERIFY(!QMcpCompression::fromName("br"));
+}
+
+void tst_QMcpCompression::expansionIsBounded()
+{
+    // A megabyte of zeros compresses to about a kilobyte.
+    const auto bomb = QMcpCompression::compress(QByteArray(1 << 20, '\0'), Encoding::Gzip);
+    QVERIFY(bomb.size() < 4096);
+
+    bool tooLarge = false;
+    QVERIFY(!QMcpCompression::decompress(bomb, Encoding::Gzip, 64 * 1024, &tooLarge));
+    QVERIFY(tooLarge);
+    QVERIFY(QMcpCompression::decompress(bomb, Encoding::Gzip, 1 << 20, &tooLarge));
+    QVERIFY(!tooLarge);
+}
+
+void tst_QMcpCompression::streamEmitsEveryMessage()
+{
+    QMcpStreamCompressor compressor(Encoding::Gzip);
+    QByteArray stream;
+    QByteArray expected;
+    for (int i = 0; i < 3; ++i) {
+        const auto event = "data: " + sample() + "\r\n\r\n";
+        const auto chunk = compressor.compress(event);
+        // Nothing is held back for the next message.
+        QVERIFY(!chunk.isEmpty());
+        stream += chunk;
+        expected += event;
+    }
+    stream += compressor.finish();
+
+    const auto decompressed = QMcpCompression::decompress(stream, Encoding::Gzip, expected.size());
+    QVERIFY(decompressed);
+    QCOMPARE(*decompressed, expected);
+    // Later messages reuse what the earlier ones taught the dictionary.
+    QVERIFY(stream.size() < QMcpCompression::compress(sample(), Encoding::Gzip).size() * 2);
+}
+
+QTEST_MAIN(tst_QMcpCompression)
+#include "tst_qmcpcompression.moc"
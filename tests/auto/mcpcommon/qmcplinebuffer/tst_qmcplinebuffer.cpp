@@ -0,0 +1,85 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtMcpCommon/private/qmcplinebuffer_p.h>
+#include <QtTest/QTest>
+
+using namespace Qt::Literals::StringLiterals;
+
+class tst_QMcpLineBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lineSplitAcrossAppends();
+    void severalLinesInOneAppend();
+    void blankLinesAndCrLf();
+    void largeLine();
+
+private:
+    static QList<QByteArray> lines(QMcpLineBuffer *buffer);
+};
+
+QList<QByteArray> tst_QMcpLineBuffer::lines(QMcpLineBuffer *buffer)
+{
+    QList<QByteArray> ret;
+    while (const auto line = buffer->nextLine())
+        ret.append(line->toByteArray());
+    return ret;
+}
+
+void tst_QMcpLineBuffer::lineSplitAcrossAppends()
+{
+    QMcpLineBuffer buffer;
+    buffer.append("{\"a\":");
+    QVERIFY(!buffer.nextLine());
+    buffer.append("1,\"b\"");
+    QVERIFY(!buffer.nextLine());
+    buffer.append(":2}\n{\"c\"");
+    QCOMPARE(lines(&buffer), QList<QByteArray>({ "{\"a\":1,\"b\":2}"_ba }));
+    QCOMPARE(buffer.size(), 4);
+    buffer.append(":3}\n");
+    QCOMPARE(lines(&buffer), QList<QByteArray>({ "{\"c\":3}"_ba }));
+    QCOMPARE(buffer.size(), 0);
+}
+
+void tst_QMcpLineBuffer::severalLinesInOneAppend()
+{
+    QMcpLineBuffer buffer;
+    buffer.append("{\"id\":1}\n{\"id\":2}\n{\"id\":3}\n{\"id\":");
+    QCOMPARE(lines(&buffer), QList<QByteArray>({ "{\"id\":1}"_ba, "{\"id\":2}"_ba, "{\"id\":3}"_ba }));
+    // Nothing is handed on twice.
+    QVERIFY(!buffer.nextLine());
+    buffer.append("4}\n");
+    QCOMPARE(lines(&buffer), QList<QByteArray>({ "{\"id\":4}"_ba }));
+}
+
+void tst_QMcpLineBuffer::blankLinesAndCrLf()
+{
+    QMcpLineBuffer buffer;
+    buffer.append("\n\r\n  \n{\"id\":1}\r\n\r");
+    buffer.append("\n{\"id\":2}\r\n");
+    QCOMPARE(lines(&buffer), QList<QByteArray>({ "{\"id\":1}"_ba, "{\"id\":2}"_ba }));
+    QCOMPARE(buffer.size(), 0);
+}
+
+void tst_QMcpLineBuffer::largeLine()
+{
+    // A message of several megabytes in small reads, with a short one on
+    // either side of it, comes out whole.
+    const QByteArray large = "{\"data\":\"" + QByteArray(4 * 1024 * 1024, 'x') + "\"}";
+    const QByteArray stream = "{\"id\":1}\n" + large + "\n{\"id\":2}\n";
+    QMcpLineBuffer buffer;
+    QList<QByteArray> received;
+    for (qsizetype i = 0; i < stream.size(); i += 4096) {
+        buffer.append(QByteArrayView(stream).sliced(i, qMin<qsizetype>(4096, stream.size() - i)));
+        received += lines(&buffer);
+    }
+    QCOMPARE(received.size(), 3);
+    QCOMPARE(received.at(0), "{\"id\":1}"_ba);
+    QVERIFY(received.at(1) == large);
+    QCOMPARE(received.at(2), "{\"id\":2}"_ba);
+}
+
+QTEST_MAIN(tst_QMcpLineBuffer)
+#include "tst_qmcplinebuffer.moc"
@@ -0,0 +1,131 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QJsonObject>
+#include <QtMcpCommon/private/qmcppendingrequests_p.h>
+#include <QtTest/QTest>
+
+class tst_QMcpPendingRequests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void idsArePerInstance();
+    void takeCompletesOnlyTheOwnersRequest();
+    void takeIgnoresForeignIds();
+    void idsBeyondIntRange();
+    void anUnansweredRequestTimesOut();
+    void anAnsweredRequestDoesNotTimeOut();
+    void zeroTimeoutWaitsForever();
+    void removeOwnerDropsWithoutInvoking();
+};
+
+void tst_QMcpPendingRequests::idsArePerInstance()
+{
+    QMcpPendingRequests a;
+    QMcpPendingRequests b;
+    QCOMPARE(a.nextId(), qint64(0));
+    QCOMPARE(a.nextId(), qint64(1));
+    QCOMPARE(b.nextId(), qint64(0));
+}
+
+void tst_QMcpPendingRequests::takeCompletesOnlyTheOwnersRequest()
+{
+    QMcpPendingRequests pending;
+    const auto owner = QUuid::createUuid();
+    const auto id = pending.nextId();
+    bool called = false;
+    pending.insert(id, owner, [&called](const QJsonObject &, const QJsonObject &) { called = true; });
+
+    QVERIFY(!pending.take(QUuid::createUuid(), id));
+    QCOMPARE(pending.size(), 1);
+
+    const auto callback = pending.take(owner, id);
+    QVERIFY(callback);
+    callback({}, {});
+    QVERIFY(called);
+    QCOMPARE(pending.size(), 0);
+    QVERIFY(!pending.take(owner, id));
+}
+
+void tst_QMcpPendingRequests::takeIgnoresForeignIds()
+{
+    QMcpPendingRequests pending;
+    const auto id = pending.nextId();
+    pending.insert(id, QUuid(), [](const QJsonObject &, const QJsonObject &) {});
+
+    // Ids are only handed out as integers, so a string id never matches.
+    QVERIFY(!pending.take(QUuid(), QJsonValue(QString::number(id))));
+    QVERIFY(!pending.take(QUuid(), QJsonValue()));
+    QVERIFY(pending.take(QUuid(), QJsonValue(id)));
+}
+
+void tst_QMcpPendingRequests::idsBeyondIntRange()
+{
+    // Where a 32-bit counter would have overflowed, ids still match.
+    QMcpPendingRequests pending;
+    const qint64 id = qint64(1) << 40;
+    pending.insert(id, QUuid(), [](const QJsonObject &, const QJsonObject &) {});
+    QVERIFY(!pending.take(QUuid(), QJsonValue(int(id))));
+    QVERIFY(pending.take(QUuid(), QJsonValue(id)));
+}
+
+void tst_QMcpPendingRequests::anUnansweredRequestTimesOut()
+{
+    QMcpPendingRequests pending;
+    pending.setTimeout(200);
+    QJsonObject error;
+    bool called = false;
+    pending.insert(pending.nextId(), QUuid(), [&](const QJsonObject &result, const QJsonObject &e) {
+        QVERIFY(result.isEmpty());
+        error = e;
+        called = true;
+    });
+
+    QTRY_VERIFY_WITH_TIMEOUT(called, 2000);
+    QCOMPARE(error.value("code"_L1).toInt(), QMcpPendingRequests::TimeoutErrorCode);
+    QCOMPARE(pending.size(), 0);
+}
+
+void tst_QMcpPendingRequests::anAnsweredRequestDoesNotTimeOut()
+{
+    QMcpPendingRequests pending;
+    pending.setTimeout(100);
+    int calls = 0;
+    const auto id = pending.nextId();
+    pending.insert(id, QUuid(), [&calls](const QJsonObject &, const QJsonObject &) { ++calls; });
+    pending.take(QUuid(), id)({}, {});
+
+    QTest::qWait(400);
+    QCOMPARE(calls, 1);
+}
+
+void tst_QMcpPendingRequests::zeroTimeoutWaitsForever()
+{
+    QMcpPendingRequests pending;
+    pending.setTimeout(0);
+    bool called = false;
+    pending.insert(pending.nextId(), QUuid(), [&called](const QJsonObject &, const QJsonObject &) { called = true; });
+
+    QTest::qWait(300);
+    QVERIFY(!called);
+    QCOMPARE(pending.size(), 1);
+}
+
+void tst_QMcpPendingRequests::removeOwnerDropsWithoutInvoking()
+{
+    QMcpPendingRequests pending;
+    const auto gone = QUuid::createUuid();
+    const auto kept = QUuid::createUuid();
+    bool called = false;
+    for (int i = 0; i < 3; ++i)
+        pending.insert(pending.nextId(), gone, [&called](const QJsonObject &, const QJsonObject &) { called = true; });
+    pending.insert(pending.nextId(), kept, [](const QJsonObject &, const QJsonObject &) {});
+
+    pending.removeOwner(gone);
+    QCOMPARE(pending.size(), 1);
+    QVERIFY(!called);
+}
+
+QTEST_MAIN(tst_QMcpPendingRequests)
+#include "tst_qmcppendingrequests.moc"
@@ -0,0 +1,141 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtMcpCommon/private/qmcptracer_p.h>
+#include <QtTest/QTest>
+
+class tst_QMcpTracer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void disabledTracesNothing();
+    void chromeTraceHasTheRequestAndItsStages();
+    void anUnadoptedScopeEndsItsTrace();
+    void otlpSpansShareTheirTrace();
+    void zeroSampleRateTracesNothing();
+
+private:
+    QString traceFile() const { return m_dir.filePath("trace.json"_L1); }
+    QByteArray readTraceFile() const;
+
+    QTemporaryDir m_dir;
+};
+
+QByteArray tst_QMcpTracer::readTraceFile() const
+{
+    QFile file(traceFile());
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll();
+}
+
+void tst_QMcpTracer::cleanup()
+{
+    QMcpTracer::stop();
+}
+
+void tst_QMcpTracer::disabledTracesNothing()
+{
+    QVERIFY(!QMcpTracer::isEnabled());
+    QCOMPARE(QMcpTracer::beginTrace(), quint64(0));
+    QMcpTraceScope scope;
+    QCOMPARE(scope.trace(), quint64(0));
+    QCOMPARE(QMcpTracer::adopt(), quint64(0));
+    QCOMPARE(QMcpTracer::current(), quint64(0));
+}
+
+void tst_QMcpTracer::chromeTraceHasTheRequestAndItsStages()
+{
+    QVERIFY(QMcpTracer::start(traceFile()));
+
+    quint64 trace = 0;
+    {
+        QMcpTraceScope scope;
+        QVERIFY(scope.trace() != 0);
+        QCOMPARE(QMcpTracer::current(), scope.trace());
+        {
+            QMcpTraceSpan span(QMcpTracer::current(), "json.decode");
+        }
+        trace = QMcpTracer::adopt();
+        QCOMPARE(trace, scope.trace());
+        QMcpTracer::annotate(trace, "tools/call"_ba, { { "mcp.tool"_ba, "echo"_L1 } });
+    }
+    QCOMPARE(QMcpTracer::current(), quint64(0));
+    // Adopted, so the scope left ending it to us.
+    QMcpTracer::endTrace(trace);
+    QMcpTracer::stop();
+
+    const auto events = QJsonDocument::fromJson(readTraceFile()).array();
+    QCOMPARE(events.size(), 2);
+    const auto decode = events.at(0).toObject();
+    const auto request = events.at(1).toObject();
+    QCOMPARE(decode.value("name"_L1).toString(), "json.decode"_L1);
+    QCOMPARE(request.value("name"_L1).toString(), "tools/call"_L1);
+    QCOMPARE(request.value("ph"_L1).toString(), "X"_L1);
+    QCOMPARE(request.value("args"_L1).toObject().value("mcp.tool"_L1).toString(), "echo"_L1);
+    QCOMPARE(decode.value("tid"_L1), request.value("tid"_L1));
+    QVERIFY(request.value("ts"_L1).toDouble() <= decode.value("ts"_L1).toDouble());
+    QVERIFY(request.value("dur"_L1).toDouble() >= decode.value("dur"_L1).toDouble());
+}
+
+void tst_QMcpTracer::anUnadoptedScopeEndsItsTrace()
+{
+    QVERIFY(QMcpTracer::start(traceFile()));
+    {
+        QMcpTraceScope scope;
+        QVERIFY(scope.trace() != 0);
+    }
+    QMcpTracer::stop();
+
+    const auto events = QJsonDocument::fromJson(readTraceFile()).array();
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events.at(0).toObject().value("name"_L1).toString(), "request"_L1);
+}
+
+void tst_QMcpTracer::otlpSpansShareTheirTrace()
+{
+    QVERIFY(QMcpTracer::start(traceFile(), QMcpTracer::Format::OtlpJson));
+    const auto trace = QMcpTracer::beginTrace();
+    QVERIFY(trace != 0);
+    const auto startNs = QMcpTracer::now();
+    QMcpTracer::addSpan(trace, "tool"_ba, startNs, QMcpTracer::now());
+    QMcpTracer::endTrace(trace);
+    QMcpTracer::stop();
+
+    const auto lines = readTraceFile().trimmed().split('\n');
+    QCOMPARE(lines.size(), 1);
+    const auto spans = QJsonDocument::fromJson(lines.first()).object()
+            .value("resourceSpans"_L1).toArray().at(0).toObject()
+            .value("scopeSpans"_L1).toArray().at(0).toObject()
+            .value("spans"_L1).toArray();
+    QCOMPARE(spans.size(), 2);
+    const auto tool = spans.at(0).toObject();
+    const auto request = spans.at(1).toObject();
+    QCOMPARE(tool.value("name"_L1).toString(), "tool"_L1);
+    QCOMPARE(request.value("traceId"_L1).toString().size(), 32);
+    QCOMPARE(tool.value("traceId"_L1), request.value("traceId"_L1));
+    QCOMPARE(tool.value("parentSpanId"_L1), request.value("spanId"_L1));
+    QVERIFY(!request.contains("parentSpanId"_L1));
+}
+
+void tst_QMcpTracer::zeroSampleRateTracesNothing()
+{
+    QVERIFY(QMcpTracer::start(traceFile(), QMcpTracer::Format::ChromeTrace, 0.0));
+    QVERIFY(QMcpTracer::isEnabled());
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(QMcpTracer::beginTrace(), quint64(0));
+    QMcpTracer::stop();
+
+    QCOMPARE(QJsonDocument::fromJson(readTraceFile()).array().size(), 0);
+}
+
+QTEST_MAIN(tst_QMcpTracer)
+#include "tst_qmcptracer.moc"
@@ -0,0 +1,302 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QPromise>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpCallToolRequest>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpCommon/QMcpInitializeRequest>
+#include <QtMcpCommon/QMcpInitializeResult>
+#include <QtMcpCommon/QMcpInitializedNotification>
+#include <QtMcpCommon/QMcpListToolsRequest>
+#include <QtMcpCommon/QMcpListToolsResult>
+#include <QtMcpCommon/QMcpToolListChangedNotification>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpProxy/QMcpProxy>
+#include <QtMcpServer/QMcpServer>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace {
+
+class ToolSet : public QObject
+{
+    Q_OBJECT
+public:
+    ToolSet(const QString &name, QObject *parent)
+        : QObject(parent)
+        , m_name(name)
+    {}
+
+    Q_INVOKABLE QString echo(const QString &message) const { return m_name + u':' + message; }
+
+private:
+    QString m_name;
+};
+
+class MoreTools : public QObject
+{
+    Q_OBJECT
+public:
+    using QObject::QObject;
+
+    Q_INVOKABLE QString reverse(const QString &message) const
+    {
+        QString reversed = message;
+        std::reverse(reversed.begin(), reversed.end());
+        return reversed;
+    }
+};
+
+QMcpCallToolRequest call(const QString &name, const QString &message)
+{
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(name);
+    params.setArguments({ { "message"_L1, message } });
+    request.setParams(params);
+    return request;
+}
+
+} // namespace
+
+class tst_QMcpProxy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void catalogIsMergedAndPrefixed();
+    void callsAreRouted();
+    void unknownPrefixIsAToolError();
+    void upstreamConnectionsAreShared();
+    void listChangesArePassedOn();
+    void upstreamErrorsArePassedOn();
+    void removedUpstreamAnswersWithAnError();
+
+private:
+    std::unique_ptr<QMcpClient> connectClient();
+    QStringList toolNames(QMcpClient *client);
+    QMcpCallToolResult callTool(QMcpClient *client, const QMcpCallToolRequest &request);
+    // Calls a tool expected to fail and returns the error code it failed with.
+    int callToolError(QMcpClient *client, const QMcpCallToolRequest &request, QString *message = nullptr);
+
+    QString m_name;
+    std::unique_ptr<QMcpServer> m_upstreamA;
+    std::unique_ptr<QMcpServer> m_upstreamB;
+    std::unique_ptr<QMcpServer> m_front;
+    QMcpProxy *m_proxy = nullptr;
+};
+
+void tst_QMcpProxy::init()
+{
+    m_name = u"tst_qmcpproxy-%1"_s.arg(QTest::currentTestFunction());
+
+    m_upstreamA = std::make_unique<QMcpServer>("inprocess"_L1);
+    m_upstreamA->registerToolSet(new ToolSet(u"a"_s, m_upstreamA.get()));
+    m_upstreamA->start(m_name + "-a"_L1);
+    m_upstreamB = std::make_unique<QMcpServer>("inprocess"_L1);
+    m_upstreamB->registerToolSet(new ToolSet(u"b"_s, m_upstreamB.get()));
+    m_upstreamB->start(m_name + "-b"_L1);
+
+    m_front = std::make_unique<QMcpServer>("inprocess"_L1);
+    m_proxy = new QMcpProxy(m_front.get());
+    QSignalSpy catalogSpy(m_proxy, &QMcpProxy::catalogChanged);
+    for (const auto *prefix : { "a", "b" }) {
+        auto *client = new QMcpClient("inprocess"_L1);
+        client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+        m_proxy->addUpstream(QString::fromLatin1(prefix), client);
+        client->start(m_name + u'-' + QLatin1StringView(prefix));
+    }
+    m_front->start(m_name);
+
+    // Tools, resources and prompts of both.
+    QTRY_COMPARE_GE(catalogSpy.count(), 6);
+}
+
+void tst_QMcpProxy::cleanup()
+{
+    m_front.reset();
+    m_upstreamA.reset();
+    m_upstreamB.reset();
+}
+
+std::unique_ptr<QMcpClient> tst_QMcpProxy::connectClient()
+{
+    auto client = std::make_unique<QMcpClient>("inprocess"_L1);
+    client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+    client->start(m_name);
+    if (!startedSpy.wait(5000))
+        return nullptr;
+
+    bool initialized = false;
+    client->request(QMcpInitializeRequest(), [&](const QMcpInitializeResult &, const QMcpJSONRPCErrorError *error) {
+        initialized = !error;
+    });
+    if (!QTest::qWaitFor([&initialized]() { return initialized; }, 5000))
+        return nullptr;
+    client->notify(QMcpInitializedNotification());
+    return client;
+}
+
+QStringList tst_QMcpProxy::toolNames(QMcpClient *client)
+{
+    QStringList names;
+    bool answered = false;
+    client->request(QMcpListToolsRequest(), [&](const QMcpListToolsResult &result, const QMcpJSONRPCErrorError *) {
+        for (const auto &tool : result.tools())
+            names.append(tool.name());
+        answered = true;
+    });
+    QTest::qWaitFor([&answered]() { return answered; }, 5000);
+    names.sort();
+    return names;
+}
+
+QMcpCallToolResult tst_QMcpProxy::callTool(QMcpClient *client, const QMcpCallToolRequest &request)
+{
+    QMcpCallToolResult called;
+    bool answered = false;
+    client->request(request, [&](const QMcpCallToolResult &result, const QMcpJSONRPCErrorError *) {
+        called = result;
+        answered = true;
+    });
+    QTest::qWaitFor([&answered]() { return answered; }, 5000);
+    return called;
+}
+
+int tst_QMcpProxy::callToolError(QMcpClient *client, const QMcpCallToolRequest &request, QString *message)
+{
+    int code = 0;
+    bool answered = false;
+    client->request(request, [&](const QMcpCallToolResult &, const QMcpJSONRPCErrorError *error) {
+        if (error) {
+            code = error->code();
+            if (message)
+                *message = error->message();
+        }
+        answered = true;
+    });
+    QTest::qWaitFor([&answered]() { return answered; }, 5000);
+    return code;
+}
+
+void tst_QMcpProxy::catalogIsMergedAndPrefixed()
+{
+    auto client = connectClient();
+    QVERIFY(client);
+    QCOMPARE(toolNames(client.get()), QStringList({ u"a__echo"_s, u"b__echo"_s }));
+
+    m_proxy->setSeparator(u"."_s);
+    QCOMPARE(toolNames(client.get()), QStringList({ u"a.echo"_s, u"b.echo"_s }));
+}
+
+void tst_QMcpProxy::callsAreRouted()
+{
+    auto client = connectClient();
+    QVERIFY(client);
+
+    const auto a = callTool(client.get(), call(u"a__echo"_s, u"hello"_s));
+    QVERIFY(!a.isError());
+    QCOMPARE(a.content().first().textContent().text(), u"a:hello"_s);
+    const auto b = callTool(client.get(), call(u"b__echo"_s, u"hello"_s));
+    QCOMPARE(b.content().first().textContent().text(), u"b:hello"_s);
+}
+
+void tst_QMcpProxy::unknownPrefixIsAToolError()
+{
+    auto client = connectClient();
+    QVERIFY(client);
+
+    const auto result = callTool(client.get(), call(u"c__echo"_s, u"hello"_s));
+    QVERIFY(result.isError());
+}
+
+void tst_QMcpProxy::upstreamConnectionsAreShared()
+{
+    std::vector<std::unique_ptr<QMcpClient>> clients;
+    for (int i = 0; i < 5; ++i) {
+        clients.push_back(connectClient());
+        QVERIFY(clients.back());
+        QCOMPARE(callTool(clients.back().get(), call(u"a__echo"_s, QString::number(i))).content().first().textContent().text(),
+                 u"a:"_s + QString::number(i));
+    }
+    QCOMPARE(m_front->sessions().size(), 5);
+    QCOMPARE(m_upstreamA->sessions().size(), 1);
+    QCOMPARE(m_upstreamB->sessions().size(), 1);
+}
+
+void tst_QMcpProxy::listChangesArePassedOn()
+{
+    auto client = connectClient();
+    QVERIFY(client);
+    int notified = 0;
+    client->addNotificationHandler([&notified](const QMcpToolListChangedNotification &) {
+        ++notified;
+    });
+
+    m_upstreamA->registerToolSet(new MoreTools(m_upstreamA.get()));
+    QTRY_VERIFY(notified > 0);
+    QCOMPARE(toolNames(client.get()), QStringList({ u"a__echo"_s, u"a__reverse"_s, u"b__echo"_s }));
+    QCOMPARE(callTool(client.get(), call(u"a__reverse"_s, u"abc"_s)).content().first().textContent().text(), u"cba"_s);
+
+    m_proxy->removeUpstream(u"b"_s);
+    QCOMPARE(toolNames(client.get()), QStringList({ u"a__echo"_s, u"a__reverse"_s }));
+}
+
+void tst_QMcpProxy::upstreamErrorsArePassedOn()
+{
+    m_upstreamA->addTool(u"fail"_s, QStringList(), []() -> QFuture<QString> {
+        QMcpJSONRPCErrorError error;
+        error.setCode(-32602);
+        error.setMessage(u"no such file"_s);
+        QPromise<QString> promise;
+        promise.start();
+        promise.setException(std::make_exception_ptr(error));
+        promise.finish();
+        return promise.future();
+    });
+    auto client = connectClient();
+    QVERIFY(client);
+
+    // The upstream's error as is, not an empty or isError result.
+    QString message;
+    QCOMPARE(callToolError(client.get(), call(u"a__fail"_s, u"x"_s), &message), -32602);
+    QCOMPARE(message, u"no such file"_s);
+}
+
+void tst_QMcpProxy::removedUpstreamAnswersWithAnError()
+{
+    std::shared_ptr<QPromise<QString>> pending;
+    m_upstreamB->addTool(u"hang"_s, QStringList(), [&pending]() -> QFuture<QString> {
+        pending = std::make_shared<QPromise<QString>>();
+        pending->start();
+        return pending->future();
+    });
+    auto client = connectClient();
+    QVERIFY(client);
+
+    int code = 0;
+    bool answered = false;
+    client->request(call(u"b__hang"_s, u"x"_s), [&](const QMcpCallToolResult &, const QMcpJSONRPCErrorError *error) {
+        code = error ? error->code() : 0;
+        answered = true;
+    });
+    QTRY_VERIFY(pending);
+    m_proxy->removeUpstream(u"b"_s);
+    QTRY_VERIFY(answered);
+    QCOMPARE(code, QMcpServer::InternalErrorCode);
+}
+
+QTEST_MAIN(tst_QMcpProxy)
+
+#include "tst_qmcpproxy.moc"
@@ -0,0 +1,224 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpReadResourceResultContents>
+#include <QtMcpCommon/QMcpResource>
+#include <QtMcpCommon/QMcpResourceUpdatedNotification>
+#include <QtMcpCommon/QMcpSubscribeRequest>
+#include <QtMcpCommon/QMcpTextResourceContents>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+#include <QtMcpServer/QMcpServerSession>
+#include <QtMcpServer/QMcpServerStatistics>
+
+#include <memory>
+
+class tst_Coalescing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void offByDefault();
+    void burstIsSentOnce();
+    void maxLatencyBoundsTheDelay();
+    void perResourceOverride();
+    void endedSessionDropsPending();
+
+private:
+    bool startClient();
+    bool subscribe(const QUrl &uri);
+    // Replaces the resource's text, which raises resourceUpdated.
+    void edit(const QUrl &uri, const QString &text);
+    int updatesFor(const QUrl &uri) const;
+    quint64 coalesced() const;
+
+    QString m_name;
+    QMcpServer *m_server = nullptr;
+    std::unique_ptr<QMcpClient> m_client;
+    QMcpServerSession *m_session = nullptr;
+    QList<QUrl> m_updates;
+};
+
+void tst_Coalescing::init()
+{
+    m_name = u"tst_coalescing-%1"_s.arg(QTest::currentTestFunction());
+    m_server = new QMcpServer("inprocess"_L1, this);
+    QSignalSpy startedSpy(m_server, &QMcpServer::started);
+    m_server->start(m_name);
+    QCOMPARE(startedSpy.count(), 1);
+    m_updates.clear();
+}
+
+void tst_Coalescing::cleanup()
+{
+    m_client.reset();
+    delete m_server;
+    m_server = nullptr;
+    m_session = nullptr;
+}
+
+bool tst_Coalescing::startClient()
+{
+    m_client = std::make_unique<QMcpClient>("inprocess"_L1);
+    m_client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    m_client->addNotificationHandler([this](const QMcpResourceUpdatedNotification &notification) {
+        m_updates.append(notification.params().uri());
+    });
+    QSignalSpy startedSpy(m_client.get(), &QMcpClient::started);
+    m_client->start(m_name);
+    if (!startedSpy.wait(5000))
+        return false;
+    if (!QTest::qWaitFor([this]() { return m_server->sessions().size() == 1; }, 5000))
+        return false;
+    m_session = m_server->sessions().first();
+    return QTest::qWaitFor([this]() { return m_session->isInitialized(); }, 5000);
+}
+
+bool tst_Coalescing::subscribe(const QUrl &uri)
+{
+    QMcpTextResourceContents content;
+    content.setUri(uri);
+    content.setText(u"initial"_s);
+    QMcpResource resource;
+    resource.setUri(uri);
+    resource.setName(uri.fileName());
+    m_session->appendResource(resource, QMcpReadResourceResultContents(content));
+
+    QMcpSubscribeRequest request;
+    auto params = request.params();
+    params.setUri(uri);
+    request.setParams(params);
+    bool answered = false;
+    m_client->request(request, [&answered](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+    });
+    return QTest::qWaitFor([&answered]() { return answered; }, 5000);
+}
+
+void tst_Coalescing::edit(const QUrl &uri, const QString &text)
+{
+    QMcpTextResourceContents content;
+    content.setUri(uri);
+    content.setText(text);
+    QMcpResource resource;
+    resource.setUri(uri);
+    resource.setName(uri.fileName());
+    m_session->replaceResource(uri, resource, QMcpReadResourceResultContents(content));
+}
+
+int tst_Coalescing::updatesFor(const QUrl &uri) const
+{
+    return m_updates.count(uri);
+}
+
+quint64 tst_Coalescing::coalesced() const
+{
+    return m_server->statistics().notificationsCoalesced().value(u"notifications/resources/updated"_s);
+}
+
+void tst_Coalescing::offByDefault()
+{
+    QCOMPARE(m_server->notificationCoalescingWindow(), 0);
+    QCOMPARE(m_server->notificationCoalescingMaxLatency(), 0);
+    QVERIFY(startClient());
+    const QUrl uri(u"file:///doc.txt"_s);
+    QVERIFY(subscribe(uri));
+
+    for (int i = 0; i < 5; ++i)
+        edit(uri, QString::number(i));
+    QTRY_COMPARE(updatesFor(uri), 5);
+    QCOMPARE(coalesced(), 0u);
+}
+
+void tst_Coalescing::burstIsSentOnce()
+{
+    m_server->setNotificationCoalescing(100);
+    QVERIFY(startClient());
+    const QUrl uri(u"file:///doc.txt"_s);
+    QVERIFY(subscribe(uri));
+
+    for (int i = 0; i < 50; ++i)
+        edit(uri, QString::number(i));
+    QTRY_COMPARE(updatesFor(uri), 1);
+    // Nothing else trickles in once the window closed.
+    QTest::qWait(250);
+    QCOMPARE(updatesFor(uri), 1);
+    QCOMPARE(coalesced(), 49u);
+    QVERIFY(m_server->statistics().toPrometheusText().contains(
+            "mcp_notifications_coalesced_total{method=\"notifications/resources/updated\"} 49"));
+
+    // The notification follows the last change, so a read sees it.
+    QCOMPARE(m_session->contents(uri).first().textResourceContents().text(), u"49"_s);
+}
+
+void tst_Coalescing::maxLatencyBoundsTheDelay()
+{
+    // Edits every 20 ms never leave the 100 ms window quiet; the bound
+    // still sends one at least every 300 ms.
+    m_server->setNotificationCoalescing(100, 300);
+    QVERIFY(startClient());
+    const QUrl uri(u"file:///doc.txt"_s);
+    QVERIFY(subscribe(uri));
+
+    QElapsedTimer timer;
+    timer.start();
+    int edits = 0;
+    while (timer.elapsed() < 1000) {
+        edit(uri, QString::number(edits++));
+        QTest::qWait(20);
+    }
+    QVERIFY2(updatesFor(uri) >= 2, qPrintable(QString::number(updatesFor(uri))));
+    QTRY_COMPARE(quint64(updatesFor(uri)) + coalesced(), quint64(edits));
+}
+
+void tst_Coalescing::perResourceOverride()
+{
+    const QUrl coalescedUri(u"file:///typed.txt"_s);
+    const QUrl plainUri(u"file:///plain.txt"_s);
+    m_server->setResourceUpdateCoalescing(coalescedUri, 100);
+    QVERIFY(startClient());
+    QVERIFY(subscribe(coalescedUri));
+    QVERIFY(subscribe(plainUri));
+
+    for (int i = 0; i < 10; ++i) {
+        edit(coalescedUri, QString::number(i));
+        edit(plainUri, QString::number(i));
+    }
+    QTRY_COMPARE(updatesFor(plainUri), 10);
+    QTRY_COMPARE(updatesFor(coalescedUri), 1);
+
+    // Dropping the override sends each one again.
+    m_server->setResourceUpdateCoalescing(coalescedUri, -1);
+    for (int i = 0; i < 3; ++i)
+        edit(coalescedUri, QString::number(i));
+    QTRY_COMPARE(updatesFor(coalescedUri), 4);
+}
+
+void tst_Coalescing::endedSessionDropsPending()
+{
+    m_server->setNotificationCoalescing(100);
+    QVERIFY(startClient());
+    const QUrl uri(u"file:///doc.txt"_s);
+    QVERIFY(subscribe(uri));
+
+    QSignalSpy endedSpy(m_server, &QMcpServer::sessionEnded);
+    edit(uri, u"last words"_s);
+    m_server->closeSession(m_session->sessionId());
+    QCOMPARE(endedSpy.count(), 1);
+    m_session = nullptr;
+    QTest::qWait(250);
+    QCOMPARE(m_updates.size(), 0);
+}
+
+QTEST_MAIN(tst_Coalescing)
+#include "tst_coalescing.moc"
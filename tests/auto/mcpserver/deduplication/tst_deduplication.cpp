@@ -0,0 +1,211 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QFuture>
+#include <QtCore/QPromise>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpReadResourceRequest>
+#include <QtMcpCommon/QMcpReadResourceResult>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+#include <QtMcpServer/QMcpServerSession>
+
+#include <memory>
+
+class tst_Deduplication : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void offByDefault();
+    void identicalRequestsShareOneRun();
+    void differentParamsRunSeparately();
+    void sessionScopeKeepsSessionsApart();
+    void serverScopeSharesAcrossSessions();
+    void sessionEndedBeforeDispatch();
+
+private:
+    std::unique_ptr<QMcpClient> startClient();
+    void read(QMcpClient *client, const QString &uri);
+
+    QString m_name;
+    QMcpServer *m_server = nullptr;
+    // Handler runs still to be answered.
+    QList<std::shared_ptr<QPromise<QMcpReadResourceResult>>> m_runs;
+    int m_answered = 0;
+};
+
+void tst_Deduplication::init()
+{
+    m_name = u"tst_deduplication-%1"_s.arg(QTest::currentTestFunction());
+    m_runs.clear();
+    m_answered = 0;
+    m_server = new QMcpServer("inprocess"_L1, this);
+    // An asynchronous handler stays in flight until the test answers it.
+    m_server->addRequestHandler([this](const QUuid &, const QMcpReadResourceRequest &, QMcpJSONRPCErrorError *) -> QFuture<QMcpReadResourceResult> {
+        auto promise = std::make_shared<QPromise<QMcpReadResourceResult>>();
+        promise->start();
+        m_runs.append(promise);
+        return promise->future();
+    });
+    QSignalSpy startedSpy(m_server, &QMcpServer::started);
+    m_server->start(m_name);
+    QCOMPARE(startedSpy.count(), 1);
+}
+
+void tst_Deduplication::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+    m_runs.clear();
+}
+
+std::unique_ptr<QMcpClient> tst_Deduplication::startClient()
+{
+    auto client = std::make_unique<QMcpClient>("inprocess"_L1);
+    client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+    client->start(m_name);
+    if (!startedSpy.wait(5000))
+        return nullptr;
+    return client;
+}
+
+void tst_Deduplication::read(QMcpClient *client, const QString &uri)
+{
+    QMcpReadResourceRequest request;
+    auto params = request.params();
+    params.setUri(QUrl(uri));
+    request.setParams(params);
+    client->request(request, [this](const QMcpReadResourceResult &, const QMcpJSONRPCErrorError *error) {
+        if (!error)
+            ++m_answered;
+    });
+}
+
+void tst_Deduplication::offByDefault()
+{
+    QCOMPARE(m_server->requestDeduplication("resources/read"_L1), QMcpServer::DeduplicationScope::None);
+    auto client = startClient();
+    QVERIFY(client);
+    read(client.get(), u"file:///a"_s);
+    read(client.get(), u"file:///a"_s);
+    QTRY_COMPARE(m_runs.size(), 2);
+    for (const auto &run : m_runs) {
+        run->addResult(QMcpReadResourceResult());
+        run->finish();
+    }
+    QTRY_COMPARE(m_answered, 2);
+}
+
+void tst_Deduplication::identicalRequestsShareOneRun()
+{
+    m_server->setRequestDeduplication("resources/read"_L1, QMcpServer::DeduplicationScope::Session);
+    auto client = startClient();
+    QVERIFY(client);
+    for (int i = 0; i < 3; ++i)
+        read(client.get(), u"file:///a"_s);
+    QTRY_COMPARE(m_runs.size(), 1);
+    QTest::qWait(50);
+    QCOMPARE(m_runs.size(), 1);
+
+    // Every request gets its own answer from the one run.
+    m_runs.first()->addResult(QMcpReadResourceResult());
+    m_runs.first()->finish();
+    QTRY_COMPARE(m_answered, 3);
+
+    // Once answered, the next request runs the handler again.
+    read(client.get(), u"file:///a"_s);
+    QTRY_COMPARE(m_runs.size(), 2);
+    m_runs.last()->addResult(QMcpReadResourceResult());
+    m_runs.last()->finish();
+    QTRY_COMPARE(m_answered, 4);
+}
+
+void tst_Deduplication::differentParamsRunSeparately()
+{
+    m_server->setRequestDeduplication("resources/read"_L1, QMcpServer::DeduplicationScope::Session);
+    auto client = startClient();
+    QVERIFY(client);
+    read(client.get(), u"file:///a"_s);
+    read(client.get(), u"file:///b"_s);
+    QTRY_COMPARE(m_runs.size(), 2);
+    for (const auto &run : m_runs) {
+        run->addResult(QMcpReadResourceResult());
+        run->finish();
+    }
+    QTRY_COMPARE(m_answered, 2);
+}
+
+void tst_Deduplication::sessionScopeKeepsSessionsApart()
+{
+    m_server->setRequestDeduplication("resources/read"_L1, QMcpServer::DeduplicationScope::Session);
+    auto first = startClient();
+    QVERIFY(first);
+    auto second = startClient();
+    QVERIFY(second);
+    read(first.get(), u"file:///a"_s);
+    read(second.get(), u"file:///a"_s);
+    QTRY_COMPARE(m_runs.size(), 2);
+    for (const auto &run : m_runs) {
+        run->addResult(QMcpReadResourceResult());
+        run->finish();
+    }
+    QTRY_COMPARE(m_answered, 2);
+}
+
+void tst_Deduplication::serverScopeSharesAcrossSessions()
+{
+    m_server->setRequestDeduplication("resources/read"_L1, QMcpServer::DeduplicationScope::Server);
+    auto first = startClient();
+    QVERIFY(first);
+    auto second = startClient();
+    QVERIFY(second);
+    read(first.get(), u"file:///a"_s);
+    QTRY_COMPARE(m_runs.size(), 1);
+    read(second.get(), u"file:///a"_s);
+    QTest::qWait(50);
+    QCOMPARE(m_runs.size(), 1);
+
+    m_runs.first()->addResult(QMcpReadResourceResult());
+    m_runs.first()->finish();
+    QTRY_COMPARE(m_answered, 2);
+}
+
+void tst_Deduplication::sessionEndedBeforeDispatch()
+{
+    m_server->setRequestDeduplication("resources/read"_L1, QMcpServer::DeduplicationScope::Session);
+    auto client = startClient();
+    QVERIFY(client);
+    QTRY_COMPARE(m_server->sessions().size(), 1);
+    const auto session = m_server->sessions().first()->sessionId();
+
+    // The request is received in the event posted first; the handler would
+    // run in one posted while receiving it, after the session ended.
+    read(client.get(), u"file:///a"_s);
+    QMetaObject::invokeMethod(m_server, [this, session]() {
+        m_server->closeSession(session);
+    }, Qt::QueuedConnection);
+    QTRY_VERIFY(m_server->sessions().isEmpty());
+    QTest::qWait(50);
+    QCOMPARE(m_runs.size(), 0);
+
+    // The server goes on serving the next session.
+    auto next = startClient();
+    QVERIFY(next);
+    read(next.get(), u"file:///a"_s);
+    QTRY_COMPARE(m_runs.size(), 1);
+    m_runs.first()->addResult(QMcpReadResourceResult());
+    m_runs.first()->finish();
+    QTRY_COMPARE(m_answered, 1);
+}
+
+QTEST_MAIN(tst_Deduplication)
+#include "tst_deduplication.moc"
@@ -0,0 +1,202 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpClient/QMcpClientBackendInterface>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpPingRequest>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpCommon/private/qmcpinprocesschannel_p.h>
+#include <QtMcpServer/QMcpServer>
+#include <QtMcpServer/QMcpServerBackendInterface>
+
+#include <cmath>
+#include <memory>
+
+class tst_InProcess : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void everyClientIsASession();
+    void unknownNameIsAnError();
+    void validatingKeepsWorking();
+    void validationWarnsAboutLoss();
+    void serverInAnotherThread();
+    void closingEndsTheSession();
+
+private:
+    std::unique_ptr<QMcpClient> startClient(const QString &name);
+    bool ping(QMcpClient *client);
+
+    QString m_name;
+    QMcpServer *m_server = nullptr;
+};
+
+void tst_InProcess::init()
+{
+    m_name = u"tst_inprocess-%1"_s.arg(QTest::currentTestFunction());
+    m_server = new QMcpServer("inprocess"_L1, this);
+    QSignalSpy startedSpy(m_server, &QMcpServer::started);
+    m_server->start(m_name);
+    QCOMPARE(startedSpy.count(), 1);
+}
+
+void tst_InProcess::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+std::unique_ptr<QMcpClient> tst_InProcess::startClient(const QString &name)
+{
+    auto client = std::make_unique<QMcpClient>("inprocess"_L1);
+    client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+    client->start(name);
+    if (!startedSpy.wait(5000))
+        return nullptr;
+    return client;
+}
+
+bool tst_InProcess::ping(QMcpClient *client)
+{
+    bool answered = false;
+    client->request(QMcpPingRequest(), [&answered](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+    });
+    return QTest::qWaitFor([&answered]() { return answered; }, 5000);
+}
+
+void tst_InProcess::everyClientIsASession()
+{
+    std::unique_ptr<QMcpClient> clients[2];
+    for (auto &client : clients) {
+        client = startClient(m_name);
+        QVERIFY(client);
+    }
+    QTRY_COMPARE(m_server->sessions().size(), 2);
+    for (auto &client : clients)
+        QVERIFY(ping(client.get()));
+}
+
+void tst_InProcess::unknownNameIsAnError()
+{
+    QMcpClient client("inprocess"_L1);
+    auto *backend = client.findChild<QMcpClientBackendInterface *>();
+    QVERIFY(backend);
+    QSignalSpy errorSpy(backend, &QMcpClientBackendInterface::errorOccurred);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("No in-process server named"_L1));
+    client.start(u"nobody-listens-here"_s);
+    QVERIFY(errorSpy.wait(5000));
+
+    // A name is served by one server at a time.
+    QMcpServer other("inprocess"_L1);
+    QSignalSpy otherStarted(&other, &QMcpServer::started);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("server start failed"_L1));
+    other.start(m_name);
+    QCOMPARE(otherStarted.count(), 0);
+}
+
+void tst_InProcess::validatingKeepsWorking()
+{
+    auto *serverBackend = m_server->findChild<QMcpServerBackendInterface *>();
+    QVERIFY(serverBackend);
+    QVERIFY(serverBackend->setProperty("validating", true));
+
+    QMcpClient client("inprocess"_L1);
+    client.setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    auto *clientBackend = client.findChild<QMcpClientBackendInterface *>();
+    QVERIFY(clientBackend);
+    QVERIFY(clientBackend->setProperty("validating", true));
+    QSignalSpy startedSpy(&client, &QMcpClient::started);
+    client.start(m_name);
+    QVERIFY(startedSpy.wait(5000));
+    QVERIFY(ping(&client));
+}
+
+void tst_InProcess::validationWarnsAboutLoss()
+{
+    const auto name = m_name + "-channel"_L1;
+    QObject context;
+    std::shared_ptr<QMcpInProcessChannel> server;
+    QVERIFY(QMcpInProcessChannel::listen(name, &context, [&server](std::shared_ptr<QMcpInProcessChannel> channel) {
+        server = std::move(channel);
+    }));
+    QList<QJsonObject> received;
+    auto client = QMcpInProcessChannel::connect(name, &context, [&received](const QJsonObject &object) {
+        received.append(object);
+    }, {});
+    QVERIFY(client);
+    QTRY_VERIFY(server);
+
+    // JSON has no NaN; what a remote peer would get is null.
+    const QJsonObject object { { "value"_L1, std::nan("") } };
+    server->send(object);
+    QTRY_COMPARE(received.size(), 1);
+    QVERIFY(std::isnan(received.first().value("value"_L1).toDouble()));
+
+    server->setValidating(true);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("changes when encoded as JSON"_L1));
+    server->send(object);
+    QTRY_COMPARE(received.size(), 2);
+    QVERIFY(received.last().value("value"_L1).isNull());
+
+    QMcpInProcessChannel::unlisten(name);
+}
+
+void tst_InProcess::serverInAnotherThread()
+{
+    const auto name = m_name + "-thread"_L1;
+    QThread thread;
+    auto *server = new QMcpServer("inprocess"_L1);
+    server->moveToThread(&thread);
+    connect(&thread, &QThread::finished, server, &QObject::deleteLater);
+    QSignalSpy startedSpy(server, &QMcpServer::started);
+    thread.start();
+    QMetaObject::invokeMethod(server, [server, name]() { server->start(name); });
+    QVERIFY(startedSpy.wait(5000));
+
+    {
+        auto client = startClient(name);
+        QVERIFY(client);
+        for (int i = 0; i < 10; ++i)
+            QVERIFY(ping(client.get()));
+    }
+
+    thread.quit();
+    QVERIFY(thread.wait(5000));
+}
+
+void tst_InProcess::closingEndsTheSession()
+{
+    auto client = startClient(m_name);
+    QVERIFY(client);
+    QTRY_COMPARE(m_server->sessions().size(), 1);
+    QVERIFY(ping(client.get()));
+
+    // The client going away leaves the server serving others.
+    client.reset();
+    auto other = startClient(m_name);
+    QVERIFY(other);
+    QVERIFY(ping(other.get()));
+
+    // A server going away finishes its clients.
+    auto *otherBackend = other->findChild<QMcpClientBackendInterface *>();
+    QSignalSpy finishedSpy(otherBackend, &QMcpClientBackendInterface::finished);
+    cleanup();
+    QVERIFY(finishedSpy.wait(5000));
+}
+
+QTEST_MAIN(tst_InProcess)
+#include "tst_inprocess.moc"
@@ -85,6 +85,18 @@ public:
     const QMetaObject *metaObject() const override { return &staticMetaObject; }
 };
 
+// Handled by a future that only looks at its request after the event loop
+// has turned, when other requests on the session have been dispatched.
+class MrtrDeferredRequest : public RawParamsRequest
+{
+    Q_GADGET
+
+public:
+    QString method() const final { return "test/mrtr-deferred"_L1; }
+
+    const QMetaObject *metaObject() const override { return &staticMetaObject; }
+};
+
 // What a request callback recorded. Held by shared_ptr so that a late answer,
 // arriving after the waiting helper gave up, cannot write to a destroyed stack
 // frame.
@@ -132,6 +144,7 @@ private slots:
     void aRetryCarryingTheResponsesCompletesTheRequest();
     void requireInputIsInertBeforeItsRevision();
     void anAsyncHandlerAnswersTheInterimResultExactlyOnce();
+    void concurrentRequestsKeepTheirOwnContext();
 
 private:
     QMcpServer *m_server = nullptr;
@@ -224,6 +237,30 @@ void tst_Mrtr::init()
         return future;
     });
 
+    // Reads its input only once the request is no longer the session's
+    // current one, through the context it kept.
+    m_server->addRequestHandler([this](const QUuid &sessionId, const MrtrDeferredRequest &,
+                                       QMcpJSONRPCErrorError *) -> QFuture<QMcpEmptyResult> {
+        ++m_handlerCalls;
+        auto *serverSession = sessionFor(sessionId);
+        auto context = serverSession ? serverSession->currentRequest() : QMcpRequestContext();
+
+        auto promise = std::make_shared<QPromise<QMcpEmptyResult>>();
+        promise->start();
+        auto future = promise->future();
+        QTimer::singleShot(100, this, [this, promise, context]() mutable {
+            if (context.inputResponses().isEmpty()) {
+                context.requireInput(nameElicitation(), kRequestState);
+            } else {
+                m_seenInputResponses = context.inputResponses();
+                m_seenRequestState = context.clientRequestState();
+            }
+            promise->addResult(QMcpEmptyResult());
+            promise->finish();
+        });
+        return future;
+    });
+
     m_server->start("127.0.0.1:10103"_L1);
 
     m_client = new QMcpClient("sse"_L1, this);
@@ -417,5 +454,48 @@ void tst_Mrtr::anAsyncHandlerAnswersTheInterimResultExactlyOnce()
     QVERIFY(!state->answered);
 }
 
+void tst_Mrtr::concurrentRequestsKeepTheirOwnContext()
+{
+    m_client->setProtocolVersion(QtMcp::ProtocolVersion::v2026_07_28);
+
+    QSignalSpy inputRequiredSpy(m_client, &QMcpClient::inputRequired);
+
+    // A first attempt and a retry in flight on the same session at once: the
+    // retry's input must neither reach the first attempt nor be lost to it.
+    auto first = std::make_shared<CallState>();
+    m_client->request(MrtrDeferredRequest(), [first](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *) {
+        first->answered = true;
+    });
+
+    MrtrDeferredRequest retry;
+    QJsonObject params;
+    params.insert("inputResponses"_L1, nameResponses());
+    params.insert("requestState"_L1, kRequestState);
+    retry.setParams(params);
+    auto second = std::make_shared<CallState>();
+    auto result = std::make_shared<std::optional<QMcpEmptyResult>>();
+    m_client->request(retry, [second, result](const QMcpEmptyResult &value, const QMcpJSONRPCErrorError *error) {
+        second->answered = true;
+        if (error)
+            second->errorCode = error->code();
+        else
+            *result = value;
+    });
+
+    QVERIFY(QTest::qWaitFor([second] { return second->answered; }, 5000));
+    QVERIFY(!second->errorCode);
+    QVERIFY(result->has_value());
+    QCOMPARE(result->value().resultType(), "complete"_L1);
+    QCOMPARE(m_seenInputResponses, nameResponses());
+    QCOMPARE(m_seenRequestState.toString(), kRequestState);
+
+    QTRY_COMPARE(inputRequiredSpy.count(), 1);
+    QVERIFY(!first->answered);
+    QCOMPARE(m_handlerCalls, 2);
+
+    // Neither request is current once its handler has returned.
+    QVERIFY(!session()->currentRequest().isValid());
+}
+
 QTEST_MAIN(tst_Mrtr)
 #include "tst_mrtr.moc"
@@ -0,0 +1,298 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QThread>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpCallToolRequest>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpTextContent>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+#include <QtMcpServer/QMcpServerSession>
+#include <QtMcpServer/QMcpToolResultWriter>
+
+#include <memory>
+
+class tst_PartialResults : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void writerWithoutRequestBuffers();
+    void streamedWhenAskedFor();
+    void bufferedWithoutOptIn();
+    void bufferLimitTruncates();
+    void workerKeepsOrder();
+    void droppedWriterFinishesWithError();
+    void serverThreadAndWorkerAppend();
+
+private:
+    bool startClient(bool partialResults);
+    // Calls the export tool for \a count lines and waits for its result.
+    bool callExport(int count, QMcpCallToolResult *result, const QString &progressToken = u"export"_s);
+    QStringList partialTexts() const;
+
+    QString m_name;
+    QMcpServer *m_server = nullptr;
+    std::unique_ptr<QMcpClient> m_client;
+    QList<QPair<QJsonValue, QList<QMcpCallToolResultContent>>> m_partials;
+    int m_partialsAtResult = -1;
+};
+
+void tst_PartialResults::init()
+{
+    m_name = u"tst_partialresults-%1"_s.arg(QTest::currentTestFunction());
+    m_server = new QMcpServer("inprocess"_L1, this);
+    m_server->addTool(u"export"_s, { u"count"_s }, [](QMcpToolResultWriter writer, int count) {
+        for (int i = 0; i < count; ++i) {
+            if (!writer.append(QMcpTextContent(u"line %1"_s.arg(i))))
+                break;
+        }
+        writer.finish();
+    });
+    QSignalSpy startedSpy(m_server, &QMcpServer::started);
+    m_server->start(m_name);
+    QCOMPARE(startedSpy.count(), 1);
+    m_partials.clear();
+    m_partialsAtResult = -1;
+}
+
+void tst_PartialResults::cleanup()
+{
+    m_client.reset();
+    delete m_server;
+    m_server = nullptr;
+}
+
+bool tst_PartialResults::startClient(bool partialResults)
+{
+    m_client = std::make_unique<QMcpClient>("inprocess"_L1);
+    m_client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    m_client->setPartialToolResultsEnabled(partialResults);
+    connect(m_client.get(), &QMcpClient::partialToolResult, this,
+            [this](const QJsonValue &progressToken, const QList<QMcpCallToolResultContent> &content) {
+        m_partials.append(qMakePair(progressToken, content));
+    });
+    QSignalSpy startedSpy(m_client.get(), &QMcpClient::started);
+    m_client->start(m_name);
+    if (!startedSpy.wait(5000))
+        return false;
+    if (!QTest::qWaitFor([this]() { return m_server->sessions().size() == 1; }, 5000))
+        return false;
+    auto *session = m_server->sessions().first();
+    return QTest::qWaitFor([session]() { return session->isInitialized(); }, 5000);
+}
+
+bool tst_PartialResults::callExport(int count, QMcpCallToolResult *result, const QString &progressToken)
+{
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(u"export"_s);
+    params.setArguments(QJsonObject { { "count"_L1, count } });
+    auto meta = params.meta();
+    meta.setProgressToken(progressToken);
+    params.setMeta(meta);
+    request.setParams(params);
+    bool answered = false;
+    m_client->request(request, [this, &answered, result](const QMcpCallToolResult &r, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+        *result = r;
+        m_partialsAtResult = m_partials.size();
+    });
+    return QTest::qWaitFor([&answered]() { return answered; }, 5000);
+}
+
+QStringList tst_PartialResults::partialTexts() const
+{
+    QStringList texts;
+    for (const auto &partial : m_partials) {
+        for (const auto &content : partial.second)
+            texts.append(content.textContent().text());
+    }
+    return texts;
+}
+
+void tst_PartialResults::writerWithoutRequestBuffers()
+{
+    QMcpToolResultWriter invalid;
+    QVERIFY(!invalid.isValid());
+    QVERIFY(!invalid.append(QMcpTextContent(u"lost"_s)));
+
+    QMcpToolResultWriter writer { QMcpRequestContext() };
+    QVERIFY(writer.isValid());
+    QVERIFY(!writer.isStreaming());
+    QVERIFY(writer.append(QMcpTextContent(u"a"_s)));
+    QVERIFY(writer.append({ QMcpTextContent(u"b"_s), QMcpTextContent(u"c"_s) }));
+    QVERIFY(!writer.future().isFinished());
+    writer.finish();
+    QVERIFY(writer.isFinished());
+    QVERIFY(!writer.append(QMcpTextContent(u"late"_s)));
+
+    const auto result = writer.future().result();
+    QCOMPARE(result.content().size(), 3);
+    QCOMPARE(result.content().at(2).textContent().text(), u"c"_s);
+    QVERIFY(!result.isError());
+}
+
+void tst_PartialResults::streamedWhenAskedFor()
+{
+    QVERIFY(startClient(true));
+    QMcpCallToolResult result;
+    QVERIFY(callExport(3, &result));
+
+    QCOMPARE(m_partialsAtResult, 3);
+    QCOMPARE(partialTexts(), QStringList({ u"line 0"_s, u"line 1"_s, u"line 2"_s }));
+    for (const auto &partial : std::as_const(m_partials))
+        QCOMPARE(partial.first.toString(), u"export"_s);
+    // Everything was sent ahead of the response.
+    QVERIFY(result.content().isEmpty());
+    QVERIFY(!result.isError());
+}
+
+void tst_PartialResults::bufferedWithoutOptIn()
+{
+    QVERIFY(startClient(false));
+    QMcpCallToolResult result;
+    QVERIFY(callExport(3, &result));
+
+    QVERIFY(m_partials.isEmpty());
+    QCOMPARE(result.content().size(), 3);
+    QCOMPARE(result.content().first().textContent().text(), u"line 0"_s);
+    QVERIFY(!result.isError());
+}
+
+void tst_PartialResults::bufferLimitTruncates()
+{
+    m_server->addTool(u"limited"_s, { u"count"_s }, [](QMcpToolResultWriter writer, int count) {
+        writer.setBufferLimit(200);
+        for (int i = 0; i < count; ++i) {
+            if (!writer.append(QMcpTextContent(u"line %1"_s.arg(i))))
+                break;
+        }
+        writer.finish();
+    });
+    QVERIFY(startClient(false));
+
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(u"limited"_s);
+    params.setArguments(QJsonObject { { "count"_L1, 1000 } });
+    request.setParams(params);
+    bool answered = false;
+    QMcpCallToolResult result;
+    m_client->request(request, [&answered, &result](const QMcpCallToolResult &r, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+        result = r;
+    });
+    QTRY_VERIFY(answered);
+
+    // Only what fit in the 200 bytes is kept, followed by the notice.
+    QVERIFY(result.isError());
+    QVERIFY(result.content().size() > 1);
+    QVERIFY(result.content().size() < 20);
+    QVERIFY(result.content().last().textContent().text().startsWith(u"Result truncated"_s));
+}
+
+void tst_PartialResults::workerKeepsOrder()
+{
+    m_server->addTool(u"worker"_s, { u"count"_s }, [](QMcpToolResultWriter writer, int count) {
+        auto *thread = QThread::create([writer, count]() mutable {
+            for (int i = 0; i < count; ++i)
+                writer.append(QMcpTextContent(u"line %1"_s.arg(i)));
+            writer.finish();
+        });
+        QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+        thread->start();
+    });
+    QVERIFY(startClient(true));
+
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(u"worker"_s);
+    params.setArguments(QJsonObject { { "count"_L1, 50 } });
+    auto meta = params.meta();
+    meta.setProgressToken(u"worker"_s);
+    params.setMeta(meta);
+    request.setParams(params);
+    bool answered = false;
+    QMcpCallToolResult result;
+    m_client->request(request, [this, &answered, &result](const QMcpCallToolResult &r, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+        result = r;
+        m_partialsAtResult = m_partials.size();
+    });
+    QTRY_VERIFY(answered);
+
+    // The response never overtakes content appended before finish().
+    QCOMPARE(m_partialsAtResult, 50);
+    const auto texts = partialTexts();
+    for (int i = 0; i < texts.size(); ++i)
+        QCOMPARE(texts.at(i), u"line %1"_s.arg(i));
+}
+
+void tst_PartialResults::droppedWriterFinishesWithError()
+{
+    QFuture<QMcpCallToolResult> future;
+    {
+        QMcpToolResultWriter writer { QMcpRequestContext() };
+        QVERIFY(writer.append(QMcpTextContent(u"a"_s)));
+        future = writer.future();
+    }
+    QVERIFY(future.isFinished());
+    QVERIFY(!future.isCanceled());
+    const auto result = future.result();
+    QVERIFY(result.isError());
+    QCOMPARE(result.content().first().textContent().text(), u"a"_s);
+    QVERIFY(result.content().last().textContent().text().startsWith(u"Result incomplete"_s));
+}
+
+void tst_PartialResults::serverThreadAndWorkerAppend()
+{
+    // The server thread appends while the worker waits for it to send.
+    m_server->addTool(u"mixed"_s, { u"count"_s }, [](QMcpToolResultWriter writer, int count) {
+        auto *thread = QThread::create([writer, count]() mutable {
+            for (int i = 0; i < count; ++i)
+                writer.append(QMcpTextContent(u"worker %1"_s.arg(i)));
+            writer.finish();
+        });
+        QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+        thread->start();
+        for (int i = 0; i < count; ++i)
+            writer.append(QMcpTextContent(u"server %1"_s.arg(i)));
+    });
+    QVERIFY(startClient(true));
+
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(u"mixed"_s);
+    params.setArguments(QJsonObject { { "count"_L1, 50 } });
+    auto meta = params.meta();
+    meta.setProgressToken(u"mixed"_s);
+    params.setMeta(meta);
+    request.setParams(params);
+    bool answered = false;
+    m_client->request(request, [this, &answered](const QMcpCallToolResult &, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+        m_partialsAtResult = m_partials.size();
+    });
+    QTRY_VERIFY(answered);
+
+    // Each thread's content keeps its order, and all of it comes first.
+    const auto texts = partialTexts();
+    const auto worker = texts.filter(u"worker "_s);
+    QCOMPARE(worker.size(), 50);
+    for (int i = 0; i < worker.size(); ++i)
+        QCOMPARE(worker.at(i), u"worker %1"_s.arg(i));
+    QCOMPARE(m_partialsAtResult, m_partials.size());
+    QVERIFY(m_partialsAtResult >= 50);
+}
+
+QTEST_MAIN(tst_PartialResults)
+#include "tst_partialresults.moc"
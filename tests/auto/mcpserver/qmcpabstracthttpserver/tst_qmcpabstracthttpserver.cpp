@@ -1,9 +1,12 @@
 // Copyright (C) 2025 Signal Slot Inc.
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
+#include <QSignalSpy>
 #include <QTest>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QUrlQuery>
 #include <QtCore/QTimer>
+#include <QtMcpCommon/private/qmcpcompression_p.h>
 #include <QtMcpServer/qmcpabstracthttpserver.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
@@ -11,6 +14,10 @@
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 class TestHttpServer : public QMcpAbstractHttpServer
 {
     Q_OBJECT
@@ -20,6 +27,7 @@ public:
 protected:
     Q_INVOKABLE QByteArray get() const;
     Q_INVOKABLE QByteArray getEcho(const QNetworkRequest &request) const;
+    Q_INVOKABLE QByteArray getSlow(const QNetworkRequest &request);
     Q_INVOKABLE QByteArray post(const QNetworkRequest &request, const QByteArray &body) const;
     Q_INVOKABLE QByteArray postEcho(const QNetworkRequest &request, const QByteArray &body) const;
     Q_INVOKABLE QByteArray getSse(const QNetworkRequest &request);
@@ -37,6 +45,15 @@ QByteArray TestHttpServer::getEcho(const QNetworkRequest &request) const
     return query.queryItemValue("message").toUtf8();
 }
 
+QByteArray TestHttpServer::getSlow(const QNetworkRequest &request)
+{
+    const auto id = deferResponse(request);
+    QTimer::singleShot(100, this, [this, id] {
+        completeResponse(id, 200, "slow"_ba, u"text/plain"_s);
+    });
+    return {};
+}
+
 QByteArray TestHttpServer::post(const QNetworkRequest &request, const QByteArray &body) const
 {
     Q_UNUSED(request);
@@ -85,8 +102,22 @@ private slots:
     void testPost_data();
     void testPost();
     void testSse();
+    void pipelinedRequestsAreAnsweredInOrder();
+    void chunkedBodyIsDecoded();
+    void oversizedHeadersAreRejected();
+    void idleConnectionsAreClosed();
+    void slowHeadersTimeOut();
+    void connectionLimitHoldsBackClients();
+    void drainFinishesResponsesInProgress();
+    void writesAreGatheredForTheDelay();
+    void compressionIsNegotiated();
+    void http2WithPriorKnowledge();
+    void http2Upgrade();
+    void http2MultiplexesRequests();
 
 private:
+    QByteArray exchange(const QByteArray &raw, const QByteArray &until);
+
     QNetworkAccessManager nam;
     TestHttpServer *server = nullptr;
     QTcpServer *tcpServer = nullptr;
@@ -273,5 +304,315 @@ void tst_QMcpAbstractHttpServer::testSse()
     qDebug() << __LINE__ << receivedData;
 }
 
+/*!
+    \internal
+    Writes \a raw on a new connection and reads until the received bytes
+    end with \a until, or the server closed the connection.
+*/
+QByteArray tst_QMcpAbstractHttpServer::exchange(const QByteArray &raw, const QByteArray &until)
+{
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    if (!socket.waitForConnected(1000))
+        return {};
+    socket.write(raw);
+
+    QByteArray received;
+    QEventLoop loop;
+    QTimer::singleShot(2000, &loop, &QEventLoop::quit);
+    connect(&socket, &QTcpSocket::readyRead, &loop, [&] {
+        received += socket.readAll();
+        if (received.endsWith(until))
+            loop.quit();
+    });
+    connect(&socket, &QTcpSocket::disconnected, &loop, &QEventLoop::quit);
+    loop.exec();
+    received += socket.readAll();
+    return received;
+}
+
+void tst_QMcpAbstractHttpServer::pipelinedRequestsAreAnsweredInOrder()
+{
+    const auto received = exchange("GET /slow HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                                   "GET /echo?message=fast HTTP/1.1\r\nHost: localhost\r\n\r\n"_ba,
+                                   "fast"_ba);
+    const auto slow = received.indexOf("slow");
+    const auto fast = received.indexOf("fast");
+    QVERIFY2(slow >= 0 && fast >= 0, received.constData());
+    QVERIFY(slow < fast);
+    QCOMPARE(received.count("HTTP/1.1 200"), 2);
+}
+
+void tst_QMcpAbstractHttpServer::chunkedBodyIsDecoded()
+{
+    const auto received = exchange("POST /echo HTTP/1.1\r\n"
+                                   "Host: localhost\r\n"
+                                   "Transfer-Encoding: chunked\r\n"
+                                   "\r\n"
+                                   "3\r\nabc\r\n"
+                                   "4;ext=1\r\ndefg\r\n"
+                                   "0\r\n\r\n"_ba,
+                                   "abcdefg"_ba);
+    QVERIFY2(received.startsWith("HTTP/1.1 200"), received.constData());
+    QVERIFY(received.endsWith("\r\n\r\nabcdefg"));
+}
+
+void tst_QMcpAbstractHttpServer::oversizedHeadersAreRejected()
+{
+    server->setMaxHeaderSize(1024);
+    QCOMPARE(server->maxHeaderSize(), qsizetype(1024));
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(socket.waitForConnected(1000));
+    socket.write("GET / HTTP/1.1\r\nX-Padding: " + QByteArray(2048, 'a') + "\r\n\r\n");
+
+    QByteArray received;
+    QEventLoop loop;
+    QTimer::singleShot(2000, &loop, &QEventLoop::quit);
+    connect(&socket, &QTcpSocket::readyRead, &loop, [&] { received += socket.readAll(); });
+    connect(&socket, &QTcpSocket::disconnected, &loop, &QEventLoop::quit);
+    loop.exec();
+    received += socket.readAll();
+
+    QVERIFY2(received.startsWith("HTTP/1.1 431"), received.constData());
+    QCOMPARE(socket.state(), QAbstractSocket::UnconnectedState);
+}
+
+void tst_QMcpAbstractHttpServer::idleConnectionsAreClosed()
+{
+    server->setIdleTimeout(200);
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(socket.waitForConnected(1000));
+    QTRY_COMPARE(server->connectionCount(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QAbstractSocket::UnconnectedState, 2000);
+    QTRY_COMPARE(server->connectionCount(), 0);
+}
+
+void tst_QMcpAbstractHttpServer::slowHeadersTimeOut()
+{
+    server->setReadHeaderTimeout(200);
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(socket.waitForConnected(1000));
+    socket.write("GET / HTTP/1.1\r\nX-Slow: ");
+
+    QByteArray received;
+    connect(&socket, &QTcpSocket::readyRead, this, [&] { received += socket.readAll(); });
+    // Trickling more bytes in does not buy more time.
+    QTimer trickle;
+    connect(&trickle, &QTimer::timeout, this, [&] { socket.write("a"); });
+    trickle.start(50);
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QAbstractSocket::UnconnectedState, 2000);
+    QVERIFY2(received.startsWith("HTTP/1.1 408"), received.constData());
+}
+
+void tst_QMcpAbstractHttpServer::connectionLimitHoldsBackClients()
+{
+    server->setMaxConnections(1);
+
+    QTcpSocket first;
+    first.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(first.waitForConnected(1000));
+    QTRY_COMPARE(server->connectionCount(), 1);
+
+    // Connected by the kernel, but not served until there is room.
+    QTcpSocket second;
+    second.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(second.waitForConnected(1000));
+    second.write("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QTest::qWait(300);
+    QCOMPARE(second.bytesAvailable(), 0);
+    QCOMPARE(server->connectionCount(), 1);
+
+    first.disconnectFromHost();
+    QTRY_VERIFY(second.bytesAvailable() > 0);
+    QVERIFY(second.readAll().startsWith("HTTP/1.1 200"));
+    QCOMPARE(server->connectionCount(), 1);
+}
+
+void tst_QMcpAbstractHttpServer::drainFinishesResponsesInProgress()
+{
+    QTcpSocket busy;
+    busy.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(busy.waitForConnected(1000));
+    QTcpSocket idle;
+    idle.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(idle.waitForConnected(1000));
+    QTRY_COMPARE(server->connectionCount(), 2);
+
+    QByteArray received;
+    connect(&busy, &QTcpSocket::readyRead, this, [&] { received += busy.readAll(); });
+    busy.write("GET /slow HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    // Deferred for 100 ms, so still in progress when draining starts.
+    QTest::qWait(50);
+
+    QSignalSpy drained(server, &QMcpAbstractHttpServer::drained);
+    server->drain();
+    QVERIFY(server->isDraining());
+    QTRY_COMPARE(idle.state(), QAbstractSocket::UnconnectedState);
+    QCOMPARE(drained.size(), 0);
+
+    QTRY_COMPARE(drained.size(), 1);
+    QVERIFY2(received.startsWith("HTTP/1.1 200"), received.constData());
+    QVERIFY(received.contains("Connection: close\r\n"));
+    QVERIFY(received.endsWith("slow"));
+    QCOMPARE(server->connectionCount(), 0);
+}
+
+void tst_QMcpAbstractHttpServer::writesAreGatheredForTheDelay()
+{
+    server->setWriteCoalescingDelay(300);
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(socket.waitForConnected(1000));
+    socket.write("GET /echo?message=a HTTP/1.1\r\n\r\n"
+                 "GET /echo?message=b HTTP/1.1\r\n\r\n");
+    QTest::qWait(100);
+    QCOMPARE(socket.bytesAvailable(), 0);
+
+    QByteArray received;
+    QTRY_VERIFY((received += socket.readAll()).endsWith("\r\n\r\nb"));
+    QCOMPARE(received.count("HTTP/1.1 200"), 2);
+
+    // Past the threshold, output does not wait.
+    server->setWriteCoalescingThreshold(1);
+    socket.write("GET /echo?message=c HTTP/1.1\r\n\r\n");
+    QTRY_VERIFY_WITH_TIMEOUT(socket.bytesAvailable() > 0, 200);
+}
+
+void tst_QMcpAbstractHttpServer::compressionIsNegotiated()
+{
+    QByteArray text;
+    while (text.size() < 4096)
+        text += "The quick brown fox jumps over the lazy dog. ";
+    const auto gzipped = QMcpCompression::compress(text, QMcpCompression::Encoding::Gzip);
+
+    // A compressed request body is decoded, the response compressed.
+    auto received = exchange("POST /echo HTTP/1.1\r\n"
+                             "Accept-Encoding: deflate;q=0.5, gzip\r\n"
+                             "Content-Encoding: gzip\r\n"
+                             "Content-Length: " + QByteArray::number(gzipped.size()) + "\r\n"
+                             "\r\n" + gzipped,
+                             gzipped);
+    QVERIFY2(received.startsWith("HTTP/1.1 200"), received.constData());
+    QVERIFY(received.contains("\r\nContent-Encoding: gzip\r\n"));
+    QVERIFY(received.contains("\r\nContent-Length: " + QByteArray::number(gzipped.size()) + "\r\n"));
+    QVERIFY(received.endsWith("\r\n\r\n" + gzipped));
+
+    // Below the threshold, or not accepted, it is not.
+    received = exchange("GET /echo?message=short HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n"_ba,
+                        "short"_ba);
+    QVERIFY(!received.contains("Content-Encoding"));
+    received = exchange("POST /echo HTTP/1.1\r\nContent-Length: " + QByteArray::number(text.size())
+                        + "\r\n\r\n" + text, text);
+    QVERIFY(!received.contains("Content-Encoding"));
+    // The client is told that it may compress what it sends.
+    QVERIFY(received.contains("\r\nAccept-Encoding: gzip, deflate\r\n"));
+
+    received = exchange("POST /echo HTTP/1.1\r\nContent-Encoding: br\r\nContent-Length: 3\r\n\r\nabc"_ba,
+                        "Content-Encoding"_ba);
+    QVERIFY2(received.startsWith("HTTP/1.1 415"), received.constData());
+    QVERIFY(received.contains("\r\nAccept-Encoding: gzip, deflate\r\n"));
+
+    server->setCompressionThreshold(-1);
+    received = exchange("POST /echo HTTP/1.1\r\nAccept-Encoding: gzip\r\nContent-Length: "
+                        + QByteArray::number(text.size()) + "\r\n\r\n" + text, text);
+    QVERIFY(!received.contains("Content-Encoding"));
+}
+
+void tst_QMcpAbstractHttpServer::http2WithPriorKnowledge()
+{
+    if (!server->isHttp2Enabled())
+        QSKIP("Built without the mcp-h2c feature");
+    QNetworkAccessManager manager;
+    QUrl url("http://127.0.0.1/echo?message=h2"_L1);
+    url.setPort(port);
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+
+    std::unique_ptr<QNetworkReply> reply(manager.get(request));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+    QCOMPARE(reply->readAll(), "h2"_ba);
+
+    // Bodies and deferred responses work on streams as on connections.
+    url.setQuery(QString());
+    request.setUrl(url);
+    reply.reset(manager.post(request, "posted"_ba));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->readAll(), "posted"_ba);
+    url.setPath("/slow"_L1);
+    request.setUrl(url);
+    reply.reset(manager.get(request));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->readAll(), "slow"_ba);
+    QCOMPARE(server->connectionCount(), 1);
+
+    // Turned off, the preface is no request.
+    server->setHttp2Enabled(false);
+    QNetworkAccessManager other;
+    reply.reset(other.get(request));
+    QTRY_VERIFY(reply->isFinished());
+    QVERIFY(reply->error() != QNetworkReply::NoError);
+}
+
+void tst_QMcpAbstractHttpServer::http2Upgrade()
+{
+    if (!server->isHttp2Enabled())
+        QSKIP("Built without the mcp-h2c feature");
+    QNetworkAccessManager manager;
+    QUrl url("http://127.0.0.1/echo?message=upgraded"_L1);
+    url.setPort(port);
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2CleartextAllowedAttribute, true);
+
+    std::unique_ptr<QNetworkReply> reply(manager.get(request));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+    QCOMPARE(reply->readAll(), "upgraded"_ba);
+
+    // The upgraded connection goes on in HTTP/2.
+    reply.reset(manager.post(request, "after"_ba));
+    QTRY_VERIFY(reply->isFinished());
+    QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+    QCOMPARE(reply->readAll(), "after"_ba);
+    QCOMPARE(server->connectionCount(), 1);
+}
+
+void tst_QMcpAbstractHttpServer::http2MultiplexesRequests()
+{
+    if (!server->isHttp2Enabled())
+        QSKIP("Built without the mcp-h2c feature");
+    QNetworkAccessManager manager;
+    QUrl url("http://127.0.0.1/slow"_L1);
+    url.setPort(port);
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+
+    std::vector<std::unique_ptr<QNetworkReply>> replies;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 10; ++i)
+        replies.emplace_back(manager.get(request));
+    QTRY_VERIFY(std::all_of(replies.cbegin(), replies.cend(), [](const auto &reply) {
+        return reply->isFinished();
+    }));
+    // Answered side by side: ten deferred responses of 100 ms each take
+    // far less than a second on one connection.
+    QVERIFY(timer.elapsed() < 900);
+    for (const auto &reply : replies) {
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll(), "slow"_ba);
+    }
+    QCOMPARE(server->connectionCount(), 1);
+}
+
 QTEST_MAIN(tst_QMcpAbstractHttpServer)
 #include "tst_qmcpabstracthttpserver.moc"
@@ -0,0 +1,235 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtMcpServer/private/qmcphttprequestparser_p.h>
+#include <QtTest/QTest>
+
+using Status = QMcpHttpRequestParser::Status;
+
+class tst_QMcpHttpRequestParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void simpleRequest();
+    void byteByByte();
+    void pipelinedRequestsComeInOrder();
+    void chunkedBodyIsDecoded();
+    void bareLineFeedsAreAccepted();
+    void leadingEmptyLinesAreIgnored();
+    void keepAlive_data();
+    void keepAlive();
+    void rejects_data();
+    void rejects();
+    void emptyLineFloodIsRejected();
+    void announcedBodyIsNotReservedUpFront();
+};
+
+void tst_QMcpHttpRequestParser::simpleRequest()
+{
+    QMcpHttpRequestParser parser;
+    parser.feed("POST /mcp?x=1 HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Content-Type: application/json\r\n"
+                "Content-Length: 2\r\n"
+                "\r\n"
+                "{}");
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    const auto request = parser.takeRequest();
+    QCOMPARE(request.method, "POST"_ba);
+    QCOMPARE(request.path, "/mcp"_ba);
+    QCOMPARE(request.query, "x=1"_ba);
+    QCOMPARE(request.minorVersion, 1);
+    QCOMPARE(request.headers.value("content-type"_L1), "application/json"_ba);
+    QCOMPARE(request.body, "{}"_ba);
+    QVERIFY(request.keepAlive);
+    QCOMPARE(parser.parse(), Status::NeedMoreData);
+    QVERIFY(!parser.hasPendingData());
+}
+
+void tst_QMcpHttpRequestParser::byteByByte()
+{
+    const QByteArray raw = "POST /mcp HTTP/1.1\r\n"
+                           "Content-Length: 11\r\n"
+                           "\r\n"
+                           "hello world"_ba;
+    QMcpHttpRequestParser parser;
+    for (qsizetype i = 0; i < raw.size() - 1; ++i) {
+        parser.feed(raw.sliced(i, 1));
+        QCOMPARE(parser.parse(), Status::NeedMoreData);
+    }
+    parser.feed(raw.sliced(raw.size() - 1));
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    QCOMPARE(parser.takeRequest().body, "hello world"_ba);
+}
+
+void tst_QMcpHttpRequestParser::pipelinedRequestsComeInOrder()
+{
+    QMcpHttpRequestParser parser;
+    parser.feed("GET /first HTTP/1.1\r\n\r\n"
+                "POST /second HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+                "GET /thi");
+
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    // Parsing again without taking the request does not move on.
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    QCOMPARE(parser.takeRequest().path, "/first"_ba);
+
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    const auto second = parser.takeRequest();
+    QCOMPARE(second.path, "/second"_ba);
+    QCOMPARE(second.body, "abc"_ba);
+
+    QCOMPARE(parser.parse(), Status::NeedMoreData);
+    QVERIFY(parser.hasPendingData());
+    parser.feed("rd HTTP/1.1\r\n\r\n");
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    QCOMPARE(parser.takeRequest().path, "/third"_ba);
+}
+
+void tst_QMcpHttpRequestParser::chunkedBodyIsDecoded()
+{
+    QMcpHttpRequestParser parser;
+    parser.feed("POST /mcp HTTP/1.1\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "5\r\nhello\r\n"
+                "1;name=value\r\n \r\n"
+                "A\r\n");
+    QCOMPARE(parser.parse(), Status::NeedMoreData);
+    parser.feed("0123456789\r\n"
+                "0\r\n"
+                "Trailer: ignored\r\n"
+                "\r\n");
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    QCOMPARE(parser.takeRequest().body, "hello 0123456789"_ba);
+}
+
+void tst_QMcpHttpRequestParser::bareLineFeedsAreAccepted()
+{
+    QMcpHttpRequestParser parser;
+    parser.feed("GET /mcp HTTP/1.1\nAccept: text/event-stream\n\n");
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    QCOMPARE(parser.takeRequest().headers.value("accept"_L1), "text/event-stream"_ba);
+}
+
+void tst_QMcpHttpRequestParser::leadingEmptyLinesAreIgnored()
+{
+    QMcpHttpRequestParser parser;
+    parser.feed("\r\n\r\nGET / HTTP/1.1\r\n\r\n");
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    QCOMPARE(parser.takeRequest().path, "/"_ba);
+}
+
+void tst_QMcpHttpRequestParser::keepAlive_data()
+{
+    QTest::addColumn<QByteArray>("raw");
+    QTest::addColumn<bool>("keepAlive");
+
+    QTest::newRow("1.1") << "GET / HTTP/1.1\r\n\r\n"_ba << true;
+    QTest::newRow("1.1 close") << "GET / HTTP/1.1\r\nConnection: Upgrade, close\r\n\r\n"_ba << false;
+    QTest::newRow("1.0") << "GET / HTTP/1.0\r\n\r\n"_ba << false;
+    QTest::newRow("1.0 keep-alive") << "GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"_ba << true;
+}
+
+void tst_QMcpHttpRequestParser::keepAlive()
+{
+    QFETCH(QByteArray, raw);
+    QFETCH(bool, keepAlive);
+
+    QMcpHttpRequestParser parser;
+    parser.feed(raw);
+    QCOMPARE(parser.parse(), Status::RequestReady);
+    QCOMPARE(parser.takeRequest().keepAlive, keepAlive);
+}
+
+void tst_QMcpHttpRequestParser::rejects_data()
+{
+    QTest::addColumn<QByteArray>("raw");
+    QTest::addColumn<int>("statusCode");
+
+    const QByteArray get = "GET / HTTP/1.1\r\n"_ba;
+    const QByteArray chunked = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"_ba;
+
+    QTest::newRow("garbage") << "HELLO\r\n"_ba << 400;
+    QTest::newRow("no version") << "GET /\r\n"_ba << 400;
+    QTest::newRow("bad method") << "G(T / HTTP/1.1\r\n"_ba << 400;
+    QTest::newRow("relative target") << "GET mcp HTTP/1.1\r\n"_ba << 400;
+    QTest::newRow("control in target") << "GET /a\x01 HTTP/1.1\r\n"_ba << 400;
+    QTest::newRow("http/2") << "GET / HTTP/2.0\r\n"_ba << 505;
+    QTest::newRow("space before colon") << get + "Host : x\r\n\r\n" << 400;
+    QTest::newRow("no colon") << get + "Host\r\n\r\n" << 400;
+    QTest::newRow("line folding") << get + "X-A: a\r\n b\r\n\r\n" << 400;
+    QTest::newRow("both framings") << get + "Content-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n" << 400;
+    QTest::newRow("conflicting lengths") << get + "Content-Length: 3\r\nContent-Length: 4\r\n\r\n" << 400;
+    QTest::newRow("conflicting list") << get + "Content-Length: 3, 4\r\n\r\n" << 400;
+    QTest::newRow("negative length") << get + "Content-Length: -1\r\n\r\n" << 400;
+    QTest::newRow("signed length") << get + "Content-Length: +1\r\n\r\n" << 400;
+    QTest::newRow("overflowing length") << get + "Content-Length: 99999999999999999999\r\n\r\n" << 400;
+    QTest::newRow("length over limit") << get + "Content-Length: 17000000\r\n\r\n" << 413;
+    QTest::newRow("gzip coding") << get + "Transfer-Encoding: gzip\r\n\r\n" << 501;
+    QTest::newRow("chunked then gzip") << get + "Transfer-Encoding: chunked, gzip\r\n\r\n" << 501;
+    QTest::newRow("chunked in 1.0") << "POST / HTTP/1.0\r\nTransfer-Encoding: chunked\r\n\r\n"_ba << 400;
+    QTest::newRow("bad chunk size") << chunked + "zz\r\n" << 400;
+    QTest::newRow("empty chunk size") << chunked + "\r\n" << 400;
+    QTest::newRow("overflowing chunk size") << chunked + "ffffffffffffffffff\r\n" << 400;
+    QTest::newRow("chunk over limit") << chunked + "1000001\r\n" << 413;
+    QTest::newRow("chunk longer than size") << chunked + "3\r\nabcd\r\n" << 400;
+    QTest::newRow("endless chunk line") << chunked + "1" + QByteArray(2000, ';') << 400;
+    QTest::newRow("request line too long") << "GET /" + QByteArray(70000, 'a') << 414;
+    QTest::newRow("header too large") << get + "X-A: " + QByteArray(70000, 'a') << 431;
+
+    QByteArray manyHeaders = get;
+    for (int i = 0; i < 101; ++i)
+        manyHeaders += "X-" + QByteArray::number(i) + ": x\r\n";
+    QTest::newRow("too many headers") << manyHeaders + "\r\n" << 431;
+}
+
+void tst_QMcpHttpRequestParser::rejects()
+{
+    QFETCH(QByteArray, raw);
+    QFETCH(int, statusCode);
+
+    QMcpHttpRequestParser parser;
+    parser.feed(raw);
+    QCOMPARE(parser.parse(), Status::Error);
+    QCOMPARE(parser.errorStatusCode(), statusCode);
+    QVERIFY(!parser.errorString().isEmpty());
+    // A failed parser stays failed; the connection is to be closed.
+    parser.feed("GET / HTTP/1.1\r\n\r\n");
+    QCOMPARE(parser.parse(), Status::Error);
+
+    // Fed in pieces, the verdict is the same.
+    QMcpHttpRequestParser pieces;
+    auto status = Status::NeedMoreData;
+    for (qsizetype i = 0; i < raw.size() && status == Status::NeedMoreData; i += 7) {
+        pieces.feed(raw.sliced(i, qMin(qsizetype(7), raw.size() - i)));
+        status = pieces.parse();
+    }
+    QCOMPARE(status, Status::Error);
+    QCOMPARE(pieces.errorStatusCode(), statusCode);
+}
+
+void tst_QMcpHttpRequestParser::emptyLineFloodIsRejected()
+{
+    QMcpHttpRequestParser parser;
+    parser.setMaxHeaderSize(1024);
+    auto status = Status::NeedMoreData;
+    for (int i = 0; i < 1000 && status == Status::NeedMoreData; ++i) {
+        parser.feed("\r\n");
+        status = parser.parse();
+    }
+    QCOMPARE(status, Status::Error);
+}
+
+void tst_QMcpHttpRequestParser::announcedBodyIsNotReservedUpFront()
+{
+    QMcpHttpRequestParser parser;
+    parser.setMaxBodySize(std::numeric_limits<qint64>::max());
+    parser.feed("POST / HTTP/1.1\r\nContent-Length: 999999999999\r\n\r\nabc");
+    QCOMPARE(parser.parse(), Status::NeedMoreData);
+    QVERIFY(parser.hasPendingData());
+}
+
+QTEST_MAIN(tst_QMcpHttpRequestParser)
+#include "tst_qmcphttprequestparser.moc"
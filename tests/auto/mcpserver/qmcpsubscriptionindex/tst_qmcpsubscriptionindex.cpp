@@ -0,0 +1,153 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtMcpServer/private/qmcpsubscriptionindex_p.h>
+#include <QtTest/QTest>
+
+using namespace Qt::Literals::StringLiterals;
+
+class tst_QMcpSubscriptionIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void exactUri();
+    void prefix();
+    void uriTemplate_data();
+    void uriTemplate();
+    void subscribersAreNotRepeated();
+    void subscriptionsAreCounted();
+    void removeSubscriber();
+    void manySessions();
+};
+
+void tst_QMcpSubscriptionIndex::exactUri()
+{
+    QMcpSubscriptionIndex index;
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    index.subscribe(a, "file:///a.txt"_L1);
+    index.subscribe(b, "file:///b.txt"_L1);
+
+    QCOMPARE(index.subscribers("file:///a.txt"_L1), QList<QUuid>{ a });
+    QCOMPARE(index.subscribers("file:///b.txt"_L1), QList<QUuid>{ b });
+    QVERIFY(index.subscribers("file:///a.txt.bak"_L1).isEmpty());
+    QVERIFY(index.isSubscribed(a, "file:///a.txt"_L1));
+    QVERIFY(!index.isSubscribed(a, "file:///b.txt"_L1));
+}
+
+void tst_QMcpSubscriptionIndex::prefix()
+{
+    QMcpSubscriptionIndex index;
+    const auto a = QUuid::createUuid();
+    index.subscribe(a, "file:///logs/*"_L1);
+
+    QCOMPARE(index.subscribers("file:///logs/today.log"_L1), QList<QUuid>{ a });
+    QCOMPARE(index.subscribers("file:///logs/2025/01.log"_L1), QList<QUuid>{ a });
+    QVERIFY(index.subscribers("file:///log"_L1).isEmpty());
+    QVERIFY(index.subscribers("file:///other/today.log"_L1).isEmpty());
+    QVERIFY(index.isSubscribed(a, "file:///logs/today.log"_L1));
+}
+
+void tst_QMcpSubscriptionIndex::uriTemplate_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("uri");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("simple") << u"db://tables/{name}"_s << u"db://tables/users"_s << true;
+    QTest::newRow("simple stops at slash") << u"db://tables/{name}"_s << u"db://tables/users/rows"_s << false;
+    QTest::newRow("reserved crosses slash") << u"file:///{+path}"_s << u"file:///a/b/c.txt"_s << true;
+    QTest::newRow("two expressions") << u"db://{schema}/{table}"_s << u"db://public/users"_s << true;
+    QTest::newRow("literal suffix") << u"db://tables/{name}/schema"_s << u"db://tables/users/schema"_s << true;
+    QTest::newRow("literal suffix differs") << u"db://tables/{name}/schema"_s << u"db://tables/users/rows"_s << false;
+    QTest::newRow("prefix differs") << u"db://tables/{name}"_s << u"db://views/users"_s << false;
+    QTest::newRow("dot is literal") << u"file:///{name}.txt"_s << u"file:///axtxt"_s << false;
+}
+
+void tst_QMcpSubscriptionIndex::uriTemplate()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, uri);
+    QFETCH(bool, matches);
+
+    QMcpSubscriptionIndex index;
+    const auto a = QUuid::createUuid();
+    index.subscribe(a, pattern);
+    QCOMPARE(index.subscribers(uri).contains(a), matches);
+    QCOMPARE(index.isSubscribed(a, uri), matches);
+}
+
+void tst_QMcpSubscriptionIndex::subscribersAreNotRepeated()
+{
+    QMcpSubscriptionIndex index;
+    const auto a = QUuid::createUuid();
+    index.subscribe(a, "file:///logs/today.log"_L1);
+    index.subscribe(a, "file:///logs/*"_L1);
+    index.subscribe(a, "file:///{+path}"_L1);
+
+    QCOMPARE(index.subscribers("file:///logs/today.log"_L1), QList<QUuid>{ a });
+}
+
+void tst_QMcpSubscriptionIndex::subscriptionsAreCounted()
+{
+    QMcpSubscriptionIndex index;
+    const auto a = QUuid::createUuid();
+    index.subscribe(a, "file:///a.txt"_L1);
+    index.subscribe(a, "file:///a.txt"_L1);
+
+    index.unsubscribe(a, "file:///a.txt"_L1);
+    QVERIFY(index.isSubscribed(a, "file:///a.txt"_L1));
+    index.unsubscribe(a, "file:///a.txt"_L1);
+    QVERIFY(!index.isSubscribed(a, "file:///a.txt"_L1));
+    QVERIFY(index.isEmpty());
+
+    // Unsubscribing from what was never subscribed to is harmless.
+    index.unsubscribe(a, "file:///a.txt"_L1);
+    QVERIFY(index.isEmpty());
+}
+
+void tst_QMcpSubscriptionIndex::removeSubscriber()
+{
+    QMcpSubscriptionIndex index;
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    index.subscribe(a, "file:///a.txt"_L1);
+    index.subscribe(a, "file:///logs/*"_L1);
+    index.subscribe(a, "db://tables/{name}"_L1);
+    index.subscribe(b, "file:///logs/*"_L1);
+
+    index.removeSubscriber(a);
+    QVERIFY(index.patterns(a).isEmpty());
+    QVERIFY(index.subscribers("file:///a.txt"_L1).isEmpty());
+    QVERIFY(index.subscribers("db://tables/users"_L1).isEmpty());
+    QCOMPARE(index.subscribers("file:///logs/today.log"_L1), QList<QUuid>{ b });
+
+    index.removeSubscriber(b);
+    QVERIFY(index.isEmpty());
+}
+
+void tst_QMcpSubscriptionIndex::manySessions()
+{
+    // Only the subscribers of the URI come back, however many sessions
+    // subscribed to something else.
+    QMcpSubscriptionIndex index;
+    QList<QUuid> sessions;
+    for (int i = 0; i < 10000; ++i) {
+        const auto session = QUuid::createUuid();
+        sessions.append(session);
+        index.subscribe(session, "file:///%1.txt"_L1.arg(i));
+        index.subscribe(session, "file:///dir%1/*"_L1.arg(i));
+    }
+
+    QCOMPARE(index.subscribers("file:///42.txt"_L1), QList<QUuid>{ sessions.at(42) });
+    QCOMPARE(index.subscribers("file:///dir42/x.txt"_L1), QList<QUuid>{ sessions.at(42) });
+    QVERIFY(index.subscribers("file:///none.txt"_L1).isEmpty());
+
+    for (const auto &session : std::as_const(sessions))
+        index.removeSubscriber(session);
+    QVERIFY(index.isEmpty());
+}
+
+QTEST_MAIN(tst_QMcpSubscriptionIndex)
+#include "tst_qmcpsubscriptionindex.moc"
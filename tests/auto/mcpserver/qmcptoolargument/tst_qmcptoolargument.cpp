@@ -0,0 +1,336 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPromise>
+#include <QtCore/QUuid>
+#include <QtTest/QTest>
+
+#include <QtMcpServer/QMcpServerSession>
+#include <QtMcpServer/qmcptoolargument.h>
+
+namespace {
+struct Range
+{
+    int from = 0;
+    int to = 0;
+    std::optional<QString> label;
+};
+
+struct Selection
+{
+    QString file;
+    QList<Range> ranges;
+};
+} // namespace
+
+template<>
+struct QMcpToolArgument<Range> : QMcpToolStruct<Range>
+{
+    static constexpr auto fields = std::make_tuple(
+            QMcpToolField{ "from", &Range::from, "First line" },
+            QMcpToolField{ "to", &Range::to },
+            QMcpToolField{ "label", &Range::label });
+};
+
+template<>
+struct QMcpToolArgument<Selection> : QMcpToolStruct<Selection>
+{
+    static constexpr auto fields = std::make_tuple(
+            QMcpToolField{ "file", &Selection::file },
+            QMcpToolField{ "ranges", &Selection::ranges });
+};
+
+class tst_QMcpToolArgument : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void scalars();
+    void integersMustBeWhole();
+    void lists();
+    void optional();
+    void structs();
+
+    void schemaFromSignature();
+    void callDecodesArguments();
+    void sessionIdIsPassed();
+    void invalidArgumentsAreErrorResults_data();
+    void invalidArgumentsAreErrorResults();
+    void resultTypes();
+    void asyncFunction();
+    void removeTool();
+
+private:
+    template<typename Function>
+    void addTool(const QString &name, const QStringList &parameterNames, Function function,
+                 const QHash<QString, QString> &descriptions = {})
+    {
+        using Tool = QtMcpPrivate::TypedTool<Function>;
+        m_session->addTool(Tool::tool(name, parameterNames, descriptions),
+                           Tool::invoker(parameterNames, std::move(function)));
+    }
+    QMcpCallToolResult call(const QString &name, const QJsonObject &arguments);
+
+    QUuid m_sessionId;
+    QMcpServerSession *m_session = nullptr;
+};
+
+void tst_QMcpToolArgument::init()
+{
+    m_sessionId = QUuid::createUuid();
+    m_session = new QMcpServerSession(m_sessionId);
+}
+
+void tst_QMcpToolArgument::cleanup()
+{
+    delete m_session;
+    m_session = nullptr;
+}
+
+QMcpCallToolResult tst_QMcpToolArgument::call(const QString &name, const QJsonObject &arguments)
+{
+    auto future = m_session->callToolAsync(name, arguments);
+    future.waitForFinished();
+    return future.result();
+}
+
+void tst_QMcpToolArgument::scalars()
+{
+    QCOMPARE(QMcpToolArgument<bool>::schema().value("type"_L1).toString(), u"boolean"_s);
+    QCOMPARE(QMcpToolArgument<int>::schema().value("type"_L1).toString(), u"integer"_s);
+    QCOMPARE(QMcpToolArgument<qint64>::schema().value("type"_L1).toString(), u"integer"_s);
+    QCOMPARE(QMcpToolArgument<double>::schema().value("type"_L1).toString(), u"number"_s);
+    QCOMPARE(QMcpToolArgument<QString>::schema().value("type"_L1).toString(), u"string"_s);
+
+    bool boolean = false;
+    QVERIFY(QMcpToolArgument<bool>::fromJson(true, &boolean));
+    QVERIFY(boolean);
+    QVERIFY(!QMcpToolArgument<bool>::fromJson(u"true"_s, &boolean));
+
+    double number = 0;
+    QVERIFY(QMcpToolArgument<double>::fromJson(2.5, &number));
+    QCOMPARE(number, 2.5);
+
+    QString text;
+    QVERIFY(QMcpToolArgument<QString>::fromJson(u"hello"_s, &text));
+    QCOMPARE(text, u"hello"_s);
+    QVERIFY(!QMcpToolArgument<QString>::fromJson(42, &text));
+}
+
+void tst_QMcpToolArgument::integersMustBeWhole()
+{
+    int value = 0;
+    QVERIFY(QMcpToolArgument<int>::fromJson(42, &value));
+    QCOMPARE(value, 42);
+    QVERIFY(!QMcpToolArgument<int>::fromJson(4.5, &value));
+    QVERIFY(!QMcpToolArgument<int>::fromJson(double(std::numeric_limits<qint64>::max()), &value));
+
+    quint8 byte = 0;
+    QVERIFY(!QMcpToolArgument<quint8>::fromJson(-1, &byte));
+    QVERIFY(!QMcpToolArgument<quint8>::fromJson(256, &byte));
+    QVERIFY(QMcpToolArgument<quint8>::fromJson(255, &byte));
+    QCOMPARE(byte, quint8(255));
+
+    // The max() of 64-bit types rounds up to 2^63 and 2^64 as a double,
+    // which are out of range.
+    qint64 wide = 0;
+    QVERIFY(!QMcpToolArgument<qint64>::fromJson(double(std::numeric_limits<qint64>::max()), &wide));
+    QVERIFY(QMcpToolArgument<qint64>::fromJson(double(std::numeric_limits<qint64>::lowest()), &wide));
+    QCOMPARE(wide, std::numeric_limits<qint64>::lowest());
+    quint64 unsignedWide = 0;
+    QVERIFY(QMcpToolArgument<quint64>::fromJson(std::ldexp(1.0, 63), &unsignedWide));
+    QCOMPARE(unsignedWide, quint64(1) << 63);
+    QVERIFY(!QMcpToolArgument<quint64>::fromJson(double(std::numeric_limits<quint64>::max()), &unsignedWide));
+}
+
+void tst_QMcpToolArgument::lists()
+{
+    const auto schema = QMcpToolArgument<QList<int>>::schema();
+    QCOMPARE(schema.value("type"_L1).toString(), u"array"_s);
+    QCOMPARE(schema.value("items"_L1).toObject().value("type"_L1).toString(), u"integer"_s);
+
+    QList<int> list;
+    QVERIFY(QMcpToolArgument<QList<int>>::fromJson(QJsonArray { 1, 2, 3 }, &list));
+    QCOMPARE(list, (QList<int> { 1, 2, 3 }));
+    QVERIFY(!QMcpToolArgument<QList<int>>::fromJson(QJsonArray { 1, u"two"_s }, &list));
+
+    std::vector<QString> strings;
+    QVERIFY(QMcpToolArgument<std::vector<QString>>::fromJson(QJsonArray { u"a"_s, u"b"_s }, &strings));
+    QCOMPARE(strings.size(), size_t(2));
+    QCOMPARE(strings.back(), u"b"_s);
+}
+
+void tst_QMcpToolArgument::optional()
+{
+    QVERIFY(QMcpToolArgument<std::optional<int>>::optional);
+    QVERIFY(!QMcpToolArgument<int>::optional);
+
+    std::optional<int> value = 1;
+    QVERIFY(QMcpToolArgument<std::optional<int>>::fromJson(QJsonValue(QJsonValue::Undefined), &value));
+    QVERIFY(!value);
+    QVERIFY(QMcpToolArgument<std::optional<int>>::fromJson(7, &value));
+    QCOMPARE(value.value_or(0), 7);
+    QVERIFY(!QMcpToolArgument<std::optional<int>>::fromJson(u"7"_s, &value));
+}
+
+void tst_QMcpToolArgument::structs()
+{
+    const auto schema = QMcpToolArgument<Selection>::schema();
+    QCOMPARE(schema.value("type"_L1).toString(), u"object"_s);
+    const auto ranges = schema.value("properties"_L1).toObject().value("ranges"_L1).toObject();
+    const auto rangeSchema = ranges.value("items"_L1).toObject();
+    QCOMPARE(rangeSchema.value("properties"_L1).toObject().value("from"_L1).toObject().value("description"_L1).toString(),
+             u"First line"_s);
+    QCOMPARE(rangeSchema.value("required"_L1).toArray(), (QJsonArray { u"from"_s, u"to"_s }));
+
+    const QJsonObject json {
+        { "file"_L1, "main.cpp"_L1 },
+        { "ranges"_L1, QJsonArray {
+                QJsonObject { { "from"_L1, 1 }, { "to"_L1, 5 } },
+                QJsonObject { { "from"_L1, 10 }, { "to"_L1, 12 }, { "label"_L1, "loop"_L1 } },
+        } },
+    };
+    Selection selection;
+    QVERIFY(QMcpToolArgument<Selection>::fromJson(json, &selection));
+    QCOMPARE(selection.file, u"main.cpp"_s);
+    QCOMPARE(selection.ranges.size(), 2);
+    QCOMPARE(selection.ranges.at(0).to, 5);
+    QVERIFY(!selection.ranges.at(0).label);
+    QCOMPARE(selection.ranges.at(1).label.value_or(QString()), u"loop"_s);
+
+    // A required member is missing.
+    Range range;
+    QVERIFY(!QMcpToolArgument<Range>::fromJson(QJsonObject { { "from"_L1, 1 } }, &range));
+}
+
+void tst_QMcpToolArgument::schemaFromSignature()
+{
+    addTool(u"edit"_s, { u"file"_s, u"line"_s, u"dryRun"_s },
+            [](const QString &, int, std::optional<bool>) { return true; },
+            { { u"edit"_s, u"Edits a file"_s }, { u"edit/line"_s, u"The line"_s } });
+
+    const auto tools = m_session->tools();
+    QCOMPARE(tools.size(), 1);
+    const auto tool = tools.first();
+    QCOMPARE(tool.name(), u"edit"_s);
+    QCOMPARE(tool.description(), u"Edits a file"_s);
+    const auto properties = tool.inputSchema().properties();
+    QCOMPARE(properties.value("file"_L1).toObject().value("type"_L1).toString(), u"string"_s);
+    QCOMPARE(properties.value("line"_L1).toObject().value("type"_L1).toString(), u"integer"_s);
+    QCOMPARE(properties.value("line"_L1).toObject().value("description"_L1).toString(), u"The line"_s);
+    QCOMPARE(properties.value("dryRun"_L1).toObject().value("type"_L1).toString(), u"boolean"_s);
+    QCOMPARE(tool.inputSchema().required(), (QStringList { u"file"_s, u"line"_s }));
+}
+
+void tst_QMcpToolArgument::callDecodesArguments()
+{
+    addTool(u"select"_s, { u"selection"_s, u"limit"_s },
+            [](const Selection &selection, std::optional<int> limit) {
+        QStringList lines;
+        for (const auto &range : selection.ranges)
+            lines.append(u"%1:%2-%3"_s.arg(selection.file).arg(range.from).arg(range.to));
+        return lines.mid(0, limit.value_or(lines.size()));
+    });
+
+    const QJsonObject selection {
+        { "file"_L1, "a.cpp"_L1 },
+        { "ranges"_L1, QJsonArray {
+                QJsonObject { { "from"_L1, 1 }, { "to"_L1, 2 } },
+                QJsonObject { { "from"_L1, 3 }, { "to"_L1, 4 } },
+        } },
+    };
+    auto result = call(u"select"_s, { { "selection"_L1, selection } });
+    QVERIFY(!result.isError());
+    QCOMPARE(result.content().size(), 2);
+    QCOMPARE(result.content().at(1).textContent().text(), u"a.cpp:3-4"_s);
+
+    result = call(u"select"_s, { { "selection"_L1, selection }, { "limit"_L1, 1 } });
+    QCOMPARE(result.content().size(), 1);
+}
+
+void tst_QMcpToolArgument::sessionIdIsPassed()
+{
+    QUuid seen;
+    addTool(u"whoami"_s, { u"greeting"_s }, [&seen](const QUuid &session, const QString &greeting) {
+        seen = session;
+        return greeting;
+    });
+    // The session id is not an argument.
+    QCOMPARE(m_session->tools().first().inputSchema().properties().keys(), QStringList { u"greeting"_s });
+
+    const auto result = call(u"whoami"_s, { { "greeting"_L1, "hi"_L1 } });
+    QCOMPARE(seen, m_sessionId);
+    QCOMPARE(result.content().first().textContent().text(), u"hi"_s);
+}
+
+void tst_QMcpToolArgument::invalidArgumentsAreErrorResults_data()
+{
+    QTest::addColumn<QJsonObject>("arguments");
+    QTest::addColumn<QString>("message");
+
+    QTest::newRow("missing") << QJsonObject { { "b"_L1, 1 } } << u"Missing required argument 'a'"_s;
+    QTest::newRow("wrong type") << QJsonObject { { "a"_L1, "one"_L1 } } << u"Invalid argument 'a'"_s;
+    QTest::newRow("unknown") << QJsonObject { { "a"_L1, 1 }, { "c"_L1, 1 } } << u"Unknown argument 'c'"_s;
+}
+
+void tst_QMcpToolArgument::invalidArgumentsAreErrorResults()
+{
+    QFETCH(QJsonObject, arguments);
+    QFETCH(QString, message);
+
+    bool called = false;
+    addTool(u"add"_s, { u"a"_s, u"b"_s }, [&called](int a, std::optional<int> b) {
+        called = true;
+        return a + b.value_or(0);
+    });
+    const auto result = call(u"add"_s, arguments);
+    QVERIFY(result.isError());
+    QVERIFY2(result.content().first().textContent().text().startsWith(message),
+             qPrintable(result.content().first().textContent().text()));
+    QVERIFY(!called);
+}
+
+void tst_QMcpToolArgument::resultTypes()
+{
+    addTool(u"number"_s, {}, []() { return 42; });
+    addTool(u"nothing"_s, {}, []() {});
+    addTool(u"object"_s, {}, []() { return QJsonObject { { "answer"_L1, 42 } }; });
+
+    QCOMPARE(call(u"number"_s, {}).content().first().textContent().text(), u"42"_s);
+    QVERIFY(call(u"nothing"_s, {}).content().isEmpty());
+    const auto result = call(u"object"_s, {});
+    QCOMPARE(result.structuredContent().value("answer"_L1).toInt(), 42);
+    QCOMPARE(result.content().first().textContent().text(), u"{\"answer\":42}"_s);
+}
+
+void tst_QMcpToolArgument::asyncFunction()
+{
+    auto promise = std::make_shared<QPromise<QString>>();
+    addTool(u"later"_s, {}, [promise]() {
+        promise->start();
+        return promise->future();
+    });
+
+    auto future = m_session->callToolAsync(u"later"_s, {});
+    QVERIFY(!future.isFinished());
+    promise->addResult(u"done"_s);
+    promise->finish();
+    future.waitForFinished();
+    QCOMPARE(future.result().content().first().textContent().text(), u"done"_s);
+}
+
+void tst_QMcpToolArgument::removeTool()
+{
+    addTool(u"gone"_s, {}, []() { return true; });
+    QCOMPARE(m_session->tools().size(), 1);
+    m_session->removeTool(u"gone"_s);
+    QVERIFY(m_session->tools().isEmpty());
+}
+
+QTEST_MAIN(tst_QMcpToolArgument)
+#include "tst_qmcptoolargument.moc"
@@ -0,0 +1,235 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtMcpServer/private/qmcptoolscheduler_p.h>
+#include <QtTest/QTest>
+
+using namespace Qt::Literals::StringLiterals;
+
+using Admission = QMcpToolScheduler::Admission;
+
+class tst_QMcpToolScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void unlimited();
+    void concurrencyLimit();
+    void sessionConcurrencyLimit();
+    void toolConcurrencyLimit();
+    void queueLimits();
+    void sessionsTakeTurns();
+    void weights();
+    void priorities();
+    void removeSession();
+
+private:
+    static QMcpToolScheduler::Call call(const QUuid &session, int id, const QString &tool = u"tool"_s);
+    // Finishes the running call and returns the session of the one that
+    // runs next.
+    static QUuid next(QMcpToolScheduler *scheduler, const QUuid &session, int id, int *nextId);
+};
+
+QMcpToolScheduler::Call tst_QMcpToolScheduler::call(const QUuid &session, int id, const QString &tool)
+{
+    QMcpToolScheduler::Call ret;
+    ret.session = session;
+    ret.id = id;
+    ret.tool = tool;
+    return ret;
+}
+
+QUuid tst_QMcpToolScheduler::next(QMcpToolScheduler *scheduler, const QUuid &session, int id, int *nextId)
+{
+    if (!scheduler->finish(session, id))
+        return {};
+    const auto call = scheduler->takeNext();
+    if (!call)
+        return {};
+    *nextId = call->id.toInt();
+    return call->session;
+}
+
+void tst_QMcpToolScheduler::unlimited()
+{
+    QMcpToolScheduler scheduler;
+    QVERIFY(!scheduler.isLimited());
+    const auto a = QUuid::createUuid();
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(scheduler.submit(call(a, i)), Admission::Run);
+    QCOMPARE(scheduler.running(), 100);
+    QCOMPARE(scheduler.queued(), 0);
+    QVERIFY(!scheduler.takeNext());
+}
+
+void tst_QMcpToolScheduler::concurrencyLimit()
+{
+    QMcpToolScheduler scheduler;
+    scheduler.setConcurrencyLimits(2, 0);
+    QVERIFY(scheduler.isLimited());
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    QCOMPARE(scheduler.submit(call(a, 1)), Admission::Run);
+    QCOMPARE(scheduler.submit(call(b, 1)), Admission::Run);
+    QCOMPARE(scheduler.submit(call(a, 2)), Admission::Queued);
+    QCOMPARE(scheduler.queued(), 1);
+    QVERIFY(!scheduler.takeNext());
+
+    QVERIFY(scheduler.finish(b, 1));
+    QVERIFY(!scheduler.finish(b, 1));
+    const auto taken = scheduler.takeNext();
+    QVERIFY(taken);
+    QCOMPARE(taken->session, a);
+    QCOMPARE(taken->id.toInt(), 2);
+    QCOMPARE(scheduler.running(a), 2);
+    QCOMPARE(scheduler.queued(), 0);
+}
+
+void tst_QMcpToolScheduler::sessionConcurrencyLimit()
+{
+    QMcpToolScheduler scheduler;
+    scheduler.setConcurrencyLimits(0, 1);
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    QCOMPARE(scheduler.submit(call(a, 1)), Admission::Run);
+    QCOMPARE(scheduler.submit(call(a, 2)), Admission::Queued);
+    // Another session is not held up by a's limit.
+    QCOMPARE(scheduler.submit(call(b, 1)), Admission::Run);
+    QVERIFY(!scheduler.takeNext());
+
+    QVERIFY(scheduler.finish(a, 1));
+    const auto taken = scheduler.takeNext();
+    QVERIFY(taken);
+    QCOMPARE(taken->id.toInt(), 2);
+}
+
+void tst_QMcpToolScheduler::toolConcurrencyLimit()
+{
+    QMcpToolScheduler scheduler;
+    scheduler.setToolConcurrencyLimit(u"render"_s, 1);
+    QCOMPARE(scheduler.toolConcurrencyLimit(u"render"_s), 1);
+    const auto a = QUuid::createUuid();
+    QCOMPARE(scheduler.submit(call(a, 1, u"render"_s)), Admission::Run);
+    QCOMPARE(scheduler.submit(call(a, 2, u"render"_s)), Admission::Queued);
+    QCOMPARE(scheduler.submit(call(a, 3, u"echo"_s)), Admission::Run);
+
+    scheduler.setToolConcurrencyLimit(u"render"_s, 0);
+    QVERIFY(!scheduler.isLimited());
+    // Dropping the limit lets the waiting call run.
+    QVERIFY(scheduler.takeNext());
+}
+
+void tst_QMcpToolScheduler::queueLimits()
+{
+    QMcpToolScheduler scheduler;
+    scheduler.setConcurrencyLimits(1, 0);
+    scheduler.setQueueLimits(2, 3);
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    QCOMPARE(scheduler.submit(call(a, 1)), Admission::Run);
+    QCOMPARE(scheduler.submit(call(a, 2)), Admission::Queued);
+    QCOMPARE(scheduler.submit(call(a, 3)), Admission::Queued);
+    QCOMPARE(scheduler.submit(call(a, 4)), Admission::SessionQueueFull);
+    QCOMPARE(scheduler.submit(call(b, 1)), Admission::Queued);
+    QCOMPARE(scheduler.submit(call(b, 2)), Admission::ServerQueueFull);
+    QCOMPARE(scheduler.queued(a), 2);
+    QCOMPARE(scheduler.queued(b), 1);
+}
+
+void tst_QMcpToolScheduler::sessionsTakeTurns()
+{
+    // a floods the server before b arrives; b still gets every other slot.
+    QMcpToolScheduler scheduler;
+    scheduler.setConcurrencyLimits(1, 0);
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    for (int i = 0; i < 10; ++i)
+        scheduler.submit(call(a, i));
+    for (int i = 100; i < 103; ++i)
+        scheduler.submit(call(b, i));
+
+    QList<QUuid> order;
+    QUuid session = a;
+    int id = 0;
+    for (int i = 0; i < 6; ++i) {
+        session = next(&scheduler, session, id, &id);
+        order.append(session);
+    }
+    QCOMPARE(order, QList<QUuid>({ b, a, b, a, b, a }));
+}
+
+void tst_QMcpToolScheduler::weights()
+{
+    QMcpToolScheduler scheduler;
+    scheduler.setConcurrencyLimits(1, 0);
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    const auto c = QUuid::createUuid();
+    scheduler.setSessionWeight(b, 3);
+    QCOMPARE(scheduler.sessionWeight(a), 1);
+    QCOMPARE(scheduler.sessionWeight(b), 3);
+
+    QCOMPARE(scheduler.submit(call(c, 0)), Admission::Run);
+    for (int i = 1; i <= 6; ++i) {
+        scheduler.submit(call(a, i));
+        scheduler.submit(call(b, 100 + i));
+    }
+
+    int fromB = 0;
+    QUuid session = c;
+    int id = 0;
+    for (int i = 0; i < 8; ++i) {
+        session = next(&scheduler, session, id, &id);
+        if (session == b)
+            ++fromB;
+    }
+    QCOMPARE(fromB, 6);
+}
+
+void tst_QMcpToolScheduler::priorities()
+{
+    QMcpToolScheduler scheduler;
+    scheduler.setConcurrencyLimits(1, 0);
+    scheduler.setToolPriority(u"cancel"_s, 10);
+    QCOMPARE(scheduler.toolPriority(u"cancel"_s), 10);
+    QCOMPARE(scheduler.toolPriority(u"export"_s), 0);
+    const auto a = QUuid::createUuid();
+    QCOMPARE(scheduler.submit(call(a, 0, u"export"_s)), Admission::Run);
+    for (int i = 1; i < 5; ++i)
+        scheduler.submit(call(a, i, u"export"_s));
+    // Queued last, but its priority puts it ahead of the exports.
+    scheduler.submit(call(a, 100, u"cancel"_s));
+
+    QVERIFY(scheduler.finish(a, 0));
+    const auto taken = scheduler.takeNext();
+    QVERIFY(taken);
+    QCOMPARE(taken->id.toInt(), 100);
+    QCOMPARE(taken->tool, u"cancel"_s);
+}
+
+void tst_QMcpToolScheduler::removeSession()
+{
+    QMcpToolScheduler scheduler;
+    scheduler.setConcurrencyLimits(2, 0);
+    const auto a = QUuid::createUuid();
+    const auto b = QUuid::createUuid();
+    scheduler.setSessionWeight(a, 2);
+    QCOMPARE(scheduler.submit(call(a, 1)), Admission::Run);
+    QCOMPARE(scheduler.submit(call(a, 2)), Admission::Run);
+    QCOMPARE(scheduler.submit(call(a, 3)), Admission::Queued);
+    QCOMPARE(scheduler.submit(call(b, 1)), Admission::Queued);
+
+    scheduler.removeSession(a);
+    QCOMPARE(scheduler.running(), 0);
+    QCOMPARE(scheduler.queued(), 1);
+    QCOMPARE(scheduler.sessionWeight(a), 1);
+    QVERIFY(!scheduler.finish(a, 1));
+
+    const auto taken = scheduler.takeNext();
+    QVERIFY(taken);
+    QCOMPARE(taken->session, b);
+    QVERIFY(!scheduler.takeNext());
+}
+
+QTEST_MAIN(tst_QMcpToolScheduler)
+#include "tst_qmcptoolscheduler.moc"
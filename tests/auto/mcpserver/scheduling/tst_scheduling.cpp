@@ -0,0 +1,215 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QFuture>
+#include <QtCore/QPromise>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpCallToolRequest>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+#include <QtMcpServer/QMcpServerSession>
+#include <QtMcpServer/QMcpServerStatistics>
+
+#include <exception>
+#include <memory>
+
+class tst_Scheduling : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void unlimitedByDefault();
+    void queuedCallRunsWhenOneFinishes();
+    void fullQueueIsBusy();
+    void canceledToolFreesItsSlot();
+    void failedToolFreesItsSlot();
+
+private:
+    struct Answer {
+        bool answered = false;
+        int errorCode = 0;
+        QString scope;
+        QString text;
+    };
+
+    bool startClient();
+    // Calls the slow tool; \a answer is filled in once it is answered.
+    void callSlow(const std::shared_ptr<Answer> &answer);
+
+    QString m_name;
+    QMcpServer *m_server = nullptr;
+    std::unique_ptr<QMcpClient> m_client;
+    // Tool runs still to be answered.
+    QList<std::shared_ptr<QPromise<QString>>> m_runs;
+};
+
+void tst_Scheduling::init()
+{
+    m_name = u"tst_scheduling-%1"_s.arg(QTest::currentTestFunction());
+    m_runs.clear();
+    m_server = new QMcpServer("inprocess"_L1, this);
+    // The tool stays running until the test answers it.
+    m_server->addTool(u"slow"_s, QStringList(), [this]() -> QFuture<QString> {
+        auto promise = std::make_shared<QPromise<QString>>();
+        promise->start();
+        m_runs.append(promise);
+        return promise->future();
+    });
+    QSignalSpy startedSpy(m_server, &QMcpServer::started);
+    m_server->start(m_name);
+    QCOMPARE(startedSpy.count(), 1);
+    QVERIFY(startClient());
+}
+
+void tst_Scheduling::cleanup()
+{
+    m_client.reset();
+    delete m_server;
+    m_server = nullptr;
+    m_runs.clear();
+}
+
+bool tst_Scheduling::startClient()
+{
+    m_client = std::make_unique<QMcpClient>("inprocess"_L1);
+    m_client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    QSignalSpy startedSpy(m_client.get(), &QMcpClient::started);
+    m_client->start(m_name);
+    if (!startedSpy.wait(5000))
+        return false;
+    if (!QTest::qWaitFor([this]() { return m_server->sessions().size() == 1; }, 5000))
+        return false;
+    auto *session = m_server->sessions().first();
+    return QTest::qWaitFor([session]() { return session->isInitialized(); }, 5000);
+}
+
+void tst_Scheduling::callSlow(const std::shared_ptr<Answer> &answer)
+{
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(u"slow"_s);
+    request.setParams(params);
+    m_client->request(request, [answer](const QMcpCallToolResult &result, const QMcpJSONRPCErrorError *error) {
+        answer->answered = true;
+        if (error) {
+            answer->errorCode = error->code();
+            answer->scope = error->data().toObject().value("scope"_L1).toString();
+        } else if (!result.content().isEmpty()) {
+            answer->text = result.content().first().textContent().text();
+        }
+    });
+}
+
+void tst_Scheduling::unlimitedByDefault()
+{
+    QCOMPARE(m_server->concurrencyLimit(), 0);
+    for (int i = 0; i < 5; ++i)
+        callSlow(std::make_shared<Answer>());
+    QTRY_COMPARE(m_runs.size(), 5);
+    QCOMPARE(m_server->statistics().queuedToolCalls(), 0);
+    QCOMPARE(m_server->statistics().runningToolCalls(), 5);
+}
+
+void tst_Scheduling::queuedCallRunsWhenOneFinishes()
+{
+    m_server->setConcurrencyLimits(1);
+    const auto first = std::make_shared<Answer>();
+    const auto second = std::make_shared<Answer>();
+    callSlow(first);
+    callSlow(second);
+    QTRY_COMPARE(m_server->statistics().queuedToolCalls(), 1);
+    QCOMPARE(m_runs.size(), 1);
+    auto statistics = m_server->statistics();
+    QCOMPARE(statistics.runningToolCalls(), 1);
+    const QUuid session = m_server->sessions().first()->sessionId();
+    QCOMPARE(statistics.queuedToolCallsBySession(), (QHash<QUuid, qsizetype>{ { session, 1 } }));
+
+    m_runs.at(0)->addResult(u"first"_s);
+    m_runs.at(0)->finish();
+    QTRY_VERIFY(first->answered);
+    QCOMPARE(first->text, u"first"_s);
+    // The waiting call took the slot the first one freed.
+    QTRY_COMPARE(m_runs.size(), 2);
+    QVERIFY(!second->answered);
+    statistics = m_server->statistics();
+    QCOMPARE(statistics.queuedToolCalls(), 0);
+    QVERIFY(statistics.queuedToolCallsBySession().isEmpty());
+    QCOMPARE(statistics.toolQueueWait().count(), quint64(1));
+
+    m_runs.at(1)->addResult(u"second"_s);
+    m_runs.at(1)->finish();
+    QTRY_VERIFY(second->answered);
+    QCOMPARE(second->text, u"second"_s);
+}
+
+void tst_Scheduling::fullQueueIsBusy()
+{
+    m_server->setConcurrencyLimits(1);
+    m_server->setQueueLimits(1);
+    const auto running = std::make_shared<Answer>();
+    const auto waiting = std::make_shared<Answer>();
+    const auto rejected = std::make_shared<Answer>();
+    callSlow(running);
+    callSlow(waiting);
+    callSlow(rejected);
+
+    QTRY_VERIFY(rejected->answered);
+    QCOMPARE(rejected->errorCode, QMcpServer::ServerBusyErrorCode);
+    QCOMPARE(rejected->scope, u"session"_s);
+    QCOMPARE(m_runs.size(), 1);
+    QVERIFY(!running->answered);
+    QVERIFY(!waiting->answered);
+}
+
+void tst_Scheduling::canceledToolFreesItsSlot()
+{
+    m_server->setConcurrencyLimits(1);
+    const auto canceled = std::make_shared<Answer>();
+    const auto next = std::make_shared<Answer>();
+    callSlow(canceled);
+    callSlow(next);
+    QTRY_COMPARE(m_runs.size(), 1);
+
+    // Dropping the promise unfinished cancels the tool's future.
+    m_runs.takeFirst().reset();
+    QTRY_VERIFY(canceled->answered);
+    QCOMPARE(canceled->errorCode, QMcpServer::InternalErrorCode);
+    QTRY_COMPARE(m_runs.size(), 1);
+    QVERIFY(!next->answered);
+}
+
+void tst_Scheduling::failedToolFreesItsSlot()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("a future only fails where there are exceptions");
+#else
+    m_server->setConcurrencyLimits(1);
+    const auto failed = std::make_shared<Answer>();
+    const auto next = std::make_shared<Answer>();
+    callSlow(failed);
+    callSlow(next);
+    QTRY_COMPARE(m_runs.size(), 1);
+
+    // The error a handler fails with is what the client is answered with.
+    QMcpJSONRPCErrorError error;
+    error.setCode(-32602);
+    error.setMessage(u"no such file"_s);
+    m_runs.at(0)->setException(std::make_exception_ptr(error));
+    m_runs.at(0)->finish();
+    QTRY_VERIFY(failed->answered);
+    QCOMPARE(failed->errorCode, -32602);
+    QTRY_COMPARE(m_runs.size(), 2);
+    QVERIFY(!next->answered);
+#endif
+}
+
+QTEST_MAIN(tst_Scheduling)
+#include "tst_scheduling.moc"
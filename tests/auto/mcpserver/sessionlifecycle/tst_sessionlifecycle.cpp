@@ -0,0 +1,191 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QFile>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpClient/QMcpClientBackendInterface>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpPingRequest>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpCommon/private/qmcpinprocesschannel_p.h>
+#include <QtMcpServer/QMcpServer>
+#include <QtMcpServer/QMcpServerSession>
+
+#include <memory>
+
+class tst_SessionLifecycle : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void clientClosingEndsTheSession();
+    void closeSessionEndsIt();
+    void idleSessionsAreClosed();
+    void activeSessionsAreKept();
+    void memoryIsFlatAcrossSessions();
+
+private:
+    std::unique_ptr<QMcpClient> startClient();
+    bool ping(QMcpClient *client);
+
+    QString m_name;
+    QMcpServer *m_server = nullptr;
+};
+
+namespace {
+
+// The resident set size in kB, or -1 where it cannot be read.
+qint64 residentKb()
+{
+    QFile status(u"/proc/self/status"_s);
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+    while (!status.atEnd()) {
+        const auto line = status.readLine();
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+}
+
+} // namespace
+
+void tst_SessionLifecycle::init()
+{
+    m_name = u"tst_sessionlifecycle-%1"_s.arg(QTest::currentTestFunction());
+    m_server = new QMcpServer("inprocess"_L1, this);
+    QSignalSpy startedSpy(m_server, &QMcpServer::started);
+    m_server->start(m_name);
+    QCOMPARE(startedSpy.count(), 1);
+}
+
+void tst_SessionLifecycle::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+std::unique_ptr<QMcpClient> tst_SessionLifecycle::startClient()
+{
+    auto client = std::make_unique<QMcpClient>("inprocess"_L1);
+    client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+    client->start(m_name);
+    if (!startedSpy.wait(5000))
+        return nullptr;
+    return client;
+}
+
+bool tst_SessionLifecycle::ping(QMcpClient *client)
+{
+    bool answered = false;
+    client->request(QMcpPingRequest(), [&answered](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *error) {
+        answered = !error;
+    });
+    return QTest::qWaitFor([&answered]() { return answered; }, 5000);
+}
+
+void tst_SessionLifecycle::clientClosingEndsTheSession()
+{
+    QSignalSpy endedSpy(m_server, &QMcpServer::sessionEnded);
+    auto client = startClient();
+    QVERIFY(client);
+    QTRY_COMPARE(m_server->sessions().size(), 1);
+    const auto sessionId = m_server->sessions().first()->sessionId();
+
+    client.reset();
+    QTRY_COMPARE(endedSpy.count(), 1);
+    QCOMPARE(endedSpy.first().first().toUuid(), sessionId);
+    QVERIFY(m_server->sessions().isEmpty());
+}
+
+void tst_SessionLifecycle::closeSessionEndsIt()
+{
+    QSignalSpy endedSpy(m_server, &QMcpServer::sessionEnded);
+    auto client = startClient();
+    QVERIFY(client);
+    QTRY_COMPARE(m_server->sessions().size(), 1);
+    QVERIFY(ping(client.get()));
+
+    auto *clientBackend = client->findChild<QMcpClientBackendInterface *>();
+    QVERIFY(clientBackend);
+    QSignalSpy finishedSpy(clientBackend, &QMcpClientBackendInterface::finished);
+    m_server->closeSession(m_server->sessions().first()->sessionId());
+    QCOMPARE(endedSpy.count(), 1);
+    QVERIFY(m_server->sessions().isEmpty());
+    QVERIFY(finishedSpy.wait(5000));
+}
+
+void tst_SessionLifecycle::idleSessionsAreClosed()
+{
+    QCOMPARE(m_server->sessionIdleTimeout(), 0);
+    m_server->setSessionIdleTimeout(200);
+    QSignalSpy endedSpy(m_server, &QMcpServer::sessionEnded);
+    auto client = startClient();
+    QVERIFY(client);
+    QTRY_COMPARE(m_server->sessions().size(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(endedSpy.count(), 1, 2000);
+    QVERIFY(m_server->sessions().isEmpty());
+}
+
+void tst_SessionLifecycle::activeSessionsAreKept()
+{
+    m_server->setSessionIdleTimeout(300);
+    QSignalSpy endedSpy(m_server, &QMcpServer::sessionEnded);
+    auto client = startClient();
+    QVERIFY(client);
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(ping(client.get()));
+        QTest::qWait(100);
+    }
+    QCOMPARE(endedSpy.count(), 0);
+    QCOMPARE(m_server->sessions().size(), 1);
+}
+
+void tst_SessionLifecycle::memoryIsFlatAcrossSessions()
+{
+    if (residentKb() < 0)
+        QSKIP("The resident set size cannot be read on this platform");
+
+    // Connects a client and closes it again, leaving the server with
+    // nothing to keep.
+    QObject context;
+    const auto cycle = [this, &context]() {
+        auto channel = QMcpInProcessChannel::connect(m_name, &context, [](const QJsonObject &) {}, {});
+        if (!channel)
+            return false;
+        channel->close();
+        // The server accepts the channel, then learns it is closed.
+        QCoreApplication::processEvents();
+        QCoreApplication::processEvents();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        return true;
+    };
+
+    // Warm up, so that the allocator and the hash tables have grown to what
+    // a steady state needs.
+    for (int i = 0; i < 1000; ++i)
+        QVERIFY(cycle());
+    QTRY_VERIFY(m_server->sessions().isEmpty());
+    const auto before = residentKb();
+
+    for (int i = 0; i < 100000; ++i)
+        QVERIFY(cycle());
+    QTRY_VERIFY(m_server->sessions().isEmpty());
+    const auto after = residentKb();
+
+    // A session left behind costs kilobytes, so 100k of them would show as
+    // hundreds of megabytes.
+    qDebug() << "resident set" << before << "kB before," << after << "kB after";
+    QVERIFY2(after - before < 16 * 1024, qPrintable(u"grew by %1 kB"_s.arg(after - before)));
+}
+
+QTEST_MAIN(tst_SessionLifecycle)
+#include "tst_sessionlifecycle.moc"
@@ -0,0 +1,126 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QUuid>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpPingRequest>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpCommon/private/qmcpshmchannel_p.h>
+#include <QtMcpServer/QMcpServer>
+
+#include <memory>
+
+class tst_Shm : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void everyConnectionIsASession();
+    void framesLargerThanTheRing();
+    void fullRingKeepsOrder();
+    void oversizeFramesAreDropped();
+
+private:
+    // A pair of ends in this process, on rings of the smallest size.
+    bool createPair(QList<QJsonObject> *received);
+
+    std::unique_ptr<QMcpShmChannel> m_server;
+    std::unique_ptr<QMcpShmChannel> m_client;
+};
+
+void tst_Shm::everyConnectionIsASession()
+{
+    const auto name = u"qtmcp-tst_shm-%1"_s.arg(QCoreApplication::applicationPid());
+    QMcpServer server("shm"_L1);
+    QSignalSpy startedSpy(&server, &QMcpServer::started);
+    server.start(name);
+    QCOMPARE(startedSpy.count(), 1);
+
+    std::unique_ptr<QMcpClient> clients[2];
+    for (auto &client : clients) {
+        client = std::make_unique<QMcpClient>("shm"_L1);
+        client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+        QSignalSpy clientStartedSpy(client.get(), &QMcpClient::started);
+        client->start(name);
+        QVERIFY(clientStartedSpy.wait(5000));
+    }
+    QTRY_COMPARE(server.sessions().size(), 2);
+
+    int answered = 0;
+    for (auto &client : clients) {
+        client->request(QMcpPingRequest(), [&answered](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *error) {
+            if (!error)
+                ++answered;
+        });
+    }
+    QTRY_COMPARE(answered, 2);
+}
+
+bool tst_Shm::createPair(QList<QJsonObject> *received)
+{
+    const auto key = u"qtmcp-tst_shm-"_s + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    m_server = std::make_unique<QMcpShmChannel>([](const QJsonObject &, qsizetype) {});
+    m_client = std::make_unique<QMcpShmChannel>([received](const QJsonObject &object, qsizetype) {
+        received->append(object);
+    });
+    return m_server->create(key, 4096) && m_client->attach(key);
+}
+
+void tst_Shm::framesLargerThanTheRing()
+{
+    QList<QJsonObject> received;
+    QVERIFY(createPair(&received));
+
+    // Streamed through the ring in pieces, and reassembled.
+    const QJsonObject large { { "text"_L1, QString(20000, u'x') } };
+    m_server->send(large);
+    QVERIFY(m_server->queuedBytes() > 0);
+    QTRY_COMPARE(received.size(), 1);
+    QCOMPARE(received.first(), large);
+    QTRY_COMPARE(m_server->queuedBytes(), 0);
+}
+
+void tst_Shm::fullRingKeepsOrder()
+{
+    QList<QJsonObject> received;
+    QVERIFY(createPair(&received));
+
+    // Far more than fits: the rest waits, and frames wrap around the end.
+    constexpr int Messages = 1000;
+    for (int i = 0; i < Messages; ++i)
+        m_server->send({ { "id"_L1, i }, { "padding"_L1, QString(i % 97, u'-') } });
+    QTRY_COMPARE(received.size(), Messages);
+    for (int i = 0; i < Messages; ++i)
+        QCOMPARE(received.at(i).value("id"_L1).toInt(), i);
+}
+
+void tst_Shm::oversizeFramesAreDropped()
+{
+    QList<QJsonObject> received;
+    QVERIFY(createPair(&received));
+
+    const QJsonObject large { { "text"_L1, QString(2000, u'x') } };
+    const QJsonObject small { { "id"_L1, 1 } };
+    m_client->setMaxFrameSize(1000);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("dropping a shared memory message"_L1));
+    QVERIFY(m_server->send(large) > 0);
+    m_server->send(small);
+    // Read past rather than taken, and what follows still arrives.
+    QTRY_COMPARE(received.size(), 1);
+    QCOMPARE(received.first(), small);
+
+    m_server->setMaxFrameSize(1000);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("not sending a shared memory message"_L1));
+    QCOMPARE(m_server->send(large), qsizetype(0));
+    QCOMPARE(m_server->queuedBytes(), qsizetype(0));
+}
+
+QTEST_MAIN(tst_Shm)
+#include "tst_shm.moc"
@@ -0,0 +1,224 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
+#include <QtTest/QTest>
+
+#include <QtMcpServer/QMcpServer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+// Passed to this very binary to have it serve over STDIN and STDOUT.
+constexpr auto StdioServerArgument = "--stdio-server";
+constexpr int Timeout = 10000;
+
+QByteArray message(const QString &method, const QJsonValue &id, const QJsonObject &params = {})
+{
+    QJsonObject object;
+    object.insert("jsonrpc"_L1, "2.0"_L1);
+    if (!id.isUndefined())
+        object.insert("id"_L1, id);
+    object.insert("method"_L1, method);
+    object.insert("params"_L1, params);
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+QByteArray initialize()
+{
+    QJsonObject clientInfo;
+    clientInfo.insert("name"_L1, "tst_stdio"_L1);
+    clientInfo.insert("version"_L1, "1.0"_L1);
+    QJsonObject params;
+    params.insert("protocolVersion"_L1, "2025-06-18"_L1);
+    params.insert("capabilities"_L1, QJsonObject());
+    params.insert("clientInfo"_L1, clientInfo);
+    return message(u"initialize"_s, 0, params);
+}
+
+QString digest(const QString &text)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+} // namespace
+
+class tst_Stdio : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void messageSplitAcrossReads();
+    void severalMessagesInOneRead();
+    void blankLinesAndCrLf();
+    void multiMegabyteMessage();
+
+private:
+    // Writes \a data and waits for it to reach the server, so that what
+    // follows arrives in a read of its own.
+    void write(const QByteArray &data);
+    // Waits until the responses with ids up to \a lastId arrived.
+    bool waitForResponses(int lastId);
+    void handshake();
+
+    QProcess m_process;
+    QByteArray m_output;
+    // Responses by id, in the order they came.
+    QMultiHash<int, QJsonObject> m_responses;
+};
+
+void tst_Stdio::init()
+{
+    m_output.clear();
+    m_responses.clear();
+    connect(&m_process, &QProcess::readyReadStandardOutput, this, [this]() {
+        m_output += m_process.readAllStandardOutput();
+        qsizetype lf;
+        while ((lf = m_output.indexOf('\n')) >= 0) {
+            const auto object = QJsonDocument::fromJson(m_output.first(lf)).object();
+            m_output.remove(0, lf + 1);
+            if (object.contains("id"_L1))
+                m_responses.insert(object.value("id"_L1).toInt(), object);
+        }
+    });
+    m_process.start(QCoreApplication::applicationFilePath(), { QLatin1StringView(StdioServerArgument) });
+    QVERIFY(m_process.waitForStarted(Timeout));
+}
+
+void tst_Stdio::cleanup()
+{
+    m_process.closeWriteChannel();
+    if (!m_process.waitForFinished(Timeout))
+        m_process.kill();
+    disconnect(&m_process, nullptr, this, nullptr);
+}
+
+void tst_Stdio::write(const QByteArray &data)
+{
+    m_process.write(data);
+    QVERIFY(m_process.waitForBytesWritten(Timeout));
+    QTest::qWait(20);
+}
+
+bool tst_Stdio::waitForResponses(int lastId)
+{
+    return QTest::qWaitFor([this, lastId]() {
+        for (int id = 0; id <= lastId; ++id) {
+            if (!m_responses.contains(id))
+                return false;
+        }
+        return true;
+    }, Timeout);
+}
+
+void tst_Stdio::handshake()
+{
+    write(initialize() + '\n' + message(u"notifications/initialized"_s, QJsonValue::Undefined) + '\n');
+    QVERIFY(waitForResponses(0));
+}
+
+void tst_Stdio::messageSplitAcrossReads()
+{
+    const auto data = initialize() + '\n';
+    const auto third = data.size() / 3;
+    write(data.first(third));
+    write(data.sliced(third, third));
+    QTest::qWait(50);
+    QVERIFY(m_responses.isEmpty());
+    write(data.sliced(2 * third));
+    QVERIFY(waitForResponses(0));
+    QVERIFY(m_responses.value(0).contains("result"_L1));
+
+    write(message(u"notifications/initialized"_s, QJsonValue::Undefined) + '\n');
+    write(message(u"ping"_s, 1).chopped(1));
+    write("}\n");
+    QVERIFY(waitForResponses(1));
+    QTest::qWait(50);
+    QCOMPARE(m_responses.size(), 2);
+}
+
+void tst_Stdio::severalMessagesInOneRead()
+{
+    handshake();
+    QByteArray data;
+    for (int id = 1; id <= 5; ++id)
+        data += message(u"ping"_s, id) + '\n';
+    // The start of the next message comes along with them.
+    const auto next = message(u"ping"_s, 6) + '\n';
+    write(data + next.first(10));
+    QVERIFY(waitForResponses(5));
+    write(next.sliced(10));
+    QVERIFY(waitForResponses(6));
+    QTest::qWait(50);
+    for (int id = 0; id <= 6; ++id)
+        QCOMPARE(m_responses.count(id), 1);
+}
+
+void tst_Stdio::blankLinesAndCrLf()
+{
+    handshake();
+    write("\n\r\n   \n" + message(u"ping"_s, 1) + "\r\n\n" + message(u"ping"_s, 2) + "\r");
+    write("\n\r\n" + message(u"ping"_s, 3) + "\n\n");
+    QVERIFY(waitForResponses(3));
+    QTest::qWait(50);
+    QCOMPARE(m_responses.size(), 4);
+    for (int id = 1; id <= 3; ++id)
+        QVERIFY(m_responses.value(id).contains("result"_L1));
+}
+
+void tst_Stdio::multiMegabyteMessage()
+{
+    handshake();
+    QString text;
+    text.reserve(4 * 1024 * 1024);
+    for (int i = 0; text.size() < 4 * 1024 * 1024; ++i)
+        text += QString::number(i) + u' ';
+    QJsonObject arguments;
+    arguments.insert("text"_L1, text);
+    QJsonObject params;
+    params.insert("name"_L1, "digest"_L1);
+    params.insert("arguments"_L1, arguments);
+    const auto data = message(u"tools/call"_s, 1, params) + '\n' + message(u"ping"_s, 2) + '\n';
+
+    // In pieces far smaller than the message, as a pipe delivers it.
+    constexpr qsizetype Piece = 256 * 1024;
+    for (qsizetype from = 0; from < data.size(); from += Piece)
+        write(data.sliced(from, qMin(Piece, data.size() - from)));
+    QVERIFY(waitForResponses(2));
+
+    const auto result = m_responses.value(1).value("result"_L1).toObject();
+    const auto content = result.value("content"_L1).toArray();
+    QVERIFY(!content.isEmpty());
+    QCOMPARE(content.first().toObject().value("text"_L1).toString(), digest(text));
+    QCOMPARE(m_responses.count(1), 1);
+    QCOMPARE(m_responses.count(2), 1);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && qstrcmp(argv[argc - 1], StdioServerArgument) == 0) {
+        QCoreApplication app(argc, argv);
+        QMcpServer server(u"stdio"_s);
+        server.addTool(u"digest"_s, { u"text"_s }, [](const QString &text) {
+            return digest(text);
+        });
+        server.start(QString());
+        QObject::connect(&server, &QMcpServer::finished, &app, &QCoreApplication::quit);
+        return app.exec();
+    }
+
+    QCoreApplication app(argc, argv);
+    tst_Stdio tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_stdio.moc"
@@ -4,16 +4,20 @@
 #include <QtCore/QEventLoop>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QPromise>
 #include <QtCore/QTimer>
 #include <QtMcpCommon/qtmcpnamespace.h>
 #include <QtMcpServer/QMcpServer>
 #include <QtMcpServer/QMcpServerSession>
+#include <QtMcpServer/qmcpserverbackendinterface.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QTcpServer>
 #include <QtTest/QTest>
 
+#include <memory>
+
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
@@ -83,18 +87,28 @@ private slots:
     void unknownSessionIsNotFound();
     void missingSessionHeaderIsBadRequest();
     void standaloneStreamAndDelete();
+    void deleteAnswersWaitingRequests();
+    void standaloneStreamResumes();
     void statelessRequest();
     void statelessHeaderMismatchIsRejected();
     void statelessRejectsGetAndDelete();
     void forbiddenOrigin();
+    void metricsEndpointServesPrometheusText();
+    void busyServerAnswersTooManyRequests();
 
 private:
     QNetworkRequest endpoint(const QString &protocolVersion = {}) const;
     // Runs the initialize / notifications/initialized handshake and returns the
     // session id the server minted.
     QByteArray openSession(const QString &protocolVersion);
+    // Opens the standalone stream of a session and waits for its headers.
+    // What it receives is appended to \a streamed.
+    QNetworkReply *openStream(const QString &protocolVersion, const QByteArray &sessionId,
+                              const QByteArray &lastEventId, QByteArray *streamed);
 
     QMcpServer *m_server = nullptr;
+    // Runs of the blocking tool still to be answered.
+    QList<std::shared_ptr<QPromise<QString>>> m_blocked;
     QNetworkAccessManager m_networkAccessManager;
     quint16 m_port = 0;
 };
@@ -111,6 +125,12 @@ void tst_StreamableHttp::initTestCase()
     probe.close();
 
     m_server = new QMcpServer("streamablehttp"_L1, this);
+    m_server->addTool(u"block"_s, QStringList(), [this]() -> QFuture<QString> {
+        auto promise = std::make_shared<QPromise<QString>>();
+        promise->start();
+        m_blocked.append(promise);
+        return promise->future();
+    });
 
     QEventLoop loop;
     connect(m_server, &QMcpServer::started, &loop, &QEventLoop::quit);
@@ -169,6 +189,27 @@ QByteArray tst_StreamableHttp::openSession(const QString &protocolVersion)
     return sessionId;
 }
 
+QNetworkReply *tst_StreamableHttp::openStream(const QString &protocolVersion, const QByteArray &sessionId,
+                                              const QByteArray &lastEventId, QByteArray *streamed)
+{
+    auto request = endpoint(protocolVersion);
+    request.setRawHeader("Accept"_ba, "text/event-stream"_ba);
+    request.setRawHeader("Mcp-Session-Id"_ba, sessionId);
+    if (!lastEventId.isEmpty())
+        request.setRawHeader("Last-Event-ID"_ba, lastEventId);
+    auto *reply = m_networkAccessManager.get(request);
+    connect(reply, &QNetworkReply::readyRead, reply, [streamed, reply]() {
+        streamed->append(reply->readAll());
+    });
+
+    QEventLoop loop;
+    connect(reply, &QNetworkReply::metaDataChanged, &loop, &QEventLoop::quit);
+    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    QTimer::singleShot(Timeout, &loop, &QEventLoop::quit);
+    loop.exec();
+    return reply;
+}
+
 void tst_StreamableHttp::backendIsAvailable()
 {
     QVERIFY(QMcpServer::backends().contains("streamablehttp"_L1));
@@ -307,7 +348,8 @@ void tst_StreamableHttp::standaloneStreamAndDelete()
         emit session->toolListChanged();
 
     QTRY_VERIFY_WITH_TIMEOUT(streamed.contains("notifications/tools/list_changed"), Timeout);
-    QVERIFY(streamed.startsWith("data: "));
+    QVERIFY(streamed.startsWith("id: "));
+    QVERIFY(streamed.contains("\r\ndata: "));
 
     streamReply->abort();
     streamReply->deleteLater();
@@ -329,6 +371,73 @@ void tst_StreamableHttp::standaloneStreamAndDelete()
     QCOMPARE(statusCode, 404);
 }
 
+void tst_StreamableHttp::deleteAnswersWaitingRequests()
+{
+    const auto version = QtMcp::protocolVersionToString(QtMcp::ProtocolVersion::v2025_11_25);
+    const auto sessionId = openSession(version);
+    QVERIFY(!sessionId.isEmpty());
+    auto request = endpoint(version);
+    request.setRawHeader("Mcp-Session-Id"_ba, sessionId);
+    QJsonObject params;
+    params.insert("name"_L1, "block"_L1);
+    const auto body = QJsonDocument(jsonRpc("tools/call"_L1, 7, params)).toJson(QJsonDocument::Compact);
+    auto *callReply = m_networkAccessManager.post(request, body);
+    QTRY_COMPARE(m_blocked.size(), 1);
+
+    // The call the session was waiting on is answered when it ends, rather
+    // than left open for good.
+    auto *deleteReply = m_networkAccessManager.deleteResource(request);
+    int statusCode = 0;
+    waitForBody(deleteReply, &statusCode);
+    deleteReply->deleteLater();
+    QCOMPARE(statusCode, 200);
+
+    const auto callBody = waitForBody(callReply, &statusCode);
+    callReply->deleteLater();
+    QCOMPARE(statusCode, 404);
+    QCOMPARE(QJsonDocument::fromJson(callBody).object().value("id"_L1).toInt(), 7);
+
+    m_blocked.at(0)->addResult(u"done"_s);
+    m_blocked.at(0)->finish();
+    m_blocked.clear();
+}
+
+void tst_StreamableHttp::standaloneStreamResumes()
+{
+    const auto version = QtMcp::protocolVersionToString(QtMcp::ProtocolVersion::v2025_11_25);
+    const auto sessionId = openSession(version);
+    QVERIFY(!sessionId.isEmpty());
+    const auto notifyAll = [this]() {
+        const auto sessions = m_server->findChildren<QMcpServerSession *>();
+        for (auto *session : sessions)
+            emit session->toolListChanged();
+    };
+
+    QByteArray streamed;
+    auto *first = openStream(version, sessionId, {}, &streamed);
+    QCOMPARE(first->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    notifyAll();
+    QTRY_VERIFY_WITH_TIMEOUT(streamed.contains("list_changed"), Timeout);
+    QVERIFY(streamed.startsWith("id: "));
+    const auto lastEventId = streamed.mid(4, streamed.indexOf('\r') - 4);
+    first->abort();
+    first->deleteLater();
+
+    // Sent while the client is away, and kept for it.
+    notifyAll();
+    notifyAll();
+
+    QByteArray resumed;
+    auto *second = openStream(version, sessionId, lastEventId, &resumed);
+    QCOMPARE(second->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    QTRY_COMPARE_WITH_TIMEOUT(resumed.count("list_changed"), qsizetype(2), Timeout);
+    const auto next = lastEventId.toULongLong() + 1;
+    QVERIFY(resumed.startsWith("id: " + QByteArray::number(next) + "\r\n"));
+    QVERIFY(resumed.contains("id: " + QByteArray::number(next + 1) + "\r\n"));
+    second->abort();
+    second->deleteLater();
+}
+
 void tst_StreamableHttp::statelessRequest()
 {
     const auto version = QtMcp::protocolVersionToString(QtMcp::ProtocolVersion::v2026_07_28);
@@ -467,5 +576,104 @@ void tst_StreamableHttp::forbiddenOrigin()
     QCOMPARE(statusCode, 400);
 }
 
+void tst_StreamableHttp::metricsEndpointServesPrometheusText()
+{
+    auto *backend = m_server->findChild<QMcpServerBackendInterface *>();
+    QVERIFY(backend);
+    QVERIFY(backend->setProperty("metricsPath", "/metrics"_L1));
+
+    // Make sure there is at least one answered request to count.
+    const auto version = QtMcp::protocolVersionToString(QtMcp::ProtocolVersion::v2026_07_28);
+    auto request = endpoint(version);
+    request.setRawHeader("Mcp-Method"_ba, "tools/list"_ba);
+    const auto message = withStatelessMeta(jsonRpc("tools/list"_L1, 1), version);
+    auto *reply = m_networkAccessManager.post(request,
+                                              QJsonDocument(message).toJson(QJsonDocument::Compact));
+    int statusCode = 0;
+    waitForBody(reply, &statusCode);
+    reply->deleteLater();
+    QCOMPARE(statusCode, 200);
+
+    const auto statistics = m_server->statistics();
+    QVERIFY(statistics.methods().value("tools/list"_L1).count() > 0);
+    QVERIFY(statistics.bytesReceived() > 0);
+    QVERIFY(statistics.bytesSent() > 0);
+
+    auto *metricsReply = m_networkAccessManager.get(
+            QNetworkRequest(QUrl(u"http://127.0.0.1:%1/metrics"_s.arg(m_port))));
+    const auto body = waitForBody(metricsReply, &statusCode);
+    metricsReply->deleteLater();
+    QCOMPARE(statusCode, 200);
+    QVERIFY(metricsReply->header(QNetworkRequest::ContentTypeHeader).toString().startsWith("text/plain"_L1));
+    QVERIFY(body.contains("mcp_requests_total{method=\"tools/list\"}"));
+    QVERIFY(body.contains("mcp_requests_duration_seconds_bucket{method=\"tools/list\",le=\"+Inf\"}"));
+    QVERIFY(body.contains("\nmcp_sessions "));
+
+    // Unsetting the path takes the endpoint away again.
+    QVERIFY(backend->setProperty("metricsPath", QString()));
+    auto *goneReply = m_networkAccessManager.get(
+            QNetworkRequest(QUrl(u"http://127.0.0.1:%1/metrics"_s.arg(m_port))));
+    waitForBody(goneReply, &statusCode);
+    goneReply->deleteLater();
+    QVERIFY(statusCode != 200);
+}
+
+void tst_StreamableHttp::busyServerAnswersTooManyRequests()
+{
+    const auto version = QtMcp::protocolVersionToString(QtMcp::ProtocolVersion::v2025_11_25);
+    const auto sessionId = openSession(version);
+    QVERIFY(!sessionId.isEmpty());
+    auto request = endpoint(version);
+    request.setRawHeader("Mcp-Session-Id"_ba, sessionId);
+    QJsonObject params;
+    params.insert("name"_L1, "block"_L1);
+    auto callBlock = [&](int id) {
+        const auto body = QJsonDocument(jsonRpc("tools/call"_L1, id, params)).toJson(QJsonDocument::Compact);
+        return m_networkAccessManager.post(request, body);
+    };
+
+    m_server->setConcurrencyLimits(1);
+    m_server->setQueueLimits(1);
+    auto *running = callBlock(1);
+    QTRY_COMPARE(m_blocked.size(), 1);
+    auto *waiting = callBlock(2);
+    QTRY_COMPARE(m_server->statistics().queuedToolCalls(), 1);
+
+    // The session's queue is full: this client sends too much.
+    auto *rejected = callBlock(3);
+    int statusCode = 0;
+    auto body = waitForBody(rejected, &statusCode);
+    rejected->deleteLater();
+    QCOMPARE(statusCode, 429);
+    QCOMPARE(rejected->rawHeader("Retry-After"_ba), "1"_ba);
+    QCOMPARE(errorCodeOf(body), QMcpServer::ServerBusyErrorCode);
+    QCOMPARE(QJsonDocument::fromJson(body).object().value("id"_L1).toInt(), 3);
+
+    // The server's queue is full: it is overloaded as a whole.
+    m_server->setQueueLimits(0, 1);
+    rejected = callBlock(4);
+    body = waitForBody(rejected, &statusCode);
+    rejected->deleteLater();
+    QCOMPARE(statusCode, 503);
+    QCOMPARE(rejected->rawHeader("Retry-After"_ba), "1"_ba);
+    QCOMPARE(errorCodeOf(body), QMcpServer::ServerBusyErrorCode);
+
+    // Answering the running call lets the waiting one run.
+    m_server->setQueueLimits(0, 0);
+    m_blocked.at(0)->addResult(u"done"_s);
+    m_blocked.at(0)->finish();
+    waitForBody(running, &statusCode);
+    running->deleteLater();
+    QCOMPARE(statusCode, 200);
+    QTRY_COMPARE(m_blocked.size(), 2);
+    m_server->setConcurrencyLimits(0);
+    m_blocked.at(1)->addResult(u"done"_s);
+    m_blocked.at(1)->finish();
+    waitForBody(waiting, &statusCode);
+    waiting->deleteLater();
+    QCOMPARE(statusCode, 200);
+    m_blocked.clear();
+}
+
 QTEST_MAIN(tst_StreamableHttp)
 #include "tst_streamablehttp.moc"
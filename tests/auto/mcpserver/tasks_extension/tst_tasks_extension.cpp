@@ -21,6 +21,10 @@
 #include <QtMcpCommon/QMcpExtGetTaskResult>
 #include <QtMcpCommon/QMcpGetTaskRequest>
 #include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpSubscriptionFilter>
+#include <QtMcpCommon/QMcpSubscriptionsListenRequest>
+#include <QtMcpCommon/QMcpSubscriptionsListenRequestParams>
+#include <QtMcpCommon/QMcpSubscriptionsListenResult>
 #include <QtMcpCommon/QMcpTextContent>
 #include <QtMcpCommon/qmcptaskstatus.h>
 #include <QtMcpCommon/qtmcpnamespace.h>
@@ -124,6 +128,8 @@ private slots:
     void withoutTheClientOptInTheCallStaysSynchronous();
     void discoverAdvertisesTheExtension();
     void anUnknownTaskIdIsRejected();
+    void aListeningClientIsToldWhenTheTaskCompletes();
+    void thePollIntervalFollowsTheToolsHistory();
 
 private:
     QMcpServer *m_server = nullptr;
@@ -335,5 +341,74 @@ void tst_TasksExtension::anUnknownTaskIdIsRejected()
     QCOMPARE(polled->errorCode, -32602);
 }
 
+void tst_TasksExtension::aListeningClientIsToldWhenTheTaskCompletes()
+{
+    startServer(300);
+    startClient(true);
+
+    // Pushes ride the subscriptions/listen stream, so the client opens one.
+    QMcpSubscriptionFilter filter;
+    filter.setToolsListChanged(true);
+    QMcpSubscriptionsListenRequestParams listenParams;
+    listenParams.setNotifications(filter);
+    QMcpSubscriptionsListenRequest listen;
+    listen.setParams(listenParams);
+    const auto listening = call<QMcpSubscriptionsListenResult>(m_client, listen);
+    QVERIFY(listening->answered);
+    QVERIFY(!listening->errorCode);
+
+    const auto created = call<QMcpExtCreateTaskResult>(m_client, slowEchoRequest("hello"_L1));
+    QVERIFY(created->answered);
+    const auto taskId = created->result.taskId();
+    QVERIFY(!taskId.isEmpty());
+
+    // A listening client gets a long poll interval: the pushes carry the
+    // transitions, polls are only the safety net.
+    QVERIFY(created->result.pollIntervalMs() > 300);
+
+    QSignalSpy statusSpy(m_client, &QMcpClient::taskStatusChanged);
+    m_client->followTask(taskId, created->result.pollIntervalMs());
+    QVERIFY(statusSpy.wait(2000));
+    QCOMPARE(statusSpy.last().at(0).toString(), taskId);
+    QCOMPARE(statusSpy.last().at(1).value<QMcpTaskStatus::QMcpTaskStatus>(), QMcpTaskStatus::completed);
+
+    // The push carries the complete task, result included, so no tasks/get
+    // round trip was needed to learn the outcome.
+    const auto task = statusSpy.last().at(2).toJsonObject();
+    QMcpCallToolResult toolResult;
+    QVERIFY(toolResult.fromJsonObject(task.value("result"_L1).toObject(), QtMcp::ProtocolVersion::v2026_07_28));
+    QCOMPARE(toolResult.content().first().textContent().text(), "hello"_L1);
+
+    bool pushed = false;
+    for (const auto &object : std::as_const(m_received)) {
+        if (object.value("method"_L1).toString() == "notifications/tasks"_L1)
+            pushed = true;
+        QVERIFY(object.value("result"_L1).toObject().value("taskId"_L1).toString() != taskId
+                || object.value("result"_L1).toObject().value("resultType"_L1).toString() == "task"_L1);
+    }
+    QVERIFY(pushed);
+}
+
+void tst_TasksExtension::thePollIntervalFollowsTheToolsHistory()
+{
+    startServer(400);
+    startClient(true);
+
+    // Nothing is known about the tool yet, so a fresh task gets the
+    // default interval rather than being polled eagerly.
+    const auto first = call<QMcpExtCreateTaskResult>(m_client, slowEchoRequest("first"_L1));
+    QVERIFY(first->answered);
+    QCOMPARE(first->result.pollIntervalMs(), 500);
+    QTest::qWait(600);
+
+    // After one 400 ms run the server expects the next to take about as
+    // long, and sends the client back around the time it should be done
+    // instead of at the default interval.
+    const auto second = call<QMcpExtCreateTaskResult>(m_client, slowEchoRequest("second"_L1));
+    QVERIFY(second->answered);
+    QVERIFY(second->result.pollIntervalMs() < first->result.pollIntervalMs());
+    QVERIFY(second->result.pollIntervalMs() >= 100);
+}
+
 QTEST_MAIN(tst_TasksExtension)
 #include "tst_tasks_extension.moc"
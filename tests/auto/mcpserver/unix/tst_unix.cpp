@@ -0,0 +1,122 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtNetwork/QLocalSocket>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpPingRequest>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+
+#include <memory>
+
+class tst_Unix : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void everyConnectionIsASession();
+    void messagesAreSplitAtNewlines();
+    void staleSocketIsReplaced();
+
+private:
+    QString m_name;
+    QMcpServer *m_server = nullptr;
+};
+
+void tst_Unix::init()
+{
+    m_name = u"qtmcp-tst_unix-%1"_s.arg(QCoreApplication::applicationPid());
+    m_server = new QMcpServer("unix"_L1, this);
+    QSignalSpy startedSpy(m_server, &QMcpServer::started);
+    m_server->start(m_name);
+    QCOMPARE(startedSpy.count(), 1);
+}
+
+void tst_Unix::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+void tst_Unix::everyConnectionIsASession()
+{
+    std::unique_ptr<QMcpClient> clients[2];
+    for (auto &client : clients) {
+        client = std::make_unique<QMcpClient>("unix"_L1);
+        client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+        QSignalSpy startedSpy(client.get(), &QMcpClient::started);
+        client->start(m_name);
+        QVERIFY(startedSpy.wait(5000));
+    }
+    QTRY_COMPARE(m_server->sessions().size(), 2);
+
+    // Each is answered on its own connection.
+    int answered = 0;
+    for (auto &client : clients) {
+        client->request(QMcpPingRequest(), [&answered](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *error) {
+            if (!error)
+                ++answered;
+        });
+    }
+    QTRY_COMPARE(answered, 2);
+}
+
+void tst_Unix::messagesAreSplitAtNewlines()
+{
+    QLocalSocket socket;
+    socket.connectToServer(m_name);
+    QTRY_COMPARE(socket.state(), QLocalSocket::ConnectedState);
+
+    // One message in two writes, the second carrying the next message too.
+    const auto first = R"({"jsonrpc":"2.0","id":1,"method":"ping"})"_ba;
+    socket.write(first.first(10));
+    socket.flush();
+    QTest::qWait(50);
+    socket.write(first.sliced(10) + "\n\n" + R"({"jsonrpc":"2.0","id":2,"method":"ping"})" + "\n");
+
+    QByteArray received;
+    QTRY_VERIFY((received += socket.readAll()).count('\n') == 2);
+    const auto lines = received.trimmed().split('\n');
+    QCOMPARE(QJsonDocument::fromJson(lines.at(0)).object().value("id"_L1).toInt(), 1);
+    QCOMPARE(QJsonDocument::fromJson(lines.at(1)).object().value("id"_L1).toInt(), 2);
+}
+
+void tst_Unix::staleSocketIsReplaced()
+{
+#ifdef Q_OS_UNIX
+    // A path someone else listens on is not taken over.
+    QMcpServer other("unix"_L1);
+    QSignalSpy otherStarted(&other, &QMcpServer::started);
+    other.start(m_name);
+    QCOMPARE(otherStarted.count(), 0);
+
+    // A file nobody answers on, as a crashed server leaves, is.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto path = dir.filePath(u"stale.sock"_s);
+    QFile stale(path);
+    QVERIFY(stale.open(QIODevice::WriteOnly));
+    stale.close();
+    QMcpServer replacement("unix"_L1);
+    QSignalSpy replacementStarted(&replacement, &QMcpServer::started);
+    replacement.start(path);
+    QCOMPARE(replacementStarted.count(), 1);
+#else
+    QSKIP("Named pipes leave nothing behind.");
+#endif
+}
+
+QTEST_MAIN(tst_Unix)
+#include "tst_unix.moc"
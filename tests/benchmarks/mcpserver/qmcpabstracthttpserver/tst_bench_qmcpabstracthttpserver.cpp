@@ -0,0 +1,94 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtMcpServer/qmcpabstracthttpserver.h>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QTcpServer>
+#include <QtTest/QTest>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+class BenchHttpServer : public QMcpAbstractHttpServer
+{
+    Q_OBJECT
+public:
+    using QMcpAbstractHttpServer::QMcpAbstractHttpServer;
+
+    int peakConnections = 0;
+
+protected:
+    Q_INVOKABLE QByteArray post(const QNetworkRequest &request, const QByteArray &body)
+    {
+        Q_UNUSED(request);
+        peakConnections = std::max(peakConnections, connectionCount());
+        return body;
+    }
+};
+
+class tst_bench_QMcpAbstractHttpServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void concurrentRequests_data();
+    void concurrentRequests();
+
+private:
+    BenchHttpServer m_server;
+    QTcpServer m_tcpServer;
+    QByteArray m_body;
+};
+
+void tst_bench_QMcpAbstractHttpServer::initTestCase()
+{
+    QVERIFY(m_tcpServer.listen(QHostAddress::LocalHost));
+    QVERIFY(m_server.bind(&m_tcpServer));
+    m_body = R"({"jsonrpc":"2.0","id":1,"method":"tools/call","params":{"name":"echo","arguments":{"message":"hello"}}})"_ba;
+}
+
+void tst_bench_QMcpAbstractHttpServer::concurrentRequests_data()
+{
+    QTest::addColumn<bool>("http2");
+
+    QTest::newRow("HTTP/1.1") << false;
+    QTest::newRow("HTTP/2") << true;
+}
+
+// 50 requests at once, as a busy client sends them: over HTTP/1.1 they
+// queue for a handful of connections, over HTTP/2 they share one.
+void tst_bench_QMcpAbstractHttpServer::concurrentRequests()
+{
+    QFETCH(bool, http2);
+    if (http2 && !m_server.isHttp2Enabled())
+        QSKIP("Built without the mcp-h2c feature");
+
+    QNetworkAccessManager manager;
+    QUrl url("http://127.0.0.1/"_L1);
+    url.setPort(m_tcpServer.serverPort());
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json"_ba);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, http2);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, http2);
+    m_server.peakConnections = 0;
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QNetworkReply>> replies;
+        for (int i = 0; i < 50; ++i)
+            replies.emplace_back(manager.post(request, m_body));
+        QTRY_VERIFY(std::all_of(replies.cbegin(), replies.cend(), [](const auto &reply) {
+            return reply->isFinished();
+        }));
+        for (const auto &reply : replies) {
+            if (reply->error() != QNetworkReply::NoError)
+                QFAIL(qPrintable(reply->errorString()));
+        }
+    }
+    qInfo() << (http2 ? "HTTP/2" : "HTTP/1.1") << "used up to" << m_server.peakConnections << "connections";
+}
+
+QTEST_MAIN(tst_bench_QMcpAbstractHttpServer)
+#include "tst_bench_qmcpabstracthttpserver.moc"
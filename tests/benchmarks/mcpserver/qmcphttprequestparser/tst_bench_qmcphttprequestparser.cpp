@@ -0,0 +1,114 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtMcpServer/private/qmcphttprequestparser_p.h>
+#include <QtTest/QTest>
+
+using Status = QMcpHttpRequestParser::Status;
+
+class tst_bench_QMcpHttpRequestParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void wholeRequest();
+    void fragments_data();
+    void fragments();
+    void pipelined();
+    void chunked();
+
+private:
+    QByteArray m_request;
+};
+
+void tst_bench_QMcpHttpRequestParser::initTestCase()
+{
+    const auto body = R"({"jsonrpc":"2.0","id":1,"method":"tools/call","params":{"name":"echo","arguments":{"message":"hello"}}})"_ba;
+    m_request = "POST /mcp HTTP/1.1\r\n"
+                "Host: 127.0.0.1:8000\r\n"
+                "User-Agent: bench/1.0\r\n"
+                "Accept: application/json, text/event-stream\r\n"
+                "Content-Type: application/json\r\n"
+                "Mcp-Session-Id: 0f8fad5b-d9cb-469f-a165-70867728950e\r\n"
+                "Mcp-Protocol-Version: 2025-06-18\r\n"
+                "Content-Length: "_ba
+            + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+}
+
+void tst_bench_QMcpHttpRequestParser::wholeRequest()
+{
+    QMcpHttpRequestParser parser;
+    QBENCHMARK {
+        parser.feed(m_request);
+        if (parser.parse() != Status::RequestReady)
+            QFAIL("request not parsed");
+        parser.takeRequest();
+    }
+}
+
+void tst_bench_QMcpHttpRequestParser::fragments_data()
+{
+    QTest::addColumn<int>("fragmentSize");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("16") << 16;
+    QTest::newRow("128") << 128;
+}
+
+void tst_bench_QMcpHttpRequestParser::fragments()
+{
+    QFETCH(int, fragmentSize);
+
+    QMcpHttpRequestParser parser;
+    QBENCHMARK {
+        auto status = Status::NeedMoreData;
+        for (qsizetype i = 0; i < m_request.size(); i += fragmentSize) {
+            parser.feed(QByteArrayView(m_request).sliced(i, qMin(qsizetype(fragmentSize), m_request.size() - i)));
+            status = parser.parse();
+        }
+        if (status != Status::RequestReady)
+            QFAIL("request not parsed");
+        parser.takeRequest();
+    }
+}
+
+void tst_bench_QMcpHttpRequestParser::pipelined()
+{
+    const auto requests = m_request.repeated(100);
+    QMcpHttpRequestParser parser;
+    QBENCHMARK {
+        parser.feed(requests);
+        int count = 0;
+        while (parser.parse() == Status::RequestReady) {
+            parser.takeRequest();
+            ++count;
+        }
+        if (count != 100)
+            QFAIL("requests not parsed");
+    }
+}
+
+void tst_bench_QMcpHttpRequestParser::chunked()
+{
+    QByteArray request = "POST /mcp HTTP/1.1\r\n"
+                         "Host: 127.0.0.1:8000\r\n"
+                         "Content-Type: application/json\r\n"
+                         "Transfer-Encoding: chunked\r\n"
+                         "\r\n"_ba;
+    const QByteArray chunk(1000, 'x');
+    for (int i = 0; i < 64; ++i)
+        request += "3e8\r\n" + chunk + "\r\n";
+    request += "0\r\n\r\n";
+
+    QMcpHttpRequestParser parser;
+    QBENCHMARK {
+        parser.feed(request);
+        if (parser.parse() != Status::RequestReady)
+            QFAIL("request not parsed");
+        parser.takeRequest();
+    }
+}
+
+QTEST_MAIN(tst_bench_QMcpHttpRequestParser)
+#include "tst_bench_qmcphttprequestparser.moc"
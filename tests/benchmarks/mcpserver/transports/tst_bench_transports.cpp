@@ -0,0 +1,244 @@
+// Copyright (C) 2025 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtCore/QElapsedTimer>
+#include <QtMcpClient/QMcpClient>
+#include <QtMcpCommon/QMcpCallToolRequest>
+#include <QtMcpCommon/QMcpCallToolResult>
+#include <QtMcpCommon/QMcpEmptyResult>
+#include <QtMcpCommon/QMcpInitializeRequest>
+#include <QtMcpCommon/QMcpInitializeResult>
+#include <QtMcpCommon/QMcpInitializedNotification>
+#include <QtMcpCommon/QMcpJSONRPCErrorError>
+#include <QtMcpCommon/QMcpPingRequest>
+#include <QtMcpCommon/qtmcpnamespace.h>
+#include <QtMcpServer/QMcpServer>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+// Passed to this very binary to have it serve the stdio rows.
+constexpr auto StdioServerArgument = "--stdio-server";
+
+} // namespace
+
+// Pings between a client and a server on one host: what the transport
+// costs per request, with next to nothing done on either end. The stdio
+// server is a second process, the others run in this one.
+class tst_bench_Transports : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void ping_data();
+    void ping();
+    void throughput_data();
+    void throughput();
+    void latency_data();
+    void latency();
+    void largeRequest_data();
+    void largeRequest();
+
+private:
+    void addRows();
+    bool startPeers();
+
+    std::unique_ptr<QMcpServer> m_server;
+    std::unique_ptr<QMcpClient> m_client;
+};
+
+void tst_bench_Transports::addRows()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<QString>("serverArgs");
+    QTest::addColumn<QString>("clientArgs");
+
+    const auto name = u"qtmcp-bench-%1"_s.arg(QCoreApplication::applicationPid());
+    const auto self = QCoreApplication::applicationFilePath() + u' ' + QLatin1StringView(StdioServerArgument);
+    QTest::newRow("inprocess") << u"inprocess"_s << name << name;
+    QTest::newRow("shm") << u"shm"_s << name << name;
+    QTest::newRow("unix") << u"unix"_s << name << name;
+    QTest::newRow("stdio") << u"stdio"_s << QString() << self;
+    QTest::newRow("streamablehttp") << u"streamablehttp"_s << u"127.0.0.1:10110"_s << u"http://127.0.0.1:10110"_s;
+    QTest::newRow("sse") << u"sse"_s << u"127.0.0.1:10111"_s << u"http://127.0.0.1:10111"_s;
+}
+
+bool tst_bench_Transports::startPeers()
+{
+    QFETCH(QString, backend);
+    QFETCH(QString, serverArgs);
+    QFETCH(QString, clientArgs);
+
+    m_client.reset();
+    m_server.reset();
+    if (backend != "stdio"_L1) {
+        m_server = std::make_unique<QMcpServer>(backend);
+        m_server->start(serverArgs);
+    }
+    m_client = std::make_unique<QMcpClient>(backend);
+    m_client->setProtocolVersion(QtMcp::ProtocolVersion::v2025_06_18);
+    QSignalSpy startedSpy(m_client.get(), &QMcpClient::started);
+    m_client->start(clientArgs);
+    if (!startedSpy.wait(5000))
+        return false;
+
+    QMcpInitializeRequest initialize;
+    auto params = initialize.params();
+    params.setProtocolVersion(QtMcp::protocolVersionToString(QtMcp::ProtocolVersion::v2025_06_18));
+    initialize.setParams(params);
+    bool initialized = false;
+    m_client->request(initialize, [&](const QMcpInitializeResult &, const QMcpJSONRPCErrorError *error) {
+        initialized = !error;
+    });
+    if (!QTest::qWaitFor([&initialized] { return initialized; }, 5000))
+        return false;
+    m_client->notify(QMcpInitializedNotification());
+    return true;
+}
+
+void tst_bench_Transports::ping_data()
+{
+    addRows();
+}
+
+void tst_bench_Transports::ping()
+{
+    QVERIFY(startPeers());
+
+    QBENCHMARK {
+        bool answered = false;
+        m_client->request(QMcpPingRequest(), [&](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *) {
+            answered = true;
+        });
+        if (!QTest::qWaitFor([&answered] { return answered; }, 5000))
+            QFAIL("ping not answered");
+    }
+}
+
+void tst_bench_Transports::throughput_data()
+{
+    addRows();
+}
+
+// As many pings in flight as a busy peer keeps: messages per second.
+void tst_bench_Transports::throughput()
+{
+    QVERIFY(startPeers());
+    constexpr int Pings = 1000;
+
+    qint64 elapsed = 0;
+    int rounds = 0;
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+        int answered = 0;
+        for (int i = 0; i < Pings; ++i) {
+            m_client->request(QMcpPingRequest(), [&](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *) {
+                ++answered;
+            });
+        }
+        if (!QTest::qWaitFor([&answered] { return answered == Pings; }, 30000))
+            QFAIL("pings not answered");
+        elapsed += timer.nsecsElapsed();
+        ++rounds;
+    }
+    // A request and its response each count.
+    qInfo() << QTest::currentDataTag() << qRound64(2.0 * Pings * rounds * 1e9 / elapsed) << "messages/s";
+}
+
+void tst_bench_Transports::latency_data()
+{
+    addRows();
+}
+
+// One ping after the other, timed one by one; the result is the 99th
+// percentile.
+void tst_bench_Transports::latency()
+{
+    QVERIFY(startPeers());
+    constexpr int Pings = 2000;
+
+    QList<qint64> samples;
+    samples.reserve(Pings);
+    for (int i = 0; i < Pings; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        bool answered = false;
+        m_client->request(QMcpPingRequest(), [&](const QMcpEmptyResult &, const QMcpJSONRPCErrorError *) {
+            answered = true;
+        });
+        if (!QTest::qWaitFor([&answered] { return answered; }, 5000))
+            QFAIL("ping not answered");
+        samples.append(timer.nsecsElapsed());
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto p50 = samples.at(Pings / 2);
+    const auto p99 = samples.at(Pings * 99 / 100);
+    qInfo() << QTest::currentDataTag() << "p50" << p50 / 1000 << "us, p99" << p99 / 1000 << "us";
+    QTest::setBenchmarkResult(p99, QTest::WalltimeNanoseconds);
+}
+
+void tst_bench_Transports::largeRequest_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<QString>("serverArgs");
+    QTest::addColumn<QString>("clientArgs");
+    QTest::addColumn<qsizetype>("size");
+
+    const auto name = u"qtmcp-bench-%1"_s.arg(QCoreApplication::applicationPid());
+    const auto self = QCoreApplication::applicationFilePath() + u' ' + QLatin1StringView(StdioServerArgument);
+    const struct {
+        const char *tag;
+        qsizetype size;
+    } sizes[] = { { "64 KiB", 64 * 1024 }, { "1 MiB", 1024 * 1024 }, { "8 MiB", 8 * 1024 * 1024 } };
+    for (const auto &size : sizes) {
+        QTest::addRow("inprocess %s", size.tag) << u"inprocess"_s << name << name << size.size;
+        QTest::addRow("shm %s", size.tag) << u"shm"_s << name << name << size.size;
+        QTest::addRow("unix %s", size.tag) << u"unix"_s << name << name << size.size;
+        QTest::addRow("stdio %s", size.tag) << u"stdio"_s << QString() << self << size.size;
+    }
+}
+
+// A tool call with arguments of the given size, answered with an error as
+// the server has no tools: the time should grow linearly with the size.
+void tst_bench_Transports::largeRequest()
+{
+    QFETCH(qsizetype, size);
+    QVERIFY(startPeers());
+
+    QMcpCallToolRequest request;
+    auto params = request.params();
+    params.setName(u"echo"_s);
+    params.setArguments({ { "text"_L1, QString(size, u'x') } });
+    request.setParams(params);
+
+    QBENCHMARK {
+        bool answered = false;
+        m_client->request(request, [&](const QMcpCallToolResult &, const QMcpJSONRPCErrorError *) {
+            answered = true;
+        });
+        if (!QTest::qWaitFor([&answered] { return answered; }, 30000))
+            QFAIL("tool call not answered");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && qstrcmp(argv[argc - 1], StdioServerArgument) == 0) {
+        QCoreApplication app(argc, argv);
+        QMcpServer server(u"stdio"_s);
+        server.start(QString());
+        return app.exec();
+    }
+
+    QCoreApplication app(argc, argv);
+    tst_bench_Transports tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_bench_transports.moc"